@@ -6,7 +6,6 @@
 
 #include <zephyr/kernel.h>
 #include <zephyr/types.h>
-#include <zephyr/sys/ring_buffer.h>
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/devicetree.h>
 
@@ -22,6 +21,7 @@
 #include "ble_ctrl_event.h"
 #include "ble_data_event.h"
 #include "uart_data_event.h"
+#include "uart_rx_pool.h"
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(MODULE, CONFIG_BRIDGE_BLE_LOG_LEVEL);
@@ -30,7 +30,9 @@ LOG_MODULE_REGISTER(MODULE, CONFIG_BRIDGE_BLE_LOG_LEVEL);
 #define BLE_RX_BUF_COUNT 4
 #define BLE_SLAB_ALIGNMENT 4
 
-#define BLE_TX_BUF_SIZE (CONFIG_BRIDGE_BUF_SIZE * 2)
+#define BLE_TX_QUEUE_SIZE CONFIG_BRIDGE_BLE_TX_QUEUE_SIZE
+
+BUILD_ASSERT(BLE_TX_QUEUE_SIZE < CONFIG_BRIDGE_UART_BUF_COUNT);
 
 #define BLE_AD_IDX_FLAGS 0
 #define BLE_AD_IDX_NAME 1
@@ -40,7 +42,11 @@ LOG_MODULE_REGISTER(MODULE, CONFIG_BRIDGE_BLE_LOG_LEVEL);
 static void bt_send_work_handler(struct k_work *work);
 
 K_MEM_SLAB_DEFINE(ble_rx_slab, BLE_RX_BLOCK_SIZE, BLE_RX_BUF_COUNT, BLE_SLAB_ALIGNMENT);
-RING_BUF_DECLARE(ble_tx_ring_buf, BLE_TX_BUF_SIZE);
+
+/* Referenced UART data waiting to be sent over NUS */
+static struct uart_rx_queue_block ble_tx_blocks[BLE_TX_QUEUE_SIZE];
+static struct uart_rx_queue ble_tx_queue = UART_RX_QUEUE_INITIALIZER(ble_tx_blocks);
+static struct k_spinlock ble_tx_lock;
 
 static K_SEM_DEFINE(ble_tx_sem, 0, 1);
 
@@ -96,8 +102,6 @@ static void connected(struct bt_conn *conn, uint8_t err)
 		LOG_WRN("bt_gatt_exchange_mtu: %d", err);
 	}
 
-	ring_buf_reset(&ble_tx_ring_buf);
-
 	struct peer_conn_event *event = new_peer_conn_event();
 
 	event->peer_id = PEER_ID_BLE;
@@ -119,6 +123,9 @@ static void disconnected(struct bt_conn *conn, uint8_t reason)
 		current_conn = NULL;
 	}
 
+	/* Release the queued data */
+	k_work_submit(&bt_send_work);
+
 	struct peer_conn_event *event = new_peer_conn_event();
 
 	event->peer_id = PEER_ID_BLE;
@@ -133,34 +140,52 @@ static struct bt_conn_cb conn_callbacks = {
 	.disconnected = disconnected,
 };
 
+static void ble_tx_flush(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&ble_tx_lock);
+
+	uart_rx_queue_flush(&ble_tx_queue);
+
+	k_spin_unlock(&ble_tx_lock, key);
+}
+
 static void bt_send_work_handler(struct k_work *work)
 {
-	uint16_t len;
-	uint8_t *buf;
+	const uint8_t *buf;
+	k_spinlock_key_t key;
+	size_t len;
 	int err;
-	bool notif_disabled = false;
 
-	do {
-		len = ring_buf_get_claim(&ble_tx_ring_buf, &buf, nus_max_send_len);
+	if (current_conn == NULL) {
+		ble_tx_flush();
+		return;
+	}
+
+	for (;;) {
+		/* The queued data is consumed only by this work, so it stays valid unlocked */
+		key = k_spin_lock(&ble_tx_lock);
+		len = uart_rx_queue_peek(&ble_tx_queue, &buf);
+		k_spin_unlock(&ble_tx_lock, key);
+
+		if (len == 0) {
+			break;
+		}
+
+		len = MIN(nus_max_send_len, len);
 
 		err = bt_nus_send(current_conn, buf, len);
 		if (err == -EINVAL) {
-			notif_disabled = true;
-			len = 0;
+			/* Peer has not enabled notifications: don't accumulate data */
+			ble_tx_flush();
+			break;
 		} else if (err) {
-			len = 0;
-		}
-
-		err = ring_buf_get_finish(&ble_tx_ring_buf, len);
-		if (err) {
-			LOG_ERR("ring_buf_get_finish: %d", err);
+			/* Retried when the pending data is sent */
 			break;
 		}
-	} while (len != 0 && !ring_buf_is_empty(&ble_tx_ring_buf));
 
-	if (notif_disabled) {
-		/* Peer has not enabled notifications: don't accumulate data */
-		ring_buf_reset(&ble_tx_ring_buf);
+		key = k_spin_lock(&ble_tx_lock);
+		uart_rx_queue_consume(&ble_tx_queue, len);
+		k_spin_unlock(&ble_tx_lock, key);
 	}
 }
 
@@ -197,7 +222,12 @@ static void bt_receive_cb(struct bt_conn *conn, const uint8_t *const data,
 
 static void bt_sent_cb(struct bt_conn *conn)
 {
-	if (ring_buf_is_empty(&ble_tx_ring_buf)) {
+	k_spinlock_key_t key = k_spin_lock(&ble_tx_lock);
+	size_t count = ble_tx_queue.count;
+
+	k_spin_unlock(&ble_tx_lock, key);
+
+	if (count == 0) {
 		return;
 	}
 
@@ -326,6 +356,9 @@ static bool app_event_handler(const struct app_event_header *aeh)
 	if (is_uart_data_event(aeh)) {
 		const struct uart_data_event *event =
 			cast_uart_data_event(aeh);
+		k_spinlock_key_t key;
+		uint32_t dropped;
+		int err;
 
 		/* Only one BLE Service instance, mapped to UART_0 */
 		if (event->dev_idx != 0) {
@@ -336,24 +369,21 @@ static bool app_event_handler(const struct app_event_header *aeh)
 			return false;
 		}
 
-		uint32_t written = ring_buf_put(
-			&ble_tx_ring_buf,
-			event->buf,
-			event->len);
-		if (written != event->len) {
-			LOG_WRN("UART_%d -> BLE overflow", event->dev_idx);
-		}
-
-		uint32_t buf_utilization =
-			(ring_buf_capacity_get(&ble_tx_ring_buf) -
-			ring_buf_space_get(&ble_tx_ring_buf));
+		/* The data is sent from bt_send_work, without copying it here */
+		key = k_spin_lock(&ble_tx_lock);
+		err = uart_rx_queue_put(&ble_tx_queue, event->buf, event->len);
+		dropped = ble_tx_queue.dropped;
+		k_spin_unlock(&ble_tx_lock, key);
 
-		/* Simple check to start transmission. */
-		/* If bt_send_work is already running, this has no effect */
-		if (buf_utilization == written) {
-			k_work_submit(&bt_send_work);
+		if (err) {
+			LOG_WRN("UART_%d -> BLE overflow, %u bytes dropped in total",
+				event->dev_idx, dropped);
+			return false;
 		}
 
+		/* If bt_send_work is already pending, this has no effect */
+		k_work_submit(&bt_send_work);
+
 		return false;
 	}
 
@@ -15,6 +15,7 @@
 #include "ble_data_event.h"
 #include "cdc_data_event.h"
 #include "uart_data_event.h"
+#include "uart_rx_pool.h"
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(MODULE, CONFIG_BRIDGE_UART_LOG_LEVEL);
@@ -28,9 +29,6 @@ static const struct device *devices[] = {
 
 #define UART_BUF_SIZE CONFIG_BRIDGE_BUF_SIZE
 
-#define UART_SLAB_BLOCK_SIZE sizeof(struct uart_rx_buf)
-#define UART_SLAB_BLOCK_COUNT (UART_DEVICE_COUNT * CONFIG_BRIDGE_UART_BUF_COUNT)
-#define UART_SLAB_ALIGNMENT 4
 #define UART_RX_TIMEOUT_USEC 1000
 
 #if defined(CONFIG_PM_DEVICE)
@@ -39,87 +37,63 @@ static const struct device *devices[] = {
 #define UART_SET_PM_STATE false
 #endif
 
-struct uart_rx_buf {
-	atomic_t ref_counter;
-	size_t len;
-	uint8_t buf[UART_BUF_SIZE];
-};
-
 struct uart_tx_buf {
 	struct ring_buf rb;
 	uint8_t buf[UART_BUF_SIZE];
 };
 
-BUILD_ASSERT((sizeof(struct uart_rx_buf) % UART_SLAB_ALIGNMENT) == 0);
+BUILD_ASSERT(UART_DEVICE_COUNT == UART_RX_POOL_DEVICE_COUNT);
 
-/* Blocks from the same slab is used for RX for all UART instances */
+/* RX uses blocks from the shared uart_rx_pool for all UART instances */
 /* TX has inidividual ringbuffers per UART instance */
 
-K_MEM_SLAB_DEFINE(uart_rx_slab, UART_SLAB_BLOCK_SIZE, UART_SLAB_BLOCK_COUNT, UART_SLAB_ALIGNMENT);
-
 static struct uart_tx_buf uart_tx_ringbufs[UART_DEVICE_COUNT];
 static uint32_t uart_default_baudrate[UART_DEVICE_COUNT];
 /* UART RX only enabled when there is one or more subscribers (power saving) */
 static int subscriber_count[UART_DEVICE_COUNT];
 static bool enable_rx_retry[UART_DEVICE_COUNT];
+/* RX ran out of buffer blocks, set by the UART callback */
+static bool rx_buf_missing[UART_DEVICE_COUNT];
+/* Bitmask of UART instances with RX disabled until a buffer block is freed */
+static atomic_t rx_stalled;
 static atomic_t uart_tx_started[UART_DEVICE_COUNT];
 
+static void rx_resume_work_handler(struct k_work *work);
+
+static K_WORK_DEFINE(rx_resume_work, rx_resume_work_handler);
+
 static void enable_uart_rx(uint8_t dev_idx);
 static void disable_uart_rx(uint8_t dev_idx);
 static void set_uart_power_state(uint8_t dev_idx, bool active);
 static int uart_tx_start(uint8_t dev_idx);
 static void uart_tx_finish(uint8_t dev_idx, size_t len);
 
-static inline struct uart_rx_buf *block_start_get(uint8_t *buf)
+static void rx_stall(uint8_t dev_idx)
 {
-	size_t block_num;
-
-	/* blocks are fixed size units from a continuous memory slab: */
-	/* round down to the closest unit size to find beginning of block. */
-
-	block_num =
-		(((size_t)buf - (size_t)uart_rx_slab.buffer) / UART_SLAB_BLOCK_SIZE);
-
-	return (struct uart_rx_buf *) &uart_rx_slab.buffer[block_num * UART_SLAB_BLOCK_SIZE];
-}
-
-static struct uart_rx_buf *uart_rx_buf_alloc(void)
-{
-	struct uart_rx_buf *buf;
-	int err;
-
-	/* Async UART driver returns pointers to received data as */
-	/* offsets from beginning of RX buffer block. */
-	/* This code uses a reference counter to keep track of the number of */
-	/* references within a single RX buffer block */
-
-	err = k_mem_slab_alloc(&uart_rx_slab, (void **) &buf, K_NO_WAIT);
-	if (err) {
-		return NULL;
-	}
+	LOG_WRN("UART_%d RX stalled until a buffer is released", dev_idx);
 
-	atomic_set(&buf->ref_counter, 1);
-
-	return buf;
+	atomic_set_bit(&rx_stalled, dev_idx);
+	uart_rx_pool_wait();
 }
 
-static void uart_rx_buf_ref(void *buf)
+static void rx_buf_free_cb(void)
 {
-	__ASSERT_NO_MSG(buf);
-
-	atomic_inc(&(block_start_get(buf)->ref_counter));
+	/* Called from the context releasing the block, RX is resumed from the work */
+	k_work_submit(&rx_resume_work);
 }
 
-static void uart_rx_buf_unref(void *buf)
+static void rx_resume_work_handler(struct k_work *work)
 {
-	__ASSERT_NO_MSG(buf);
-
-	struct uart_rx_buf *uart_buf = block_start_get(buf);
-	atomic_t ref_counter = atomic_dec(&uart_buf->ref_counter);
+	for (int i = 0; i < UART_DEVICE_COUNT; ++i) {
+		if (!atomic_test_and_clear_bit(&rx_stalled, i)) {
+			continue;
+		}
 
-	/* ref_counter is the uart_buf->ref_counter value prior to decrement */
-	if (ref_counter == 1) {
-		k_mem_slab_free(&uart_rx_slab, (void *)uart_buf);
+		if (subscriber_count[i] > 0) {
+			enable_uart_rx(i);
+		} else if (UART_SET_PM_STATE) {
+			set_uart_power_state(i, false);
+		}
 	}
 }
 
@@ -128,12 +102,12 @@ static void uart_callback(const struct device *dev, struct uart_event *evt,
 {
 	int dev_idx = (int) user_data;
 	struct uart_data_event *event;
-	struct uart_rx_buf *buf;
+	uint8_t *buf;
 	int err;
 
 	switch (evt->type) {
 	case UART_RX_RDY:
-		uart_rx_buf_ref(evt->data.rx.buf);
+		uart_rx_pool_ref(evt->data.rx.buf);
 
 		event = new_uart_data_event();
 		event->dev_idx = dev_idx;
@@ -143,26 +117,31 @@ static void uart_callback(const struct device *dev, struct uart_event *evt,
 		break;
 	case UART_RX_BUF_RELEASED:
 		if (evt->data.rx_buf.buf) {
-			uart_rx_buf_unref(evt->data.rx_buf.buf);
+			uart_rx_pool_unref(evt->data.rx_buf.buf);
 		}
 		break;
 	case UART_RX_BUF_REQUEST:
-		buf = uart_rx_buf_alloc();
+		buf = uart_rx_pool_alloc();
 		if (buf == NULL) {
+			/* RX is disabled when the current buffer is full */
 			LOG_WRN("UART_%d RX overflow", dev_idx);
+			rx_buf_missing[dev_idx] = true;
 			break;
 		}
 
-		err = uart_rx_buf_rsp(dev, buf->buf, sizeof(buf->buf));
+		err = uart_rx_buf_rsp(dev, buf, UART_RX_POOL_BUF_SIZE);
 		if (err) {
 			LOG_ERR("uart_rx_buf_rsp: %d", err);
-			uart_rx_buf_unref(buf);
+			uart_rx_pool_unref(buf);
 		}
 		break;
 	case UART_RX_DISABLED:
 		if (enable_rx_retry[dev_idx]) {
 			enable_uart_rx(dev_idx);
 			enable_rx_retry[dev_idx] = false;
+		} else if (rx_buf_missing[dev_idx]) {
+			/* Keep the UART powered, RX is resumed when the sinks release a buffer */
+			rx_stall(dev_idx);
 		} else if (UART_SET_PM_STATE) {
 			set_uart_power_state(dev_idx, false);
 		}
@@ -245,7 +224,10 @@ static void enable_uart_rx(uint8_t dev_idx)
 {
 	const struct device *dev = devices[dev_idx];
 	int err;
-	struct uart_rx_buf *buf;
+	uint8_t *buf;
+
+	atomic_clear_bit(&rx_stalled, dev_idx);
+	rx_buf_missing[dev_idx] = false;
 
 	err = uart_callback_set(dev, uart_callback, (void *) (int) dev_idx);
 	if (err) {
@@ -253,15 +235,15 @@ static void enable_uart_rx(uint8_t dev_idx)
 		return;
 	}
 
-	buf = uart_rx_buf_alloc();
+	buf = uart_rx_pool_alloc();
 	if (!buf) {
-		LOG_ERR("uart_rx_buf_alloc error");
+		rx_stall(dev_idx);
 		return;
 	}
 
-	err = uart_rx_enable(dev, buf->buf, sizeof(buf->buf), UART_RX_TIMEOUT_USEC);
+	err = uart_rx_enable(dev, buf, UART_RX_POOL_BUF_SIZE, UART_RX_TIMEOUT_USEC);
 	if (err) {
-		uart_rx_buf_unref(buf);
+		uart_rx_pool_unref(buf);
 		LOG_ERR("uart_rx_enable: %d", err);
 		return;
 	}
@@ -347,8 +329,8 @@ static bool app_event_handler(const struct app_event_header *aeh)
 		const struct uart_data_event *event =
 			cast_uart_data_event(aeh);
 
-		/* All subscribers have gotten a chance to copy data at this point */
-		uart_rx_buf_unref(event->buf);
+		/* All subscribers have gotten a chance to copy or reference data at this point */
+		uart_rx_pool_unref(event->buf);
 
 		return true;
 	}
@@ -426,7 +408,14 @@ static bool app_event_handler(const struct app_event_header *aeh)
 			set_uart_baudrate(
 				event->dev_idx,
 				uart_default_baudrate[event->dev_idx]);
-			disable_uart_rx(event->dev_idx);
+			if (atomic_test_and_clear_bit(&rx_stalled, event->dev_idx)) {
+				/* RX is already disabled */
+				if (UART_SET_PM_STATE) {
+					set_uart_power_state(event->dev_idx, false);
+				}
+			} else {
+				disable_uart_rx(event->dev_idx);
+			}
 		} else if (prev_count == 0) {
 			LOG_DBG("First subscriber. Open UART_%d RX", event->dev_idx);
 			if (UART_SET_PM_STATE) {
@@ -445,6 +434,8 @@ static bool app_event_handler(const struct app_event_header *aeh)
 			cast_module_state_event(aeh);
 
 		if (check_state(event, MODULE_ID(main), MODULE_STATE_READY)) {
+			uart_rx_pool_init(rx_buf_free_cb);
+
 			for (int i = 0; i < UART_DEVICE_COUNT; ++i) {
 				struct uart_config cfg;
 
@@ -462,6 +453,7 @@ static bool app_event_handler(const struct app_event_header *aeh)
 				uart_default_baudrate[i] = cfg.baudrate;
 				subscriber_count[i] = 0;
 				enable_rx_retry[i] = false;
+				rx_buf_missing[i] = false;
 
 				atomic_set(&uart_tx_started[i], false);
 
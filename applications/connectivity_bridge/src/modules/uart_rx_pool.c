@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#include "uart_rx_pool.h"
+
+#define UART_SLAB_BLOCK_SIZE sizeof(struct uart_rx_buf)
+#define UART_SLAB_ALIGNMENT 4
+
+struct uart_rx_buf {
+	atomic_t ref_counter;
+	size_t len;
+	uint8_t buf[UART_RX_POOL_BUF_SIZE];
+};
+
+BUILD_ASSERT((sizeof(struct uart_rx_buf) % UART_SLAB_ALIGNMENT) == 0);
+
+/* Blocks from the same slab is used for RX for all UART instances */
+K_MEM_SLAB_DEFINE_STATIC(uart_rx_slab, UART_SLAB_BLOCK_SIZE, UART_RX_POOL_BLOCK_COUNT,
+			 UART_SLAB_ALIGNMENT);
+
+static uart_rx_pool_free_cb_t pool_free_cb;
+static atomic_t pool_waiting;
+
+static inline struct uart_rx_buf *block_start_get(const uint8_t *buf)
+{
+	size_t block_num;
+
+	/* blocks are fixed size units from a continuous memory slab: */
+	/* round down to the closest unit size to find beginning of block. */
+
+	block_num =
+		(((size_t)buf - (size_t)uart_rx_slab.buffer) / UART_SLAB_BLOCK_SIZE);
+
+	return (struct uart_rx_buf *) &uart_rx_slab.buffer[block_num * UART_SLAB_BLOCK_SIZE];
+}
+
+static void pool_waiting_notify(void)
+{
+	/* Only one of the concurrent callers clears the flag and calls the callback */
+	if (atomic_cas(&pool_waiting, true, false) && pool_free_cb) {
+		pool_free_cb();
+	}
+}
+
+void uart_rx_pool_init(uart_rx_pool_free_cb_t free_cb)
+{
+	pool_free_cb = free_cb;
+	atomic_set(&pool_waiting, false);
+}
+
+uint8_t *uart_rx_pool_alloc(void)
+{
+	struct uart_rx_buf *buf;
+	int err;
+
+	/* Async UART driver returns pointers to received data as */
+	/* offsets from beginning of RX buffer block. */
+	/* This code uses a reference counter to keep track of the number of */
+	/* references within a single RX buffer block */
+
+	err = k_mem_slab_alloc(&uart_rx_slab, (void **) &buf, K_NO_WAIT);
+	if (err) {
+		return NULL;
+	}
+
+	atomic_set(&buf->ref_counter, 1);
+
+	return buf->buf;
+}
+
+void uart_rx_pool_ref(const uint8_t *buf)
+{
+	__ASSERT_NO_MSG(buf);
+
+	atomic_inc(&(block_start_get(buf)->ref_counter));
+}
+
+void uart_rx_pool_unref(const uint8_t *buf)
+{
+	__ASSERT_NO_MSG(buf);
+
+	struct uart_rx_buf *uart_buf = block_start_get(buf);
+	atomic_t ref_counter = atomic_dec(&uart_buf->ref_counter);
+
+	/* ref_counter is the uart_buf->ref_counter value prior to decrement */
+	if (ref_counter == 1) {
+		k_mem_slab_free(&uart_rx_slab, (void *)uart_buf);
+		pool_waiting_notify();
+	}
+}
+
+void uart_rx_pool_wait(void)
+{
+	atomic_set(&pool_waiting, true);
+
+	/* A block may have been freed before the flag was set */
+	if (k_mem_slab_num_free_get(&uart_rx_slab) > 0) {
+		pool_waiting_notify();
+	}
+}
+
+void uart_rx_queue_init(struct uart_rx_queue *queue, struct uart_rx_queue_block *blocks,
+			size_t size)
+{
+	__ASSERT_NO_MSG(size > 0);
+
+	queue->blocks = blocks;
+	queue->size = size;
+	queue->head = 0;
+	queue->count = 0;
+	queue->offset = 0;
+	queue->dropped = 0;
+}
+
+int uart_rx_queue_put(struct uart_rx_queue *queue, const uint8_t *buf, size_t len)
+{
+	struct uart_rx_queue_block *tail;
+
+	if (queue->count > 0) {
+		tail = &queue->blocks[(queue->head + queue->count - 1) % queue->size];
+
+		/* The UART driver reports the data of a buffer in order: append it to the block
+		 * that already holds a reference to the buffer.
+		 */
+		if ((block_start_get(tail->buf) == block_start_get(buf)) &&
+		    (tail->buf + tail->len == buf)) {
+			tail->len += len;
+			return 0;
+		}
+	}
+
+	if (queue->count == queue->size) {
+		queue->dropped += len;
+		return -ENOMEM;
+	}
+
+	uart_rx_pool_ref(buf);
+
+	tail = &queue->blocks[(queue->head + queue->count) % queue->size];
+	tail->buf = buf;
+	tail->len = len;
+	queue->count++;
+
+	return 0;
+}
+
+size_t uart_rx_queue_peek(struct uart_rx_queue *queue, const uint8_t **buf)
+{
+	struct uart_rx_queue_block *head;
+
+	if (queue->count == 0) {
+		return 0;
+	}
+
+	head = &queue->blocks[queue->head];
+	*buf = &head->buf[queue->offset];
+
+	return head->len - queue->offset;
+}
+
+void uart_rx_queue_consume(struct uart_rx_queue *queue, size_t len)
+{
+	struct uart_rx_queue_block *head = &queue->blocks[queue->head];
+
+	__ASSERT_NO_MSG(queue->count > 0);
+	__ASSERT_NO_MSG(queue->offset + len <= head->len);
+
+	queue->offset += len;
+	if (queue->offset < head->len) {
+		return;
+	}
+
+	queue->head = (queue->head + 1) % queue->size;
+	queue->count--;
+	queue->offset = 0;
+
+	uart_rx_pool_unref(head->buf);
+}
+
+void uart_rx_queue_flush(struct uart_rx_queue *queue)
+{
+	while (queue->count > 0) {
+		uart_rx_queue_consume(queue, queue->blocks[queue->head].len - queue->offset);
+	}
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _UART_RX_POOL_H_
+#define _UART_RX_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/sys/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of UART instances sharing the pool */
+#define UART_RX_POOL_DEVICE_COUNT 2
+
+#define UART_RX_POOL_BUF_SIZE CONFIG_BRIDGE_BUF_SIZE
+#define UART_RX_POOL_BLOCK_COUNT (UART_RX_POOL_DEVICE_COUNT * CONFIG_BRIDGE_UART_BUF_COUNT)
+
+/** Callback called when a block is freed after @ref uart_rx_pool_wait. */
+typedef void (*uart_rx_pool_free_cb_t)(void);
+
+/** Received UART data referenced by a sink, waiting to be sent. */
+struct uart_rx_queue_block {
+	const uint8_t *buf;
+	size_t len;
+};
+
+/** Queue of referenced UART data for a single sink.
+ *
+ * Data that continues the last queued block in the same buffer is appended to
+ * it, so each entry holds a single buffer block. The queue is not thread-safe.
+ */
+struct uart_rx_queue {
+	struct uart_rx_queue_block *blocks;
+	size_t size;
+	size_t head;
+	size_t count;
+	/* Number of bytes of the first block already consumed */
+	size_t offset;
+	uint32_t dropped;
+};
+
+/** Static initializer for a queue using the @p _blocks array as storage. */
+#define UART_RX_QUEUE_INITIALIZER(_blocks)		\
+	{						\
+		.blocks = (_blocks),			\
+		.size = ARRAY_SIZE(_blocks),		\
+	}
+
+/** @brief Set the callback for @ref uart_rx_pool_wait.
+ *
+ * @param free_cb Callback called when a block is freed.
+ */
+void uart_rx_pool_init(uart_rx_pool_free_cb_t free_cb);
+
+/** @brief Allocate a buffer block with a reference count of one.
+ *
+ * @return Buffer of @ref UART_RX_POOL_BUF_SIZE bytes, or NULL if all blocks are in use.
+ */
+uint8_t *uart_rx_pool_alloc(void);
+
+/** @brief Take a reference to the block containing the data.
+ *
+ * @param buf Pointer anywhere within an allocated buffer.
+ */
+void uart_rx_pool_ref(const uint8_t *buf);
+
+/** @brief Release a reference to the block containing the data.
+ *
+ * The block is freed when the last reference is released.
+ *
+ * @param buf Pointer anywhere within an allocated buffer.
+ */
+void uart_rx_pool_unref(const uint8_t *buf);
+
+/** @brief Request a call to the free callback once a block is available.
+ *
+ * The callback is called once, immediately if a block is already free.
+ */
+void uart_rx_pool_wait(void);
+
+/** @brief Initialize a queue.
+ *
+ * @param queue Queue.
+ * @param blocks Storage for the queued blocks.
+ * @param size Number of entries in @p blocks.
+ */
+void uart_rx_queue_init(struct uart_rx_queue *queue, struct uart_rx_queue_block *blocks,
+			size_t size);
+
+/** @brief Queue received data, referencing its buffer block.
+ *
+ * @param queue Queue.
+ * @param buf Received data, within an allocated buffer.
+ * @param len Length of the data.
+ *
+ * @retval 0 The data is queued.
+ * @retval -ENOMEM The queue is full, the data is dropped and counted in uart_rx_queue::dropped.
+ */
+int uart_rx_queue_put(struct uart_rx_queue *queue, const uint8_t *buf, size_t len);
+
+/** @brief Get the data of the first queued block that is not consumed yet.
+ *
+ * @param queue Queue.
+ * @param buf Set to the data.
+ *
+ * @return Length of the data, zero if the queue is empty.
+ */
+size_t uart_rx_queue_peek(struct uart_rx_queue *queue, const uint8_t **buf);
+
+/** @brief Consume data of the first queued block.
+ *
+ * The block is removed and its reference released when all of its data is consumed.
+ *
+ * @param queue Queue.
+ * @param len Number of bytes consumed, at most the length returned by @ref uart_rx_queue_peek.
+ */
+void uart_rx_queue_consume(struct uart_rx_queue *queue, size_t len);
+
+/** @brief Remove all the queued data, releasing the references.
+ *
+ * @param queue Queue.
+ */
+void uart_rx_queue_flush(struct uart_rx_queue *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _UART_RX_POOL_H_ */
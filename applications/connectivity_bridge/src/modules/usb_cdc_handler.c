@@ -13,6 +13,7 @@
 #include "peer_conn_event.h"
 #include "cdc_data_event.h"
 #include "uart_data_event.h"
+#include "uart_rx_pool.h"
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(MODULE, CONFIG_BRIDGE_CDC_LOG_LEVEL);
@@ -28,6 +29,9 @@ static const struct device *devices[] = {
 #define USB_CDC_RX_BLOCK_SIZE CONFIG_BRIDGE_BUF_SIZE
 #define USB_CDC_RX_BLOCK_COUNT (CDC_DEVICE_COUNT * 3)
 #define USB_CDC_SLAB_ALIGNMENT 4
+#define USB_CDC_TX_QUEUE_SIZE CONFIG_BRIDGE_CDC_TX_QUEUE_SIZE
+
+BUILD_ASSERT(USB_CDC_TX_QUEUE_SIZE < CONFIG_BRIDGE_UART_BUF_COUNT);
 
 static void cdc_dtr_timer_handler(struct k_timer *timer);
 static void cdc_dtr_work_handler(struct k_work *work);
@@ -39,11 +43,82 @@ K_MEM_SLAB_DEFINE(cdc_rx_slab, USB_CDC_RX_BLOCK_SIZE, USB_CDC_RX_BLOCK_COUNT, US
 
 static uint32_t cdc_ready[CDC_DEVICE_COUNT];
 
+/* Referenced UART data waiting to be written to a CDC instance */
+static struct uart_rx_queue_block cdc_tx_blocks[CDC_DEVICE_COUNT][USB_CDC_TX_QUEUE_SIZE];
+static struct uart_rx_queue cdc_tx_queue[] = {
+	UART_RX_QUEUE_INITIALIZER(cdc_tx_blocks[0]),
+	UART_RX_QUEUE_INITIALIZER(cdc_tx_blocks[1]),
+};
+
+BUILD_ASSERT(ARRAY_SIZE(cdc_tx_queue) == CDC_DEVICE_COUNT);
+
+static struct k_spinlock cdc_tx_lock;
+
 static uint8_t overflow_buf[64];
 
 static bool fs_module_ready;
 static bool bulk_module_ready;
 
+static void cdc_tx_flush(int dev_idx)
+{
+	k_spinlock_key_t key = k_spin_lock(&cdc_tx_lock);
+
+	uart_irq_tx_disable(devices[dev_idx]);
+	uart_rx_queue_flush(&cdc_tx_queue[dev_idx]);
+
+	k_spin_unlock(&cdc_tx_lock, key);
+}
+
+static void cdc_tx_fill(int dev_idx)
+{
+	const struct device *dev = devices[dev_idx];
+	const uint8_t *buf;
+	size_t len;
+	k_spinlock_key_t key = k_spin_lock(&cdc_tx_lock);
+
+	while ((len = uart_rx_queue_peek(&cdc_tx_queue[dev_idx], &buf)) > 0) {
+		int written;
+
+		written = uart_fifo_fill(dev, buf, len);
+		if (written <= 0) {
+			/* Continue when the CDC instance has space again */
+			k_spin_unlock(&cdc_tx_lock, key);
+			return;
+		}
+
+		uart_rx_queue_consume(&cdc_tx_queue[dev_idx], written);
+	}
+
+	uart_irq_tx_disable(dev);
+
+	k_spin_unlock(&cdc_tx_lock, key);
+}
+
+static void cdc_tx_enqueue(int dev_idx, const uint8_t *buf, size_t len)
+{
+	k_spinlock_key_t key;
+	uint32_t dropped;
+	int err;
+
+	key = k_spin_lock(&cdc_tx_lock);
+
+	/* The data is written from the TX interrupt, without copying it here */
+	err = uart_rx_queue_put(&cdc_tx_queue[dev_idx], buf, len);
+	if (!err) {
+		uart_irq_tx_enable(devices[dev_idx]);
+	}
+	dropped = cdc_tx_queue[dev_idx].dropped;
+
+	k_spin_unlock(&cdc_tx_lock, key);
+
+	if (err) {
+		LOG_WRN("UART_%d->CDC_%d overflow, %u bytes dropped in total",
+			dev_idx,
+			dev_idx,
+			dropped);
+	}
+}
+
 static void cdc_dtr_timer_handler(struct k_timer *timer)
 {
 	k_work_submit(&cdc_dtr_work);
@@ -84,6 +159,11 @@ static void poll_dtr(void)
 			APP_EVENT_SUBMIT(event);
 
 			cdc_ready[i] = cdc_val;
+
+			if (cdc_val == 0) {
+				/* Release the UART data that will not be read by the host */
+				cdc_tx_flush(i);
+			}
 		}
 	}
 }
@@ -99,6 +179,10 @@ static void cdc_uart_interrupt_handler(const struct device *dev, void *user_data
 
 	uart_irq_update(dev);
 
+	if (uart_irq_tx_ready(dev)) {
+		cdc_tx_fill(dev_idx);
+	}
+
 	while (uart_irq_rx_ready(dev)) {
 		void *rx_buf;
 		int err;
@@ -181,7 +265,6 @@ static bool app_event_handler(const struct app_event_header *aeh)
 	if (is_uart_data_event(aeh)) {
 		const struct uart_data_event *event =
 			cast_uart_data_event(aeh);
-		int tx_written;
 
 		if (event->dev_idx >= CDC_DEVICE_COUNT) {
 			return false;
@@ -191,16 +274,7 @@ static bool app_event_handler(const struct app_event_header *aeh)
 			return false;
 		}
 
-		tx_written = uart_fifo_fill(
-			devices[event->dev_idx],
-			event->buf,
-			event->len);
-
-		if (tx_written != event->len) {
-			LOG_DBG("UART_%d->CDC_%d overflow",
-				event->dev_idx,
-				event->dev_idx);
-		}
+		cdc_tx_enqueue(event->dev_idx, event->buf, event->len);
 
 		return false;
 	}
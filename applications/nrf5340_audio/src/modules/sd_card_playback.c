@@ -7,8 +7,6 @@
 #include "sd_card_playback.h"
 
 #include <stdint.h>
-#include <math.h>
-#include <zephyr/sys/ring_buffer.h>
 #include <zephyr/shell/shell.h>
 #include <pcm_mix.h>
 
@@ -27,6 +25,21 @@ LOG_MODULE_REGISTER(sd_card_playback, CONFIG_MODULE_SD_CARD_PLAYBACK_LOG_LEVEL);
 #define WAV_FORMAT_PCM	    1
 #define WAV_SAMPLE_RATE_48K 48000
 
+/* Largest supported decoded frame: 48 kHz mono */
+#define PCM_BLOCK_SIZE_MAX                                                                         \
+	(WAV_SAMPLE_RATE_48K * (CONFIG_AUDIO_BIT_DEPTH_BITS / 8) * FRAME_DURATION_MS / 1000)
+#define PCM_BLOCK_COUNT		CONFIG_SD_CARD_PLAYBACK_PCM_BLOCK_COUNT
+#define READ_BLOCK_SIZE		CONFIG_SD_CARD_PLAYBACK_READ_BLOCK_SIZE
+#define SD_CARD_SECTOR_SIZE	512
+
+/* The PCM blocks are consumed by the audio datapath every frame. Timeout value should therefore
+ * not be less than the frame duration.
+ */
+#define PCM_BLOCK_ALLOC_TIMEOUT_MS (2 * FRAME_DURATION_MS)
+
+BUILD_ASSERT(READ_BLOCK_SIZE % SD_CARD_SECTOR_SIZE == 0,
+	     "Read-ahead block size must be a multiple of the SD card sector size");
+
 /* WAV header */
 struct wav_header {
 	/* RIFF Header */
@@ -72,9 +85,21 @@ enum audio_formats {
 	SD_CARD_PLAYBACK_LC3,
 };
 
-RING_BUF_DECLARE(m_ringbuf_audio_data_lc3, CONFIG_SD_CARD_PLAYBACK_RING_BUF_SIZE);
-K_SEM_DEFINE(m_sem_ringbuf_space_available, 0, 1);
-K_MUTEX_DEFINE(mtx_ringbuf);
+/* Decoded audio frame, ready to be mixed with the stream */
+struct pcm_block {
+	size_t size;
+	uint8_t data[PCM_BLOCK_SIZE_MAX];
+};
+
+/* File data read ahead of the parser, in whole blocks */
+struct read_ahead {
+	uint8_t buf[READ_BLOCK_SIZE] __aligned(4);
+	size_t pos;
+	size_t len;
+};
+
+K_MEM_SLAB_DEFINE_STATIC(pcm_block_slab, sizeof(struct pcm_block), PCM_BLOCK_COUNT, 4);
+K_MSGQ_DEFINE(pcm_block_queue, sizeof(struct pcm_block *), PCM_BLOCK_COUNT, 4);
 K_SEM_DEFINE(m_sem_playback, 0, 1);
 K_THREAD_STACK_DEFINE(sd_card_playback_thread_stack, CONFIG_SD_CARD_PLAYBACK_STACK_SIZE);
 
@@ -93,73 +118,132 @@ static struct wav_header wav_file_header;
 static struct lc3_playback_config lc3_playback_cfg;
 
 static struct fs_file_t f_seg_read_entry;
+static struct read_ahead file_read_ahead;
+
+/* Statistics */
+static atomic_t underrun_cnt;
+static uint32_t sd_card_read_max_ms;
 
-static int sd_card_playback_ringbuf_read(uint8_t *buf, size_t *size)
+/**
+ * @brief	Read data from the open file through the read-ahead buffer.
+ *
+ * @note	The file is always read in whole read-ahead blocks, so that the reads from the
+ *		SD card are aligned to the card sectors and span several sectors each.
+ *
+ * @param[out]		buf	Buffer to read the data into.
+ * @param[in, out]	size	Number of bytes to read. The actual read size is returned, which
+ *				is smaller than requested only at the end of the file.
+ *
+ * @retval	0 on success, otherwise, error from the SD card module.
+ */
+static int sd_card_playback_read(void *buf, size_t *size)
 {
 	int ret;
-	uint16_t read_size;
+	struct read_ahead *ra = &file_read_ahead;
+	uint8_t *dst = buf;
+	size_t remaining = *size;
 
-	ret = k_mutex_lock(&mtx_ringbuf, K_NO_WAIT);
-	if (ret) {
-		LOG_ERR("Unable to take mutex. Ret: %d", ret);
-		return ret;
-	}
+	while (remaining > 0) {
+		if (ra->pos == ra->len) {
+			size_t read_size = sizeof(ra->buf);
+			int64_t start = k_uptime_get();
+			uint32_t read_time_ms;
 
-	read_size = ring_buf_get(&m_ringbuf_audio_data_lc3, buf, *size);
-	if (read_size != *size) {
-		LOG_WRN("Read size (%d) not equal requested size (%d)", read_size, *size);
-	}
+			ret = sd_card_read((char *)ra->buf, &read_size, &f_seg_read_entry);
+			if (ret) {
+				return ret;
+			}
 
-	ret = k_mutex_unlock(&mtx_ringbuf);
-	if (ret) {
-		LOG_ERR("Mutex unlock err: %d", ret);
-		return ret;
-	}
+			read_time_ms = k_uptime_delta(&start);
+			sd_card_read_max_ms = MAX(sd_card_read_max_ms, read_time_ms);
+
+			ra->pos = 0;
+			ra->len = read_size;
+
+			if (read_size == 0) {
+				/* End of file */
+				break;
+			}
+		}
+
+		size_t copy_size = MIN(remaining, ra->len - ra->pos);
 
-	if (ring_buf_space_get(&m_ringbuf_audio_data_lc3) >= pcm_frame_size) {
-		k_sem_give(&m_sem_ringbuf_space_available);
+		memcpy(dst, &ra->buf[ra->pos], copy_size);
+		ra->pos += copy_size;
+		dst += copy_size;
+		remaining -= copy_size;
 	}
 
-	*size = read_size;
+	*size -= remaining;
 
 	return 0;
 }
 
-static int sd_card_playback_ringbuf_write(uint8_t *buffer, size_t numbytes)
+static int sd_card_playback_block_alloc(struct pcm_block **block)
 {
 	int ret;
-	uint8_t *buf_ptr;
 
-	/* The ringbuffer is read every 10 ms by audio datapath when SD card playback is enabled.
-	 * Timeout value should therefore not be less than 10 ms
-	 */
-	ret = k_sem_take(&m_sem_ringbuf_space_available, K_MSEC(20));
+	ret = k_mem_slab_alloc(&pcm_block_slab, (void **)block, K_MSEC(PCM_BLOCK_ALLOC_TIMEOUT_MS));
 	if (ret) {
-		LOG_ERR("Sem take err: %d. Skipping frame", ret);
+		LOG_ERR("PCM block alloc err: %d", ret);
 		return ret;
 	}
 
-	ret = k_mutex_lock(&mtx_ringbuf, K_NO_WAIT);
+	return 0;
+}
+
+static int sd_card_playback_block_put(struct pcm_block *block)
+{
+	int ret;
+
+	ret = k_msgq_put(&pcm_block_queue, &block, K_NO_WAIT);
 	if (ret) {
-		LOG_ERR("Unable to take mutex. Ret: %d", ret);
+		/* Cannot happen, the queue can hold all the blocks */
+		LOG_ERR("PCM block queue err: %d", ret);
+		k_mem_slab_free(&pcm_block_slab, block);
 		return ret;
 	}
 
-	numbytes = ring_buf_put_claim(&m_ringbuf_audio_data_lc3, &buf_ptr, numbytes);
-	memcpy(buf_ptr, buffer, numbytes);
-	ret = ring_buf_put_finish(&m_ringbuf_audio_data_lc3, numbytes);
-	if (ret) {
-		LOG_ERR("Ring buf put finish err: %d", ret);
-		return ret;
+	/* Start the playback once all blocks are filled, so that the read-ahead can absorb
+	 * latency spikes of the SD card.
+	 */
+	if (!sd_card_playback_active && k_msgq_num_free_get(&pcm_block_queue) == 0) {
+		sd_card_playback_active = true;
 	}
 
-	ret = k_mutex_unlock(&mtx_ringbuf);
-	if (ret) {
-		LOG_ERR("Mutex unlock err: %d", ret);
-		return ret;
+	return 0;
+}
+
+static void sd_card_playback_drain(void)
+{
+	if (k_msgq_num_used_get(&pcm_block_queue) > 0) {
+		/* The file was shorter than the read-ahead */
+		sd_card_playback_active = true;
+	}
+
+	for (int i = 0; i <= PCM_BLOCK_COUNT; i++) {
+		if (k_msgq_num_used_get(&pcm_block_queue) == 0) {
+			break;
+		}
+
+		k_msleep(FRAME_DURATION_MS);
+	}
+
+	sd_card_playback_active = false;
+}
+
+static void sd_card_playback_reset(void)
+{
+	struct pcm_block *block;
+
+	while (k_msgq_get(&pcm_block_queue, &block, K_NO_WAIT) == 0) {
+		k_mem_slab_free(&pcm_block_slab, block);
 	}
 
-	return numbytes;
+	file_read_ahead.pos = 0;
+	file_read_ahead.len = 0;
+	atomic_set(&underrun_cnt, 0);
+	sd_card_read_max_ms = 0;
 }
 
 static int sd_card_playback_check_wav_header(struct wav_header wav_file_header)
@@ -193,8 +277,10 @@ static int sd_card_playback_play_wav(void)
 	int ret_sd_card_close;
 	size_t wav_read_size;
 	size_t wav_file_header_size = sizeof(wav_file_header);
+	uint32_t frame_size;
 	int audio_length_bytes;
 	int n_iter;
+	struct pcm_block *block;
 
 	ret = sd_card_open(playback_file_name, &f_seg_read_entry);
 	if (ret) {
@@ -202,7 +288,7 @@ static int sd_card_playback_play_wav(void)
 		return ret;
 	}
 
-	ret = sd_card_read((char *)&wav_file_header, &wav_file_header_size, &f_seg_read_entry);
+	ret = sd_card_playback_read(&wav_file_header, &wav_file_header_size);
 	if (ret) {
 		LOG_ERR("Read SD card err: %d", ret);
 		ret_sd_card_close = sd_card_close(&f_seg_read_entry);
@@ -226,35 +312,53 @@ static int sd_card_playback_play_wav(void)
 	}
 
 	/* Size corresponding to frame size of audio BT stream */
-	pcm_frame_size = wav_file_header.byte_rate * FRAME_DURATION_MS / 1000;
-	wav_read_size = pcm_frame_size;
-	uint8_t pcm_mono_frame[wav_read_size];
+	frame_size = wav_file_header.byte_rate * FRAME_DURATION_MS / 1000;
+	if (frame_size == 0 || frame_size > PCM_BLOCK_SIZE_MAX) {
+		LOG_ERR("Unsupported WAV frame size: %u", frame_size);
+		ret = -EINVAL;
+		ret_sd_card_close = sd_card_close(&f_seg_read_entry);
+		if (ret_sd_card_close) {
+			LOG_ERR("Close SD card err: %d", ret_sd_card_close);
+			return ret_sd_card_close;
+		}
+		return ret;
+	}
+
+	pcm_frame_size = frame_size;
 
 	audio_length_bytes = wav_file_header.wav_size + 8 - sizeof(wav_file_header);
-	n_iter = ceil((float)audio_length_bytes / (float)wav_read_size);
+	n_iter = DIV_ROUND_UP(audio_length_bytes, pcm_frame_size);
 
 	for (int i = 0; i < n_iter; i++) {
+		ret = sd_card_playback_block_alloc(&block);
+		if (ret) {
+			break;
+		}
+
 		/* Read a chunk of audio data from file */
-		ret = sd_card_read(pcm_mono_frame, &wav_read_size, &f_seg_read_entry);
+		wav_read_size = pcm_frame_size;
+		ret = sd_card_playback_read(block->data, &wav_read_size);
 		if (ret < 0) {
 			LOG_ERR("SD card read err: %d", ret);
+			k_mem_slab_free(&pcm_block_slab, block);
 			break;
 		}
 
-		/* Write audio data to the ringbuffer */
-		ret = sd_card_playback_ringbuf_write(pcm_mono_frame, wav_read_size);
-		if (ret < 0) {
-			LOG_ERR("Load ringbuf err: %d", ret);
+		if (wav_read_size == 0) {
+			/* File is shorter than stated in the header */
+			k_mem_slab_free(&pcm_block_slab, block);
 			break;
 		}
 
-		if (i == 0) {
-			/* Data can now be read from the ringbuffer */
-			sd_card_playback_active = true;
+		block->size = wav_read_size;
+
+		ret = sd_card_playback_block_put(block);
+		if (ret) {
+			break;
 		}
 	}
 
-	sd_card_playback_active = false;
+	sd_card_playback_drain();
 
 	ret_sd_card_close = sd_card_close(&f_seg_read_entry);
 	/* Check if something inside the for loop failed */
@@ -278,7 +382,9 @@ static int sd_card_playback_play_lc3(void)
 	uint16_t pcm_mono_write_size;
 	uint8_t decoder_num_ch = audio_system_decoder_num_ch_get();
 	size_t lc3_file_header_size = sizeof(lc3_file_header);
-	size_t lc3_frame_header_size = sizeof(uint16_t);
+	size_t lc3_frame_header_size;
+	uint32_t frame_size;
+	struct pcm_block *block;
 
 	ret = sd_card_open(playback_file_name, &f_seg_read_entry);
 	if (ret) {
@@ -287,7 +393,7 @@ static int sd_card_playback_play_lc3(void)
 	}
 
 	/* Read the file header */
-	ret = sd_card_read((char *)&lc3_file_header, &lc3_file_header_size, &f_seg_read_entry);
+	ret = sd_card_playback_read(&lc3_file_header, &lc3_file_header_size);
 	if (ret < 0) {
 		LOG_ERR("Read SD card file err: %d", ret);
 		ret_sd_card_close = sd_card_close(&f_seg_read_entry);
@@ -298,19 +404,31 @@ static int sd_card_playback_play_lc3(void)
 		return ret;
 	}
 
-	pcm_frame_size = sizeof(uint16_t) * lc3_file_header.sample_rate *
-			 lc3_file_header.frame_duration / 1000;
+	frame_size = sizeof(uint16_t) * lc3_file_header.sample_rate *
+		     lc3_file_header.frame_duration / 1000;
+	if (frame_size == 0 || frame_size > PCM_BLOCK_SIZE_MAX) {
+		LOG_ERR("Unsupported LC3 frame size: %u", frame_size);
+		ret = -EINVAL;
+		ret_sd_card_close = sd_card_close(&f_seg_read_entry);
+		if (ret_sd_card_close) {
+			LOG_ERR("Close SD card err: %d", ret_sd_card_close);
+			return ret_sd_card_close;
+		}
+		return ret;
+	}
+
+	pcm_frame_size = frame_size;
+
 	lc3_playback_cfg.lc3_frames_num =
 		sizeof(uint16_t) *
 		((lc3_file_header.signal_len_msb << 16) + lc3_file_header.signal_len_lsb) /
 		pcm_frame_size;
 
-	uint8_t pcm_mono_frame[pcm_frame_size];
-
 	for (int i = 0; i < lc3_playback_cfg.lc3_frames_num; i++) {
 		/* Read the frame header */
-		ret = sd_card_read((char *)&lc3_playback_cfg.lc3_frame_length_bytes,
-				   &lc3_frame_header_size, &f_seg_read_entry);
+		lc3_frame_header_size = sizeof(uint16_t);
+		ret = sd_card_playback_read(&lc3_playback_cfg.lc3_frame_length_bytes,
+					    &lc3_frame_header_size);
 		if (ret < 0) {
 			LOG_ERR("SD card read err: %d", ret);
 			break;
@@ -320,7 +438,7 @@ static int sd_card_playback_play_lc3(void)
 		size_t lc3_fr_len = lc3_playback_cfg.lc3_frame_length_bytes;
 
 		/* Read the audio data frame to be decoded */
-		ret = sd_card_read(lc3_frame, &lc3_fr_len, &f_seg_read_entry);
+		ret = sd_card_playback_read(lc3_frame, &lc3_fr_len);
 		if (ret < 0) {
 			LOG_ERR("SD card read err: %d", ret);
 			break;
@@ -333,27 +451,30 @@ static int sd_card_playback_play_lc3(void)
 			break;
 		}
 
-		/* Decode audio data frame */
+		ret = sd_card_playback_block_alloc(&block);
+		if (ret) {
+			break;
+		}
+
+		/* Decode audio data frame ahead of need, straight into the block */
 		ret = sw_codec_lc3_dec_run(lc3_frame, lc3_playback_cfg.lc3_frame_length_bytes,
-					   pcm_frame_size, decoder_num_ch - 1, pcm_mono_frame,
+					   pcm_frame_size, decoder_num_ch - 1, block->data,
 					   &pcm_mono_write_size, false);
 		if (ret) {
 			LOG_ERR("Decoding err: %d", ret);
+			k_mem_slab_free(&pcm_block_slab, block);
 			break;
 		}
 
-		ret = sd_card_playback_ringbuf_write((char *)pcm_mono_frame, pcm_mono_write_size);
-		if (ret < 0) {
-			LOG_ERR("Load ringbuf err: %d", ret);
-			break;
-		}
+		block->size = pcm_mono_write_size;
 
-		if (i == 0) {
-			sd_card_playback_active = true;
+		ret = sd_card_playback_block_put(block);
+		if (ret) {
+			break;
 		}
 	}
 
-	sd_card_playback_active = false;
+	sd_card_playback_drain();
 	ret_sd_card_close = sd_card_close(&f_seg_read_entry);
 	if (ret < 0) {
 		LOG_ERR("LC3 playback err: %d", ret);
@@ -378,9 +499,7 @@ static void sd_card_playback_thread(void *arg1, void *arg2, void *arg3)
 		k_sem_take(&m_sem_playback, K_FOREVER);
 		switch (playback_file_format) {
 		case SD_CARD_PLAYBACK_WAV:
-			ring_buf_reset(&m_ringbuf_audio_data_lc3);
-			k_sem_reset(&m_sem_ringbuf_space_available);
-			k_sem_give(&m_sem_ringbuf_space_available);
+			sd_card_playback_reset();
 			ret = sd_card_playback_play_wav();
 			if (ret) {
 				LOG_ERR("Wav playback err: %d", ret);
@@ -389,9 +508,7 @@ static void sd_card_playback_thread(void *arg1, void *arg2, void *arg3)
 			break;
 
 		case SD_CARD_PLAYBACK_LC3:
-			ring_buf_reset(&m_ringbuf_audio_data_lc3);
-			k_sem_reset(&m_sem_ringbuf_space_available);
-			k_sem_give(&m_sem_ringbuf_space_available);
+			sd_card_playback_reset();
 			ret = sd_card_playback_play_lc3();
 			if (ret) {
 				LOG_ERR("LC3 playback err: %d", ret);
@@ -438,33 +555,36 @@ int sd_card_playback_lc3(char *filename)
 int sd_card_playback_mix_with_stream(void *const pcm_a, size_t pcm_a_size)
 {
 	int ret;
-	uint8_t pcm_b[pcm_frame_size];
-	size_t read_size = pcm_frame_size;
+	struct pcm_block *block;
 
 	if (!sd_card_playback_active) {
 		LOG_ERR("SD card playback is not active");
 		return -EACCES;
 	}
 
-	ret = sd_card_playback_ringbuf_read(pcm_b, &read_size);
+	ret = k_msgq_get(&pcm_block_queue, &block, K_NO_WAIT);
 	if (ret) {
-		LOG_ERR("Loading data into buffer err: %d", ret);
-		return ret;
+		/* The SD card read could not keep up */
+		atomic_inc(&underrun_cnt);
+		LOG_DBG("Underrun. Skipping");
+		return 0;
 	}
 
-	if (read_size > 0) {
-		ret = pcm_mix(pcm_a, pcm_a_size, pcm_b, read_size, B_MONO_INTO_A_STEREO_L);
-		if (ret) {
-			LOG_ERR("Pcm mix err: %d", ret);
-			return ret;
-		}
-	} else {
-		LOG_WRN("Size read from ringbuffer: %d. Skipping", read_size);
+	ret = pcm_mix(pcm_a, pcm_a_size, block->data, block->size, B_MONO_INTO_A_STEREO_L);
+	k_mem_slab_free(&pcm_block_slab, block);
+	if (ret) {
+		LOG_ERR("Pcm mix err: %d", ret);
+		return ret;
 	}
 
 	return 0;
 }
 
+uint32_t sd_card_playback_underrun_cnt_get(void)
+{
+	return atomic_get(&underrun_cnt);
+}
+
 int sd_card_playback_init(void)
 {
 	int ret;
@@ -558,6 +678,16 @@ static int cmd_change_dir(const struct shell *shell, size_t argc, char **argv)
 	return 0;
 }
 
+static int cmd_stats(const struct shell *shell, size_t argc, char **argv)
+{
+	shell_print(shell, "Underruns: %d", sd_card_playback_underrun_cnt_get());
+	shell_print(shell, "Blocks ready: %d/%d", k_msgq_num_used_get(&pcm_block_queue),
+		    PCM_BLOCK_COUNT);
+	shell_print(shell, "Max SD card read time: %d ms", sd_card_read_max_ms);
+
+	return 0;
+}
+
 static int cmd_list_files(const struct shell *shell, size_t argc, char **argv)
 {
 	int ret;
@@ -581,6 +711,7 @@ SHELL_STATIC_SUBCMD_SET_CREATE(
 	SHELL_COND_CMD(CONFIG_SHELL, play_wav, NULL, "Play WAV file", cmd_play_wav_file),
 	SHELL_COND_CMD(CONFIG_SHELL, cd, NULL, "Change directory", cmd_change_dir),
 	SHELL_COND_CMD(CONFIG_SHELL, list_files, NULL, "List files", cmd_list_files),
+	SHELL_COND_CMD(CONFIG_SHELL, stats, NULL, "Print playback statistics", cmd_stats),
 	SHELL_SUBCMD_SET_END);
 
 SHELL_CMD_REGISTER(sd_card_playback, &sd_card_playback_cmd, "Play audio files from SD card", NULL);
@@ -62,6 +62,15 @@ int sd_card_playback_lc3(char *filename);
  */
 int sd_card_playback_mix_with_stream(void *const pcm_a, size_t pcm_a_size);
 
+/**
+ * @brief	Get the number of audio frames that were not ready when the stream needed them.
+ *
+ * @note	The counter is reset when a new playback starts.
+ *
+ * @return	Number of underruns in the current playback.
+ */
+uint32_t sd_card_playback_underrun_cnt_get(void);
+
 /**
  * @brief	Initialize the SD card playback module. Create the SD card playback thread.
  *
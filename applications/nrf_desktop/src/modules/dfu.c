@@ -46,8 +46,7 @@ LOG_MODULE_REGISTER(MODULE, CONFIG_DESKTOP_CONFIG_CHANNEL_DFU_LOG_LEVEL);
 
 #define ERASED_VAL_32(x) (((x) << 24) | ((x) << 16) | ((x) << 8) | (x))
 
-/* Keep small to avoid blocking the workqueue for long periods of time. */
-#define STORE_CHUNK_SIZE		16 /* bytes */
+#define STORE_CHUNK_SIZE		CONFIG_DESKTOP_CONFIG_CHANNEL_DFU_STORE_CHUNK_SIZE /* bytes */
 
 #define SYNC_BUFFER_SIZE (CONFIG_DESKTOP_CONFIG_CHANNEL_DFU_SYNC_BUFFER_SIZE * sizeof(uint32_t)) /* bytes */
 
@@ -118,11 +117,17 @@ static uint32_t img_csum;
 static uint32_t img_length;
 
 static uint16_t store_offset;
+static uint16_t store_length;
 static uint16_t sync_offset;
 static uint32_t flash_write_block_size;
 static uint8_t erased_val;
 
-static char sync_buffer[SYNC_BUFFER_SIZE] __aligned(4);
+/* Sync buffers are used alternately. One buffer receives data from the host while
+ * the other one is moved to flash in the background.
+ */
+static char sync_buffer[2][SYNC_BUFFER_SIZE] __aligned(4);
+static uint8_t sync_buffer_idx;
+static bool sync_pending;
 
 static bool device_in_use;
 static bool is_flash_area_clean;
@@ -209,6 +214,9 @@ static void terminate_dfu(void)
 	(void)k_work_cancel_delayable(&background_store);
 	flash_area = NULL;
 	sync_offset = 0;
+	store_offset = 0;
+	store_length = 0;
+	sync_pending = false;
 
 	if (IS_ENABLED(CONFIG_CAF_POWER_MANAGER_EVENTS)) {
 		power_manager_restrict(MODULE_IDX(MODULE), POWER_MANAGER_LEVEL_MAX);
@@ -321,10 +329,26 @@ static void background_erase_handler(struct k_work *work)
 	}
 }
 
-static void complete_dfu_data_store(void)
+static void start_dfu_data_store(void)
 {
-	cur_offset += sync_offset;
+	__ASSERT_NO_MSG(store_length == 0);
+	__ASSERT_NO_MSG(sync_offset > 0);
+
+	LOG_DBG("DFU data store start: %" PRIu32 " %" PRIu32, cur_offset, sync_offset);
+
+	/* Swap the buffers. The host can send new data while the synchronized data is stored. */
+	store_length = sync_offset;
+	store_offset = 0;
 	sync_offset = 0;
+	sync_buffer_idx ^= 1;
+
+	k_work_reschedule(&background_store, K_NO_WAIT);
+}
+
+static void complete_dfu_data_store(void)
+{
+	cur_offset += store_length;
+	store_length = 0;
 	store_offset = 0;
 
 	LOG_DBG("DFU data store complete: %" PRIu32, cur_offset);
@@ -344,30 +368,36 @@ static void complete_dfu_data_store(void)
 		LOG_INF("Update will be performed on configuration channel reboot request");
 #endif
 		terminate_dfu();
+	} else if (sync_pending) {
+		/* Host requested synchronization while the previous data was stored. */
+		sync_pending = false;
+		start_dfu_data_store();
 	}
 }
 
 static void store_dfu_data_chunk(void)
 {
-	__ASSERT_NO_MSG(store_offset <= sync_offset);
+	char *store_buffer = sync_buffer[sync_buffer_idx ^ 1];
+
+	__ASSERT_NO_MSG(store_offset <= store_length);
 	__ASSERT_NO_MSG(flash_area != NULL);
 
 	size_t store_size = STORE_CHUNK_SIZE;
 
-	if (sync_offset - store_offset < store_size) {
-		store_size = sync_offset - store_offset;
+	if (store_length - store_offset < store_size) {
+		store_size = store_length - store_offset;
 	}
 
 	if (store_size % flash_write_block_size != 0) {
 		size_t pad_len = (flash_write_block_size - (store_size % flash_write_block_size));
 
-		memset(&sync_buffer[store_offset + store_size], erased_val, pad_len);
+		memset(&store_buffer[store_offset + store_size], erased_val, pad_len);
 		store_size += pad_len;
 	}
 
 	LOG_DBG("DFU data store chunk: %" PRIu32, cur_offset + store_offset);
 	int err = flash_area_write(flash_area, cur_offset + store_offset,
-				   &sync_buffer[store_offset], store_size);
+				   &store_buffer[store_offset], store_size);
 	if (err) {
 		LOG_ERR("Cannot write data (%d)", err);
 		terminate_dfu();
@@ -384,7 +414,12 @@ static void background_store_handler(struct k_work *work)
 		store_dfu_data_chunk();
 	}
 
-	if (store_offset < sync_offset) {
+	if (!flash_area) {
+		/* DFU terminated because of a flash write error. */
+		return;
+	}
+
+	if (store_offset < store_length) {
 		k_work_reschedule(&background_store, BACKGROUND_FLASH_STORE_TIMEOUT);
 		k_work_reschedule(&dfu_timeout, DFU_TIMEOUT);
 	} else {
@@ -394,14 +429,7 @@ static void background_store_handler(struct k_work *work)
 
 static bool is_dfu_data_store_active(void)
 {
-	return k_work_delayable_is_pending(&background_store);
-}
-
-static void start_dfu_data_store(void)
-{
-	LOG_DBG("DFU data store start: %" PRIu32 " %" PRIu32, cur_offset, sync_offset);
-	store_offset = 0;
-	k_work_reschedule(&background_store, K_NO_WAIT);
+	return (store_length > 0);
 }
 
 static void handle_dfu_data(const uint8_t *data, size_t size)
@@ -430,11 +458,11 @@ static void handle_dfu_data(const uint8_t *data, size_t size)
 		return;
 	}
 
-	if (size > sizeof(sync_buffer) - sync_offset) {
+	if (size > SYNC_BUFFER_SIZE - sync_offset) {
 		LOG_WRN("Chunk size truncated");
-		size = sizeof(sync_buffer) - sync_offset;
+		size = SYNC_BUFFER_SIZE - sync_offset;
 	}
-	memcpy(&sync_buffer[sync_offset], data, size);
+	memcpy(&sync_buffer[sync_buffer_idx][sync_offset], data, size);
 
 	sync_offset += size;
 
@@ -571,15 +599,26 @@ static void handle_dfu_start(const uint8_t *data, const size_t size)
 static void handle_dfu_sync(uint8_t *data, size_t *size)
 {
 	LOG_INF("DFU sync requested");
-	uint16_t sync_buffer_size = sizeof(sync_buffer);
+	uint16_t sync_buffer_size = SYNC_BUFFER_SIZE;
 
-	bool storing_data = (sync_offset > 0);
 	bool dfu_active = (flash_area != NULL);
 
-	if (storing_data && !is_dfu_data_store_active()) {
-		start_dfu_data_store();
+	if (sync_offset > 0) {
+		if (!is_dfu_data_store_active()) {
+			start_dfu_data_store();
+		} else {
+			sync_pending = true;
+		}
 	}
 
+	/* Host must wait only if the received data could not be handed over to the
+	 * background store yet. Data that is being stored is included in the reported
+	 * offset. If the store fails, DFU is terminated and the offset falls back to
+	 * the data actually written to flash.
+	 */
+	bool storing_data = (sync_offset > 0);
+	uint32_t sync_cur_offset = cur_offset + store_length;
+
 	bool can_access_flash;
 	uint8_t dfu_state;
 
@@ -601,7 +640,7 @@ static void handle_dfu_sync(uint8_t *data, size_t *size)
 	}
 
 	size_t data_size = sizeof(dfu_state) + sizeof(img_length) +
-			   sizeof(img_csum) + sizeof(cur_offset) +
+			   sizeof(img_csum) + sizeof(sync_cur_offset) +
 			   sizeof(sync_buffer_size);
 
 	*size = data_size;
@@ -617,8 +656,8 @@ static void handle_dfu_sync(uint8_t *data, size_t *size)
 	sys_put_le32(img_csum, &data[pos]);
 	pos += sizeof(img_csum);
 
-	sys_put_le32(cur_offset, &data[pos]);
-	pos += sizeof(cur_offset);
+	sys_put_le32(sync_cur_offset, &data[pos]);
+	pos += sizeof(sync_cur_offset);
 
 	sys_put_le16(sync_buffer_size, &data[pos]);
 	pos += sizeof(sync_buffer_size);
@@ -958,7 +997,7 @@ static bool app_event_handler(const struct app_event_header *aeh)
 
 			/* Some flash may require word alignment. */
 			__ASSERT_NO_MSG((STORE_CHUNK_SIZE % flash_write_block_size) == 0);
-			__ASSERT_NO_MSG((sizeof(sync_buffer) % flash_write_block_size) == 0);
+			__ASSERT_NO_MSG((SYNC_BUFFER_SIZE % flash_write_block_size) == 0);
 
 			k_work_init_delayable(&dfu_timeout, dfu_timeout_handler);
 			k_work_init_delayable(&reboot_request, reboot_request_handler);
@@ -18,6 +18,13 @@
 #if defined(CONFIG_SLM_NATIVE_TLS)
 #include "slm_native_tls.h"
 #endif
+#if defined(CONFIG_SLM_SOCKET_RX_PUSH)
+#include <zephyr/posix/sys/eventfd.h>
+#endif
+#if defined(CONFIG_SLM_SOCKET_RX_PUSH_ON_CMUX_CHANNEL)
+#include <zephyr/modem/pipe.h>
+#include "slm_cmux.h"
+#endif
 
 LOG_MODULE_REGISTER(slm_sock, CONFIG_SLM_LOG_LEVEL);
 
@@ -73,6 +80,18 @@ static int handle_at_sendto(enum at_cmd_type cmd_type, const struct at_param_lis
 
 static int socket_ranking;
 
+#if defined(CONFIG_SLM_SOCKET_RX_PUSH)
+static void rx_push_socket_opened(int index);
+static void rx_push_lock(void);
+static void rx_push_unlock(void);
+static bool rx_push_enabled(void);
+#else
+static inline void rx_push_socket_opened(int) {}
+static inline void rx_push_lock(void) {}
+static inline void rx_push_unlock(void) {}
+static inline bool rx_push_enabled(void) { return false; }
+#endif
+
 #define INIT_SOCKET(socket)			\
 	socket.family  = AF_UNSPEC;		\
 	socket.sec_tag = INVALID_SEC_TAG;	\
@@ -169,7 +188,10 @@ static int do_socket_open(void)
 	if (ret < 0) {
 		goto error;
 	}
+	rx_push_lock();
 	socks[ret] = sock;
+	rx_push_socket_opened(ret);
+	rx_push_unlock();
 	rsp_send("\r\n#XSOCKET: %d,%d,%d\r\n", sock.fd, sock.type, proto);
 
 	return 0;
@@ -260,7 +282,10 @@ static int do_secure_socket_open(int peer_verify)
 	if (ret < 0) {
 		goto error;
 	}
+	rx_push_lock();
 	socks[ret] = sock;
+	rx_push_socket_opened(ret);
+	rx_push_unlock();
 	rsp_send("\r\n#XSSOCKET: %d,%d,%d\r\n", sock.fd, sock.type, proto);
 
 	return 0;
@@ -279,6 +304,7 @@ static int do_socket_close(void)
 		return 0;
 	}
 
+	rx_push_lock();
 	if (sock.fd_peer != INVALID_SOCKET) {
 		ret = close(sock.fd_peer);
 		if (ret) {
@@ -317,6 +343,7 @@ static int do_socket_close(void)
 	} else {
 		INIT_SOCKET(sock);
 	}
+	rx_push_unlock();
 
 	return ret;
 }
@@ -697,6 +724,17 @@ static int do_accept(int timeout)
 	} else {
 		return -EINVAL;
 	}
+
+	/* Keep the socket table in sync, the accepted socket is received from there. */
+	rx_push_lock();
+	for (int i = 0; i < SLM_MAX_SOCKET_COUNT; i++) {
+		if (socks[i].fd == sock.fd) {
+			socks[i].fd_peer = sock.fd_peer;
+			rx_push_socket_opened(i);
+			break;
+		}
+	}
+	rx_push_unlock();
 	rsp_send("\r\n#XACCEPT: %d,\"%s\"\r\n", sock.fd_peer, peer_addr);
 
 	return 0;
@@ -772,6 +810,11 @@ static int do_recv(int timeout, int flags)
 	int ret;
 	int sockfd = sock.fd;
 
+	if (rx_push_enabled()) {
+		LOG_ERR("Receive is in push mode");
+		return -EBUSY;
+	}
+
 	/* For TCP/TLS Server, receive from incoming socket */
 	if (sock.type == SOCK_STREAM && sock.role == AT_SOCKET_ROLE_SERVER) {
 		if (sock.fd_peer != INVALID_SOCKET) {
@@ -890,6 +933,11 @@ static int do_recvfrom(int timeout, int flags)
 	socklen_t addrlen = sizeof(struct sockaddr);
 	struct timeval tmo = {.tv_sec = timeout};
 
+	if (rx_push_enabled()) {
+		LOG_ERR("Receive is in push mode");
+		return -EBUSY;
+	}
+
 	ret = setsockopt(sock.fd, SOL_SOCKET, SO_RCVTIMEO, &tmo, sizeof(tmo));
 	if (ret) {
 		LOG_ERR("setsockopt(%d) error: %d", SO_RCVTIMEO, -errno);
@@ -1581,6 +1629,416 @@ static int handle_at_recvfrom(enum at_cmd_type cmd_type, const struct at_param_l
 	return err;
 }
 
+#if defined(CONFIG_SLM_SOCKET_RX_PUSH)
+
+#define RX_PUSH_THREAD_PRIORITY K_LOWEST_APPLICATION_THREAD_PRIO
+#define RX_PUSH_POLL_TIMEOUT_MS MSEC_PER_SEC
+#define RX_PUSH_HEADER_LEN	(48 + INET6_ADDRSTRLEN)
+
+/**@brief Receive modes. */
+enum slm_recv_mode {
+	AT_RECV_MODE_PULL,
+	AT_RECV_MODE_PUSH
+};
+
+static struct {
+	atomic_t mode;				    /* enum slm_recv_mode. */
+	uint16_t initial_credits;		    /* Credits given to newly opened sockets. */
+	uint16_t credits[SLM_MAX_SOCKET_COUNT];	    /* Flow control credits, per socks[] entry. */
+	int efd;				    /* Event file descriptor to wake up the thread. */
+#if defined(CONFIG_SLM_SOCKET_RX_PUSH_ON_CMUX_CHANNEL)
+	struct modem_pipe *pipe;		    /* CMUX channel for the data frames. */
+	struct k_sem tx_idle;
+#endif
+} rx_push = {
+	.mode = ATOMIC_INIT(AT_RECV_MODE_PULL),
+	.initial_credits = CONFIG_SLM_SOCKET_RX_PUSH_CREDITS,
+	.efd = INVALID_SOCKET
+};
+
+/* Serializes the access to the socket table between AT commands and the receive thread. */
+static K_MUTEX_DEFINE(rx_push_mutex);
+
+static struct k_thread rx_push_thread;
+static K_THREAD_STACK_DEFINE(rx_push_thread_stack, CONFIG_SLM_SOCKET_RX_PUSH_STACK_SIZE);
+static uint8_t rx_push_buf[CONFIG_SLM_SOCKET_RX_PUSH_BUF_SIZE];
+
+static void rx_push_lock(void)
+{
+	k_mutex_lock(&rx_push_mutex, K_FOREVER);
+}
+
+static void rx_push_unlock(void)
+{
+	k_mutex_unlock(&rx_push_mutex);
+}
+
+static bool rx_push_enabled(void)
+{
+	return atomic_get(&rx_push.mode) == AT_RECV_MODE_PUSH;
+}
+
+static void rx_push_wakeup(void)
+{
+	if (rx_push.efd != INVALID_SOCKET) {
+		(void)eventfd_write(rx_push.efd, 1);
+	}
+}
+
+/* Call with the socket table locked. */
+static void rx_push_socket_opened(int index)
+{
+	rx_push.credits[index] = rx_push.initial_credits;
+	rx_push_wakeup();
+}
+
+/* The socket that receives the data of a socks[] entry. */
+static int rx_push_fd(const struct slm_socket *s)
+{
+	if (s->type == SOCK_STREAM && s->role == AT_SOCKET_ROLE_SERVER) {
+		return s->fd_peer;
+	}
+
+	return s->fd;
+}
+
+#if defined(CONFIG_SLM_SOCKET_RX_PUSH_ON_CMUX_CHANNEL)
+static void rx_push_pipe_event_handler(struct modem_pipe *, enum modem_pipe_event event, void *)
+{
+	if (event == MODEM_PIPE_EVENT_TRANSMIT_IDLE) {
+		k_sem_give(&rx_push.tx_idle);
+	}
+}
+
+static void rx_push_pipe_write(const uint8_t *data, size_t len)
+{
+	while (len && rx_push_enabled()) {
+		const int ret = modem_pipe_transmit(rx_push.pipe, data, len);
+
+		if (ret < 0) {
+			LOG_ERR("Failed to send %u bytes on CMUX channel. (%d)", len, ret);
+			return;
+		}
+		data += ret;
+		len -= ret;
+		if (len) {
+			(void)k_sem_take(&rx_push.tx_idle, K_MSEC(RX_PUSH_POLL_TIMEOUT_MS));
+		}
+	}
+}
+#endif
+
+static void rx_push_frame_send(const char *header, size_t header_len,
+			       const uint8_t *data, size_t len)
+{
+#if defined(CONFIG_SLM_SOCKET_RX_PUSH_ON_CMUX_CHANNEL)
+	rx_push_pipe_write(header, header_len);
+	rx_push_pipe_write(data, len);
+#else
+	rsp_send("%s", header);
+	if (len > 0) {
+		data_send(data, len);
+	}
+#endif
+}
+
+/* Receive the data of a socket into rx_push_buf and format the header of its frame.
+ * Call with the socket table locked.
+ *
+ * Returns the length of the header, or zero if there is nothing to send.
+ */
+static size_t rx_push_receive(int index, char *header, size_t header_size, size_t *data_len)
+{
+	const struct slm_socket *s = &socks[index];
+	const int fd = rx_push_fd(s);
+	struct sockaddr remote = {
+		.sa_family = AF_UNSPEC
+	};
+	socklen_t addrlen = sizeof(remote);
+	int header_len;
+	int ret;
+
+	ret = recvfrom(fd, rx_push_buf, sizeof(rx_push_buf), MSG_DONTWAIT,
+		       (s->type == SOCK_DGRAM) ? &remote : NULL,
+		       (s->type == SOCK_DGRAM) ? &addrlen : NULL);
+	if (ret < 0) {
+		if (errno == EAGAIN) {
+			return 0;
+		}
+		LOG_WRN("recvfrom(%d) error: %d", fd, -errno);
+		ret = -errno;
+	}
+
+	if (ret > 0 && (remote.sa_family == AF_INET || remote.sa_family == AF_INET6)) {
+		char peer_addr[INET6_ADDRSTRLEN] = {0};
+		uint16_t peer_port;
+
+		if (remote.sa_family == AF_INET) {
+			(void)inet_ntop(AF_INET, &((struct sockaddr_in *)&remote)->sin_addr,
+					peer_addr, sizeof(peer_addr));
+			peer_port = ntohs(((struct sockaddr_in *)&remote)->sin_port);
+		} else {
+			(void)inet_ntop(AF_INET6, &((struct sockaddr_in6 *)&remote)->sin6_addr,
+					peer_addr, sizeof(peer_addr));
+			peer_port = ntohs(((struct sockaddr_in6 *)&remote)->sin6_port);
+		}
+		header_len = snprintf(header, header_size, "\r\n#XRECVDATA: %d,%d,\"%s\",%d\r\n",
+				      s->fd, ret, peer_addr, peer_port);
+	} else {
+		header_len = snprintf(header, header_size, "\r\n#XRECVDATA: %d,%d\r\n",
+				      s->fd, ret);
+	}
+
+	if (ret > 0 || (ret == 0 && s->type == SOCK_DGRAM)) {
+		rx_push.credits[index]--;
+	} else {
+		/* Remote closed or socket error. Stop polling until the host closes the socket. */
+		rx_push.credits[index] = 0;
+	}
+
+	*data_len = MAX(ret, 0);
+
+	return MIN(header_len, header_size - 1);
+}
+
+static void rx_push_thread_func(void *, void *, void *)
+{
+	struct pollfd pfds[SLM_MAX_SOCKET_COUNT + 1];
+	int indexes[SLM_MAX_SOCKET_COUNT];
+	char header[RX_PUSH_HEADER_LEN];
+	size_t header_len;
+	size_t data_len;
+	eventfd_t value;
+	int nfds;
+	int ret;
+
+	while (rx_push_enabled()) {
+		nfds = 0;
+		rx_push_lock();
+		/* No unsolicited data is allowed in data mode. */
+		for (int i = 0; i < SLM_MAX_SOCKET_COUNT && !in_datamode(); i++) {
+			const int fd = rx_push_fd(&socks[i]);
+
+			if (socks[i].fd == INVALID_SOCKET || fd == INVALID_SOCKET ||
+			    rx_push.credits[i] == 0) {
+				continue;
+			}
+			pfds[nfds].fd = fd;
+			pfds[nfds].events = POLLIN;
+			indexes[nfds] = i;
+			nfds++;
+		}
+		rx_push_unlock();
+		pfds[nfds].fd = rx_push.efd;
+		pfds[nfds].events = POLLIN;
+
+		ret = poll(pfds, nfds + 1, RX_PUSH_POLL_TIMEOUT_MS);
+		if (ret < 0) {
+			/* A socket may have been closed while polling. */
+			LOG_DBG("poll() error: %d", -errno);
+			k_sleep(K_MSEC(10));
+			continue;
+		}
+		if (ret == 0) {
+			continue;
+		}
+		if (pfds[nfds].revents & POLLIN) {
+			(void)eventfd_read(rx_push.efd, &value);
+		}
+
+		for (int k = 0; k < nfds && rx_push_enabled() && !in_datamode(); k++) {
+			const int i = indexes[k];
+
+			if (pfds[k].revents == 0) {
+				continue;
+			}
+
+			rx_push_lock();
+			if (rx_push_fd(&socks[i]) != pfds[k].fd || rx_push.credits[i] == 0) {
+				/* The socket changed since it was polled. */
+				header_len = 0;
+			} else {
+				header_len = rx_push_receive(i, header, sizeof(header), &data_len);
+			}
+			rx_push_unlock();
+
+			/* Sent without the lock, as the send may block. */
+			if (header_len > 0) {
+				rx_push_frame_send(header, header_len, rx_push_buf, data_len);
+			}
+		}
+	}
+
+	LOG_DBG("Receive thread terminated");
+}
+
+static int rx_push_start(void)
+{
+	if (rx_push_enabled()) {
+		return 0;
+	}
+
+	rx_push.efd = eventfd(0, 0);
+	if (rx_push.efd < 0) {
+		LOG_ERR("eventfd() error: %d", -errno);
+		rx_push.efd = INVALID_SOCKET;
+		return -errno;
+	}
+
+#if defined(CONFIG_SLM_SOCKET_RX_PUSH_ON_CMUX_CHANNEL)
+	k_sem_init(&rx_push.tx_idle, 0, 1);
+	rx_push.pipe = slm_cmux_reserve(CMUX_SOCKET_CHANNEL);
+	modem_pipe_attach(rx_push.pipe, rx_push_pipe_event_handler, NULL);
+#endif
+
+	rx_push_lock();
+	for (int i = 0; i < SLM_MAX_SOCKET_COUNT; i++) {
+		rx_push.credits[i] = rx_push.initial_credits;
+	}
+	atomic_set(&rx_push.mode, AT_RECV_MODE_PUSH);
+	rx_push_unlock();
+
+	k_thread_create(&rx_push_thread, rx_push_thread_stack,
+			K_THREAD_STACK_SIZEOF(rx_push_thread_stack),
+			rx_push_thread_func, NULL, NULL, NULL,
+			RX_PUSH_THREAD_PRIORITY, K_USER, K_NO_WAIT);
+	k_thread_name_set(&rx_push_thread, "slm_sock_rx");
+
+	return 0;
+}
+
+static int rx_push_stop(void)
+{
+	if (!atomic_cas(&rx_push.mode, AT_RECV_MODE_PUSH, AT_RECV_MODE_PULL)) {
+		return 0;
+	}
+
+	/* The thread checks the mode at least every RX_PUSH_POLL_TIMEOUT_MS and does not hold
+	 * the socket table lock while sending, so it is not aborted.
+	 */
+	rx_push_wakeup();
+	(void)k_thread_join(&rx_push_thread, K_FOREVER);
+
+#if defined(CONFIG_SLM_SOCKET_RX_PUSH_ON_CMUX_CHANNEL)
+	slm_cmux_release(CMUX_SOCKET_CHANNEL);
+	rx_push.pipe = NULL;
+#endif
+
+	close(rx_push.efd);
+	rx_push.efd = INVALID_SOCKET;
+
+	return 0;
+}
+
+SLM_AT_CMD_CUSTOM(xrecvcfg, "AT#XRECVCFG", handle_at_recvcfg);
+static int handle_at_recvcfg(enum at_cmd_type cmd_type, const struct at_param_list *param_list,
+			     uint32_t param_count)
+{
+	int err = -EINVAL;
+	uint16_t mode;
+	uint16_t credits = rx_push.initial_credits;
+
+	switch (cmd_type) {
+	case AT_CMD_TYPE_SET_COMMAND:
+		err = at_params_unsigned_short_get(param_list, 1, &mode);
+		if (err) {
+			return err;
+		}
+		if (param_count > 2) {
+			err = at_params_unsigned_short_get(param_list, 2, &credits);
+			if (err) {
+				return err;
+			}
+			if (credits == 0) {
+				return -EINVAL;
+			}
+		}
+		rx_push.initial_credits = credits;
+		if (mode == AT_RECV_MODE_PUSH) {
+			err = rx_push_start();
+		} else if (mode == AT_RECV_MODE_PULL) {
+			err = rx_push_stop();
+		} else {
+			err = -EINVAL;
+		}
+		break;
+
+	case AT_CMD_TYPE_READ_COMMAND:
+		rsp_send("\r\n#XRECVCFG: %d,%d\r\n", (int)atomic_get(&rx_push.mode),
+			 rx_push.initial_credits);
+		err = 0;
+		break;
+
+	case AT_CMD_TYPE_TEST_COMMAND:
+		rsp_send("\r\n#XRECVCFG: (%d,%d),<credits>\r\n",
+			 AT_RECV_MODE_PULL, AT_RECV_MODE_PUSH);
+		err = 0;
+		break;
+
+	default:
+		break;
+	}
+
+	return err;
+}
+
+SLM_AT_CMD_CUSTOM(xrecvcredit, "AT#XRECVCREDIT", handle_at_recvcredit);
+static int handle_at_recvcredit(enum at_cmd_type cmd_type, const struct at_param_list *param_list,
+				uint32_t)
+{
+	int err = -EINVAL;
+	int fd;
+	uint16_t credits;
+
+	switch (cmd_type) {
+	case AT_CMD_TYPE_SET_COMMAND:
+		if (!rx_push_enabled()) {
+			LOG_ERR("Receive is not in push mode");
+			return -EPERM;
+		}
+		err = at_params_int_get(param_list, 1, &fd);
+		if (err) {
+			return err;
+		}
+		err = at_params_unsigned_short_get(param_list, 2, &credits);
+		if (err) {
+			return err;
+		}
+		err = -EBADF;
+		rx_push_lock();
+		for (int i = 0; i < SLM_MAX_SOCKET_COUNT; i++) {
+			if (fd != INVALID_SOCKET && socks[i].fd == fd) {
+				rx_push.credits[i] = MIN(rx_push.credits[i] + credits, UINT16_MAX);
+				rsp_send("\r\n#XRECVCREDIT: %d,%d\r\n", fd, rx_push.credits[i]);
+				rx_push_wakeup();
+				err = 0;
+				break;
+			}
+		}
+		rx_push_unlock();
+		break;
+
+	case AT_CMD_TYPE_READ_COMMAND:
+		rx_push_lock();
+		for (int i = 0; i < SLM_MAX_SOCKET_COUNT; i++) {
+			if (socks[i].fd != INVALID_SOCKET) {
+				rsp_send("\r\n#XRECVCREDIT: %d,%d\r\n",
+					 socks[i].fd, rx_push.credits[i]);
+			}
+		}
+		rx_push_unlock();
+		err = 0;
+		break;
+
+	default:
+		break;
+	}
+
+	return err;
+}
+
+#endif /* CONFIG_SLM_SOCKET_RX_PUSH */
+
 SLM_AT_CMD_CUSTOM(xgetaddrinfo, "AT#XGETADDRINFO", handle_at_getaddrinfo);
 static int handle_at_getaddrinfo(enum at_cmd_type cmd_type, const struct at_param_list *param_list,
 				 uint32_t)
@@ -1705,6 +2163,9 @@ int slm_at_socket_init(void)
  */
 int slm_at_socket_uninit(void)
 {
+#if defined(CONFIG_SLM_SOCKET_RX_PUSH)
+	(void)rx_push_stop();
+#endif
 	(void)do_socket_close();
 	for (int i = 0; i < SLM_MAX_SOCKET_COUNT; i++) {
 		if (socks[i].fd_peer != INVALID_SOCKET) {
@@ -192,6 +192,13 @@ static struct cmux_dlci *cmux_get_dlci(enum cmux_channel channel)
 		/* The last DLCI. */
 		return &cmux.dlcis[CHANNEL_COUNT - 1];
 	}
+#endif
+#if defined(CONFIG_SLM_SOCKET_RX_PUSH_ON_CMUX_CHANNEL)
+	if (channel == CMUX_SOCKET_CHANNEL) {
+		/* The last DLCI, or the one before it when GNSS has the last one. */
+		return &cmux.dlcis[CHANNEL_COUNT - 1 -
+				   IS_ENABLED(CONFIG_SLM_GNSS_OUTPUT_NMEA_ON_CMUX_CHANNEL)];
+	}
 #endif
 	assert(false);
 }
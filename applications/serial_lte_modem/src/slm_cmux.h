@@ -17,6 +17,9 @@ enum cmux_channel {
 #endif
 #if defined(CONFIG_SLM_GNSS_OUTPUT_NMEA_ON_CMUX_CHANNEL)
 	CMUX_GNSS_CHANNEL,
+#endif
+#if defined(CONFIG_SLM_SOCKET_RX_PUSH_ON_CMUX_CHANNEL)
+	CMUX_SOCKET_CHANNEL,
 #endif
 	CMUX_EXT_CHANNEL_COUNT
 };
@@ -47,7 +47,22 @@ struct rx_event_t {
 K_MSGQ_DEFINE(rx_event_queue, sizeof(struct rx_event_t), UART_RX_EVENT_COUNT, 4);
 
 RING_BUF_DECLARE(tx_buf, CONFIG_SLM_UART_TX_BUF_SIZE);
-K_MUTEX_DEFINE(mutex_tx_put); /* Protects the tx_buf from multiple writes. */
+K_MUTEX_DEFINE(mutex_tx_put); /* Protects the tx_buf and tx_queue from multiple writes. */
+
+/* TX queue of buffer descriptors, sent in order. Small writes are coalesced
+ * into tx_buf and described by a single descriptor, large ones are sent in place.
+ */
+struct tx_desc {
+	const uint8_t *buf;	/* Buffer sent in place, or NULL for data in tx_buf. */
+	size_t len;		/* Bytes left to send. */
+	slm_uart_tx_done_cb_t cb;
+	void *user_data;
+};
+static struct tx_desc tx_queue[CONFIG_SLM_UART_TX_QUEUE_SIZE];
+static size_t tx_queue_head;	/* Oldest descriptor, the one being sent when tx_active. */
+static size_t tx_queue_count;
+static bool tx_active;
+static struct k_spinlock tx_lock; /* Protects the TX queue between writers and the callback. */
 
 enum uart_recovery_state {
 	RECOVERY_IDLE,
@@ -56,6 +71,7 @@ enum uart_recovery_state {
 };
 static atomic_t recovery_state;
 
+/* Given on each TX completion, to wake up writers waiting for space. */
 K_SEM_DEFINE(tx_done_sem, 0, 1);
 
 static inline struct rx_buf_t *block_start_get(uint8_t *buf)
@@ -175,29 +191,157 @@ static void rx_process(struct k_work *work)
 	rx_recovery();
 }
 
+static bool uart_is_active(void)
+{
+	enum pm_device_state state = PM_DEVICE_STATE_OFF;
+
+	pm_device_state_get(slm_uart_dev, &state);
+
+	return (state == PM_DEVICE_STATE_ACTIVE);
+}
+
+static int tx_queue_push(const uint8_t *buf, size_t len, slm_uart_tx_done_cb_t cb,
+			 void *user_data)
+{
+	k_spinlock_key_t key = k_spin_lock(&tx_lock);
+	struct tx_desc *last = tx_queue_count ?
+		&tx_queue[(tx_queue_head + tx_queue_count - 1) % ARRAY_SIZE(tx_queue)] : NULL;
+
+	if (buf == NULL && last && last->buf == NULL) {
+		/* Coalesce with the previous data in tx_buf. This also works if it is
+		 * being sent, the rest is sent once the ongoing transfer is done.
+		 */
+		last->len += len;
+	} else if (tx_queue_count < ARRAY_SIZE(tx_queue)) {
+		tx_queue[(tx_queue_head + tx_queue_count) % ARRAY_SIZE(tx_queue)] =
+			(struct tx_desc) {
+				.buf = buf,
+				.len = len,
+				.cb = cb,
+				.user_data = user_data
+			};
+		tx_queue_count++;
+	} else {
+		k_spin_unlock(&tx_lock, key);
+		return -ENOBUFS;
+	}
+	k_spin_unlock(&tx_lock, key);
+
+	return 0;
+}
+
+/* Complete the queued buffers sent in place that are not being sent, with -EAGAIN,
+ * as their owners cannot wait for the UART to be resumed. The data in tx_buf stays queued.
+ */
+static void tx_queue_cancel_in_place(void)
+{
+	struct tx_desc canceled[ARRAY_SIZE(tx_queue)];
+	size_t canceled_count = 0;
+	size_t kept_count = 0;
+	k_spinlock_key_t key = k_spin_lock(&tx_lock);
+
+	for (size_t i = 0; i < tx_queue_count; i++) {
+		const struct tx_desc desc = tx_queue[(tx_queue_head + i) % ARRAY_SIZE(tx_queue)];
+
+		if (desc.buf != NULL && !(i == 0 && tx_active)) {
+			canceled[canceled_count++] = desc;
+		} else {
+			tx_queue[(tx_queue_head + kept_count) % ARRAY_SIZE(tx_queue)] = desc;
+			kept_count++;
+		}
+	}
+	tx_queue_count = kept_count;
+	k_spin_unlock(&tx_lock, key);
+
+	for (size_t i = 0; i < canceled_count; i++) {
+		if (canceled[i].cb) {
+			canceled[i].cb(-EAGAIN, canceled[i].user_data);
+		}
+	}
+	if (canceled_count) {
+		k_sem_give(&tx_done_sem);
+	}
+}
+
 static int tx_start(void)
 {
-	uint8_t *buf;
+	const uint8_t *buf;
+	uint8_t *ring_data;
 	size_t len;
+	bool from_ring;
 	int err;
-	enum pm_device_state state = PM_DEVICE_STATE_OFF;
+	k_spinlock_key_t key;
 
-	pm_device_state_get(slm_uart_dev, &state);
-	if (state != PM_DEVICE_STATE_ACTIVE) {
+	if (!uart_is_active()) {
+		tx_queue_cancel_in_place();
 		return 1;
 	}
 
-	len = ring_buf_get_claim(&tx_buf, &buf, ring_buf_capacity_get(&tx_buf));
+	key = k_spin_lock(&tx_lock);
+	if (tx_active || tx_queue_count == 0) {
+		k_spin_unlock(&tx_lock, key);
+		return 0;
+	}
+	from_ring = (tx_queue[tx_queue_head].buf == NULL);
+	if (from_ring) {
+		len = ring_buf_get_claim(&tx_buf, &ring_data, tx_queue[tx_queue_head].len);
+		buf = ring_data;
+	} else {
+		buf = tx_queue[tx_queue_head].buf;
+		len = tx_queue[tx_queue_head].len;
+	}
+	tx_active = true;
+	k_spin_unlock(&tx_lock, key);
+
+	/* Called without the lock, as the driver may call back right away. */
 	err = uart_tx(slm_uart_dev, buf, len, SYS_FOREVER_US);
 	if (err) {
 		LOG_ERR("UART TX error: %d", err);
-		ring_buf_get_finish(&tx_buf, 0);
+		key = k_spin_lock(&tx_lock);
+		if (from_ring) {
+			ring_buf_get_finish(&tx_buf, 0);
+		}
+		tx_active = false;
+		k_spin_unlock(&tx_lock, key);
 		return err;
 	}
 
 	return 0;
 }
 
+static void tx_complete(size_t sent, bool aborted)
+{
+	struct tx_desc done = { 0 };
+	struct tx_desc *desc;
+	k_spinlock_key_t key = k_spin_lock(&tx_lock);
+	int err;
+
+	desc = &tx_queue[tx_queue_head];
+	if (desc->buf == NULL) {
+		err = ring_buf_get_finish(&tx_buf, sent);
+		if (err) {
+			LOG_ERR("UART_TX_%s failure: %d", aborted ? "ABORTED" : "DONE", err);
+		}
+	} else {
+		desc->buf += sent;
+	}
+	desc->len -= MIN(sent, desc->len);
+
+	/* A buffer sent in place cannot wait for the UART to be resumed. */
+	if (desc->len == 0 || (aborted && desc->buf != NULL)) {
+		done = *desc;
+		tx_queue_head = (tx_queue_head + 1) % ARRAY_SIZE(tx_queue);
+		tx_queue_count--;
+	}
+	tx_active = false;
+	k_spin_unlock(&tx_lock, key);
+
+	if (done.cb) {
+		done.cb((done.len == 0) ? 0 : -ECANCELED, done.user_data);
+	}
+	k_sem_give(&tx_done_sem);
+}
+
 static void uart_callback(const struct device *dev, struct uart_event *evt, void *user_data)
 {
 	struct rx_buf_t *buf;
@@ -210,16 +354,8 @@ static void uart_callback(const struct device *dev, struct uart_event *evt, void
 	switch (evt->type) {
 	case UART_TX_DONE:
 	case UART_TX_ABORTED:
-		err = ring_buf_get_finish(&tx_buf, evt->data.tx.len);
-		if (err) {
-			LOG_ERR("UART_TX_%s failure: %d",
-				(evt->type == UART_TX_DONE) ? "DONE" : "ABORTED", err);
-		}
-		if (ring_buf_is_empty(&tx_buf) == false) {
-			tx_start();
-		} else {
-			k_sem_give(&tx_done_sem);
-		}
+		tx_complete(evt->data.tx.len, evt->type == UART_TX_ABORTED);
+		tx_start();
 		break;
 	case UART_RX_RDY:
 		rx_buf_ref(evt->data.rx.buf);
@@ -264,46 +400,147 @@ static void uart_callback(const struct device *dev, struct uart_event *evt, void
 	}
 }
 
-/* Write the data to tx_buffer and trigger sending. */
-static int slm_uart_tx_write(const uint8_t *data, size_t len)
+static bool tx_queue_has_room(bool coalesce)
+{
+	k_spinlock_key_t key = k_spin_lock(&tx_lock);
+	bool has_room = (tx_queue_count < ARRAY_SIZE(tx_queue)) ||
+		(coalesce && tx_queue[(tx_queue_head + tx_queue_count - 1) %
+				      ARRAY_SIZE(tx_queue)].buf == NULL);
+
+	k_spin_unlock(&tx_lock, key);
+
+	return has_room;
+}
+
+/* Wait until a descriptor can be queued. Call with mutex_tx_put locked.
+ * The room cannot be taken away as only the UART callback removes descriptors.
+ */
+static int tx_queue_wait(bool coalesce)
+{
+	int err;
+
+	while (!tx_queue_has_room(coalesce)) {
+		err = tx_start();
+		if (err) {
+			LOG_ERR("TX queue full. Unable to send: %d", err);
+			return -ENOBUFS;
+		}
+		k_sem_take(&tx_done_sem, K_FOREVER);
+	}
+
+	return 0;
+}
+
+/* Copy the data to tx_buf and queue it. Call with mutex_tx_put locked. */
+static int tx_write_copy(const uint8_t *data, size_t len)
 {
 	size_t ret;
 	size_t sent = 0;
 	int err;
 
-	k_mutex_lock(&mutex_tx_put, K_FOREVER);
+	err = tx_queue_wait(true);
+	if (err) {
+		return err;
+	}
+
 	while (sent < len) {
 		ret = ring_buf_put(&tx_buf, data + sent, len - sent);
 		if (ret) {
+			/* Cannot fail, there was room for the descriptor. */
+			(void)tx_queue_push(NULL, ret, NULL, NULL);
 			sent += ret;
 		} else {
-			/* Buffer full, block and start TX. */
-			k_sem_take(&tx_done_sem, K_FOREVER);
+			/* Buffer full, block until TX makes room. */
 			err = tx_start();
 			if (err) {
 				LOG_ERR("TX buf overflow, %d dropped. Unable to send: %d",
 					len - sent,
 					err);
-				k_sem_give(&tx_done_sem);
-				k_mutex_unlock(&mutex_tx_put);
 				return err;
 			}
+			k_sem_take(&tx_done_sem, K_FOREVER);
 		}
 	}
+
+	return 0;
+}
+
+int slm_uart_tx_write_nocopy(const uint8_t *data, size_t len, slm_uart_tx_done_cb_t cb,
+			     void *user_data)
+{
+	int err;
+
+	if (len == 0) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&mutex_tx_put, K_FOREVER);
+	err = tx_queue_wait(false);
+	if (!err) {
+		err = tx_queue_push(data, len, cb, user_data);
+	}
 	k_mutex_unlock(&mutex_tx_put);
+	if (err) {
+		return err;
+	}
 
-	if (k_sem_take(&tx_done_sem, K_NO_WAIT) == 0) {
-		err = tx_start();
-		if (err == 1) {
-			k_sem_give(&tx_done_sem);
-			return 0;
-		} else if (err) {
-			LOG_ERR("TX start failed: %d", err);
-			k_sem_give(&tx_done_sem);
+	err = tx_start();
+	if (err < 0) {
+		LOG_ERR("TX start failed: %d", err);
+		return err;
+	}
+
+	return 0;
+}
+
+struct tx_sync {
+	struct k_sem done;
+	int result;
+};
+
+static void tx_sync_done(int result, void *user_data)
+{
+	struct tx_sync *sync = user_data;
+
+	sync->result = result;
+	k_sem_give(&sync->done);
+}
+
+/* Send the data, in place if large enough, else through tx_buf. */
+static int slm_uart_tx_write(const uint8_t *data, size_t len)
+{
+	int err;
+
+	/* Large payloads are sent in place, and waited for as the caller owns the buffer.
+	 * When the UART is suspended, they are copied so that the caller is not blocked.
+	 * The UART can be suspended while the buffer is queued, in which case it is
+	 * returned unsent and copied.
+	 */
+	if (len >= CONFIG_SLM_UART_TX_NOCOPY_THRESHOLD && uart_is_active()) {
+		struct tx_sync sync;
+
+		k_sem_init(&sync.done, 0, 1);
+		err = slm_uart_tx_write_nocopy(data, len, tx_sync_done, &sync);
+		if (err == 0) {
+			k_sem_take(&sync.done, K_FOREVER);
+			err = sync.result;
+		}
+		if (err != -EAGAIN) {
 			return err;
 		}
-	} else {
-		/* TX already in progress. */
+	}
+
+	k_mutex_lock(&mutex_tx_put, K_FOREVER);
+	err = tx_write_copy(data, len);
+	k_mutex_unlock(&mutex_tx_put);
+	if (err) {
+		return err;
+	}
+
+	err = tx_start();
+	if (err < 0) {
+		LOG_ERR("TX start failed: %d", err);
+		return err;
 	}
 
 	return 0;
@@ -358,8 +595,6 @@ static int slm_uart_handler_init(void)
 
 	k_work_init_delayable(&rx_process_work, rx_process);
 
-	k_sem_give(&tx_done_sem);
-
 	/* Flush possibly pending data in case SLM was idle. */
 	tx_start();
 
@@ -23,6 +23,30 @@ extern uint32_t slm_uart_baudrate;
 /** @retval 0 on success. Otherwise, the error code is returned. */
 int slm_uart_handler_enable(void);
 
+/**
+ * @brief TX completion callback type.
+ *
+ * Called from the UART interrupt context, or from the context of a writer when
+ * the UART is suspended.
+ *
+ * @param result 0 if all the data was sent, -ECANCELED if the transfer was aborted,
+ *               -EAGAIN if the UART was suspended before the transfer was started.
+ * @param user_data User data given to @c slm_uart_tx_write_nocopy().
+ */
+typedef void (*slm_uart_tx_done_cb_t)(int result, void *user_data);
+
+/**
+ * @brief Queue data to be sent in place, without copying it.
+ *
+ * The data is sent in order with the other UART output.
+ * The buffer must stay valid and unmodified until @p cb is called.
+ * If the UART is suspended, @p cb is called without waiting for it to be resumed.
+ *
+ * @retval 0 on success. Otherwise, a (negative) error code is returned.
+ */
+int slm_uart_tx_write_nocopy(const uint8_t *data, size_t len, slm_uart_tx_done_cb_t cb,
+			     void *user_data);
+
 /** @} */
 
 #endif /* SLM_UART_HANDLER_ */
@@ -33,14 +33,46 @@ extern "C" {
 		}                                                              \
 	}
 
+#if defined(CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_FIXED_POINT)
+/** @cond INTERNAL_HIDDEN */
+/* Floating-point regulator input and its Q16.16 conversion. The input is
+ * converted again only when its value changes.
+ */
+struct bt_mesh_light_ctrl_reg_spec_val {
+	uint32_t bits;
+	int64_t q;
+};
+/** @endcond */
+#endif
+
 /** Specification-defined illuminance regulator context. */
 struct bt_mesh_light_ctrl_reg_spec {
 	/** Common regulator context. */
 	struct bt_mesh_light_ctrl_reg reg;
 	/** Regulator step timer. */
 	struct k_work_delayable timer;
+#if defined(CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_FIXED_POINT)
+	/** Internal integral sum, in Q16.16 format. */
+	int64_t i;
+	/** @cond INTERNAL_HIDDEN */
+	struct {
+		struct bt_mesh_light_ctrl_reg_spec_val ki_up;
+		struct bt_mesh_light_ctrl_reg_spec_val ki_down;
+		struct bt_mesh_light_ctrl_reg_spec_val kp_up;
+		struct bt_mesh_light_ctrl_reg_spec_val kp_down;
+		struct bt_mesh_light_ctrl_reg_spec_val accuracy;
+		struct bt_mesh_light_ctrl_reg_spec_val measured;
+		struct bt_mesh_light_ctrl_reg_spec_val target;
+		struct bt_mesh_light_ctrl_reg_spec_val prev_target;
+	} in;
+	/* Last output, in Q16.16 format and as reported. */
+	int64_t out_q;
+	float out;
+	/** @endcond */
+#else
 	/** Internal integral sum. */
 	float i;
+#endif
 	/** Regulator enabled flag. */
 	bool enabled;
 	/* If true, internal integral sum can be negative until it becomes positive. */
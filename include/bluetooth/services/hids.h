@@ -63,10 +63,19 @@ extern "C" {
 
 /**@brief Helping macro for @ref BT_HIDS_DEF, that calculates
  *        the link context size for HIDS instance.
+ *
+ * With the Input Report queue, the report data is reserved once more
+ * for the queued reports.
  */
+#if defined(CONFIG_BT_HIDS_INPUT_REP_QUEUE)
+#define _BT_HIDS_CONN_CTX_SIZE_CALC(...)		   \
+	(2 * (FOR_EACH(_BT_HIDS_GET_ARG1, (+), __VA_ARGS__)) + \
+	sizeof(struct bt_hids_conn_data))
+#else
 #define _BT_HIDS_CONN_CTX_SIZE_CALC(...)		   \
 	(FOR_EACH(_BT_HIDS_GET_ARG1, (+), __VA_ARGS__)	+ \
 	sizeof(struct bt_hids_conn_data))
+#endif
 #define _BT_HIDS_GET_ARG1(...) GET_ARG_N(1, __VA_ARGS__)
 
 /** @brief Possible values for the Protocol Mode Characteristic value.
@@ -177,6 +186,36 @@ typedef void (*bt_hids_rep_handler_t) (struct bt_hids_rep *rep,
 				       struct bt_conn *conn,
 				       bool write);
 
+/** @brief Input Report merge policy used by the Input Report queue.
+ *
+ * The policy is applied when a report is sent while a report with the same
+ * ID is still queued for the connection.
+ */
+enum bt_hids_inp_rep_merge {
+	/** The new report is rejected with -EBUSY. */
+	BT_HIDS_INP_REP_MERGE_NONE,
+
+	/** The new report replaces the queued report. */
+	BT_HIDS_INP_REP_MERGE_REPLACE,
+
+	/** The new report is merged into the queued report by the merge
+	 *  callback, for example by summing relative mouse motion.
+	 */
+	BT_HIDS_INP_REP_MERGE_CB,
+};
+
+/** @brief Input Report merge callback.
+ *
+ * @param queued Queued report data, to be updated with the new report.
+ * @param rep	 New report data.
+ * @param len	 Length of the report data.
+ *
+ * @return 0 If the new report was merged. Otherwise, a (negative) error code
+ *	   is returned and the new report is rejected.
+ */
+typedef int (*bt_hids_inp_rep_merge_t) (uint8_t *queued, uint8_t const *rep,
+					uint8_t len);
+
 /** @brief Input Report.
  */
 struct bt_hids_inp_rep {
@@ -227,6 +266,14 @@ struct bt_hids_inp_rep {
 
 	/** Callback with the notification event. */
 	bt_hids_notify_handler_t handler;
+
+#if defined(CONFIG_BT_HIDS_INPUT_REP_QUEUE) || defined(__DOXYGEN__)
+	/** Merge policy used by the Input Report queue. */
+	enum bt_hids_inp_rep_merge merge;
+
+	/** Merge callback, used with @ref BT_HIDS_INP_REP_MERGE_CB. */
+	bt_hids_inp_rep_merge_t merge_cb;
+#endif
 };
 
 
@@ -416,6 +463,73 @@ struct bt_hids_init_param {
 	bool is_kb;
 };
 
+/** @brief Input Report queue statistics.
+ */
+struct bt_hids_inp_rep_queue_stats {
+	/** Number of notifications sent. */
+	uint32_t sent;
+
+	/** Number of reports merged into a queued report. */
+	uint32_t merged;
+
+	/** Number of reports dropped. */
+	uint32_t dropped;
+};
+
+#if defined(CONFIG_BT_HIDS_INPUT_REP_QUEUE) || defined(__DOXYGEN__)
+/** Number of Input Report queue slots: one for each Input Report and one for
+ *  the Boot Mouse Input Report.
+ */
+#define _BT_HIDS_INP_REP_QUEUE_SLOTS (CONFIG_BT_HIDS_INPUT_REP_MAX + 1)
+
+/** @brief Input Report queue of a connection.
+ *
+ *  The queued reports are accessed with the connection context locked. The
+ *  notifications in flight are also updated by the notification complete
+ *  callback, so they are protected by the queue lock.
+ */
+struct bt_hids_inp_rep_queue {
+	/** Lock of the notifications in flight. */
+	struct k_spinlock lock;
+
+	/** Notification complete callbacks of the notifications in flight. */
+	bt_gatt_complete_func_t tx_cb[CONFIG_BT_HIDS_INPUT_REP_TX_MAX];
+
+	/** Index of the first notification in flight. */
+	uint8_t tx_head;
+
+	/** Number of notifications in flight. */
+	uint8_t tx_cnt;
+
+	/** Pointer to the queued Input Reports data. */
+	uint8_t *rep_ctx;
+
+	/** Queued Boot Mouse Input Report. */
+	uint8_t boot_mouse_rep[BT_HIDS_BOOT_MOUSE_REP_LEN];
+
+	/** Notification complete callbacks of the queued reports. */
+	bt_gatt_complete_func_t cb[_BT_HIDS_INP_REP_QUEUE_SLOTS];
+
+
+	/** Queued report slots, in the order of queuing. */
+	uint8_t order[_BT_HIDS_INP_REP_QUEUE_SLOTS];
+
+	/** Index of the first queued report slot. */
+	uint8_t order_head;
+
+	/** Number of queued reports. */
+	uint8_t order_cnt;
+
+	/** Bitmask of the queued report slots. */
+	uint16_t pending;
+
+	/** Statistics. */
+	struct bt_hids_inp_rep_queue_stats stats;
+};
+
+BUILD_ASSERT(_BT_HIDS_INP_REP_QUEUE_SLOTS <= 16);
+#endif
+
 /** @brief HID Service structure.
  */
 struct bt_hids {
@@ -460,6 +574,14 @@ struct bt_hids {
 
 	/** Bluetooth connection contexts. */
 	struct bt_conn_ctx_lib *conn_ctx;
+
+#if defined(CONFIG_BT_HIDS_INPUT_REP_QUEUE) || defined(__DOXYGEN__)
+	/** Input Report queues, indexed by the connection index. */
+	struct bt_hids_inp_rep_queue inp_rep_queue[CONFIG_BT_MAX_CONN];
+
+	/** Work that sends the queued Input Reports. */
+	struct k_work inp_rep_queue_work;
+#endif
 };
 
 /** @brief HID Connection context data structure.
@@ -591,6 +713,22 @@ int bt_hids_boot_kb_inp_rep_send(struct bt_hids *hids_obj, struct bt_conn *conn,
 				 uint8_t const *rep, uint16_t len,
 				 bt_gatt_complete_func_t cb);
 
+/** @brief Get the Input Report queue statistics of a connection.
+ *
+ *  The statistics are available if @kconfig{CONFIG_BT_HIDS_INPUT_REP_QUEUE}
+ *  is enabled.
+ *
+ *  @param hids_obj Pointer to HIDS instance.
+ *  @param conn Pointer to Connection Object.
+ *  @param stats Pointer to the structure for the statistics.
+ *
+ *  @return 0 If the operation was successful. Otherwise, a (negative) error
+ *	      code is returned.
+ */
+int bt_hids_inp_rep_queue_stats_get(struct bt_hids *hids_obj,
+				    struct bt_conn *conn,
+				    struct bt_hids_inp_rep_queue_stats *stats);
+
 
 #ifdef __cplusplus
 }
@@ -36,6 +36,8 @@ struct data_fifo {
 	char *slab_buffer;
 	struct k_mem_slab mem_slab;
 	struct k_msgq msgq;
+	/* Keeps msgq and slab counts in sync for this FIFO only */
+	struct k_spinlock lock;
 	uint32_t elements_max;
 	size_t block_size_max;
 	bool initialized;
@@ -8,6 +8,9 @@
 #define __CPU_LOAD_H
 
 #include <zephyr/types.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/iterable_sections.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -47,6 +50,123 @@ void cpu_load_reset(void);
  */
 uint32_t cpu_load_get(void);
 
+/** @brief Type of the profiled execution context. */
+enum cpu_load_profile_type {
+	/** Thread. */
+	CPU_LOAD_PROFILE_THREAD,
+	/** Interrupt line. */
+	CPU_LOAD_PROFILE_IRQ,
+};
+
+/** @brief CPU usage of a single execution context. */
+struct cpu_load_profile_entry {
+	/** Type of the execution context. */
+	enum cpu_load_profile_type type;
+
+	/** Thread, or NULL for the threads that did not fit in the table.
+	 *  Valid only for threads.
+	 */
+	const struct k_thread *thread;
+
+	/** Interrupt line, or a negative value for the system exceptions.
+	 *  Valid only for interrupts.
+	 */
+	int irq;
+
+	/** Number of CPU cycles used since the last reset. */
+	uint64_t cycles;
+
+	/** Number of times the thread was switched in or the interrupt was
+	 *  handled since the last reset.
+	 */
+	uint32_t count;
+};
+
+/** @brief Callback used to iterate over the profiled execution contexts.
+ *
+ * @param entry CPU usage of the execution context.
+ * @param user_data User data passed to @ref cpu_load_profile_foreach.
+ */
+typedef void (*cpu_load_profile_cb_t)(const struct cpu_load_profile_entry *entry,
+				      void *user_data);
+
+/** @brief Work item execution time histogram.
+ *
+ * Use @ref CPU_LOAD_WORK_HIST_DEFINE to define the histogram.
+ */
+struct cpu_load_work_hist {
+	/** Name of the histogram. */
+	const char *name;
+	/** Number of executions in every bin. */
+	atomic_t *bins;
+	/** Longest execution time in CPU cycles. */
+	uint32_t *max;
+};
+
+/** @brief Define a work item execution time histogram.
+ *
+ * @param _name Name of the histogram.
+ */
+#define CPU_LOAD_WORK_HIST_DEFINE(_name)						\
+	static atomic_t _CONCAT(_name, _cpu_load_bins)[CONFIG_CPU_LOAD_PROFILE_HIST_BINS];	\
+	static uint32_t _CONCAT(_name, _cpu_load_max);					\
+	static const STRUCT_SECTION_ITERABLE(cpu_load_work_hist,			\
+					     _CONCAT(cpu_load_work_hist_, _name)) = {	\
+		.name = STRINGIFY(_name),						\
+		.bins = _CONCAT(_name, _cpu_load_bins),					\
+		.max = &_CONCAT(_name, _cpu_load_max),					\
+	}
+
+/** @brief Add an execution of a work item to the histogram.
+ *
+ * @param _name Name of the histogram.
+ * @param _start Value of @ref cpu_load_cycles_get read when the execution
+ *		 started.
+ */
+#define CPU_LOAD_WORK_HIST_ADD(_name, _start)						\
+	cpu_load_work_hist_add(&_CONCAT(cpu_load_work_hist_, _name),			\
+			       cpu_load_cycles_get() - (_start))
+
+/** @brief Get the CPU cycle counter used for profiling.
+ *
+ * The counter does not run while the CPU is sleeping.
+ *
+ * @return The current value of the counter.
+ */
+uint32_t cpu_load_cycles_get(void);
+
+/** @brief Iterate over the CPU usage of threads and interrupts.
+ *
+ * Only the execution contexts that were active since the last reset
+ * are reported.
+ *
+ * @param cb Callback called for every execution context.
+ * @param user_data User data passed to the callback.
+ */
+void cpu_load_profile_foreach(cpu_load_profile_cb_t cb, void *user_data);
+
+/** @brief Get the number of CPU cycles used by all execution contexts.
+ *
+ * @return The number of CPU cycles used since the last reset.
+ */
+uint64_t cpu_load_profile_total_get(void);
+
+/** @brief Add an execution of a work item to the histogram.
+ *
+ * @param hist Histogram.
+ * @param cycles Execution time in CPU cycles.
+ */
+void cpu_load_work_hist_add(const struct cpu_load_work_hist *hist, uint32_t cycles);
+
+/** @brief Get the upper limit of a histogram bin.
+ *
+ * @param bin Index of the bin.
+ *
+ * @return The upper limit of the bin in CPU cycles, exclusive, or UINT32_MAX
+ *	   for the last bin.
+ */
+uint32_t cpu_load_work_hist_bin_limit(size_t bin);
+
 /** @} */
 
 #ifdef __cplusplus
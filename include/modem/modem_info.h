@@ -403,6 +403,18 @@ int modem_info_get_operator(char *buf, size_t buf_size);
  */
 int modem_info_get_snr(int *val);
 
+/**
+ * @brief Invalidate the cached modem information.
+ *
+ * All values are read from the modem again the next time they are requested.
+ * The cache is invalidated automatically when the modem library is initialized.
+ * Call this function after the modem information has changed in a way that is
+ * not reported by notifications.
+ *
+ * @note Requires @kconfig{CONFIG_MODEM_INFO_CACHE}.
+ */
+void modem_info_cache_invalidate(void);
+
 /** @} */
 
 #ifdef __cplusplus
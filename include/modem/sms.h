@@ -50,6 +50,18 @@ enum sms_data_type {
  */
 #define SMS_MAX_PAYLOAD_LEN_CHARS 160
 
+/**
+ * @brief Maximum length of the message payload delivered to listeners in number of characters.
+ *
+ * @details When @kconfig{CONFIG_SMS_CONCAT_REASSEMBLY} is enabled, a reassembled concatenated
+ * message may consist of up to @kconfig{CONFIG_SMS_CONCAT_MAX_PARTS} short messages.
+ */
+#if defined(CONFIG_SMS_CONCAT_REASSEMBLY)
+#define SMS_MAX_MESSAGE_LEN_CHARS (SMS_MAX_PAYLOAD_LEN_CHARS * CONFIG_SMS_CONCAT_MAX_PARTS)
+#else
+#define SMS_MAX_MESSAGE_LEN_CHARS SMS_MAX_PAYLOAD_LEN_CHARS
+#endif
+
 /**
  * @brief Maximum length of SMS address, i.e., phone number, in characters
  * as specified in 3GPP TS 23.040 Section 9.1.2.3.
@@ -96,7 +108,11 @@ struct sms_udh_concat {
 	uint16_t ref_number;
 	/** @brief Maximum number of short messages in the concatenated short message. */
 	uint8_t total_msgs;
-	/** @brief Sequence number of the current short message. */
+	/**
+	 * @brief Sequence number of the current short message.
+	 *
+	 * @details Zero if the message has been reassembled from all of its parts by the library.
+	 */
 	uint8_t seq_number;
 };
 
@@ -160,7 +176,7 @@ struct sms_data {
 	 * e.g., via application port information, in which case it should be treated as
 	 * specified for that purpose.
 	 */
-	uint8_t payload[SMS_MAX_PAYLOAD_LEN_CHARS + 1];
+	uint8_t payload[SMS_MAX_MESSAGE_LEN_CHARS + 1];
 };
 
 /** @brief SMS listener callback function. */
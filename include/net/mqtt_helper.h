@@ -69,6 +69,20 @@ typedef void (*mqtt_helper_on_suback_t)(uint16_t message_id, int result);
 typedef void (*mqtt_helper_on_pingresp_t)(void);
 typedef void (*mqtt_helper_on_error_t)(enum mqtt_helper_error error);
 
+/** @brief Handler invoked for fragments of incoming MQTT messages.
+ *	   If this handler is set, it is used instead of the on_publish handler.
+ *	   The payload is passed to the handler in fragments of up to
+ *	   CONFIG_MQTT_HELPER_PAYLOAD_BUFFER_LEN bytes, so that messages larger than
+ *	   the payload buffer can be received.
+ *  @param topic_buf Topic of the message.
+ *  @param fragment_buf Fragment of the payload. Valid only until the handler returns.
+ *  @param offset Offset of the fragment within the payload.
+ *  @param total_len Length of the whole payload.
+ */
+typedef void (*mqtt_helper_on_publish_fragment_t)(struct mqtt_helper_buf topic_buf,
+						  struct mqtt_helper_buf fragment_buf,
+						  size_t offset, size_t total_len);
+
 struct mqtt_helper_cfg {
 	struct {
 		mqtt_helper_on_all_events_t on_all_events;
@@ -79,6 +93,7 @@ struct mqtt_helper_cfg {
 		mqtt_helper_on_suback_t on_suback;
 		mqtt_helper_on_pingresp_t on_pingresp;
 		mqtt_helper_on_error_t on_error;
+		mqtt_helper_on_publish_fragment_t on_publish_fragment;
 	} cb;
 };
 
@@ -131,6 +146,22 @@ int mqtt_helper_subscribe(struct mqtt_subscription_list *sub_list);
  */
 int mqtt_helper_publish(const struct mqtt_publish_param *param);
 
+/** @brief Queue an MQTT message for publishing.
+ *	   The topic and payload are copied, and the message is published from the
+ *	   library's work queue, so the caller does not wait for the socket.
+ *	   Queued messages are published in order. At most CONFIG_MQTT_HELPER_QOS1_WINDOW
+ *	   QoS 1 messages are waiting for acknowledgment at a time. Queued messages are
+ *	   dropped when the client disconnects.
+ *	   If publishing of a QoS 1 message fails, the on_puback handler is called with
+ *	   the error code as the result.
+ *	   Requires CONFIG_MQTT_HELPER_PUBLISH_QUEUE to be enabled.
+ *  @retval 0 if successful.
+ *  @retval -EOPNOTSUPP if operation is not supported in the current state.
+ *  @retval -EMSGSIZE if the topic and payload do not fit in a queue entry.
+ *  @retval -ENOMEM if the queue is full.
+ */
+int mqtt_helper_publish_queued(const struct mqtt_publish_param *param);
+
 /** @brief Deinitialize library. Must be called when all MQTT operations are done to
  *	   release resources and allow for a new client. The client must be in a disconnected state.
  *
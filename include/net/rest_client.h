@@ -56,7 +56,9 @@ enum rest_client_http_status {
  */
 struct rest_client_req_context {
 	/** Socket identifier for the connection. When using the default value,
-	 *  the library will open a new socket connection. Default: @ref REST_CLIENT_SCKT_CONNECT.
+	 *  the library will open a new socket connection, or reuse a pooled one if
+	 *  @kconfig{CONFIG_REST_CLIENT_CONN_POOL} is enabled and @c keep_alive is false.
+	 *  Default: @ref REST_CLIENT_SCKT_CONNECT.
 	 */
 	int connect_socket;
 
@@ -159,6 +161,16 @@ struct rest_client_resp_context {
 int rest_client_request(struct rest_client_req_context *req_ctx,
 			struct rest_client_resp_context *resp_ctx);
 
+/**
+ * @brief Close all connections in the connection pool.
+ *
+ * @details Intended to be used when the network connection is lost, for example.
+ *          Later requests open new connections.
+ *
+ * @note Requires @kconfig{CONFIG_REST_CLIENT_CONN_POOL}.
+ */
+void rest_client_conn_pool_flush(void);
+
 /**
  * @brief Sets the default values into a given request context.
  *
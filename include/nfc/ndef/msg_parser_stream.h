@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef NFC_NDEF_MSG_PARSER_STREAM_H_
+#define NFC_NDEF_MSG_PARSER_STREAM_H_
+
+/**
+ * @file
+ * @defgroup nfc_ndef_msg_parser_stream Streaming parser for NDEF messages
+ * @{
+ * @brief Incremental parser for NFC NDEF messages.
+ *
+ * The streaming parser accepts an NDEF message in fragments of any size and
+ * reports records through callbacks as soon as they are parsed. It does not
+ * need the whole message in memory, and it does not need any memory for
+ * record descriptors. Payloads are passed to the application as slices of
+ * the fragments provided to the parser, without copying.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <zephyr/types.h>
+#include <nfc/ndef/record.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Header of the record that is being parsed.
+ */
+struct nfc_ndef_msg_parser_stream_record {
+	/** Index of the record within the NDEF message. */
+	uint32_t index;
+
+	/** Type Name Format. */
+	enum nfc_ndef_record_tnf tnf;
+
+	/** Location of the record within the NDEF message. */
+	enum nfc_ndef_record_location location;
+
+	/** Pointer to the record type, or NULL if the type is empty. */
+	const uint8_t *type;
+
+	/** Length of the record type. */
+	uint8_t type_length;
+
+	/** Pointer to the record ID, or NULL if the record has no ID. */
+	const uint8_t *id;
+
+	/** Length of the record ID. */
+	uint8_t id_length;
+
+	/** Length of the record payload. */
+	uint32_t payload_length;
+};
+
+/** @brief Callbacks of the streaming NDEF message parser.
+ *
+ *  The record header passed to the callbacks, including the type and ID
+ *  fields, is valid only until the record_end callback returns.
+ *
+ *  Any callback can be NULL. If a callback returns a negative error code,
+ *  parsing is stopped and the error code is returned from
+ *  @ref nfc_ndef_msg_parser_stream_feed.
+ */
+struct nfc_ndef_msg_parser_stream_cb {
+	/** @brief Record header was parsed.
+	 *
+	 *  @param[in] record Header of the record.
+	 *  @param[in] user_data User data provided during initialization.
+	 *
+	 *  @retval 0 To continue parsing.
+	 *            Otherwise, a (negative) error code.
+	 */
+	int (*record_begin)(const struct nfc_ndef_msg_parser_stream_record *record,
+			    void *user_data);
+
+	/** @brief Part of the record payload was parsed.
+	 *
+	 *  The data points to the fragment provided to
+	 *  @ref nfc_ndef_msg_parser_stream_feed and is not copied.
+	 *
+	 *  @param[in] record Header of the record.
+	 *  @param[in] offset Offset of the data within the record payload.
+	 *  @param[in] data Pointer to the payload data.
+	 *  @param[in] len Length of the payload data.
+	 *  @param[in] user_data User data provided during initialization.
+	 *
+	 *  @retval 0 To continue parsing.
+	 *            Otherwise, a (negative) error code.
+	 */
+	int (*payload)(const struct nfc_ndef_msg_parser_stream_record *record,
+		       uint32_t offset, const uint8_t *data, uint32_t len,
+		       void *user_data);
+
+	/** @brief Whole record was parsed.
+	 *
+	 *  @param[in] record Header of the record.
+	 *  @param[in] user_data User data provided during initialization.
+	 *
+	 *  @retval 0 To continue parsing.
+	 *            Otherwise, a (negative) error code.
+	 */
+	int (*record_end)(const struct nfc_ndef_msg_parser_stream_record *record,
+			  void *user_data);
+};
+
+/** @brief Streaming NDEF message parser instance.
+ *
+ *  The members of this structure are internal and must not be accessed
+ *  directly.
+ */
+struct nfc_ndef_msg_parser_stream {
+	const struct nfc_ndef_msg_parser_stream_cb *cb;
+	void *user_data;
+	struct nfc_ndef_msg_parser_stream_record record;
+	uint32_t field_left;
+	uint32_t payload_offset;
+	uint8_t flags;
+	uint8_t state;
+	uint8_t field_len;
+	uint8_t field_buf[NDEF_RECORD_PAYLOAD_LEN_LONG_SIZE];
+	uint16_t hdr_len;
+	uint8_t hdr_buf[CONFIG_NFC_NDEF_PARSER_STREAM_HDR_BUF_SIZE];
+};
+
+/** @brief Initialize the streaming NDEF message parser.
+ *
+ *  The parser must be initialized again before parsing another message,
+ *  or after @ref nfc_ndef_msg_parser_stream_feed returned an error.
+ *
+ *  @param[out] parser Pointer to the parser instance.
+ *  @param[in] cb Pointer to the parser callbacks.
+ *  @param[in] user_data User data passed to the callbacks.
+ */
+void nfc_ndef_msg_parser_stream_init(struct nfc_ndef_msg_parser_stream *parser,
+				     const struct nfc_ndef_msg_parser_stream_cb *cb,
+				     void *user_data);
+
+/** @brief Feed a fragment of an NDEF message to the parser.
+ *
+ *  The callbacks are called from this function as the records are parsed.
+ *  Parsing stops at the end of the last record of the message.
+ *
+ *  @param[in,out] parser Pointer to the parser instance.
+ *  @param[in] data Pointer to the fragment of the NDEF message.
+ *  @param[in,out] len As input: size of the fragment. As output: number of
+ *                     bytes that belong to the NDEF message. This is less
+ *                     than the fragment size only if the message ends within
+ *                     the fragment.
+ *
+ *  @retval 0 If the operation was successful.
+ *  @retval -EINVAL If the record is malformed.
+ *  @retval -EFAULT If the record location flags are incorrect.
+ *  @retval -ENOMEM If the record type and ID do not fit in the parser buffer.
+ *  @retval -EALREADY If the whole message was already parsed.
+ *            Otherwise, a (negative) error code returned by a callback.
+ */
+int nfc_ndef_msg_parser_stream_feed(struct nfc_ndef_msg_parser_stream *parser,
+				    const uint8_t *data,
+				    uint32_t *len);
+
+/** @brief Check if the whole NDEF message was parsed.
+ *
+ *  @param[in] parser Pointer to the parser instance.
+ *
+ *  @retval true If the last record of the message was parsed.
+ *  @retval false Otherwise.
+ */
+bool nfc_ndef_msg_parser_stream_is_complete(const struct nfc_ndef_msg_parser_stream *parser);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* NFC_NDEF_MSG_PARSER_STREAM_H_ */
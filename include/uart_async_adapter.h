@@ -77,6 +77,18 @@ struct uart_async_adapter_data {
 		int32_t timeout;
 		/** Timer used for timeout */
 		struct k_timer timeout_timer;
+		/** Cycle count of the last received data, used to rearm the timer only on idle */
+		uint32_t last_rx_cycles;
+		/** Timeout timer state */
+		bool timer_active;
+#if CONFIG_UART_ASYNC_ADAPTER_RX_STAGING_SIZE > 0
+		/** Staging buffer for data received when no user buffer is available */
+		uint8_t staging[CONFIG_UART_ASYNC_ADAPTER_RX_STAGING_SIZE];
+		/** Position of the oldest byte in the staging buffer */
+		size_t staging_head;
+		/** Number of bytes in the staging buffer */
+		size_t staging_len;
+#endif
 		/** RX state */
 		bool enabled;
 	} rx;
@@ -11,8 +11,6 @@
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(data_fifo, CONFIG_DATA_FIFO_LOG_LEVEL);
 
-static struct k_spinlock lock;
-
 /** @brief Checks that the elements in the msgq and slab are legal.
  * I.e. the number of msgq elements cannot be more than mem blocks used.
  */
@@ -20,12 +18,12 @@ static int msgq_slab_legal_used_elements(struct data_fifo *data_fifo, uint32_t *
 					 uint32_t *slab_blocks_num_used_in)
 {
 	/* Lock so msgq and slab reads are in sync */
-	k_spinlock_key_t key = k_spin_lock(&lock);
+	k_spinlock_key_t key = k_spin_lock(&data_fifo->lock);
 
 	uint32_t msgq_num_used = k_msgq_num_used_get(&data_fifo->msgq);
 	uint32_t slab_blocks_num_used = k_mem_slab_num_used_get(&data_fifo->mem_slab);
 
-	k_spin_unlock(&lock, key);
+	k_spin_unlock(&data_fifo->lock, key);
 
 	if (slab_blocks_num_used < msgq_num_used) {
 		LOG_ERR("Num used mgsq %d cannot be larger than used blocks %d", msgq_num_used,
@@ -32,6 +32,15 @@ BUILD_ASSERT(CONFIG_EI_WRAPPER_THREAD_STACK_SIZE > 0);
 #define THREAD_STACK_SIZE	CONFIG_EI_WRAPPER_THREAD_STACK_SIZE
 #define THREAD_PRIORITY 	CONFIG_EI_WRAPPER_THREAD_PRIORITY
 #define DEBUG_MODE		IS_ENABLED(CONFIG_EI_WRAPPER_DEBUG_MODE)
+#define CONTINUOUS		IS_ENABLED(CONFIG_EI_WRAPPER_CONTINUOUS)
+#define CONTINUOUS_AVERAGING	IS_ENABLED(CONFIG_EI_WRAPPER_CONTINUOUS_AVERAGING)
+
+#if CONFIG_EI_WRAPPER_CONTINUOUS
+#define INPUT_SLICE_COUNT	EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW
+#else
+#define INPUT_SLICE_COUNT	1
+#endif
+#define INPUT_SLICE_SIZE	(INPUT_WINDOW_SIZE / INPUT_SLICE_COUNT)
 
 enum state {
 	STATE_DISABLED,
@@ -45,6 +54,8 @@ struct data_buffer {
 	size_t process_idx;
 	size_t append_idx;
 	size_t wait_data_size;
+	size_t last_move;
+	bool prev_processed;
 	struct k_spinlock lock;
 	enum state state;
 };
@@ -58,11 +69,14 @@ static K_SEM_DEFINE(ei_sem, 0, 1);
 static struct data_buffer ei_input;
 static ei_impulse_result_t ei_result;
 static int cur_res_idx;
+static size_t slice_offset;
 static ei_wrapper_result_ready_cb user_cb;
 
 
 BUILD_ASSERT(DATA_BUFFER_SIZE > INPUT_WINDOW_SIZE);
 BUILD_ASSERT(INPUT_WINDOW_SIZE % INPUT_FRAME_SIZE == 0);
+BUILD_ASSERT(INPUT_WINDOW_SIZE % INPUT_SLICE_COUNT == 0);
+BUILD_ASSERT(INPUT_SLICE_SIZE % INPUT_FRAME_SIZE == 0);
 
 
 static size_t buf_get_collected_data_count(const struct data_buffer *b)
@@ -84,12 +98,13 @@ static size_t buf_calc_free_space(const struct data_buffer *b)
 	return ARRAY_SIZE(b->buf) - buf_get_collected_data_count(b) - 1;
 }
 
-static void buf_processing_end(struct data_buffer *b)
+static void buf_processing_end(struct data_buffer *b, bool processed)
 {
 	k_spinlock_key_t key = k_spin_lock(&b->lock);
 
 	__ASSERT_NO_MSG(b->state == STATE_PROCESSING);
 	b->state = STATE_READY;
+	b->prev_processed = processed;
 
 	k_spin_unlock(&b->lock, key);
 }
@@ -111,6 +126,8 @@ static int buf_cleanup(struct data_buffer *b, bool *cancelled)
 		b->process_idx = 0;
 		b->append_idx = 0;
 		b->wait_data_size = 0;
+		b->last_move = 0;
+		b->prev_processed = false;
 		b->state = STATE_READY;
 	}
 
@@ -210,6 +227,7 @@ static int buf_processing_move(struct data_buffer *b, size_t move,
 
 	size_t max_move = buf_get_collected_data_count(b);
 
+	b->last_move = move;
 	b->process_idx += move;
 	if (b->process_idx >= ARRAY_SIZE(b->buf)) {
 		b->process_idx -= ARRAY_SIZE(b->buf);
@@ -301,18 +319,60 @@ int ei_wrapper_start_prediction(size_t window_shift, size_t frame_shift)
 	return err;
 }
 
+static size_t buf_get_new_slice_count(const struct data_buffer *b)
+{
+	/* Processing index cannot change while processing is done. */
+	__ASSERT_NO_MSG(b->state == STATE_PROCESSING);
+
+	/* Only the slices that entered the window since the previous prediction need to be
+	 * processed, as long as the window was moved by whole slices. Otherwise, the whole window
+	 * is processed from scratch.
+	 */
+	if (!b->prev_processed || (b->last_move == 0) || (b->last_move >= INPUT_WINDOW_SIZE) ||
+	    (b->last_move % INPUT_SLICE_SIZE)) {
+		return INPUT_SLICE_COUNT;
+	}
+
+	return b->last_move / INPUT_SLICE_SIZE;
+}
+
 static int raw_feature_get_data(size_t offset, size_t length, float *out_ptr)
 {
-	buf_get(&ei_input, out_ptr, offset, length);
+	buf_get(&ei_input, out_ptr, slice_offset + offset, length);
 
 	return 0;
 }
 
+static EI_IMPULSE_ERROR run_classifier_slices(signal_t *signal)
+{
+	EI_IMPULSE_ERROR err = EI_IMPULSE_OK;
+	size_t slice_cnt = buf_get_new_slice_count(&ei_input);
+
+	if (slice_cnt == INPUT_SLICE_COUNT) {
+		/* Drop DSP output cached for the previous window. */
+		run_classifier_init();
+	}
+
+	for (size_t i = INPUT_SLICE_COUNT - slice_cnt; i < INPUT_SLICE_COUNT; i++) {
+		slice_offset = i * INPUT_SLICE_SIZE;
+
+		err = run_classifier_continuous(signal, &ei_result, DEBUG_MODE,
+						CONTINUOUS_AVERAGING);
+		if (err) {
+			break;
+		}
+	}
+
+	slice_offset = 0;
+
+	return err;
+}
+
 static void processing_finished(int err)
 {
 	__ASSERT_NO_MSG(user_cb);
 
-	buf_processing_end(&ei_input);
+	buf_processing_end(&ei_input, !err);
 	cur_res_idx = -1;
 	user_cb(err);
 }
@@ -326,15 +386,21 @@ static void edge_impulse_thread_fn(void)
 		k_sem_take(&ei_sem, K_FOREVER);
 
 		features_signal.get_data = &raw_feature_get_data;
-		features_signal.total_length = INPUT_WINDOW_SIZE;
+		features_signal.total_length = INPUT_SLICE_SIZE;
 
 		if (IS_ENABLED(CONFIG_EI_WRAPPER_PROFILING)) {
 			start_time = k_uptime_get();
 		}
 
 		/* Invoke the impulse. */
-		EI_IMPULSE_ERROR err = run_classifier(&features_signal,
-						      &ei_result, DEBUG_MODE);
+		EI_IMPULSE_ERROR err;
+
+		if (CONTINUOUS) {
+			err = run_classifier_slices(&features_signal);
+		} else {
+			err = run_classifier(&features_signal, &ei_result, DEBUG_MODE);
+		}
+
 		if (IS_ENABLED(CONFIG_EI_WRAPPER_PROFILING)) {
 			int64_t delta = k_uptime_delta(&start_time);
 
@@ -89,6 +89,12 @@ static const char cscon[] = "AT+CSCON=1";
 static struct lte_lc_ncellmeas_params ncellmeas_params;
 /* Sempahore value 1 means ncellmeas is not ongoing, and 0 means it's ongoing. */
 K_SEM_DEFINE(ncellmeas_idle_sem, 1, 1);
+/* Storage for the cells of a %NCELLMEAS notification. The notifications are parsed
+ * one at a time in the AT monitor context, and the storage is only valid while the
+ * event is dispatched.
+ */
+static struct lte_lc_ncell neighbor_cells[CONFIG_LTE_NEIGHBOR_CELLS_MAX];
+static struct lte_lc_cell gci_cells[AT_NCELLMEAS_GCI_COUNT_MAX];
 /* Network attach semaphore */
 static K_SEM_DEFINE(link, 0, 1);
 
@@ -459,25 +465,21 @@ static void at_handler_ncellmeas_gci(const char *response)
 {
 	int err;
 	struct lte_lc_evt evt = {0};
-	const char *resp = response;
+	struct lte_lc_ncellmeas_params params = ncellmeas_params;
 
 	__ASSERT_NO_MSG(response != NULL);
 
-	int max_cell_count = ncellmeas_params.gci_count;
-	struct lte_lc_cell *cells = NULL;
-
 	LOG_DBG("%%NCELLMEAS GCI notification parsing starts");
 
-	if (max_cell_count != 0) {
-		cells = k_calloc(max_cell_count, sizeof(struct lte_lc_cell));
-		if (cells == NULL) {
-			LOG_ERR("Failed to allocate memory for the GCI cells");
-			return;
-		}
+	if (params.gci_count > AT_NCELLMEAS_GCI_COUNT_MAX) {
+		LOG_WRN("GCI count %d is bigger than the supported max: %d",
+			params.gci_count, AT_NCELLMEAS_GCI_COUNT_MAX);
+		params.gci_count = AT_NCELLMEAS_GCI_COUNT_MAX;
 	}
 
-	evt.cells_info.gci_cells = cells;
-	err = parse_ncellmeas_gci(&ncellmeas_params, resp, &evt.cells_info);
+	evt.cells_info.gci_cells = gci_cells;
+	evt.cells_info.neighbor_cells = neighbor_cells;
+	err = parse_ncellmeas_gci(&params, response, &evt.cells_info);
 	LOG_DBG("parse_ncellmeas_gci returned %d", err);
 	switch (err) {
 	case -E2BIG:
@@ -497,9 +499,6 @@ static void at_handler_ncellmeas_gci(const char *response)
 		LOG_ERR("Parsing of neighbor cells failed, err: %d", err);
 		break;
 	}
-
-	k_free(cells);
-	k_free(evt.cells_info.neighbor_cells);
 }
 
 static void at_handler_ncellmeas(const char *response)
@@ -521,23 +520,13 @@ static void at_handler_ncellmeas(const char *response)
 		goto exit;
 	}
 
-	int ncell_count = neighborcell_count_get(response);
-	struct lte_lc_ncell *neighbor_cells = NULL;
-
-	LOG_DBG("%%NCELLMEAS notification: neighbor cell count: %d", ncell_count);
-
-	if (ncell_count != 0) {
-		neighbor_cells = k_calloc(ncell_count, sizeof(struct lte_lc_ncell));
-		if (neighbor_cells == NULL) {
-			LOG_ERR("Failed to allocate memory for neighbor cells");
-			goto exit;
-		}
-	}
-
 	evt.cells_info.neighbor_cells = neighbor_cells;
 
 	err = parse_ncellmeas(response, &evt.cells_info);
 
+	LOG_DBG("%%NCELLMEAS notification: neighbor cell count: %d",
+		evt.cells_info.ncells_count);
+
 	switch (err) {
 	case -E2BIG:
 		LOG_WRN("Not all neighbor cells could be parsed");
@@ -554,9 +543,6 @@ static void at_handler_ncellmeas(const char *response)
 		break;
 	}
 
-	if (neighbor_cells) {
-		k_free(neighbor_cells);
-	}
 exit:
 	k_sem_give(&ncellmeas_idle_sem);
 }
@@ -944,282 +944,431 @@ uint32_t neighborcell_count_get(const char *at_response)
 	return ncell_count;
 }
 
-/* Parse NCELLMEAS notification and put information into struct lte_lc_cells_info.
- *
- * Returns 0 on successful cell measurements and population of struct.
- *	     The current cell information is valid if the current cell ID is
- *	     not set to LTE_LC_CELL_EUTRAN_ID_INVALID.
- *	     The ncells_count indicates how many neighbor cells were parsed
- *	     into the neighbor_cells array.
- * Returns 1 on measurement failure
- * Returns -E2BIG if not all cells were parsed due to memory limitations
- * Returns otherwise a negative error code.
+/* Single-pass tokenizer for the parameters of an NCELLMEAS notification.
+ * The parameters are read directly from the notification, so no parameter
+ * list needs to be allocated for the response.
  */
-int parse_ncellmeas(const char *at_response, struct lte_lc_cells_info *cells)
+struct ncellmeas_tokenizer {
+	const char *pos;
+	bool end;
+};
+
+static bool is_line_end(char c)
 {
-	int err, status, tmp, len;
-	struct at_param_list resp_list;
-	char  response_prefix[sizeof(AT_NCELLMEAS_RESPONSE_PREFIX)] = {0};
-	size_t response_prefix_len = sizeof(response_prefix);
-	char tmp_str[7];
-	bool incomplete = false;
-	/* Count the actual number of parameters in the AT response before
-	 * allocating heap for it. This may save quite a bit of heap as the
-	 * worst case scenario is 96 elements.
-	 * 3 is added to account for the parameters that do not have a trailng
-	 * comma.
-	 */
-	size_t param_count = get_char_frequency(at_response, ',') + 3;
+	return (c == '\0') || (c == '\r') || (c == '\n');
+}
 
-	cells->ncells_count = 0;
-	cells->current_cell.id = LTE_LC_CELL_EUTRAN_ID_INVALID;
+/* Initializes the tokenizer to the first parameter after the response prefix.
+ * Returns false if the response is not an NCELLMEAS notification.
+ */
+static bool ncellmeas_tokenizer_init(struct ncellmeas_tokenizer *tok, const char *at_response)
+{
+	const size_t prefix_len = sizeof(AT_NCELLMEAS_RESPONSE_PREFIX) - 1;
 
-	err = at_params_list_init(&resp_list, param_count);
-	if (err) {
-		LOG_ERR("Could not init AT params list, error: %d", err);
-		return err;
+	if (strncmp(at_response, AT_NCELLMEAS_RESPONSE_PREFIX, prefix_len) != 0 ||
+	    at_response[prefix_len] != ':') {
+		return false;
 	}
 
-	err = at_parser_params_from_str(at_response,
-					NULL,
-					&resp_list);
-	if (err && err != -E2BIG) {
-		LOG_ERR("Could not parse AT%%NCELLMEAS response, error: %d", err);
-		goto clean_exit;
-	} else if (err == -E2BIG) {
-		incomplete = true;
+	tok->pos = &at_response[prefix_len + 1];
+	tok->end = false;
+
+	return true;
+}
+
+/* Gets the next parameter. The quotes of a string parameter are not included.
+ * Returns -ENODATA if there are no more parameters and -EBADMSG if the
+ * notification is malformed.
+ */
+static int ncellmeas_param_next(struct ncellmeas_tokenizer *tok,
+				const char **str, size_t *len, bool *quoted)
+{
+	const char *p = tok->pos;
+
+	if (tok->end) {
+		return -ENODATA;
 	}
 
-	err = at_params_string_get(&resp_list,
-				   AT_RESPONSE_PREFIX_INDEX,
-				   response_prefix,
-				   &response_prefix_len);
-	if (err) {
-		LOG_ERR("Could not get response prefix, error: %d", err);
-		goto clean_exit;
+	while (*p == ' ') {
+		p++;
 	}
 
-	if (!response_is_valid(response_prefix, response_prefix_len,
-			       AT_NCELLMEAS_RESPONSE_PREFIX)) {
-		/* The unsolicited response is not a NCELLMEAS response, ignore it. */
-		LOG_DBG("Not a valid NCELLMEAS response");
-		goto clean_exit;
+	*quoted = (*p == '"');
+
+	if (*quoted) {
+		*str = ++p;
+
+		while (*p != '"') {
+			if (is_line_end(*p)) {
+				return -EBADMSG;
+			}
+
+			p++;
+		}
+
+		*len = p - *str;
+		p++;
+	} else {
+		*str = p;
+
+		while (*p != ',' && !is_line_end(*p)) {
+			p++;
+		}
+
+		*len = p - *str;
 	}
 
-	/* Status code. */
-	err = at_params_int_get(&resp_list, AT_NCELLMEAS_STATUS_INDEX, &status);
+	if (*p == ',') {
+		p++;
+	} else if (is_line_end(*p)) {
+		tok->end = true;
+	} else {
+		return -EBADMSG;
+	}
+
+	tok->pos = p;
+
+	return 0;
+}
+
+/* Gets the next parameter as an integer within the given range. Values that do not
+ * fit into 64 bits are saturated, like the AT command parser does.
+ */
+static int ncellmeas_param_int_get(struct ncellmeas_tokenizer *tok,
+				   int64_t min, int64_t max, int64_t *value)
+{
+	char buf[sizeof("-18446744073709551615")];
+	const char *str;
+	char *end_ptr;
+	size_t len;
+	bool quoted;
+	int err;
+
+	err = ncellmeas_param_next(tok, &str, &len, &quoted);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
-	if (status != AT_NCELLMEAS_STATUS_VALUE_SUCCESS) {
-		err = 1;
-		goto clean_exit;
+	if (quoted || len == 0 || len >= sizeof(buf)) {
+		return -EINVAL;
+	}
+
+	memcpy(buf, str, len);
+	buf[len] = '\0';
+
+	*value = strtoll(buf, &end_ptr, 10);
+	if (*end_ptr != '\0' || *value < min || *value > max) {
+		return -EINVAL;
 	}
 
-	/* Current cell ID. */
-	err = string_param_to_int(&resp_list, AT_NCELLMEAS_CELL_ID_INDEX, &tmp, 16);
+	return 0;
+}
+
+/* Gets the next parameter as an integer in a hexadecimal string, such as a cell ID. */
+static int ncellmeas_param_hex_get(struct ncellmeas_tokenizer *tok, int *value)
+{
+	char buf[16];
+	const char *str;
+	size_t len;
+	bool quoted;
+	int err;
+
+	err = ncellmeas_param_next(tok, &str, &len, &quoted);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
-	if (tmp > LTE_LC_CELL_EUTRAN_ID_MAX) {
-		tmp = LTE_LC_CELL_EUTRAN_ID_INVALID;
+	if (!quoted || len >= sizeof(buf)) {
+		return -EINVAL;
 	}
-	cells->current_cell.id = tmp;
 
-	/* PLMN */
-	len = sizeof(tmp_str);
+	memcpy(buf, str, len);
+	buf[len] = '\0';
+
+	return string_to_int(buf, 16, value);
+}
+
+/* Gets the MCC and MNC from the next parameter. */
+static int ncellmeas_param_plmn_get(struct ncellmeas_tokenizer *tok, int *mcc, int *mnc)
+{
+	char buf[sizeof("123456")];
+	const char *str;
+	size_t len;
+	bool quoted;
+	int err;
 
-	err = at_params_string_get(&resp_list, AT_NCELLMEAS_PLMN_INDEX,
-				   tmp_str, &len);
+	err = ncellmeas_param_next(tok, &str, &len, &quoted);
 	if (err) {
-		goto clean_exit;
+		return err;
+	}
+
+	if (!quoted || len >= sizeof(buf)) {
+		return -EINVAL;
 	}
 
-	tmp_str[len] = '\0';
+	memcpy(buf, str, len);
+	buf[len] = '\0';
 
 	/* Read MNC and store as integer. The MNC starts as the fourth character
 	 * in the string, following three characters long MCC.
 	 */
-	err = string_to_int(&tmp_str[3], 10, &cells->current_cell.mnc);
+	err = string_to_int(&buf[3], 10, mnc);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
 	/* Null-terminated MCC, read and store it. */
-	tmp_str[3] = '\0';
+	buf[3] = '\0';
 
-	err = string_to_int(tmp_str, 10, &cells->current_cell.mcc);
+	return string_to_int(buf, 10, mcc);
+}
+
+/* Parses the parameters of a measured cell. The timing advance measurement time is
+ * reported after the timing advance only for the GCI search types.
+ */
+static int ncellmeas_cell_parse(struct ncellmeas_tokenizer *tok, bool gci,
+				struct lte_lc_cell *cell)
+{
+	int64_t value;
+	int tmp;
+	int err;
+
+	/* <cell_id> */
+	err = ncellmeas_param_hex_get(tok, &tmp);
 	if (err) {
-		goto clean_exit;
+		LOG_ERR("Could not parse cell_id, error: %d", err);
+		return err;
+	}
+
+	if (tmp > LTE_LC_CELL_EUTRAN_ID_MAX) {
+		tmp = LTE_LC_CELL_EUTRAN_ID_INVALID;
 	}
+	cell->id = tmp;
 
-	/* Tracking area code. */
-	err = string_param_to_int(&resp_list, AT_NCELLMEAS_TAC_INDEX, &tmp, 16);
+	/* <plmn> */
+	err = ncellmeas_param_plmn_get(tok, &cell->mcc, &cell->mnc);
 	if (err) {
-		goto clean_exit;
+		LOG_ERR("Could not parse plmn, error: %d", err);
+		return err;
 	}
 
-	cells->current_cell.tac = tmp;
+	/* <tac> */
+	err = ncellmeas_param_hex_get(tok, &tmp);
+	if (err) {
+		LOG_ERR("Could not parse tracking_area_code, error: %d", err);
+		return err;
+	}
+	cell->tac = tmp;
 
-	/* Timing advance */
-	err = at_params_int_get(&resp_list, AT_NCELLMEAS_TIMING_ADV_INDEX,
-				&tmp);
+	/* <ta> */
+	err = ncellmeas_param_int_get(tok, INT32_MIN, INT32_MAX, &value);
 	if (err) {
-		goto clean_exit;
+		LOG_ERR("Could not parse timing_advance, error: %d", err);
+		return err;
 	}
+	cell->timing_advance = value;
 
-	cells->current_cell.timing_advance = tmp;
+	/* <ta_meas_time> */
+	if (gci) {
+		err = ncellmeas_param_int_get(tok, INT64_MIN, INT64_MAX, &value);
+		if (err) {
+			LOG_ERR("Could not parse timing_advance_meas_time, error: %d", err);
+			return err;
+		}
+		cell->timing_advance_meas_time = value;
+	}
 
-	/* EARFCN */
-	err = at_params_int_get(&resp_list, AT_NCELLMEAS_EARFCN_INDEX,
-				&cells->current_cell.earfcn);
+	/* <earfcn> */
+	err = ncellmeas_param_int_get(tok, INT32_MIN, INT32_MAX, &value);
 	if (err) {
-		goto clean_exit;
+		LOG_ERR("Could not parse earfcn, error: %d", err);
+		return err;
 	}
+	cell->earfcn = value;
 
-	/* Physical cell ID. */
-	err = at_params_short_get(&resp_list, AT_NCELLMEAS_PHYS_CELL_ID_INDEX,
-				&cells->current_cell.phys_cell_id);
+	/* <phys_cell_id> */
+	err = ncellmeas_param_int_get(tok, INT16_MIN, INT16_MAX, &value);
 	if (err) {
-		goto clean_exit;
+		LOG_ERR("Could not parse phys_cell_id, error: %d", err);
+		return err;
 	}
+	cell->phys_cell_id = value;
 
-	/* RSRP */
-	err = at_params_int_get(&resp_list, AT_NCELLMEAS_RSRP_INDEX, &tmp);
+	/* <rsrp> */
+	err = ncellmeas_param_int_get(tok, INT32_MIN, INT32_MAX, &value);
 	if (err) {
-		goto clean_exit;
+		LOG_ERR("Could not parse rsrp, error: %d", err);
+		return err;
 	}
+	cell->rsrp = value;
 
-	cells->current_cell.rsrp = tmp;
+	/* <rsrq> */
+	err = ncellmeas_param_int_get(tok, INT32_MIN, INT32_MAX, &value);
+	if (err) {
+		LOG_ERR("Could not parse rsrq, error: %d", err);
+		return err;
+	}
+	cell->rsrq = value;
 
-	/* RSRQ */
-	err = at_params_int_get(&resp_list, AT_NCELLMEAS_RSRQ_INDEX, &tmp);
+	/* <meas_time> */
+	err = ncellmeas_param_int_get(tok, INT64_MIN, INT64_MAX, &value);
 	if (err) {
-		goto clean_exit;
+		LOG_ERR("Could not parse meas_time, error: %d", err);
+		return err;
 	}
+	cell->measurement_time = value;
 
-	cells->current_cell.rsrq = tmp;
+	return 0;
+}
+
+/* Parses the remaining parameters of a neighbor cell, following the EARFCN. */
+static int ncellmeas_ncell_parse(struct ncellmeas_tokenizer *tok, int64_t earfcn,
+				 struct lte_lc_ncell *ncell)
+{
+	int64_t value;
+	int err;
 
-	/* Measurement time. */
-	err = at_params_int64_get(&resp_list, AT_NCELLMEAS_MEASUREMENT_TIME_INDEX,
-				  &cells->current_cell.measurement_time);
+	ncell->earfcn = earfcn;
+
+	/* <n_phys_cell_id> */
+	err = ncellmeas_param_int_get(tok, INT16_MIN, INT16_MAX, &value);
 	if (err) {
-		goto clean_exit;
+		LOG_ERR("Could not parse n_phys_cell_id, error: %d", err);
+		return err;
 	}
+	ncell->phys_cell_id = value;
 
-	/* Neighbor cell count. */
-	cells->ncells_count = neighborcell_count_get(at_response);
+	/* <n_rsrp> */
+	err = ncellmeas_param_int_get(tok, INT32_MIN, INT32_MAX, &value);
+	if (err) {
+		LOG_ERR("Could not parse n_rsrp, error: %d", err);
+		return err;
+	}
+	ncell->rsrp = value;
 
-	/* Starting from modem firmware v1.3.1, timing advance measurement time
-	 * information is added as the last parameter in the response.
-	 */
-	size_t ta_meas_time_index = AT_NCELLMEAS_PRE_NCELLS_PARAMS_COUNT +
-			cells->ncells_count * AT_NCELLMEAS_N_PARAMS_COUNT;
+	/* <n_rsrq> */
+	err = ncellmeas_param_int_get(tok, INT32_MIN, INT32_MAX, &value);
+	if (err) {
+		LOG_ERR("Could not parse n_rsrq, error: %d", err);
+		return err;
+	}
+	ncell->rsrq = value;
 
-	if (at_params_valid_count_get(&resp_list) > ta_meas_time_index) {
-		err = at_params_int64_get(&resp_list, ta_meas_time_index,
-					  &cells->current_cell.timing_advance_meas_time);
-		if (err) {
-			goto clean_exit;
-		}
-	} else {
-		cells->current_cell.timing_advance_meas_time = 0;
+	/* <time_diff> */
+	err = ncellmeas_param_int_get(tok, INT32_MIN, INT32_MAX, &value);
+	if (err) {
+		LOG_ERR("Could not parse time_diff, error: %d", err);
+		return err;
 	}
+	ncell->time_diff = value;
 
-	if ((cells->ncells_count == 0) || (cells->neighbor_cells == NULL)) {
-		goto clean_exit;
+	return 0;
+}
+
+/* Parse NCELLMEAS notification and put information into struct lte_lc_cells_info.
+ *
+ * Returns 0 on successful cell measurements and population of struct.
+ *	     The current cell information is valid if the current cell ID is
+ *	     not set to LTE_LC_CELL_EUTRAN_ID_INVALID.
+ *	     The ncells_count indicates how many neighbor cells were parsed
+ *	     into the neighbor_cells array.
+ * Returns 1 on measurement failure
+ * Returns -E2BIG if not all cells were parsed due to memory limitations
+ * Returns otherwise a negative error code.
+ */
+int parse_ncellmeas(const char *at_response, struct lte_lc_cells_info *cells)
+{
+	struct ncellmeas_tokenizer tok;
+	struct lte_lc_ncell ncell;
+	size_t ncells_max = cells->neighbor_cells ? CONFIG_LTE_NEIGHBOR_CELLS_MAX : 0;
+	bool incomplete = false;
+	int64_t value;
+	int err;
+
+	cells->ncells_count = 0;
+	cells->current_cell.id = LTE_LC_CELL_EUTRAN_ID_INVALID;
+
+	if (!ncellmeas_tokenizer_init(&tok, at_response)) {
+		/* The unsolicited response is not a NCELLMEAS response, ignore it. */
+		LOG_DBG("Not a valid NCELLMEAS response");
+		return 0;
 	}
 
-	/* Neighboring cells. */
-	for (size_t i = 0; i < cells->ncells_count; i++) {
-		size_t start_idx = AT_NCELLMEAS_PRE_NCELLS_PARAMS_COUNT +
-				   i * AT_NCELLMEAS_N_PARAMS_COUNT;
+	/* Status code. */
+	err = ncellmeas_param_int_get(&tok, INT32_MIN, INT32_MAX, &value);
+	if (err) {
+		return err;
+	}
 
-		/* EARFCN */
-		err = at_params_int_get(&resp_list,
-					start_idx + AT_NCELLMEAS_N_EARFCN_INDEX,
-					&cells->neighbor_cells[i].earfcn);
-		if (err) {
-			goto clean_exit;
-		}
+	if (value != AT_NCELLMEAS_STATUS_VALUE_SUCCESS) {
+		return 1;
+	}
 
-		/* Physical cell ID. */
-		err = at_params_short_get(&resp_list,
-					  start_idx + AT_NCELLMEAS_N_PHYS_CELL_ID_INDEX,
-					  &cells->neighbor_cells[i].phys_cell_id);
-		if (err) {
-			goto clean_exit;
-		}
+	err = ncellmeas_cell_parse(&tok, false, &cells->current_cell);
+	if (err) {
+		cells->current_cell.id = LTE_LC_CELL_EUTRAN_ID_INVALID;
+		return err;
+	}
 
-		/* RSRP */
-		err = at_params_int_get(&resp_list,
-					start_idx + AT_NCELLMEAS_N_RSRP_INDEX,
-					&tmp);
+	/* Starting from modem firmware v1.3.1, timing advance measurement time
+	 * information is added as the last parameter in the response.
+	 */
+	cells->current_cell.timing_advance_meas_time = 0;
+
+	/* Neighboring cells. The first parameter of each cell is read ahead to detect
+	 * the timing advance measurement time, which is the only parameter after the
+	 * last neighbor cell.
+	 */
+	while (!tok.end) {
+		err = ncellmeas_param_int_get(&tok, INT64_MIN, INT64_MAX, &value);
 		if (err) {
-			goto clean_exit;
+			return err;
 		}
 
-		cells->neighbor_cells[i].rsrp = tmp;
-
-		/* RSRQ */
-		err = at_params_int_get(&resp_list,
-					start_idx + AT_NCELLMEAS_N_RSRQ_INDEX,
-					&tmp);
-		if (err) {
-			goto clean_exit;
+		if (tok.end) {
+			cells->current_cell.timing_advance_meas_time = value;
+			break;
 		}
 
-		cells->neighbor_cells[i].rsrq = tmp;
+		if (value < INT32_MIN || value > INT32_MAX) {
+			return -EINVAL;
+		}
 
-		/* Time difference. */
-		err = at_params_int_get(&resp_list,
-					start_idx + AT_NCELLMEAS_N_TIME_DIFF_INDEX,
-					&cells->neighbor_cells[i].time_diff);
+		err = ncellmeas_ncell_parse(&tok, value, &ncell);
 		if (err) {
-			goto clean_exit;
+			return err;
 		}
-	}
 
-	if (incomplete) {
-		err = -E2BIG;
+		if (cells->ncells_count < ncells_max) {
+			cells->neighbor_cells[cells->ncells_count++] = ncell;
+		} else {
+			incomplete = true;
+		}
 	}
 
-clean_exit:
-	at_params_list_free(&resp_list);
-
-	return err;
+	return incomplete ? -E2BIG : 0;
 }
 
 int parse_ncellmeas_gci(struct lte_lc_ncellmeas_params *params,
 	const char *at_response, struct lte_lc_cells_info *cells)
 {
-	struct at_param_list resp_list;
-	struct lte_lc_ncell *ncells = NULL;
-	int err, status, tmp_int, len;
-	int16_t tmp_short;
-	char response_prefix[sizeof(AT_NCELLMEAS_RESPONSE_PREFIX)] = {0};
-	size_t response_prefix_len = sizeof(response_prefix);
-	char tmp_str[7];
+	struct ncellmeas_tokenizer tok;
+	struct lte_lc_cell parsed_cell;
+	struct lte_lc_ncell ncell;
+	size_t gci_cells_max = cells->gci_cells ? params->gci_count : 0;
+	size_t ncells_max = cells->neighbor_cells ? CONFIG_LTE_NEIGHBOR_CELLS_MAX : 0;
 	bool incomplete = false;
-	int curr_index;
-	size_t i = 0, j = 0, k = 0;
-
-	/* Count the actual number of parameters in the AT response before
-	 * allocating heap for it. This may save quite a bit of heap as the
-	 * worst case scenario is 96 elements.
-	 * 3 is added to account for the parameters that do not have a trailing
-	 * comma.
-	 */
-	size_t param_count = get_char_frequency(at_response, ',') + 3;
+	bool is_serving_cell;
+	int64_t parsed_ncells_count;
+	int64_t value;
+	int err;
 
 	/* Fill the defaults */
 	cells->gci_cells_count = 0;
 	cells->ncells_count = 0;
 	cells->current_cell.id = LTE_LC_CELL_EUTRAN_ID_INVALID;
 
-	for (i = 0; i < params->gci_count; i++) {
+	for (size_t i = 0; i < gci_cells_max; i++) {
 		cells->gci_cells[i].id = LTE_LC_CELL_EUTRAN_ID_INVALID;
 		cells->gci_cells[i].timing_advance = LTE_LC_CELL_TIMING_ADVANCE_INVALID;
 	}
@@ -1243,297 +1392,91 @@ int parse_ncellmeas_gci(struct lte_lc_ncellmeas_params *params,
 	 *	[,<n_earfcn2>,<n_phys_cell_id2>,<n_rsrp2>,<n_rsrq2>,<time_diff2>]...]...
 	 */
 
-	err = at_params_list_init(&resp_list, param_count);
-	if (err) {
-		LOG_ERR("Could not init AT params list for cell_list, error: %d", err);
-		goto clean_exit;
-	}
-
-	err = at_parser_params_from_str(at_response, NULL, &resp_list);
-	if (err && err != -E2BIG) {
-		LOG_ERR("Could not parse AT%%NCELLMEAS response, error: %d", err);
-		goto clean_exit;
-	} else if (err == -E2BIG) {
-		/* Returns -E2BIG if the buffers set by CONFIG_LTE_NEIGHBOR_CELLS_MAX
-		 * are too small for the modem response. The associated data is still valid,
-		 * but not complete.
-		 */
-		incomplete = true;
-		LOG_WRN("E2BIG was returned, continue. param_count %d, err %d, str %s",
-			param_count, err, at_response);
-	}
-
-	err = at_params_string_get(&resp_list,
-				   AT_RESPONSE_PREFIX_INDEX,
-				   response_prefix,
-				   &response_prefix_len);
-	if (err) {
-		LOG_ERR("Could not get response prefix, error: %d", err);
-		goto clean_exit;
-	}
-
-	if (!response_is_valid(response_prefix, response_prefix_len,
-			       AT_NCELLMEAS_RESPONSE_PREFIX)) {
+	if (!ncellmeas_tokenizer_init(&tok, at_response)) {
 		/* The unsolicited response is not a NCELLMEAS response, ignore it. */
 		LOG_ERR("Not a valid NCELLMEAS response");
-		goto clean_exit;
+		return 0;
 	}
 
 	/* Status code. */
-	curr_index = AT_NCELLMEAS_STATUS_INDEX;
-	err = at_params_int_get(&resp_list, curr_index, &status);
+	err = ncellmeas_param_int_get(&tok, INT32_MIN, INT32_MAX, &value);
 	if (err) {
 		LOG_DBG("Cannot parse NCELLMEAS status");
-		goto clean_exit;
+		return err;
 	}
 
-	if (status == AT_NCELLMEAS_STATUS_VALUE_FAIL) {
-		err = 1;
-		LOG_DBG("NCELLMEAS status %d", status);
-		goto clean_exit;
-	} else if (status == AT_NCELLMEAS_STATUS_VALUE_INCOMPLETE) {
+	if (value == AT_NCELLMEAS_STATUS_VALUE_FAIL) {
+		LOG_DBG("NCELLMEAS status %d", (int)value);
+		return 1;
+	} else if (value == AT_NCELLMEAS_STATUS_VALUE_INCOMPLETE) {
 		LOG_WRN("NCELLMEAS measurements interrupted; results incomplete");
 	}
 
 	/* Go through the cells. */
-	for (i = 0; curr_index < (param_count - (AT_NCELLMEAS_GCI_CELL_PARAMS_COUNT + 1)) &&
-			i < params->gci_count; i++) {
-		struct lte_lc_cell parsed_cell;
-		bool is_serving_cell;
-		uint8_t parsed_ncells_count;
-
-		/* <cell_id>  */
-		curr_index++;
-		err = string_param_to_int(&resp_list, curr_index, &tmp_int, 16);
-		if (err) {
-			LOG_ERR("Could not parse cell_id, index %d, i %d error: %d",
-				curr_index, i, err);
-			goto clean_exit;
-		}
-
-		if (tmp_int > LTE_LC_CELL_EUTRAN_ID_MAX) {
-			LOG_WRN("cell_id = %d which is > LTE_LC_CELL_EUTRAN_ID_MAX; "
-				"marking invalid", tmp_int);
-			tmp_int = LTE_LC_CELL_EUTRAN_ID_INVALID;
-		}
-		parsed_cell.id = tmp_int;
-
-		/* <plmn> */
-		len = sizeof(tmp_str);
-
-		curr_index++;
-		err = at_params_string_get(&resp_list, curr_index, tmp_str, &len);
-		if (err) {
-			LOG_ERR("Could not parse plmn, error: %d", err);
-			goto clean_exit;
-		}
-		/* A successful call to `at_params_string_get` guarantees `len` to be set to
-		 * a value lower than the totalt size of `tmp_str`.
-		 */
-		tmp_str[len] = '\0';
-
-		/* Read MNC and store as integer. The MNC starts as the fourth character
-		 * in the string, following three characters long MCC.
-		 */
-		err = string_to_int(&tmp_str[3], 10, &parsed_cell.mnc);
-		if (err) {
-			LOG_ERR("string_to_int, error: %d", err);
-			goto clean_exit;
-		}
-
-		/* Null-terminated MCC, read and store it. */
-		tmp_str[3] = '\0';
-
-		err = string_to_int(tmp_str, 10, &parsed_cell.mcc);
-		if (err) {
-			LOG_ERR("string_to_int, error: %d", err);
-			goto clean_exit;
-		}
-
-		/* <tac> */
-		curr_index++;
-		err = string_param_to_int(&resp_list, curr_index, &tmp_int, 16);
-		if (err) {
-			LOG_ERR("Could not parse tracking_area_code in i %d, error: %d", i, err);
-			goto clean_exit;
-		}
-		parsed_cell.tac = tmp_int;
-
-		/* <ta> */
-		curr_index++;
-		err = at_params_int_get(&resp_list, curr_index, &tmp_int);
-		if (err) {
-			LOG_ERR("Could not parse timing_advance, error: %d", err);
-			goto clean_exit;
-		}
-		parsed_cell.timing_advance = tmp_int;
-
-		/* <ta_meas_time> */
-		curr_index++;
-		err = at_params_int64_get(&resp_list, curr_index,
-					  &parsed_cell.timing_advance_meas_time);
-		if (err) {
-			LOG_ERR("Could not parse timing_advance_meas_time, error: %d", err);
-			goto clean_exit;
-		}
-
-		/* <earfcn> */
-		curr_index++;
-		err = at_params_int_get(&resp_list, curr_index, &parsed_cell.earfcn);
-		if (err) {
-			LOG_ERR("Could not parse earfcn, error: %d", err);
-			goto clean_exit;
-		}
-
-		/* <phys_cell_id> */
-		curr_index++;
-		err = at_params_short_get(&resp_list, curr_index, &parsed_cell.phys_cell_id);
-		if (err) {
-			LOG_ERR("Could not parse phys_cell_id, error: %d", err);
-			goto clean_exit;
-		}
-
-		/* <rsrp> */
-		curr_index++;
-		err = at_params_short_get(&resp_list, curr_index, &parsed_cell.rsrp);
-		if (err) {
-			LOG_ERR("Could not parse rsrp, error: %d", err);
-			goto clean_exit;
-		}
-
-		/* <rsrq> */
-		curr_index++;
-		err = at_params_short_get(&resp_list, curr_index, &parsed_cell.rsrq);
-		if (err) {
-			LOG_ERR("Could not parse rsrq, error: %d", err);
-			goto clean_exit;
-		}
-
-		/* <meas_time> */
-		curr_index++;
-		err = at_params_int64_get(&resp_list, curr_index, &parsed_cell.measurement_time);
+	while (!tok.end) {
+		err = ncellmeas_cell_parse(&tok, true, &parsed_cell);
 		if (err) {
-			LOG_ERR("Could not parse meas_time, error: %d", err);
-			goto clean_exit;
+			return err;
 		}
 
 		/* <serving> */
-		curr_index++;
-		err = at_params_short_get(&resp_list, curr_index, &tmp_short);
+		err = ncellmeas_param_int_get(&tok, INT16_MIN, INT16_MAX, &value);
 		if (err) {
 			LOG_ERR("Could not parse serving, error: %d", err);
-			goto clean_exit;
+			return err;
 		}
-		is_serving_cell = tmp_short;
+		is_serving_cell = value;
 
 		/* <neighbor_count> */
-		curr_index++;
-		err = at_params_short_get(&resp_list, curr_index, &tmp_short);
+		err = ncellmeas_param_int_get(&tok, 0, INT16_MAX, &parsed_ncells_count);
 		if (err) {
 			LOG_ERR("Could not parse neighbor_count, error: %d", err);
-			goto clean_exit;
+			return err;
 		}
-		parsed_ncells_count = tmp_short;
 
 		if (is_serving_cell) {
-			int to_be_parsed_ncell_count = 0;
-
-			/* This the current/serving cell.
-			 * In practice the <neighbor_count> is always 0 for other than
-			 * the serving cell, i.e. no neigbour cell list is available.
-			 * Thus, handle neighbor cells only for the serving cell.
-			 */
 			cells->current_cell = parsed_cell;
-			if (parsed_ncells_count != 0) {
-				/* Allocate room for the parsed neighbor info. */
-				if (parsed_ncells_count > CONFIG_LTE_NEIGHBOR_CELLS_MAX) {
-					to_be_parsed_ncell_count = CONFIG_LTE_NEIGHBOR_CELLS_MAX;
-					incomplete = true;
-					LOG_WRN("Cutting response, because received neigbor cell"
-						" count is bigger than configured max: %d",
-							CONFIG_LTE_NEIGHBOR_CELLS_MAX);
-
-				} else {
-					to_be_parsed_ncell_count = parsed_ncells_count;
-				}
-				ncells = k_calloc(
-						to_be_parsed_ncell_count,
-						sizeof(struct lte_lc_ncell));
-				if (ncells == NULL) {
-					LOG_WRN("Failed to allocate memory for the ncells"
-						" (continue)");
-					continue;
-				}
-				cells->neighbor_cells = ncells;
-				cells->ncells_count = to_be_parsed_ncell_count;
+		} else if (cells->gci_cells_count < gci_cells_max) {
+			cells->gci_cells[cells->gci_cells_count++] = parsed_cell;
+		} else {
+			incomplete = true;
+		}
+
+		/* In practice the <neighbor_count> is always 0 for other than the serving cell,
+		 * i.e. no neighbor cell list is available. The neighbor cells of other cells
+		 * are parsed but not stored.
+		 */
+		for (int j = 0; j < parsed_ncells_count; j++) {
+			/* <n_earfcn> */
+			err = ncellmeas_param_int_get(&tok, INT32_MIN, INT32_MAX, &value);
+			if (err) {
+				LOG_ERR("Could not parse n_earfcn, error: %d", err);
+				return err;
 			}
 
-			/* Parse neighbors */
-			for (j = 0; j < to_be_parsed_ncell_count; j++) {
-				/* <n_earfcn[j]> */
-				curr_index++;
-				err = at_params_int_get(&resp_list,
-							curr_index,
-							&cells->neighbor_cells[j].earfcn);
-				if (err) {
-					LOG_ERR("Could not parse n_earfcn, error: %d", err);
-					goto clean_exit;
-				}
-
-				/* <n_phys_cell_id[j]> */
-				curr_index++;
-				err = at_params_short_get(&resp_list,
-							  curr_index,
-							  &cells->neighbor_cells[j].phys_cell_id);
-				if (err) {
-					LOG_ERR("Could not parse n_phys_cell_id, error: %d", err);
-					goto clean_exit;
-				}
-
-				/* <n_rsrp[j]> */
-				curr_index++;
-				err = at_params_int_get(&resp_list, curr_index, &tmp_int);
-				if (err) {
-					LOG_ERR("Could not parse n_rsrp, error: %d", err);
-					goto clean_exit;
-				}
-				cells->neighbor_cells[j].rsrp = tmp_int;
-
-				/* <n_rsrq[j]> */
-				curr_index++;
-				err = at_params_int_get(&resp_list, curr_index, &tmp_int);
-				if (err) {
-					LOG_ERR("Could not parse n_rsrq, error: %d", err);
-					goto clean_exit;
-				}
-				cells->neighbor_cells[j].rsrq = tmp_int;
-
-				/* <time_diff[j]> */
-				curr_index++;
-				err = at_params_int_get(&resp_list,
-							curr_index,
-							&cells->neighbor_cells[j].time_diff);
-				if (err) {
-					LOG_ERR("Could not parse time_diff, error: %d", err);
-					goto clean_exit;
-				}
+			err = ncellmeas_ncell_parse(&tok, value, &ncell);
+			if (err) {
+				return err;
+			}
+
+			if (!is_serving_cell) {
+				continue;
+			}
+
+			if (cells->ncells_count < ncells_max) {
+				cells->neighbor_cells[cells->ncells_count++] = ncell;
+			} else {
+				incomplete = true;
 			}
-		} else {
-			cells->gci_cells[k] = parsed_cell;
-			cells->gci_cells_count++; /* Increase count for non-serving GCI cell */
-			k++;
 		}
 	}
 
 	if (incomplete) {
-		err = -E2BIG;
-		LOG_ERR("Buffer is too small; results incomplete: %d", err);
+		LOG_WRN("Buffer is too small; results incomplete");
+		return -E2BIG;
 	}
 
-clean_exit:
-	at_params_list_free(&resp_list);
-
-	return err;
+	return 0;
 }
 
 int parse_xmodemsleep(const char *at_response, struct lte_lc_modem_sleep *modem_sleep)
@@ -16,11 +16,14 @@
 #include <zephyr/toolchain.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <zephyr/kernel.h>
 #include <zephyr/types.h>
 #include <zephyr/logging/log.h>
 
+#include "modem_info_cache.h"
+
 LOG_MODULE_REGISTER(modem_info);
 
 #define INVALID_DESCRIPTOR	-1
@@ -466,6 +469,16 @@ int modem_info_short_get(enum modem_info info, uint16_t *buf)
 		return -EINVAL;
 	}
 
+	if (IS_ENABLED(CONFIG_MODEM_INFO_CACHE)) {
+		err = modem_info_cache_string_get(info, recv_buf, sizeof(recv_buf));
+		if (err >= 0) {
+			*buf = (uint16_t)strtoul(recv_buf, NULL, 10);
+			return sizeof(uint16_t);
+		} else if (err != -ENODATA) {
+			return err;
+		}
+	}
+
 	err = nrf_modem_at_cmd(recv_buf, CONFIG_MODEM_INFO_BUFFER_SIZE, modem_data[info]->cmd);
 	if (err != 0) {
 		return -EIO;
@@ -484,6 +497,11 @@ int modem_info_short_get(enum modem_info info, uint16_t *buf)
 		return err;
 	}
 
+	if (IS_ENABLED(CONFIG_MODEM_INFO_CACHE)) {
+		snprintk(recv_buf, sizeof(recv_buf), "%u", *buf);
+		modem_info_cache_store(info, recv_buf);
+	}
+
 	return sizeof(uint16_t);
 }
 
@@ -609,7 +627,7 @@ parse_line:
 	return strlen(out_buf);
 }
 
-int modem_info_string_get(enum modem_info info, char *buf, const size_t buf_size)
+static int string_get(enum modem_info info, char *buf, const size_t buf_size)
 {
 	int err;
 	char recv_buf[CONFIG_MODEM_INFO_BUFFER_SIZE] = {0};
@@ -715,6 +733,30 @@ int modem_info_string_get(enum modem_info info, char *buf, const size_t buf_size
 	return len <= 0 ? -ENOTSUP : len;
 }
 
+int modem_info_string_get(enum modem_info info, char *buf, const size_t buf_size)
+{
+	int ret;
+
+	if ((buf == NULL) || (buf_size == 0)) {
+		return -EINVAL;
+	}
+
+	if (IS_ENABLED(CONFIG_MODEM_INFO_CACHE)) {
+		ret = modem_info_cache_string_get(info, buf, buf_size);
+		if (ret != -ENODATA) {
+			return ret;
+		}
+	}
+
+	ret = string_get(info, buf, buf_size);
+
+	if (IS_ENABLED(CONFIG_MODEM_INFO_CACHE) && (ret > 0)) {
+		modem_info_cache_store(info, buf);
+	}
+
+	return ret;
+}
+
 static void modem_info_rsrp_subscribe_handler(const char *notif)
 {
 	int err;
@@ -904,12 +946,23 @@ int modem_info_get_rsrp(int *val)
 		return -EINVAL;
 	}
 
-	ret = nrf_modem_at_scanf("AT+CESQ",
-				 "+CESQ: %*d,%*d,%*d,%*d,%*d,%d", val);
+	if (IS_ENABLED(CONFIG_MODEM_INFO_CACHE)) {
+		char rsrp[sizeof("255")];
 
-	if (ret != 1) {
-		LOG_ERR("at_scanf_int failed");
-		return map_nrf_modem_at_scanf_error(ret);
+		ret = modem_info_cache_string_get(MODEM_INFO_RSRP, rsrp, sizeof(rsrp));
+		if (ret < 0) {
+			return ret;
+		}
+
+		*val = atoi(rsrp);
+	} else {
+		ret = nrf_modem_at_scanf("AT+CESQ",
+					 "+CESQ: %*d,%*d,%*d,%*d,%*d,%d", val);
+
+		if (ret != 1) {
+			LOG_ERR("at_scanf_int failed");
+			return map_nrf_modem_at_scanf_error(ret);
+		}
 	}
 
 	if (*val == CELL_RSRP_INVALID) {
@@ -944,11 +997,24 @@ int modem_info_get_current_band(uint8_t *val)
 		return -EINVAL;
 	}
 
-	int ret = nrf_modem_at_scanf("AT%XCBAND", "%%XCBAND: %u", val);
+	int ret;
 
-	if (ret != 1) {
-		LOG_ERR("Could not get band, error: %d", ret);
-		return map_nrf_modem_at_scanf_error(ret);
+	if (IS_ENABLED(CONFIG_MODEM_INFO_CACHE)) {
+		char band[sizeof("255")];
+
+		ret = modem_info_cache_string_get(MODEM_INFO_CUR_BAND, band, sizeof(band));
+		if (ret < 0) {
+			return ret;
+		}
+
+		*val = (uint8_t)atoi(band);
+	} else {
+		ret = nrf_modem_at_scanf("AT%XCBAND", "%%XCBAND: %u", val);
+
+		if (ret != 1) {
+			LOG_ERR("Could not get band, error: %d", ret);
+			return map_nrf_modem_at_scanf_error(ret);
+		}
 	}
 
 	if (*val == BAND_UNAVAILABLE) {
@@ -965,6 +1031,10 @@ int modem_info_get_operator(char *buf, size_t buf_size)
 		return -EINVAL;
 	}
 
+	if (IS_ENABLED(CONFIG_MODEM_INFO_CACHE)) {
+		return modem_info_cache_operator_name_get(buf, buf_size);
+	}
+
 	int ret = nrf_modem_at_scanf(
 		"AT%XMONITOR",
 		"%%XMONITOR: "
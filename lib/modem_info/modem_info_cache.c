@@ -0,0 +1,558 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <nrf_modem_at.h>
+#include <modem/at_monitor.h>
+#include <modem/nrf_modem_lib.h>
+#include <modem/modem_info.h>
+
+#include "modem_info_cache.h"
+
+LOG_MODULE_DECLARE(modem_info);
+
+#define AT_CMD_XMONITOR		"AT%%XMONITOR"
+#define AT_CMD_PDP_CONTEXT	"AT+CGDCONT?"
+#define AT_CMD_XSIM_SUBSCRIBE	"AT%%XSIM=1"
+
+#define PDP_CONTEXT_PREFIX	"+CGDCONT:"
+
+/* Field indexes in the %XMONITOR response. */
+#define XMONITOR_SHORT_NAME_INDEX	2
+#define XMONITOR_PLMN_INDEX		3
+#define XMONITOR_TAC_INDEX		4
+#define XMONITOR_BAND_INDEX		6
+#define XMONITOR_CELLID_INDEX		7
+#define XMONITOR_RSRP_INDEX		10
+
+/* Field indexes in the +CGDCONT response. */
+#define PDP_CONTEXT_APN_INDEX		2
+#define PDP_CONTEXT_ADDR_INDEX		3
+
+/* Field indexes in the notifications. */
+#define CEREG_STATUS_INDEX		0
+#define CEREG_TAC_INDEX			1
+#define CEREG_CELLID_INDEX		2
+#define CESQ_RSRP_INDEX			0
+#define XMODEMSLEEP_TIME_INDEX		1
+
+#define CEREG_REGISTERED_HOME		1
+#define CEREG_REGISTERED_ROAMING	5
+
+#define IP_ADDR_SEPARATOR		", "
+
+#define RSRP_UNAVAILABLE_STR		"255"
+#define BAND_UNAVAILABLE_STR		STRINGIFY(BAND_UNAVAILABLE)
+
+/* Staleness rules of the cached values. */
+enum cache_rule {
+	/* Not cached, always read from the modem. */
+	RULE_NONE,
+	/* Read with %XMONITOR, updated by notifications, expires after the network TTL. */
+	RULE_NETWORK,
+	/* Read with +CGDCONT, expires after the PDN TTL or on a PDN event. */
+	RULE_PDN,
+	/* Read by the caller, valid until the SIM state changes. Only cached while
+	 * subscribed to the %XSIM notifications.
+	 */
+	RULE_SIM,
+	/* Read by the caller, valid until the cache is invalidated. */
+	RULE_STATIC,
+};
+
+struct cache_entry {
+	enum cache_rule rule;
+	char *buf;
+	size_t size;
+};
+
+static struct {
+	char rsrp[sizeof(RSRP_UNAVAILABLE_STR)];
+	char band[sizeof("255")];
+	char sup_band[MODEM_INFO_MAX_RESPONSE_SIZE];
+	char area_code[sizeof("FFFF")];
+	char operator[sizeof("123456")];
+	char cellid[sizeof("FFFFFFFF")];
+	char ip_address[MODEM_INFO_MAX_RESPONSE_SIZE];
+	char uicc[sizeof("255")];
+	char fw_version[MODEM_INFO_FWVER_SIZE];
+	char iccid[sizeof("12345678901234567890")];
+	char imsi[sizeof("123456789012345")];
+	char imei[sizeof("123456789012345")];
+	char apn[MODEM_INFO_MAX_RESPONSE_SIZE];
+	char short_name[MODEM_INFO_SHORT_OP_NAME_SIZE];
+} snapshot;
+
+#define ENTRY(_rule, _field) { .rule = _rule, .buf = snapshot._field, .size = sizeof(snapshot._field) }
+
+static const struct cache_entry entries[] = {
+	[MODEM_INFO_RSRP]	= ENTRY(RULE_NETWORK, rsrp),
+	[MODEM_INFO_CUR_BAND]	= ENTRY(RULE_NETWORK, band),
+	[MODEM_INFO_SUP_BAND]	= ENTRY(RULE_STATIC, sup_band),
+	[MODEM_INFO_AREA_CODE]	= ENTRY(RULE_NETWORK, area_code),
+	/* The UE mode can be changed with the +CEMODE command. */
+	[MODEM_INFO_UE_MODE]	= { .rule = RULE_NONE },
+	[MODEM_INFO_OPERATOR]	= ENTRY(RULE_NETWORK, operator),
+	[MODEM_INFO_MCC]	= { .rule = RULE_NONE },
+	[MODEM_INFO_MNC]	= { .rule = RULE_NONE },
+	[MODEM_INFO_CELLID]	= ENTRY(RULE_NETWORK, cellid),
+	[MODEM_INFO_IP_ADDRESS]	= ENTRY(RULE_PDN, ip_address),
+	[MODEM_INFO_UICC]	= ENTRY(RULE_SIM, uicc),
+	[MODEM_INFO_BATTERY]	= { .rule = RULE_NONE },
+	[MODEM_INFO_TEMP]	= { .rule = RULE_NONE },
+	[MODEM_INFO_FW_VERSION]	= ENTRY(RULE_STATIC, fw_version),
+	[MODEM_INFO_ICCID]	= ENTRY(RULE_SIM, iccid),
+	/* The system mode can be changed with AT commands that the cache does not see. */
+	[MODEM_INFO_LTE_MODE]	= { .rule = RULE_NONE },
+	[MODEM_INFO_NBIOT_MODE]	= { .rule = RULE_NONE },
+	[MODEM_INFO_GPS_MODE]	= { .rule = RULE_NONE },
+	[MODEM_INFO_IMSI]	= ENTRY(RULE_SIM, imsi),
+	[MODEM_INFO_IMEI]	= ENTRY(RULE_STATIC, imei),
+	[MODEM_INFO_DATE_TIME]	= { .rule = RULE_NONE },
+	[MODEM_INFO_APN]	= ENTRY(RULE_PDN, apn),
+};
+
+BUILD_ASSERT(ARRAY_SIZE(entries) == MODEM_INFO_COUNT);
+BUILD_ASSERT(MODEM_INFO_COUNT <= 32);
+
+static K_MUTEX_DEFINE(cache_lock);
+static char rsp_buf[CONFIG_MODEM_INFO_CACHE_BUFFER_SIZE];
+static int64_t updated[MODEM_INFO_COUNT];
+static uint32_t valid_mask;
+static bool modem_sleeping;
+static bool xsim_subscribed;
+
+static void cereg_mon_handler(const char *notif);
+static void cesq_mon_handler(const char *notif);
+static void xsim_mon_handler(const char *notif);
+static void cgev_mon_handler(const char *notif);
+static void xmodemsleep_mon_handler(const char *notif);
+
+AT_MONITOR(modem_info_cache_cereg_mon, "+CEREG", cereg_mon_handler);
+AT_MONITOR(modem_info_cache_cesq_mon, "%CESQ", cesq_mon_handler);
+AT_MONITOR(modem_info_cache_xsim_mon, "%XSIM", xsim_mon_handler);
+AT_MONITOR(modem_info_cache_cgev_mon, "+CGEV", cgev_mon_handler);
+AT_MONITOR(modem_info_cache_xmodemsleep_mon, "%XMODEMSLEEP", xmodemsleep_mon_handler);
+
+/* Copy a field of a comma separated response line without the quotes.
+ * Returns the length of the field, or a negative error code if the line
+ * does not have the field.
+ */
+static int field_get(const char *line, size_t index, char *buf, size_t buf_size)
+{
+	const char *p = strchr(line, ':');
+	bool quoted = false;
+	size_t len = 0;
+
+	if (!p) {
+		return -EBADMSG;
+	}
+
+	p++;
+	while (*p == ' ') {
+		p++;
+	}
+
+	for (size_t i = 0; i < index; p++) {
+		if ((*p == '\0') || (*p == '\r') || (*p == '\n')) {
+			return -ENOENT;
+		}
+
+		if (*p == '"') {
+			quoted = !quoted;
+		} else if ((*p == ',') && !quoted) {
+			i++;
+		}
+	}
+
+	for (; (*p != '\0') && (*p != '\r') && (*p != '\n'); p++) {
+		if (*p == '"') {
+			quoted = !quoted;
+			continue;
+		}
+
+		if ((*p == ',') && !quoted) {
+			break;
+		}
+
+		if (len + 1 >= buf_size) {
+			return -EMSGSIZE;
+		}
+
+		buf[len++] = *p;
+	}
+
+	buf[len] = '\0';
+
+	return len;
+}
+
+static void value_set(enum modem_info info, const char *value)
+{
+	const struct cache_entry *entry = &entries[info];
+
+	strncpy(entry->buf, value, entry->size - 1);
+	entry->buf[entry->size - 1] = '\0';
+
+	updated[info] = k_uptime_get();
+	valid_mask |= BIT(info);
+}
+
+static void rule_invalidate(enum cache_rule rule)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (entries[i].rule == rule) {
+			valid_mask &= ~BIT(i);
+		}
+	}
+}
+
+static bool is_fresh(enum modem_info info)
+{
+	int64_t ttl;
+
+	if (!(valid_mask & BIT(info))) {
+		return false;
+	}
+
+	switch (entries[info].rule) {
+	case RULE_NETWORK:
+		/* The network information does not change while the modem sleeps. */
+		if (modem_sleeping) {
+			return true;
+		}
+
+		ttl = CONFIG_MODEM_INFO_CACHE_NETWORK_TTL;
+		break;
+	case RULE_PDN:
+		ttl = CONFIG_MODEM_INFO_CACHE_PDN_TTL;
+		break;
+	case RULE_SIM:
+		return xsim_subscribed;
+	default:
+		return true;
+	}
+
+	return (k_uptime_get() - updated[info]) < ttl;
+}
+
+static void response_field_store(enum modem_info info, size_t index, const char *def)
+{
+	char field[MODEM_INFO_MAX_RESPONSE_SIZE];
+
+	if (field_get(rsp_buf, index, field, sizeof(field)) > 0) {
+		value_set(info, field);
+	} else {
+		value_set(info, def);
+	}
+}
+
+static int xmonitor_refresh(void)
+{
+	int err;
+
+	err = nrf_modem_at_cmd(rsp_buf, sizeof(rsp_buf), AT_CMD_XMONITOR);
+	if (err) {
+		LOG_ERR("Failed to read network information, error: %d", err);
+		return -EIO;
+	}
+
+	/* Only the registration status is reported when the modem is not registered. */
+	response_field_store(MODEM_INFO_OPERATOR, XMONITOR_PLMN_INDEX, "");
+	response_field_store(MODEM_INFO_AREA_CODE, XMONITOR_TAC_INDEX, "");
+	response_field_store(MODEM_INFO_CUR_BAND, XMONITOR_BAND_INDEX, BAND_UNAVAILABLE_STR);
+	response_field_store(MODEM_INFO_CELLID, XMONITOR_CELLID_INDEX, "");
+	response_field_store(MODEM_INFO_RSRP, XMONITOR_RSRP_INDEX, RSRP_UNAVAILABLE_STR);
+
+	if (field_get(rsp_buf, XMONITOR_SHORT_NAME_INDEX, snapshot.short_name,
+		      sizeof(snapshot.short_name)) < 0) {
+		snapshot.short_name[0] = '\0';
+	}
+
+	return 0;
+}
+
+static int pdp_context_refresh(void)
+{
+	char field[MODEM_INFO_MAX_RESPONSE_SIZE];
+	char ip_address[sizeof(snapshot.ip_address)] = "";
+	char *line;
+	char *ip_v6_str;
+	size_t len = 0;
+	bool apn_found = false;
+	int ret;
+
+	ret = nrf_modem_at_cmd(rsp_buf, sizeof(rsp_buf), AT_CMD_PDP_CONTEXT);
+	if (ret) {
+		LOG_ERR("Failed to read PDP contexts, error: %d", ret);
+		return -EIO;
+	}
+
+	for (line = strstr(rsp_buf, PDP_CONTEXT_PREFIX); line;
+	     line = strstr(line + 1, PDP_CONTEXT_PREFIX)) {
+		/* The APN of the default PDP context is reported. */
+		if (!apn_found && (field_get(line, PDP_CONTEXT_APN_INDEX, field,
+					     sizeof(field)) >= 0)) {
+			value_set(MODEM_INFO_APN, field);
+			apn_found = true;
+		}
+
+		if (field_get(line, PDP_CONTEXT_ADDR_INDEX, field, sizeof(field)) <= 0) {
+			continue;
+		}
+
+		/* Only the IPv4 address is reported if both addresses are given. */
+		ip_v6_str = strchr(field, ' ');
+		if (ip_v6_str) {
+			*ip_v6_str = '\0';
+		}
+
+		ret = snprintk(&ip_address[len], sizeof(ip_address) - len, "%s%s",
+			       (len > 0) ? IP_ADDR_SEPARATOR : "", field);
+		if ((ret < 0) || (ret >= (sizeof(ip_address) - len))) {
+			return -EMSGSIZE;
+		}
+
+		len += ret;
+	}
+
+	if (!apn_found) {
+		value_set(MODEM_INFO_APN, "");
+	}
+
+	value_set(MODEM_INFO_IP_ADDRESS, ip_address);
+
+	return 0;
+}
+
+int modem_info_cache_string_get(enum modem_info info, char *buf, size_t buf_size)
+{
+	int err = 0;
+	size_t len;
+
+	if ((info >= MODEM_INFO_COUNT) || (entries[info].rule == RULE_NONE)) {
+		return -ENODATA;
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (!is_fresh(info)) {
+		switch (entries[info].rule) {
+		case RULE_NETWORK:
+			err = xmonitor_refresh();
+			break;
+		case RULE_PDN:
+			err = pdp_context_refresh();
+			break;
+		default:
+			/* Read by the caller. */
+			err = -ENODATA;
+			break;
+		}
+	}
+
+	if (err) {
+		goto exit;
+	}
+
+	len = strlen(entries[info].buf);
+	if (len >= buf_size) {
+		err = -EMSGSIZE;
+		goto exit;
+	}
+
+	memcpy(buf, entries[info].buf, len + 1);
+
+	/* An empty list of IP addresses is a valid value. */
+	err = ((len == 0) && (info != MODEM_INFO_IP_ADDRESS)) ? -ENOTSUP : len;
+
+exit:
+	k_mutex_unlock(&cache_lock);
+
+	return err;
+}
+
+void modem_info_cache_store(enum modem_info info, const char *value)
+{
+	if ((info >= MODEM_INFO_COUNT) ||
+	    ((entries[info].rule != RULE_SIM) && (entries[info].rule != RULE_STATIC))) {
+		return;
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	if ((entries[info].rule != RULE_SIM) || xsim_subscribed) {
+		value_set(info, value);
+	}
+	k_mutex_unlock(&cache_lock);
+}
+
+int modem_info_cache_operator_name_get(char *buf, size_t buf_size)
+{
+	int err = 0;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (!is_fresh(MODEM_INFO_OPERATOR)) {
+		err = xmonitor_refresh();
+	}
+
+	if (!err) {
+		if (snapshot.short_name[0] == '\0') {
+			err = -ENOTSUP;
+		} else {
+			strncpy(buf, snapshot.short_name, buf_size - 1);
+			buf[buf_size - 1] = '\0';
+		}
+	}
+
+	k_mutex_unlock(&cache_lock);
+
+	return err;
+}
+
+void modem_info_cache_invalidate(void)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	valid_mask = 0;
+	k_mutex_unlock(&cache_lock);
+}
+
+static void cereg_mon_handler(const char *notif)
+{
+	char field[sizeof(snapshot.cellid)];
+	int status;
+
+	if (field_get(notif, CEREG_STATUS_INDEX, field, sizeof(field)) <= 0) {
+		return;
+	}
+
+	status = atoi(field);
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	/* The operator and band are not reported, so they must be read again. */
+	valid_mask &= ~(BIT(MODEM_INFO_OPERATOR) | BIT(MODEM_INFO_CUR_BAND));
+
+	if ((status == CEREG_REGISTERED_HOME) || (status == CEREG_REGISTERED_ROAMING)) {
+		if (field_get(notif, CEREG_TAC_INDEX, field, sizeof(field)) > 0) {
+			value_set(MODEM_INFO_AREA_CODE, field);
+		}
+
+		if (field_get(notif, CEREG_CELLID_INDEX, field, sizeof(field)) > 0) {
+			value_set(MODEM_INFO_CELLID, field);
+		}
+	} else {
+		rule_invalidate(RULE_NETWORK);
+	}
+
+	k_mutex_unlock(&cache_lock);
+}
+
+static void cesq_mon_handler(const char *notif)
+{
+	char field[sizeof(snapshot.rsrp)];
+
+	if (field_get(notif, CESQ_RSRP_INDEX, field, sizeof(field)) <= 0) {
+		return;
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	value_set(MODEM_INFO_RSRP, field);
+	k_mutex_unlock(&cache_lock);
+}
+
+static void xsim_mon_handler(const char *notif)
+{
+	ARG_UNUSED(notif);
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	rule_invalidate(RULE_SIM);
+	k_mutex_unlock(&cache_lock);
+}
+
+static void cgev_mon_handler(const char *notif)
+{
+	ARG_UNUSED(notif);
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	rule_invalidate(RULE_PDN);
+	k_mutex_unlock(&cache_lock);
+}
+
+static void xmodemsleep_mon_handler(const char *notif)
+{
+	char field[sizeof("4294967295")];
+	bool sleeping = false;
+
+	/* The modem has left the sleep when the sleep time is missing or zero. */
+	if (field_get(notif, XMODEMSLEEP_TIME_INDEX, field, sizeof(field)) > 0) {
+		sleeping = strtoul(field, NULL, 10) > 0;
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	/* The network information may have changed during the sleep. */
+	if (modem_sleeping && !sleeping) {
+		rule_invalidate(RULE_NETWORK);
+	}
+
+	modem_sleeping = sleeping;
+
+	k_mutex_unlock(&cache_lock);
+}
+
+#ifdef CONFIG_UNITY
+void modem_info_cache_on_modem_init(int ret, void *ctx)
+#else
+NRF_MODEM_LIB_ON_INIT(modem_info_cache_init_hook, modem_info_cache_on_modem_init, NULL);
+static void modem_info_cache_on_modem_init(int ret, void *ctx)
+#endif
+{
+	int err;
+
+	ARG_UNUSED(ctx);
+
+	if (ret != 0) {
+		/* Return if modem initialization failed */
+		return;
+	}
+
+	/* The SIM values are invalidated by the %XSIM notifications, which are not
+	 * subscribed to by default.
+	 */
+	err = nrf_modem_at_printf(AT_CMD_XSIM_SUBSCRIBE);
+	if (err) {
+		LOG_WRN("Failed to subscribe to %%XSIM, SIM information is not cached, err %d",
+			err);
+	}
+
+	/* The modem firmware may have been updated. */
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	xsim_subscribed = (err == 0);
+	modem_sleeping = false;
+	valid_mask = 0;
+	k_mutex_unlock(&cache_lock);
+}
+
+#ifdef CONFIG_UNITY
+void modem_info_cache_on_modem_shutdown(void *ctx)
+#else
+NRF_MODEM_LIB_ON_SHUTDOWN(modem_info_cache_shutdown_hook, modem_info_cache_on_modem_shutdown,
+			  NULL);
+static void modem_info_cache_on_modem_shutdown(void *ctx)
+#endif
+{
+	ARG_UNUSED(ctx);
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	xsim_subscribed = false;
+	modem_sleeping = false;
+	valid_mask = 0;
+	k_mutex_unlock(&cache_lock);
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef MODEM_INFO_CACHE_H_
+#define MODEM_INFO_CACHE_H_
+
+#include <stddef.h>
+#include <modem/modem_info.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Get a value from the cache.
+ *
+ * Values that are read together with other values, for example with
+ * %XMONITOR, are refreshed here when they are stale.
+ *
+ * @param info The information type.
+ * @param buf Buffer for the value in string format.
+ * @param buf_size Size of the buffer.
+ *
+ * @return Length of the value on success.
+ * @retval -ENODATA If the value is not cached, or it is stale and must be
+ *		    read and stored with @ref modem_info_cache_store by the caller.
+ * @retval -ENOTSUP If the value is not available.
+ * @retval -EMSGSIZE If the buffer is too small.
+ * @retval -EIO If the value could not be refreshed.
+ */
+int modem_info_cache_string_get(enum modem_info info, char *buf, size_t buf_size);
+
+/** @brief Store a value that was read by the caller.
+ *
+ * @param info The information type.
+ * @param value The value in string format.
+ */
+void modem_info_cache_store(enum modem_info info, const char *value);
+
+/** @brief Get the short operator name from the cache.
+ *
+ * @param buf Buffer for the name.
+ * @param buf_size Size of the buffer.
+ *
+ * @retval 0 On success.
+ * @retval -ENOTSUP If the name is not available.
+ * @retval -EIO If the name could not be refreshed.
+ */
+int modem_info_cache_operator_name_get(char *buf, size_t buf_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MODEM_INFO_CACHE_H_ */
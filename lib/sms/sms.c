@@ -20,6 +20,9 @@
 #include "sms_submit.h"
 #include "sms_deliver.h"
 #include "sms_internal.h"
+#if defined(CONFIG_SMS_CONCAT_REASSEMBLY)
+#include "sms_concat.h"
+#endif
 
 LOG_MODULE_REGISTER(sms, CONFIG_SMS_LOG_LEVEL);
 
@@ -106,6 +109,15 @@ static void sms_ack(struct k_work *work)
 	}
 }
 
+void sms_listeners_notify(struct sms_data *data)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(subscribers); i++) {
+		if (subscribers[i].listener != NULL) {
+			subscribers[i].listener(data, subscribers[i].ctx);
+		}
+	}
+}
+
 /**
  * @brief Notify SMS subscribers about received SMS or status report.
  *
@@ -113,11 +125,7 @@ static void sms_ack(struct k_work *work)
  */
 static void sms_notify(struct k_work *work)
 {
-	for (size_t i = 0; i < ARRAY_SIZE(subscribers); i++) {
-		if (subscribers[i].listener != NULL) {
-			subscribers[i].listener(&sms_data_info, subscribers[i].ctx);
-		}
-	}
+	sms_listeners_notify(&sms_data_info);
 }
 
 /**
@@ -142,6 +150,11 @@ static void sms_reregister(struct k_work *work)
 		at_monitor_pause(&sms_at_handler_cds);
 		at_monitor_pause(&sms_at_handler_cms);
 
+#if defined(CONFIG_SMS_CONCAT_REASSEMBLY)
+		/* Partially received messages are delivered before the observers are cleared. */
+		sms_concat_flush();
+#endif
+
 		/* Clear all observers. */
 		for (size_t i = 0; i < ARRAY_SIZE(subscribers); i++) {
 			subscribers[i].ctx = NULL;
@@ -183,6 +196,15 @@ static void sms_at_cmd_handler_cmt(const char *at_notif)
 	}
 	LOG_DBG("Valid SMS notification decoded");
 
+#if defined(CONFIG_SMS_CONCAT_REASSEMBLY)
+	/* Parts of a concatenated message are acknowledged but listeners are notified only
+	 * when the whole message has been received.
+	 */
+	if (sms_concat_process(&sms_data_info) == -EINPROGRESS) {
+		goto sms_ack_send;
+	}
+#endif
+
 	k_work_submit(&sms_notify_work);
 
 sms_ack_send:
@@ -381,6 +403,15 @@ void sms_unregister_listener(int handle)
 		return;
 	}
 
+#if defined(CONFIG_SMS_CONCAT_REASSEMBLY)
+	/* Partially received messages are delivered as they are before the last listener
+	 * is unregistered, because they have already been acknowledged.
+	 */
+	if (subscribers[handle].listener != NULL && sms_subscriber_count() == 1) {
+		sms_concat_flush();
+	}
+#endif
+
 	subscribers[handle].ctx = NULL;
 	subscribers[handle].listener = NULL;
 
@@ -0,0 +1,361 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/logging/log.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <errno.h>
+#include <modem/sms.h>
+
+#include "sms_concat.h"
+#include "sms_internal.h"
+
+LOG_MODULE_DECLARE(sms, CONFIG_SMS_LOG_LEVEL);
+
+BUILD_ASSERT(CONFIG_SMS_CONCAT_MAX_PARTS <= 32, "Received parts are tracked in a 32-bit mask");
+
+/** @brief Partially received concatenated message. */
+struct sms_concat_msg {
+	/** Indicates whether this entry is in use. */
+	bool in_use;
+	/** Number of received parts. */
+	uint8_t received_cnt;
+	/** Bit mask of received parts, bit 0 representing sequence number 1. */
+	uint32_t received_mask;
+	/** Uptime of the latest received part in milliseconds. */
+	int64_t timestamp;
+	/** Header of the first part, or of the first received part until the first part arrives. */
+	struct sms_deliver_header header;
+	/** Timestamps of the received parts. */
+	struct sms_time part_time[CONFIG_SMS_CONCAT_MAX_PARTS];
+	/** Payload lengths of the received parts. */
+	uint8_t part_len[CONFIG_SMS_CONCAT_MAX_PARTS];
+	/** Payloads of the received parts. */
+	uint8_t part[CONFIG_SMS_CONCAT_MAX_PARTS][SMS_MAX_PAYLOAD_LEN_CHARS];
+};
+
+/** @brief Concatenated message whose parts are delivered to listeners as they are. */
+struct sms_concat_passthrough {
+	/** Uptime of the latest part in milliseconds, zero if this entry is not in use. */
+	int64_t timestamp;
+	/** Reference number of the message. */
+	uint16_t ref_number;
+	/** Number of parts in the message. */
+	uint8_t total_msgs;
+	/** Originating address of the message. */
+	char address_str[SMS_MAX_ADDRESS_LEN_CHARS + 1];
+};
+
+#define CONCAT_TIMEOUT_MS (CONFIG_SMS_CONCAT_TIMEOUT * MSEC_PER_SEC)
+
+static void concat_timeout_work_fn(struct k_work *work);
+
+/** @brief Pool of partially received concatenated messages. */
+static struct sms_concat_msg concat_pool[CONFIG_SMS_CONCAT_POOL_SIZE];
+/** @brief Messages that did not fit into the pool or timed out. */
+static struct sms_concat_passthrough concat_passthrough[CONFIG_SMS_CONCAT_POOL_SIZE];
+static size_t concat_passthrough_next;
+static struct k_spinlock concat_lock;
+
+/** @brief Worker delivering the parts of timed out messages to listeners. */
+static K_WORK_DELAYABLE_DEFINE(concat_timeout_work, concat_timeout_work_fn);
+
+/* Pool entry and message being delivered as is, protected by the mutex. */
+static K_MUTEX_DEFINE(concat_flush_mutex);
+static struct sms_concat_msg concat_flush_msg;
+static struct sms_data concat_flush_data;
+
+static bool concat_header_match(uint16_t ref_number, uint8_t total_msgs, const char *address_str,
+				const struct sms_deliver_header *header)
+{
+	return ref_number == header->concatenated.ref_number &&
+	       total_msgs == header->concatenated.total_msgs &&
+	       strcmp(address_str, header->originating_address.address_str) == 0;
+}
+
+static bool concat_msg_match(const struct sms_concat_msg *msg,
+			     const struct sms_deliver_header *header)
+{
+	return msg->in_use &&
+	       concat_header_match(msg->header.concatenated.ref_number,
+				   msg->header.concatenated.total_msgs,
+				   msg->header.originating_address.address_str, header);
+}
+
+/* Find a message whose parts are passed through. The timestamp is updated so that
+ * the message is remembered until no part of it has been received within the timeout.
+ */
+static bool concat_passthrough_find(const struct sms_deliver_header *header, int64_t now)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(concat_passthrough); i++) {
+		struct sms_concat_passthrough *entry = &concat_passthrough[i];
+
+		if (entry->timestamp != 0 && now - entry->timestamp < CONCAT_TIMEOUT_MS &&
+		    concat_header_match(entry->ref_number, entry->total_msgs,
+					entry->address_str, header)) {
+			entry->timestamp = now;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Remember a message whose parts are passed through, replacing the oldest one. */
+static void concat_passthrough_add(const struct sms_deliver_header *header, int64_t now)
+{
+	struct sms_concat_passthrough *entry = &concat_passthrough[concat_passthrough_next];
+
+	entry->timestamp = now;
+	entry->ref_number = header->concatenated.ref_number;
+	entry->total_msgs = header->concatenated.total_msgs;
+	strcpy(entry->address_str, header->originating_address.address_str);
+
+	concat_passthrough_next = (concat_passthrough_next + 1) % ARRAY_SIZE(concat_passthrough);
+}
+
+static struct sms_concat_msg *concat_pool_get(const struct sms_deliver_header *header)
+{
+	struct sms_concat_msg *free_msg = NULL;
+
+	for (size_t i = 0; i < ARRAY_SIZE(concat_pool); i++) {
+		if (concat_msg_match(&concat_pool[i], header)) {
+			return &concat_pool[i];
+		}
+		if (!concat_pool[i].in_use && free_msg == NULL) {
+			free_msg = &concat_pool[i];
+		}
+	}
+
+	if (free_msg != NULL) {
+		free_msg->in_use = true;
+		free_msg->received_cnt = 0;
+		free_msg->received_mask = 0;
+		free_msg->header = *header;
+	}
+
+	return free_msg;
+}
+
+static void concat_msg_assemble(struct sms_concat_msg *msg, struct sms_data *data)
+{
+	size_t len = 0;
+
+	data->header.deliver = msg->header;
+	data->header.deliver.concatenated.seq_number = 0;
+
+	for (size_t i = 0; i < msg->header.concatenated.total_msgs; i++) {
+		memcpy(&data->payload[len], msg->part[i], msg->part_len[i]);
+		len += msg->part_len[i];
+	}
+	data->payload[len] = '\0';
+	data->payload_len = len;
+
+	msg->in_use = false;
+}
+
+/* Deliver the received parts of a message to listeners one by one, as they were received. */
+static void concat_msg_deliver_parts(const struct sms_concat_msg *msg)
+{
+	struct sms_data *data = &concat_flush_data;
+
+	for (size_t i = 0; i < msg->header.concatenated.total_msgs; i++) {
+		if (!(msg->received_mask & BIT(i))) {
+			continue;
+		}
+
+		memset(data, 0, sizeof(*data));
+		data->type = SMS_TYPE_DELIVER;
+		data->header.deliver = msg->header;
+		data->header.deliver.time = msg->part_time[i];
+		data->header.deliver.concatenated.seq_number = i + 1;
+		memcpy(data->payload, msg->part[i], msg->part_len[i]);
+		data->payload_len = msg->part_len[i];
+
+		sms_listeners_notify(data);
+	}
+}
+
+static void concat_timeout_work_fn(struct k_work *work)
+{
+	k_spinlock_key_t key;
+	int64_t now;
+	int64_t next_timeout;
+	bool expired;
+
+	k_mutex_lock(&concat_flush_mutex, K_FOREVER);
+
+	do {
+		expired = false;
+		next_timeout = INT64_MAX;
+
+		key = k_spin_lock(&concat_lock);
+
+		now = k_uptime_get();
+
+		for (size_t i = 0; i < ARRAY_SIZE(concat_pool); i++) {
+			struct sms_concat_msg *msg = &concat_pool[i];
+
+			if (!msg->in_use) {
+				continue;
+			}
+
+			if (now - msg->timestamp < CONCAT_TIMEOUT_MS) {
+				next_timeout = MIN(next_timeout,
+						   msg->timestamp + CONCAT_TIMEOUT_MS);
+				continue;
+			}
+
+			/* Parts received after this are delivered as they are, as the parts
+			 * received so far have already been delivered.
+			 */
+			concat_flush_msg = *msg;
+			msg->in_use = false;
+			concat_passthrough_add(&msg->header, now);
+			expired = true;
+			break;
+		}
+
+		if (!expired && next_timeout != INT64_MAX) {
+			k_work_reschedule(&concat_timeout_work, K_MSEC(next_timeout - now));
+		}
+
+		k_spin_unlock(&concat_lock, key);
+
+		if (expired) {
+			LOG_WRN("Concatenated message (ref %d) timed out with %d/%d parts, "
+				"delivering them as they are",
+				concat_flush_msg.header.concatenated.ref_number,
+				concat_flush_msg.received_cnt,
+				concat_flush_msg.header.concatenated.total_msgs);
+
+			concat_msg_deliver_parts(&concat_flush_msg);
+		}
+	} while (expired);
+
+	k_mutex_unlock(&concat_flush_mutex);
+}
+
+int sms_concat_process(struct sms_data *data)
+{
+	struct sms_deliver_header *header = &data->header.deliver;
+	struct sms_udh_concat *concat = &header->concatenated;
+	struct sms_concat_msg *msg;
+	uint32_t part_bit;
+	k_spinlock_key_t key;
+	int64_t now;
+	int ret = -EINPROGRESS;
+
+	if (data->type != SMS_TYPE_DELIVER || !concat->present) {
+		return 0;
+	}
+
+	if (concat->total_msgs > CONFIG_SMS_CONCAT_MAX_PARTS) {
+		LOG_WRN("Concatenated message (ref %d) has too many parts (%d), "
+			"delivering part %d as is",
+			concat->ref_number, concat->total_msgs, concat->seq_number);
+		return 0;
+	}
+
+	/* The header parser guarantees that the part is within the message. */
+	__ASSERT_NO_MSG(concat->seq_number >= 1 && concat->seq_number <= concat->total_msgs);
+	__ASSERT_NO_MSG(data->payload_len <= SMS_MAX_PAYLOAD_LEN_CHARS);
+
+	part_bit = BIT(concat->seq_number - 1);
+
+	key = k_spin_lock(&concat_lock);
+
+	now = k_uptime_get();
+
+	if (concat_passthrough_find(header, now)) {
+		LOG_DBG("Delivering part %d of concatenated message (ref %d) as is",
+			concat->seq_number, concat->ref_number);
+		ret = 0;
+		goto exit;
+	}
+
+	msg = concat_pool_get(header);
+	if (msg == NULL) {
+		LOG_WRN("No room for concatenated message (ref %d), delivering its parts as is",
+			concat->ref_number);
+		concat_passthrough_add(header, now);
+		ret = 0;
+		goto exit;
+	}
+
+	msg->timestamp = now;
+
+	if (msg->received_mask & part_bit) {
+		LOG_DBG("Duplicate part %d of concatenated message (ref %d) ignored",
+			concat->seq_number, concat->ref_number);
+		goto exit;
+	}
+
+	msg->received_mask |= part_bit;
+	msg->received_cnt++;
+	msg->part_time[concat->seq_number - 1] = header->time;
+	msg->part_len[concat->seq_number - 1] = data->payload_len;
+	memcpy(msg->part[concat->seq_number - 1], data->payload, data->payload_len);
+
+	/* Timestamp and other header information of the reassembled message are taken
+	 * from the first part.
+	 */
+	if (concat->seq_number == 1) {
+		msg->header = *header;
+	}
+
+	LOG_DBG("Stored part %d/%d of concatenated message (ref %d)",
+		concat->seq_number, concat->total_msgs, concat->ref_number);
+
+	if (msg->received_cnt == concat->total_msgs) {
+		concat_msg_assemble(msg, data);
+		ret = 0;
+	} else {
+		/* Does nothing if the worker is already scheduled for an earlier timeout. */
+		k_work_schedule(&concat_timeout_work, K_MSEC(CONCAT_TIMEOUT_MS));
+	}
+
+exit:
+	k_spin_unlock(&concat_lock, key);
+
+	return ret;
+}
+
+void sms_concat_flush(void)
+{
+	k_spinlock_key_t key;
+
+	k_work_cancel_delayable(&concat_timeout_work);
+
+	k_mutex_lock(&concat_flush_mutex, K_FOREVER);
+
+	for (size_t i = 0; i < ARRAY_SIZE(concat_pool); i++) {
+		key = k_spin_lock(&concat_lock);
+
+		if (!concat_pool[i].in_use) {
+			k_spin_unlock(&concat_lock, key);
+			continue;
+		}
+
+		concat_flush_msg = concat_pool[i];
+		concat_pool[i].in_use = false;
+
+		k_spin_unlock(&concat_lock, key);
+
+		LOG_DBG("Delivering %d/%d parts of concatenated message (ref %d) as they are",
+			concat_flush_msg.received_cnt,
+			concat_flush_msg.header.concatenated.total_msgs,
+			concat_flush_msg.header.concatenated.ref_number);
+
+		concat_msg_deliver_parts(&concat_flush_msg);
+	}
+
+	key = k_spin_lock(&concat_lock);
+	memset(concat_passthrough, 0, sizeof(concat_passthrough));
+	k_spin_unlock(&concat_lock, key);
+
+	k_mutex_unlock(&concat_flush_mutex);
+}
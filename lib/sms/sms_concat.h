@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _SMS_CONCAT_INCLUDE_H_
+#define _SMS_CONCAT_INCLUDE_H_
+
+/* Forward declaration */
+struct sms_data;
+
+/**
+ * @brief Process a received SMS-DELIVER message for concatenated message reassembly.
+ *
+ * @details Messages that are not part of a concatenated message are left untouched.
+ * A part of a concatenated message is stored into the reassembly pool until all parts
+ * of the message have been received. The part that completes the message is replaced
+ * with the reassembled message.
+ *
+ * If the message cannot be reassembled, because it has too many parts or the reassembly
+ * pool is full, the part is left untouched so that it is delivered to listeners as is.
+ * The later parts of a message that did not fit into the pool are also delivered as they
+ * are. If no new part of a partially received message is received within
+ * @kconfig{CONFIG_SMS_CONCAT_TIMEOUT} seconds, its parts are delivered to listeners as they
+ * are from the system workqueue.
+ *
+ * @param[in,out] data Received SMS message.
+ *
+ * @retval 0 Message in @p data is ready to be delivered to listeners.
+ * @retval -EINPROGRESS Part was stored and more parts are needed before the message
+ *         can be delivered.
+ */
+int sms_concat_process(struct sms_data *data);
+
+/**
+ * @brief Deliver all partially received concatenated messages to listeners.
+ *
+ * @details The received parts are delivered as they are, one by one, and the reassembly
+ * pool is emptied. Must not be called from an interrupt context.
+ */
+void sms_concat_flush(void);
+
+#endif
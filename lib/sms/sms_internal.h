@@ -29,4 +29,16 @@ extern uint8_t sms_buf_tmp[SMS_BUF_TMP_LEN];
  */
 extern uint8_t sms_payload_tmp[SMS_MAX_PAYLOAD_LEN_CHARS];
 
+/* Forward declaration */
+struct sms_data;
+
+/**
+ * @brief Notify SMS subscribers about a received message.
+ *
+ * @details Must not be called from an interrupt context.
+ *
+ * @param[in] data Received message.
+ */
+void sms_listeners_notify(struct sms_data *data);
+
 #endif
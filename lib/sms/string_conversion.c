@@ -325,29 +325,38 @@ uint8_t string_conversion_7bit_sms_unpacking(
 	uint8_t *unpacked,
 	uint8_t num_char)
 {
-	uint8_t shift = 1;
-	uint8_t index_pack = 1;
-	uint8_t index_char = 0;
+	uint16_t index_pack = 0;
+	uint16_t index_char = 0;
 
 	if ((packed == NULL) || (unpacked == NULL) || (num_char == 0)) {
 		return 0;
 	}
 
-	unpacked[0] = packed[0] & STR_7BIT_CODE_MASK;
-	index_char++;
-
+	/* Every 7 packed bytes hold exactly 8 septets. Each block is loaded into a single
+	 * 64-bit word from which the septets are extracted with a fixed shift, instead of
+	 * combining two neighbouring bytes for every character. The last block may be
+	 * partial in which case only the bytes holding the remaining septets are read.
+	 */
 	while (index_char < num_char) {
-		unpacked[index_char] =
-			(packed[index_pack] << shift) | (packed[index_pack - 1] >> (8 - shift));
-		unpacked[index_char] &= STR_7BIT_CODE_MASK;
+		uint8_t chars = num_char - index_char;
+		uint8_t bytes;
+		uint64_t word = 0;
 
-		shift++;
-		if (shift == 8) {
-			shift = 0;
-		} else {
-			index_pack++;
+		if (chars > 8) {
+			chars = 8;
+		}
+		bytes = (chars * 7 + 7) / 8;
+
+		for (uint8_t i = 0; i < bytes; i++) {
+			word |= (uint64_t)packed[index_pack + i] << (8 * i);
+		}
+
+		for (uint8_t i = 0; i < chars; i++) {
+			unpacked[index_char + i] = (word >> (7 * i)) & STR_7BIT_CODE_MASK;
 		}
-		index_char++;
+
+		index_pack += 7;
+		index_char += chars;
 	}
 
 	return index_char;
@@ -4,43 +4,125 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <string.h>
 #include <bluetooth/mesh/light_ctrl_reg_spec.h>
 
 #define REG_INT CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_INTERVAL
 
+#if defined(CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_FIXED_POINT)
+/* Q16.16 values in 64-bit containers, so that the products of lux levels and
+ * coefficients never overflow. The floating-point inputs are converted only
+ * when they change, so a regulator step is integer-only as long as the
+ * configuration, measured value and target stay the same.
+ */
+typedef int64_t reg_val_t;
+
+#define REG_Q_ONE (1LL << 16)
+#define REG_IN(_spec_reg, _name, _f) reg_in_get(&(_spec_reg)->in._name, (_f))
+#define REG_UINT(_u) ((int64_t)(_u) * REG_Q_ONE)
+#define REG_MUL(_a, _b) (((_a) * (_b)) / REG_Q_ONE)
+#define REG_INT_SCALE(_v) (((_v) * REG_INT) / MSEC_PER_SEC)
+
+static int64_t reg_in_get(struct bt_mesh_light_ctrl_reg_spec_val *val, float f)
+{
+	uint32_t bits;
+
+	/* Compare the bit patterns, as float comparison is as costly as the conversion. */
+	memcpy(&bits, &f, sizeof(bits));
+	if (bits != val->bits) {
+		val->bits = bits;
+		val->q = (int64_t)(f * (float)REG_Q_ONE);
+	}
+
+	return val->q;
+}
+
+static reg_val_t reg_target_get(struct bt_mesh_light_ctrl_reg_spec *spec_reg)
+{
+	struct bt_mesh_light_ctrl_reg *reg = &spec_reg->reg;
+	int64_t target = REG_IN(spec_reg, target, reg->target);
+	int64_t prev_target;
+	int32_t elapsed;
+
+	/* Same interpolation as bt_mesh_light_ctrl_reg_target_get(). */
+	if (reg->transition_time == 0) {
+		return target;
+	}
+
+	elapsed = k_uptime_get() - reg->transition_start;
+	if (elapsed >= reg->transition_time) {
+		reg->transition_time = 0;
+		return target;
+	}
+
+	prev_target = REG_IN(spec_reg, prev_target, reg->prev_target);
+
+	return prev_target + (elapsed * (target - prev_target)) / reg->transition_time;
+}
+
+static float reg_output_get(struct bt_mesh_light_ctrl_reg_spec *spec_reg, reg_val_t output)
+{
+	if (output != spec_reg->out_q) {
+		spec_reg->out_q = output;
+		spec_reg->out = (float)output / (float)REG_Q_ONE;
+	}
+
+	return spec_reg->out;
+}
+#else
+typedef float reg_val_t;
+
+#define REG_IN(_spec_reg, _name, _f) (_f)
+#define REG_UINT(_u) (_u)
+#define REG_MUL(_a, _b) ((_a) * (_b))
+#define REG_INT_SCALE(_v) ((_v) * ((float)REG_INT / (float)MSEC_PER_SEC))
+
+static reg_val_t reg_target_get(struct bt_mesh_light_ctrl_reg_spec *spec_reg)
+{
+	return bt_mesh_light_ctrl_reg_target_get(&spec_reg->reg);
+}
+
+static float reg_output_get(struct bt_mesh_light_ctrl_reg_spec *spec_reg, reg_val_t output)
+{
+	return output;
+}
+#endif
+
 struct reg_terms {
-	float i;
-	float p;
+	reg_val_t i;
+	reg_val_t p;
 };
 
 static struct reg_terms reg_terms_calc(struct bt_mesh_light_ctrl_reg_spec *spec_reg)
 {
-	float target = bt_mesh_light_ctrl_reg_target_get(&spec_reg->reg);
-	float error = target - spec_reg->reg.measured;
+	struct bt_mesh_light_ctrl_reg_cfg *cfg = &spec_reg->reg.cfg;
+	reg_val_t target = reg_target_get(spec_reg);
+	reg_val_t error = target - REG_IN(spec_reg, measured, spec_reg->reg.measured);
 	/* Accuracy should be in percent and both up and down: */
-	float accuracy = (spec_reg->reg.cfg.accuracy * target) / (2 * 100.0f);
-	float input;
-	float kp, ki;
+	reg_val_t accuracy =
+		REG_MUL(REG_IN(spec_reg, accuracy, cfg->accuracy), target) / (2 * 100);
+	reg_val_t input;
+	reg_val_t kp, ki;
 
 	if (error > accuracy) {
 		input = error - accuracy;
 	} else if (error < -accuracy) {
 		input = error + accuracy;
 	} else {
-		input = 0.0f;
+		input = 0;
 	}
 
 	if (input >= 0) {
-		kp = spec_reg->reg.cfg.kp.up;
-		ki = spec_reg->reg.cfg.ki.up;
+		kp = REG_IN(spec_reg, kp_up, cfg->kp.up);
+		ki = REG_IN(spec_reg, ki_up, cfg->ki.up);
 	} else {
-		kp = spec_reg->reg.cfg.kp.down;
-		ki = spec_reg->reg.cfg.ki.down;
+		kp = REG_IN(spec_reg, kp_down, cfg->kp.down);
+		ki = REG_IN(spec_reg, ki_down, cfg->ki.down);
 	}
 
 	return (struct reg_terms){
-		.i = ((input) * (ki) * ((float)REG_INT / (float)MSEC_PER_SEC)),
-		.p = input * kp,
+		.i = REG_INT_SCALE(REG_MUL(input, ki)),
+		.p = REG_MUL(input, kp),
 	};
 }
 
@@ -67,10 +149,10 @@ static void reg_step(struct k_work *work)
 	}
 
 	if (!spec_reg->neg) {
-		spec_reg->i = CLAMP(spec_reg->i, 0, UINT16_MAX);
+		spec_reg->i = CLAMP(spec_reg->i, 0, REG_UINT(UINT16_MAX));
 	}
 
-	float output = spec_reg->i + reg_terms.p;
+	float output = reg_output_get(spec_reg, spec_reg->i + reg_terms.p);
 
 	spec_reg->reg.updated(&spec_reg->reg, output);
 }
@@ -84,7 +166,7 @@ static void internal_sum_recover(struct bt_mesh_light_ctrl_reg_spec *spec_reg, u
 	/* Recalculate the internal sum so that it is equal to the passed lightness level at the
 	 * next regulator step.
 	 */
-	spec_reg->i = lightness - reg_terms.i;
+	spec_reg->i = REG_UINT(lightness) - reg_terms.i;
 	/* Allow the internal sum to be negative until it becomes positive. */
 	spec_reg->neg = true;
 }
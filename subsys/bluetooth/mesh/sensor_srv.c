@@ -24,12 +24,21 @@ LOG_MODULE_REGISTER(bt_mesh_sensor_srv);
 static struct bt_mesh_sensor *sensor_get(struct bt_mesh_sensor_srv *srv,
 					 uint16_t id)
 {
-	struct bt_mesh_sensor *sensor;
+	size_t low = 0;
+	size_t high = srv->sensor_count;
 
-	SENSOR_FOR_EACH(&srv->sensors, sensor)
-	{
-		if (sensor->type->id == id) {
-			return sensor;
+	while (low < high) {
+		size_t mid = low + (high - low) / 2;
+		uint16_t mid_id = srv->sorted[mid]->type->id;
+
+		if (mid_id == id) {
+			return srv->sorted[mid];
+		}
+
+		if (mid_id < id) {
+			low = mid + 1;
+		} else {
+			high = mid;
 		}
 	}
 
@@ -997,6 +1006,12 @@ static int sensor_srv_init(const struct bt_mesh_model *model)
 	 */
 	uint16_t min_id = 0;
 
+	if (srv->sensor_count > ARRAY_SIZE(srv->sorted)) {
+		LOG_WRN("Too many sensors, ignoring %u",
+			srv->sensor_count - ARRAY_SIZE(srv->sorted));
+		srv->sensor_count = ARRAY_SIZE(srv->sorted);
+	}
+
 	for (int count = 0; count < srv->sensor_count; ++count) {
 		struct bt_mesh_sensor *best = NULL;
 
@@ -1014,6 +1029,7 @@ static int sensor_srv_init(const struct bt_mesh_model *model)
 			break;
 		}
 
+		srv->sorted[count] = best;
 		sys_slist_append(&srv->sensors, &best->state.node);
 		LOG_DBG("Sensor 0x%04x", best->type->id);
 		min_id = best->type->id + 1;
@@ -31,9 +31,17 @@
 #define FORMAT(_name)                                                          \
 	const struct bt_mesh_sensor_format bt_mesh_sensor_format_##_name
 
-#define SENSOR_TYPE(name)                                                      \
-	const STRUCT_SECTION_ITERABLE(bt_mesh_sensor_type,                     \
-					bt_mesh_sensor_##name)
+/* The sensor types are placed in sections named after their ID, which the
+ * linker sorts, allowing bt_mesh_sensor_type_get() to do a binary search.
+ * The ID is given once, so the section name always matches it.
+ */
+#define SENSOR_TYPE(name, _id, ...)                                            \
+	const STRUCT_SECTION_ITERABLE_NAMED(bt_mesh_sensor_type,               \
+					    _CONCAT(id_, _id),                 \
+					    bt_mesh_sensor_##name) = {         \
+		.id = _id,                                                     \
+		__VA_ARGS__                                                    \
+	}
 
 #ifdef CONFIG_BT_MESH_SENSOR_LABELS
 
@@ -1552,473 +1560,416 @@ static const struct bt_mesh_sensor_channel voltage_stats[] = {
 /*******************************************************************************
  * Occupancy
  ******************************************************************************/
-SENSOR_TYPE(motion_sensed) = {
-	.id = BT_MESH_PROP_ID_MOTION_SENSED,
+SENSOR_TYPE(motion_sensed, BT_MESH_PROP_ID_MOTION_SENSED,
 	CHANNELS(CHANNEL("Motion sensed", percentage_8)),
-};
-SENSOR_TYPE(motion_threshold) = {
-	.id = BT_MESH_PROP_ID_MOTION_THRESHOLD,
+);
+SENSOR_TYPE(motion_threshold, BT_MESH_PROP_ID_MOTION_THRESHOLD,
 	CHANNELS(CHANNEL("Motion threshold", percentage_8)),
-};
-SENSOR_TYPE(people_count) = {
-	.id = BT_MESH_PROP_ID_PEOPLE_COUNT,
+);
+SENSOR_TYPE(people_count, BT_MESH_PROP_ID_PEOPLE_COUNT,
 	CHANNELS(CHANNEL("People count", count_16)),
-};
-SENSOR_TYPE(presence_detected) = {
-	.id = BT_MESH_PROP_ID_PRESENCE_DETECTED,
+);
+SENSOR_TYPE(presence_detected, BT_MESH_PROP_ID_PRESENCE_DETECTED,
 	CHANNELS(CHANNEL("Presence detected", boolean)),
-};
-SENSOR_TYPE(time_since_motion_sensed) = {
-	.id = BT_MESH_PROP_ID_TIME_SINCE_MOTION_SENSED,
+);
+SENSOR_TYPE(time_since_motion_sensed, BT_MESH_PROP_ID_TIME_SINCE_MOTION_SENSED,
 	CHANNELS(CHANNEL("Time since motion detected", time_millisecond_24)),
-};
-SENSOR_TYPE(time_since_presence_detected) = {
-	.id = BT_MESH_PROP_ID_TIME_SINCE_PRESENCE_DETECTED,
+);
+SENSOR_TYPE(time_since_presence_detected, BT_MESH_PROP_ID_TIME_SINCE_PRESENCE_DETECTED,
 	CHANNELS(CHANNEL("Time since presence detected", time_second_16)),
-};
+);
 
 /*******************************************************************************
  * Ambient temperature
  ******************************************************************************/
-SENSOR_TYPE(avg_amb_temp_in_day) = {
-	.id = BT_MESH_PROP_ID_AVG_AMB_TEMP_IN_A_PERIOD_OF_DAY,
+SENSOR_TYPE(avg_amb_temp_in_day, BT_MESH_PROP_ID_AVG_AMB_TEMP_IN_A_PERIOD_OF_DAY,
 	CHANNELS(CHANNEL("Temperature", temp_8),
 		 CHANNEL("Start time", time_decihour_8),
 		 CHANNEL("End time", time_decihour_8)),
-};
-SENSOR_TYPE(indoor_amb_temp_stat_values) = {
-	.id = BT_MESH_PROP_ID_INDOOR_AMB_TEMP_STAT_VALUES,
+);
+SENSOR_TYPE(indoor_amb_temp_stat_values, BT_MESH_PROP_ID_INDOOR_AMB_TEMP_STAT_VALUES,
 	CHANNELS(CHANNEL("Avg", temp_8),
 		 CHANNEL("Standard deviation", temp_8),
 		 CHANNEL("Min", temp_8),
 		 CHANNEL("Max", temp_8),
 		 CHANNEL("Sensing duration", time_exp_8)),
-};
-SENSOR_TYPE(outdoor_stat_values) = {
-	.id = BT_MESH_PROP_ID_OUTDOOR_STAT_VALUES,
+);
+SENSOR_TYPE(outdoor_stat_values, BT_MESH_PROP_ID_OUTDOOR_STAT_VALUES,
 	CHANNELS(CHANNEL("Avg", temp_8),
 		 CHANNEL("Standard deviation", temp_8),
 		 CHANNEL("Min", temp_8),
 		 CHANNEL("Max", temp_8),
 		 CHANNEL("Sensing duration", time_exp_8)),
-};
-SENSOR_TYPE(present_amb_temp) = {
-	.id = BT_MESH_PROP_ID_PRESENT_AMB_TEMP,
+);
+SENSOR_TYPE(present_amb_temp, BT_MESH_PROP_ID_PRESENT_AMB_TEMP,
 	CHANNELS(CHANNEL("Present ambient temperature", temp_8)),
-};
-SENSOR_TYPE(present_indoor_amb_temp) = {
-	.id = BT_MESH_PROP_ID_PRESENT_INDOOR_AMB_TEMP,
+);
+SENSOR_TYPE(present_indoor_amb_temp, BT_MESH_PROP_ID_PRESENT_INDOOR_AMB_TEMP,
 	CHANNELS(CHANNEL("Present indoor ambient temperature", temp_8)),
-};
-SENSOR_TYPE(present_outdoor_amb_temp) = {
-	.id = BT_MESH_PROP_ID_PRESENT_OUTDOOR_AMB_TEMP,
+);
+SENSOR_TYPE(present_outdoor_amb_temp, BT_MESH_PROP_ID_PRESENT_OUTDOOR_AMB_TEMP,
 	CHANNELS(CHANNEL("Present outdoor ambient temperature", temp_8)),
-};
-SENSOR_TYPE(desired_amb_temp) = {
-	.id = BT_MESH_PROP_ID_DESIRED_AMB_TEMP,
+);
+SENSOR_TYPE(desired_amb_temp, BT_MESH_PROP_ID_DESIRED_AMB_TEMP,
 	CHANNELS(CHANNEL("Desired ambient temperature", temp_8)),
-};
-SENSOR_TYPE(precise_present_amb_temp) = {
-	.id = BT_MESH_PROP_ID_PRECISE_PRESENT_AMB_TEMP,
+);
+SENSOR_TYPE(precise_present_amb_temp, BT_MESH_PROP_ID_PRECISE_PRESENT_AMB_TEMP,
 	CHANNELS(CHANNEL("Precise present ambient temperature", temp)),
-};
+);
 
 /*******************************************************************************
  * Environmental
  ******************************************************************************/
-SENSOR_TYPE(apparent_wind_direction) = {
-	.id = BT_MESH_PROP_ID_APPARENT_WIND_DIRECTION,
+SENSOR_TYPE(apparent_wind_direction, BT_MESH_PROP_ID_APPARENT_WIND_DIRECTION,
 	CHANNELS(CHANNEL("Apparent Wind Direction", direction_16)),
-};
-SENSOR_TYPE(apparent_wind_speed) = {
-	.id = BT_MESH_PROP_ID_APPARENT_WIND_SPEED,
+);
+SENSOR_TYPE(apparent_wind_speed, BT_MESH_PROP_ID_APPARENT_WIND_SPEED,
 	CHANNELS(CHANNEL("Apparent Wind Speed", wind_speed)),
-};
-SENSOR_TYPE(dew_point) = {
-	.id = BT_MESH_PROP_ID_DEW_POINT,
+);
+SENSOR_TYPE(dew_point, BT_MESH_PROP_ID_DEW_POINT,
 	CHANNELS(CHANNEL("Dew Point", temp_8_wide)),
-};
-SENSOR_TYPE(gust_factor) = {
-	.id = BT_MESH_PROP_ID_GUST_FACTOR,
+);
+SENSOR_TYPE(gust_factor, BT_MESH_PROP_ID_GUST_FACTOR,
 	CHANNELS(CHANNEL("Gust Factor", gust_factor)),
-};
-SENSOR_TYPE(heat_index) = {
-	.id = BT_MESH_PROP_ID_HEAT_INDEX,
+);
+SENSOR_TYPE(heat_index, BT_MESH_PROP_ID_HEAT_INDEX,
 	CHANNELS(CHANNEL("Heat Index", temp_8_wide)),
-};
-SENSOR_TYPE(present_amb_rel_humidity) = {
-	.id = BT_MESH_PROP_ID_PRESENT_AMB_REL_HUMIDITY,
+);
+SENSOR_TYPE(present_amb_rel_humidity, BT_MESH_PROP_ID_PRESENT_AMB_REL_HUMIDITY,
 	CHANNELS(CHANNEL("Present ambient relative humidity", percentage_16)),
-};
-SENSOR_TYPE(present_amb_co2_concentration) = {
-	.id = BT_MESH_PROP_ID_PRESENT_AMB_CO2_CONCENTRATION,
+);
+SENSOR_TYPE(present_amb_co2_concentration, BT_MESH_PROP_ID_PRESENT_AMB_CO2_CONCENTRATION,
 	CHANNELS(CHANNEL("Present ambient CO2 concentration",
 			 co2_concentration)),
-};
-SENSOR_TYPE(present_amb_voc_concentration) = {
-	.id = BT_MESH_PROP_ID_PRESENT_AMB_VOC_CONCENTRATION,
+);
+SENSOR_TYPE(present_amb_voc_concentration, BT_MESH_PROP_ID_PRESENT_AMB_VOC_CONCENTRATION,
 	CHANNELS(CHANNEL("Present ambient VOC concentration",
 			 voc_concentration)),
-};
-SENSOR_TYPE(present_amb_noise) = {
-	.id = BT_MESH_PROP_ID_PRESENT_AMB_NOISE,
+);
+SENSOR_TYPE(present_amb_noise, BT_MESH_PROP_ID_PRESENT_AMB_NOISE,
 	CHANNELS(CHANNEL("Present ambient noise", noise)),
-};
-SENSOR_TYPE(present_indoor_relative_humidity) = {
-	.id = BT_MESH_PROP_ID_PRESENT_INDOOR_RELATIVE_HUMIDITY,
+);
+SENSOR_TYPE(present_indoor_relative_humidity, BT_MESH_PROP_ID_PRESENT_INDOOR_RELATIVE_HUMIDITY,
 	CHANNELS(CHANNEL("Humidity", percentage_16)),
-};
-SENSOR_TYPE(present_outdoor_relative_humidity) = {
-	.id = BT_MESH_PROP_ID_PRESENT_OUTDOOR_RELATIVE_HUMIDITY,
+);
+SENSOR_TYPE(present_outdoor_relative_humidity,
+	    BT_MESH_PROP_ID_PRESENT_OUTDOOR_RELATIVE_HUMIDITY,
 	CHANNELS(CHANNEL("Humidity", percentage_16)),
-};
-SENSOR_TYPE(magnetic_declination) = {
-	.id = BT_MESH_PROP_ID_MAGNETIC_DECLINATION,
+);
+SENSOR_TYPE(magnetic_declination, BT_MESH_PROP_ID_MAGNETIC_DECLINATION,
 	CHANNELS(CHANNEL("Magnetic Declination", direction_16)),
-};
-SENSOR_TYPE(magnetic_flux_density_2d) = {
-	.id = BT_MESH_PROP_ID_MAGNETIC_FLUX_DENSITY_2D,
+);
+SENSOR_TYPE(magnetic_flux_density_2d, BT_MESH_PROP_ID_MAGNETIC_FLUX_DENSITY_2D,
 	CHANNELS(CHANNEL("X-axis", magnetic_flux_density),
 		 CHANNEL("Y-axis", magnetic_flux_density)),
-};
-SENSOR_TYPE(magnetic_flux_density_3d) = {
-	.id = BT_MESH_PROP_ID_MAGNETIC_FLUX_DENSITY_3D,
+);
+SENSOR_TYPE(magnetic_flux_density_3d, BT_MESH_PROP_ID_MAGNETIC_FLUX_DENSITY_3D,
 	CHANNELS(CHANNEL("X-axis", magnetic_flux_density),
 		 CHANNEL("Y-axis", magnetic_flux_density),
 		 CHANNEL("Z-axis", magnetic_flux_density)),
-};
-SENSOR_TYPE(pollen_concentration) = {
-	.id = BT_MESH_PROP_ID_POLLEN_CONCENTRATION,
+);
+SENSOR_TYPE(pollen_concentration, BT_MESH_PROP_ID_POLLEN_CONCENTRATION,
 	CHANNELS(CHANNEL("Pollen Concentration", pollen_concentration)),
-};
-SENSOR_TYPE(air_pressure) = {
-	.id = BT_MESH_PROP_ID_AIR_PRESSURE,
+);
+SENSOR_TYPE(air_pressure, BT_MESH_PROP_ID_AIR_PRESSURE,
 	CHANNELS(CHANNEL("Pressure", pressure)),
-};
-SENSOR_TYPE(pressure) = {
-	.id = BT_MESH_PROP_ID_PRESSURE,
+);
+SENSOR_TYPE(pressure, BT_MESH_PROP_ID_PRESSURE,
 	CHANNELS(CHANNEL("Pressure", pressure)),
-};
-SENSOR_TYPE(rainfall) = {
-	.id = BT_MESH_PROP_ID_RAINFALL,
+);
+SENSOR_TYPE(rainfall, BT_MESH_PROP_ID_RAINFALL,
 	CHANNELS(CHANNEL("Rainfall", rainfall)),
-};
-SENSOR_TYPE(true_wind_direction) = {
-	.id = BT_MESH_PROP_ID_TRUE_WIND_DIRECTION,
+);
+SENSOR_TYPE(true_wind_direction, BT_MESH_PROP_ID_TRUE_WIND_DIRECTION,
 	CHANNELS(CHANNEL("True Wind Direction", direction_16)),
-};
-SENSOR_TYPE(true_wind_speed) = {
-	.id = BT_MESH_PROP_ID_TRUE_WIND_SPEED,
+);
+SENSOR_TYPE(true_wind_speed, BT_MESH_PROP_ID_TRUE_WIND_SPEED,
 	CHANNELS(CHANNEL("True Wind Speed", wind_speed)),
-};
-SENSOR_TYPE(uv_index) = {
-	.id = BT_MESH_PROP_ID_UV_INDEX,
+);
+SENSOR_TYPE(uv_index, BT_MESH_PROP_ID_UV_INDEX,
 	CHANNELS(CHANNEL("UV Index", uv_index)),
-};
-SENSOR_TYPE(wind_chill) = {
-	.id = BT_MESH_PROP_ID_WIND_CHILL,
+);
+SENSOR_TYPE(wind_chill, BT_MESH_PROP_ID_WIND_CHILL,
 	CHANNELS(CHANNEL("Wind Chill", temp_8_wide)),
-};
+);
 
 /*******************************************************************************
  * Device operating temperature
  ******************************************************************************/
-SENSOR_TYPE(dev_op_temp_range_spec) = {
-	.id = BT_MESH_PROP_ID_DEV_OP_TEMP_RANGE_SPEC,
+SENSOR_TYPE(dev_op_temp_range_spec, BT_MESH_PROP_ID_DEV_OP_TEMP_RANGE_SPEC,
 	CHANNELS(CHANNEL("Min", temp),
 		 CHANNEL("Max", temp)),
-};
-SENSOR_TYPE(dev_op_temp_stat_values) = {
-	.id = BT_MESH_PROP_ID_DEV_OP_TEMP_STAT_VALUES,
+);
+SENSOR_TYPE(dev_op_temp_stat_values, BT_MESH_PROP_ID_DEV_OP_TEMP_STAT_VALUES,
 	CHANNELS(CHANNEL("Avg", temp),
 		 CHANNEL("Standard deviation", temp),
 		 CHANNEL("Min", temp),
 		 CHANNEL("Max", temp),
 		 CHANNEL("Sensing duration", time_exp_8)),
-};
-SENSOR_TYPE(present_dev_op_temp) = {
-	.id = BT_MESH_PROP_ID_PRESENT_DEV_OP_TEMP,
+);
+SENSOR_TYPE(present_dev_op_temp, BT_MESH_PROP_ID_PRESENT_DEV_OP_TEMP,
 	CHANNELS(CHANNEL("Temperature", temp)),
-};
+);
 
-SENSOR_TYPE(rel_runtime_in_a_dev_op_temp_range) = {
-	.id = BT_MESH_PROP_ID_REL_RUNTIME_IN_A_DEV_OP_TEMP_RANGE,
+SENSOR_TYPE(rel_runtime_in_a_dev_op_temp_range,
+	    BT_MESH_PROP_ID_REL_RUNTIME_IN_A_DEV_OP_TEMP_RANGE,
 	CHANNELS(CHANNEL("Relative value", percentage_8),
 		 CHANNEL("Min", temp),
 		 CHANNEL("Max", temp))
-};
+);
 
 /*******************************************************************************
  * Electrical input
  ******************************************************************************/
-SENSOR_TYPE(avg_input_current) = {
-	.id = BT_MESH_PROP_ID_AVG_INPUT_CURRENT,
+SENSOR_TYPE(avg_input_current, BT_MESH_PROP_ID_AVG_INPUT_CURRENT,
 	CHANNELS(CHANNEL("Electric current value", electric_current),
 		 CHANNEL("Sensing duration", time_exp_8)),
-};
-SENSOR_TYPE(avg_input_voltage) = {
-	.id = BT_MESH_PROP_ID_AVG_INPUT_VOLTAGE,
+);
+SENSOR_TYPE(avg_input_voltage, BT_MESH_PROP_ID_AVG_INPUT_VOLTAGE,
 	CHANNELS(CHANNEL("Voltage value", voltage),
 		 CHANNEL("Sensing duration", time_exp_8)),
-};
-SENSOR_TYPE(input_current_range_spec) = {
-	.id = BT_MESH_PROP_ID_INPUT_CURRENT_RANGE_SPEC,
+);
+SENSOR_TYPE(input_current_range_spec, BT_MESH_PROP_ID_INPUT_CURRENT_RANGE_SPEC,
 	CHANNELS(CHANNEL("Min", electric_current),
 		 CHANNEL("Typical electric current value", electric_current),
 		 CHANNEL("Max", electric_current)),
-};
-SENSOR_TYPE(input_current_stat) = {
-	.id = BT_MESH_PROP_ID_INPUT_CURRENT_STAT,
+);
+SENSOR_TYPE(input_current_stat, BT_MESH_PROP_ID_INPUT_CURRENT_STAT,
 	.channel_count = ARRAY_SIZE(electric_current_stats),
 	.channels = electric_current_stats,
-};
-SENSOR_TYPE(input_voltage_range_spec) = {
-	.id = BT_MESH_PROP_ID_INPUT_VOLTAGE_RANGE_SPEC,
+);
+SENSOR_TYPE(input_voltage_range_spec, BT_MESH_PROP_ID_INPUT_VOLTAGE_RANGE_SPEC,
 	CHANNELS(CHANNEL("Min", voltage),
 		 CHANNEL("Typical voltage value", voltage),
 		 CHANNEL("Max", voltage)),
-};
-SENSOR_TYPE(input_voltage_stat) = {
-	.id = BT_MESH_PROP_ID_INPUT_VOLTAGE_STAT,
+);
+SENSOR_TYPE(input_voltage_stat, BT_MESH_PROP_ID_INPUT_VOLTAGE_STAT,
 	.channel_count = ARRAY_SIZE(voltage_stats),
 	.channels = voltage_stats,
-};
-SENSOR_TYPE(present_input_current) = {
-	.id = BT_MESH_PROP_ID_PRESENT_INPUT_CURRENT,
+);
+SENSOR_TYPE(present_input_current, BT_MESH_PROP_ID_PRESENT_INPUT_CURRENT,
 	CHANNELS(CHANNEL("Present input current", electric_current)),
-};
-SENSOR_TYPE(present_input_ripple_voltage) = {
-	.id = BT_MESH_PROP_ID_PRESENT_INPUT_RIPPLE_VOLTAGE,
+);
+SENSOR_TYPE(present_input_ripple_voltage, BT_MESH_PROP_ID_PRESENT_INPUT_RIPPLE_VOLTAGE,
 	CHANNELS(CHANNEL("Present input ripple voltage", percentage_8)),
-};
-SENSOR_TYPE(present_input_voltage) = {
-	.id = BT_MESH_PROP_ID_PRESENT_INPUT_VOLTAGE,
+);
+SENSOR_TYPE(present_input_voltage, BT_MESH_PROP_ID_PRESENT_INPUT_VOLTAGE,
 	CHANNELS(CHANNEL("Present input voltage", voltage)),
-};
-SENSOR_TYPE(rel_runtime_in_an_input_current_range) = {
-	.id = BT_MESH_PROP_ID_REL_RUNTIME_IN_AN_INPUT_CURRENT_RANGE,
+);
+SENSOR_TYPE(rel_runtime_in_an_input_current_range,
+	    BT_MESH_PROP_ID_REL_RUNTIME_IN_AN_INPUT_CURRENT_RANGE,
 	CHANNELS(CHANNEL("Relative runtime value", percentage_8),
 		 CHANNEL("Min", electric_current),
 		 CHANNEL("Max", electric_current)),
-};
+);
 
-SENSOR_TYPE(rel_runtime_in_an_input_voltage_range) = {
-	.id = BT_MESH_PROP_ID_REL_RUNTIME_IN_AN_INPUT_VOLTAGE_RANGE,
+SENSOR_TYPE(rel_runtime_in_an_input_voltage_range,
+	    BT_MESH_PROP_ID_REL_RUNTIME_IN_AN_INPUT_VOLTAGE_RANGE,
 	CHANNELS(CHANNEL("Relative runtime value", percentage_8),
 		 CHANNEL("Min", voltage),
 		 CHANNEL("Max", voltage)),
-};
+);
 
 /*******************************************************************************
  * Energy management
  ******************************************************************************/
-SENSOR_TYPE(dev_power_range_spec) = {
-	.id = BT_MESH_PROP_ID_DEV_POWER_RANGE_SPEC,
+SENSOR_TYPE(dev_power_range_spec, BT_MESH_PROP_ID_DEV_POWER_RANGE_SPEC,
 	CHANNELS(CHANNEL("Min power value", power),
 		 CHANNEL("Typical power value", power),
 		 CHANNEL("Max power value", power)),
-};
-SENSOR_TYPE(present_dev_input_power) = {
-	.id = BT_MESH_PROP_ID_PRESENT_DEV_INPUT_POWER,
+);
+SENSOR_TYPE(present_dev_input_power, BT_MESH_PROP_ID_PRESENT_DEV_INPUT_POWER,
 	CHANNELS(CHANNEL("Present device input power", power)),
-};
-SENSOR_TYPE(present_dev_op_efficiency) = {
-	.id = BT_MESH_PROP_ID_PRESENT_DEV_OP_EFFICIENCY,
+);
+SENSOR_TYPE(present_dev_op_efficiency, BT_MESH_PROP_ID_PRESENT_DEV_OP_EFFICIENCY,
 	CHANNELS(CHANNEL("Present device operating efficiency", percentage_8)),
-};
-SENSOR_TYPE(tot_dev_energy_use) = {
-	.id = BT_MESH_PROP_ID_TOT_DEV_ENERGY_USE,
+);
+SENSOR_TYPE(tot_dev_energy_use, BT_MESH_PROP_ID_TOT_DEV_ENERGY_USE,
 	CHANNELS(CHANNEL("Total device energy use", energy)),
-};
-SENSOR_TYPE(precise_tot_dev_energy_use) = {
-	.id = BT_MESH_PROP_ID_PRECISE_TOT_DEV_ENERGY_USE,
+);
+SENSOR_TYPE(precise_tot_dev_energy_use, BT_MESH_PROP_ID_PRECISE_TOT_DEV_ENERGY_USE,
 	CHANNELS(CHANNEL("Total device energy use", energy32)),
-};
-SENSOR_TYPE(dev_energy_use_since_turn_on) = {
-	.id = BT_MESH_PROP_ID_DEV_ENERGY_USE_SINCE_TURN_ON,
+);
+SENSOR_TYPE(dev_energy_use_since_turn_on, BT_MESH_PROP_ID_DEV_ENERGY_USE_SINCE_TURN_ON,
 	CHANNELS(CHANNEL("Device energy use since turn on", energy)),
-};
-SENSOR_TYPE(power_factor) = {
-	.id = BT_MESH_PROP_ID_POWER_FACTOR,
+);
+SENSOR_TYPE(power_factor, BT_MESH_PROP_ID_POWER_FACTOR,
 	CHANNELS(CHANNEL("Cosine of the angle", cos_of_the_angle)),
-};
-SENSOR_TYPE(rel_dev_energy_use_in_a_period_of_day) = {
-	.id = BT_MESH_PROP_ID_REL_DEV_ENERGY_USE_IN_A_PERIOD_OF_DAY,
+);
+SENSOR_TYPE(rel_dev_energy_use_in_a_period_of_day,
+	    BT_MESH_PROP_ID_REL_DEV_ENERGY_USE_IN_A_PERIOD_OF_DAY,
 	CHANNELS(CHANNEL("Energy", energy),
 		 CHANNEL("Start time", time_decihour_8),
 		 CHANNEL("End time", time_decihour_8)),
-};
-SENSOR_TYPE(apparent_energy) = {
-	.id = BT_MESH_PROP_ID_APPARENT_ENERGY,
+);
+SENSOR_TYPE(apparent_energy, BT_MESH_PROP_ID_APPARENT_ENERGY,
 	CHANNELS(CHANNEL("Apparent energy", apparent_energy32)),
-};
-SENSOR_TYPE(apparent_power) = {
-	.id = BT_MESH_PROP_ID_APPARENT_POWER,
+);
+SENSOR_TYPE(apparent_power, BT_MESH_PROP_ID_APPARENT_POWER,
 	CHANNELS(CHANNEL("Apparent power", apparent_power)),
-};
-SENSOR_TYPE(active_energy_loadside) = {
-	.id = BT_MESH_PROP_ID_ACTIVE_ENERGY_LOADSIDE,
+);
+SENSOR_TYPE(active_energy_loadside, BT_MESH_PROP_ID_ACTIVE_ENERGY_LOADSIDE,
 	CHANNELS(CHANNEL("Energy", energy32)),
-};
-SENSOR_TYPE(active_power_loadside) = {
-	.id = BT_MESH_PROP_ID_ACTIVE_POWER_LOADSIDE,
+);
+SENSOR_TYPE(active_power_loadside, BT_MESH_PROP_ID_ACTIVE_POWER_LOADSIDE,
 	CHANNELS(CHANNEL("Power", power)),
-};
+);
 
 /*******************************************************************************
  * Photometry
  ******************************************************************************/
-SENSOR_TYPE(present_amb_light_level) = {
-	.id = BT_MESH_PROP_ID_PRESENT_AMB_LIGHT_LEVEL,
+SENSOR_TYPE(present_amb_light_level, BT_MESH_PROP_ID_PRESENT_AMB_LIGHT_LEVEL,
 	CHANNELS(CHANNEL("Present ambient light level", illuminance)),
-};
-SENSOR_TYPE(initial_cie_1931_chromaticity_coords) = {
-	.id = BT_MESH_PROP_ID_INITIAL_CIE_1931_CHROMATICITY_COORDS,
+);
+SENSOR_TYPE(initial_cie_1931_chromaticity_coords,
+	    BT_MESH_PROP_ID_INITIAL_CIE_1931_CHROMATICITY_COORDS,
 	CHANNELS(CHANNEL("Initial CIE 1931 chromaticity x-coordinate", chromaticity_coordinate),
 		 CHANNEL("Initial CIE 1931 chromaticity y-coordinate", chromaticity_coordinate)),
-};
-SENSOR_TYPE(present_cie_1931_chromaticity_coords) = {
-	.id = BT_MESH_PROP_ID_PRESENT_CIE_1931_CHROMATICITY_COORDS,
+);
+SENSOR_TYPE(present_cie_1931_chromaticity_coords,
+	    BT_MESH_PROP_ID_PRESENT_CIE_1931_CHROMATICITY_COORDS,
 	CHANNELS(CHANNEL("Present CIE 1931 chromaticity x-coordinate", chromaticity_coordinate),
 		 CHANNEL("Present CIE 1931 chromaticity y-coordinate", chromaticity_coordinate)),
-};
-SENSOR_TYPE(initial_correlated_col_temp) = {
-	.id = BT_MESH_PROP_ID_INITIAL_CORRELATED_COL_TEMP,
+);
+SENSOR_TYPE(initial_correlated_col_temp, BT_MESH_PROP_ID_INITIAL_CORRELATED_COL_TEMP,
 	CHANNELS(CHANNEL("Initial correlated color temperature",
 			 correlated_color_temp)),
-};
-SENSOR_TYPE(present_correlated_col_temp) = {
-	.id = BT_MESH_PROP_ID_PRESENT_CORRELATED_COL_TEMP,
+);
+SENSOR_TYPE(present_correlated_col_temp, BT_MESH_PROP_ID_PRESENT_CORRELATED_COL_TEMP,
 	CHANNELS(CHANNEL("Present correlated color temperature",
 			 correlated_color_temp)),
-};
-SENSOR_TYPE(present_illuminance) = {
-	.id = BT_MESH_PROP_ID_PRESENT_ILLUMINANCE,
+);
+SENSOR_TYPE(present_illuminance, BT_MESH_PROP_ID_PRESENT_ILLUMINANCE,
 	CHANNELS(CHANNEL("Present illuminance", illuminance)),
-};
-SENSOR_TYPE(initial_luminous_flux) = {
-	.id = BT_MESH_PROP_ID_INITIAL_LUMINOUS_FLUX,
+);
+SENSOR_TYPE(initial_luminous_flux, BT_MESH_PROP_ID_INITIAL_LUMINOUS_FLUX,
 	CHANNELS(CHANNEL("Initial luminous flux", luminous_flux)),
-};
-SENSOR_TYPE(present_luminous_flux) = {
-	.id = BT_MESH_PROP_ID_PRESENT_LUMINOUS_FLUX,
+);
+SENSOR_TYPE(present_luminous_flux, BT_MESH_PROP_ID_PRESENT_LUMINOUS_FLUX,
 	CHANNELS(CHANNEL("Present luminous flux", luminous_flux)),
-};
-SENSOR_TYPE(initial_planckian_distance) = {
-	.id = BT_MESH_PROP_ID_INITIAL_PLANCKIAN_DISTANCE,
+);
+SENSOR_TYPE(initial_planckian_distance, BT_MESH_PROP_ID_INITIAL_PLANCKIAN_DISTANCE,
 	CHANNELS(CHANNEL("Initial planckian distance", chromatic_distance)),
-};
-SENSOR_TYPE(present_planckian_distance) = {
-	.id = BT_MESH_PROP_ID_PRESENT_PLANCKIAN_DISTANCE,
+);
+SENSOR_TYPE(present_planckian_distance, BT_MESH_PROP_ID_PRESENT_PLANCKIAN_DISTANCE,
 	CHANNELS(CHANNEL("Present planckian distance", chromatic_distance)),
-};
-SENSOR_TYPE(rel_exposure_time_in_an_illuminance_range) = {
-	.id = BT_MESH_PROP_ID_REL_EXPOSURE_TIME_IN_AN_ILLUMINANCE_RANGE,
+);
+SENSOR_TYPE(rel_exposure_time_in_an_illuminance_range,
+	    BT_MESH_PROP_ID_REL_EXPOSURE_TIME_IN_AN_ILLUMINANCE_RANGE,
 	CHANNELS(CHANNEL("Relative value", percentage_8),
 		 CHANNEL("Min", illuminance),
 		 CHANNEL("Max", illuminance))
-};
-SENSOR_TYPE(tot_light_exposure_time) = {
-	.id = BT_MESH_PROP_ID_TOT_LIGHT_EXPOSURE_TIME,
+);
+SENSOR_TYPE(tot_light_exposure_time, BT_MESH_PROP_ID_TOT_LIGHT_EXPOSURE_TIME,
 	CHANNELS(CHANNEL("Total light exposure time", time_hour_24)),
-};
-SENSOR_TYPE(lumen_maintenance_factor) = {
-	.id = BT_MESH_PROP_ID_LUMEN_MAINTENANCE_FACTOR,
+);
+SENSOR_TYPE(lumen_maintenance_factor, BT_MESH_PROP_ID_LUMEN_MAINTENANCE_FACTOR,
 	CHANNELS(CHANNEL("Lumen maintenance factor", percentage_8)),
-};
-SENSOR_TYPE(luminous_efficacy) = {
-	.id = BT_MESH_PROP_ID_LUMINOUS_EFFICACY,
+);
+SENSOR_TYPE(luminous_efficacy, BT_MESH_PROP_ID_LUMINOUS_EFFICACY,
 	CHANNELS(CHANNEL("Luminous efficacy", luminous_efficacy)),
-};
-SENSOR_TYPE(luminous_energy_since_turn_on) = {
-	.id = BT_MESH_PROP_ID_LUMINOUS_ENERGY_SINCE_TURN_ON,
+);
+SENSOR_TYPE(luminous_energy_since_turn_on, BT_MESH_PROP_ID_LUMINOUS_ENERGY_SINCE_TURN_ON,
 	CHANNELS(CHANNEL("Luminous energy since turn on", luminous_energy)),
-};
-SENSOR_TYPE(luminous_exposure) = {
-	.id = BT_MESH_PROP_ID_LUMINOUS_EXPOSURE,
+);
+SENSOR_TYPE(luminous_exposure, BT_MESH_PROP_ID_LUMINOUS_EXPOSURE,
 	CHANNELS(CHANNEL("Luminous exposure", luminous_exposure)),
-};
-SENSOR_TYPE(luminous_flux_range) = {
-	.id = BT_MESH_PROP_ID_LUMINOUS_FLUX_RANGE,
+);
+SENSOR_TYPE(luminous_flux_range, BT_MESH_PROP_ID_LUMINOUS_FLUX_RANGE,
 	CHANNELS(CHANNEL("Min", luminous_flux),
 		 CHANNEL("Max", luminous_flux)),
-};
+);
 
 /*******************************************************************************
  * Power supply output
  ******************************************************************************/
-SENSOR_TYPE(avg_output_current) = {
-	.id = BT_MESH_PROP_ID_AVG_OUTPUT_CURRENT,
+SENSOR_TYPE(avg_output_current, BT_MESH_PROP_ID_AVG_OUTPUT_CURRENT,
 	CHANNELS(CHANNEL("Electric current value", electric_current),
 		 CHANNEL("Sensing duration", time_exp_8)),
-};
-SENSOR_TYPE(avg_output_voltage) = {
-	.id = BT_MESH_PROP_ID_AVG_OUTPUT_VOLTAGE,
+);
+SENSOR_TYPE(avg_output_voltage, BT_MESH_PROP_ID_AVG_OUTPUT_VOLTAGE,
 	CHANNELS(CHANNEL("Voltage value", voltage),
 		 CHANNEL("Sensing duration", time_exp_8)),
-};
-SENSOR_TYPE(output_current_range) = {
-	.id = BT_MESH_PROP_ID_OUTPUT_CURRENT_RANGE,
+);
+SENSOR_TYPE(output_current_range, BT_MESH_PROP_ID_OUTPUT_CURRENT_RANGE,
 	CHANNELS(CHANNEL("Min", electric_current),
 		 CHANNEL("Max", electric_current)),
-};
-SENSOR_TYPE(output_current_stat) = {
-	.id = BT_MESH_PROP_ID_OUTPUT_CURRENT_STAT,
+);
+SENSOR_TYPE(output_current_stat, BT_MESH_PROP_ID_OUTPUT_CURRENT_STAT,
 	.channel_count = ARRAY_SIZE(electric_current_stats),
 	.channels = electric_current_stats,
-};
-SENSOR_TYPE(output_ripple_voltage_spec) = {
-	.id = BT_MESH_PROP_ID_OUTPUT_RIPPLE_VOLTAGE_SPEC,
+);
+SENSOR_TYPE(output_ripple_voltage_spec, BT_MESH_PROP_ID_OUTPUT_RIPPLE_VOLTAGE_SPEC,
 	CHANNELS(CHANNEL("Output ripple voltage", percentage_8)),
-};
-SENSOR_TYPE(output_voltage_range) = {
-	.id = BT_MESH_PROP_ID_OUTPUT_VOLTAGE_RANGE,
+);
+SENSOR_TYPE(output_voltage_range, BT_MESH_PROP_ID_OUTPUT_VOLTAGE_RANGE,
 	CHANNELS(CHANNEL("Min", voltage),
 		 CHANNEL("Typical voltage value", voltage),
 		 CHANNEL("Max", voltage)),
-};
-SENSOR_TYPE(output_voltage_stat) = {
-	.id = BT_MESH_PROP_ID_OUTPUT_VOLTAGE_STAT,
+);
+SENSOR_TYPE(output_voltage_stat, BT_MESH_PROP_ID_OUTPUT_VOLTAGE_STAT,
 	.channel_count = ARRAY_SIZE(voltage_stats),
 	.channels = voltage_stats,
-};
-SENSOR_TYPE(present_output_current) = {
-	.id = BT_MESH_PROP_ID_PRESENT_OUTPUT_CURRENT,
+);
+SENSOR_TYPE(present_output_current, BT_MESH_PROP_ID_PRESENT_OUTPUT_CURRENT,
 	CHANNELS(CHANNEL("Present output current", electric_current)),
-};
-SENSOR_TYPE(present_output_voltage) = {
-	.id = BT_MESH_PROP_ID_PRESENT_OUTPUT_VOLTAGE,
+);
+SENSOR_TYPE(present_output_voltage, BT_MESH_PROP_ID_PRESENT_OUTPUT_VOLTAGE,
 	CHANNELS(CHANNEL("Present output voltage", voltage)),
-};
-SENSOR_TYPE(present_rel_output_ripple_voltage) = {
-	.id = BT_MESH_PROP_ID_PRESENT_REL_OUTPUT_RIPPLE_VOLTAGE,
+);
+SENSOR_TYPE(present_rel_output_ripple_voltage,
+	    BT_MESH_PROP_ID_PRESENT_REL_OUTPUT_RIPPLE_VOLTAGE,
 	CHANNELS(CHANNEL("Output ripple voltage", percentage_8)),
-};
+);
 
 /*******************************************************************************
  * Warranty and service
  ******************************************************************************/
-SENSOR_TYPE(gain) = {
-	.id = BT_MESH_PROP_ID_SENSOR_GAIN,
+SENSOR_TYPE(gain, BT_MESH_PROP_ID_SENSOR_GAIN,
 	CHANNELS(CHANNEL("Sensor gain", coefficient)),
-};
-SENSOR_TYPE(rel_dev_runtime_in_a_generic_level_range) = {
-	.id = BT_MESH_PROP_ID_REL_DEV_RUNTIME_IN_A_GENERIC_LEVEL_RANGE,
+);
+SENSOR_TYPE(rel_dev_runtime_in_a_generic_level_range,
+	    BT_MESH_PROP_ID_REL_DEV_RUNTIME_IN_A_GENERIC_LEVEL_RANGE,
 	CHANNELS(CHANNEL("Relative value", percentage_8),
 		 CHANNEL("Min", gen_lvl),
 		 CHANNEL("Max", gen_lvl)),
-};
+);
 
-SENSOR_TYPE(total_dev_runtime) = {
-	.id = BT_MESH_PROP_ID_TOT_DEV_RUNTIME,
+SENSOR_TYPE(total_dev_runtime, BT_MESH_PROP_ID_TOT_DEV_RUNTIME,
 	CHANNELS(CHANNEL("Total device runtime", time_hour_24)),
-};
+);
 
 /******************************************************************************/
 
+/* End of the types defined with SENSOR_TYPE(), sorted by ID. Types defined
+ * elsewhere follow in no particular order.
+ */
+STRUCT_SECTION_START_EXTERN(bt_mesh_sensor_type);
+STRUCT_SECTION_END_EXTERN(bt_mesh_sensor_type);
+extern const struct bt_mesh_sensor_type _bt_mesh_sensor_type_sorted_end[];
+
 const struct bt_mesh_sensor_type *bt_mesh_sensor_type_get(uint16_t id)
 {
-	STRUCT_SECTION_FOREACH(bt_mesh_sensor_type, type) {
+	const struct bt_mesh_sensor_type *types = STRUCT_SECTION_START(bt_mesh_sensor_type);
+	size_t low = 0;
+	size_t high = _bt_mesh_sensor_type_sorted_end - types;
+
+	while (low < high) {
+		size_t mid = low + (high - low) / 2;
+
+		if (types[mid].id == id) {
+			return &types[mid];
+		}
+
+		if (types[mid].id < id) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	for (const struct bt_mesh_sensor_type *type = _bt_mesh_sensor_type_sorted_end;
+	     type < STRUCT_SECTION_END(bt_mesh_sensor_type); type++) {
 		if (type->id == id) {
 			return type;
 		}
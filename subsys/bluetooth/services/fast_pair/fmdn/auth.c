@@ -22,11 +22,6 @@ LOG_MODULE_REGISTER(fp_fmdn_auth, CONFIG_BT_FAST_PAIR_LOG_LEVEL);
 #define EIK_DERIVED_KEY_SEED_BUF_LEN \
 	(FP_FMDN_STATE_EIK_LEN + EIK_DERIVED_KEY_SEED_END_BYTE_LEN)
 
-struct account_key_find_context {
-	struct net_buf_simple *auth_data_buf;
-	const uint8_t *auth_seg;
-};
-
 static bool auth_seg_compare(const struct net_buf_simple *auth_data_buf,
 			     const uint8_t *key,
 			     size_t key_len,
@@ -49,14 +44,18 @@ static bool auth_seg_compare(const struct net_buf_simple *auth_data_buf,
 	return !memcmp(local_auth_seg, auth_seg, FP_FMDN_AUTH_SEG_LEN);
 }
 
-static bool account_key_find_iterator(const struct fp_account_key *account_key, void *context)
+static bool account_key_find_check(const uint8_t *local_auth_seg, void *context)
 {
-	struct account_key_find_context *account_key_find_context = context;
+	const uint8_t *auth_seg = context;
 
-	return auth_seg_compare(account_key_find_context->auth_data_buf,
-				account_key->key,
-				sizeof(account_key->key),
-				account_key_find_context->auth_seg);
+	return !memcmp(local_auth_seg, auth_seg, FP_FMDN_AUTH_SEG_LEN);
+}
+
+static bool account_key_match(const struct fp_account_key *account_key, void *context)
+{
+	const struct fp_account_key *found_key = context;
+
+	return !memcmp(account_key->key, found_key->key, sizeof(account_key->key));
 }
 
 static void auth_data_encode(struct net_buf_simple *auth_data_buf,
@@ -216,20 +215,45 @@ int fp_fmdn_auth_account_key_find(const struct fp_fmdn_auth_data *auth_data,
 				  struct fp_account_key *account_key)
 {
 	int err;
-	struct account_key_find_context account_key_find_context = {0};
+	int idx;
+	struct fp_account_key ak[CONFIG_BT_FAST_PAIR_STORAGE_ACCOUNT_KEY_MAX];
+	size_t ak_cnt = ARRAY_SIZE(ak);
+	uint8_t local_auth_seg[FP_CRYPTO_SHA256_HASH_LEN];
 
 	NET_BUF_SIMPLE_DEFINE(auth_data_buf, AUTH_DATA_BUF_LEN);
 
-	account_key_find_context.auth_data_buf = &auth_data_buf;
-	account_key_find_context.auth_seg = auth_seg;
-	auth_data_encode(account_key_find_context.auth_data_buf, auth_data);
+	auth_data_encode(&auth_data_buf, auth_data);
 
-	err = fp_storage_ak_find(account_key,
-				 account_key_find_iterator,
-				 &account_key_find_context);
+	err = fp_storage_ak_get(ak, &ak_cnt);
 	if (err) {
 		return err;
 	}
 
-	return 0;
+	/* Try all of the Account Keys in one batch, without going through the storage module
+	 * for each candidate.
+	 */
+	idx = fp_crypto_hmac_sha256_find(local_auth_seg,
+					 auth_data_buf.data,
+					 auth_data_buf.len,
+					 ak,
+					 ak_cnt,
+					 account_key_find_check,
+					 (void *)auth_seg);
+	if (idx < 0) {
+		if (idx != -ESRCH) {
+			LOG_ERR("Authentication: Account Key find:"
+				" fp_crypto_hmac_sha256_find failed: %d", idx);
+		}
+
+		err = idx;
+		goto cleanup;
+	}
+
+	/* Mark the found Account Key as recently used. */
+	err = fp_storage_ak_find(account_key, account_key_match, &ak[idx]);
+
+cleanup:
+	memset(ak, 0, sizeof(ak));
+
+	return err;
 }
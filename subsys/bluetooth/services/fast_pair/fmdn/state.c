@@ -144,6 +144,33 @@ static uint32_t utp_rotations; /* Number of EID rotations in each RPA rotation c
 
 static bool is_enabled;
 
+#if CONFIG_BT_FAST_PAIR_FMDN_EID_PRECOMPUTE
+/* Index of the EID cache entry for the given FMDN clock value of the rotation period. */
+#define EID_CACHE_IDX(fmdn_clock)                          \
+	(((fmdn_clock) >> FMDN_EID_SEED_ROT_PERIOD_EXP) %  \
+	 CONFIG_BT_FAST_PAIR_FMDN_EID_PRECOMPUTE_COUNT)
+
+/* EID precomputed for the upcoming rotation period. */
+struct eid_cache_entry {
+	bool valid;
+	uint32_t fmdn_clock;
+	uint8_t eid[FP_FMDN_STATE_EID_LEN];
+	uint8_t hashed_flags_xor_operand;
+};
+
+static struct eid_cache_entry eid_cache[CONFIG_BT_FAST_PAIR_FMDN_EID_PRECOMPUTE_COUNT];
+static uint32_t eid_cache_generation;
+static uint32_t eid_precompute_clock;
+static struct k_spinlock eid_cache_lock;
+
+static void eid_precompute_work_handle(struct k_work *work);
+
+static K_THREAD_STACK_DEFINE(eid_precompute_stack,
+			     CONFIG_BT_FAST_PAIR_FMDN_EID_PRECOMPUTE_STACK_SIZE);
+static struct k_work_q eid_precompute_work_q;
+static K_WORK_DEFINE(eid_precompute_work, eid_precompute_work_handle);
+#endif /* CONFIG_BT_FAST_PAIR_FMDN_EID_PRECOMPUTE */
+
 static uint32_t fmdn_conn_cnt;
 static bool fmdn_conns[CONFIG_BT_MAX_CONN];
 
@@ -168,34 +195,16 @@ static void eid_seed_half_encode(struct net_buf_simple *buf,
 	net_buf_simple_add_be32(buf, fmdn_clock);
 }
 
-static int eid_encode(void)
+static int eid_calculate(uint32_t fmdn_clock, uint8_t *eid, uint8_t *hashed_flags_xor_operand)
 {
 	int err;
-	uint32_t fmdn_clock;
 	uint8_t eik[FP_STORAGE_EIK_LEN];
 	uint8_t encrypted_eid_seed[FP_CRYPTO_AES256_BLOCK_LEN];
-	const uint8_t uninitialized_eid[FP_FMDN_STATE_EID_LEN] = {};
 	uint8_t secp_mod_res[SECP_MOD_RES_LEN];
 	uint8_t mod_res_hash[FP_CRYPTO_SHA256_HASH_LEN];
 
 	NET_BUF_SIMPLE_DEFINE(eid_seed_buf, FMDN_EID_SEED_LEN);
 
-	/* Prepare the FMDN Clock value. */
-	fmdn_clock = fp_fmdn_clock_read();
-
-	/* Clear the K lowest bits in the clock value. */
-	fmdn_clock &= ~BIT_MASK(FMDN_EID_SEED_ROT_PERIOD_EXP);
-
-	/* Check if the EID seed or EIK has changed since the last call. */
-	if (memcmp(fmdn_eid, uninitialized_eid, sizeof(uninitialized_eid)) != 0) {
-		if (fmdn_clock == fmdn_eid_clock_checkpoint) {
-			LOG_DBG("FMDN State: EID does not require recalculation");
-
-			return 0;
-		}
-	}
-	fmdn_eid_clock_checkpoint = fmdn_clock;
-
 	/* Prepare the EID seed data. */
 	eid_seed_half_encode(&eid_seed_buf,
 			     FMDN_EID_SEED_PADDING_TYPE_ONE,
@@ -231,7 +240,7 @@ static int eid_encode(void)
 
 	/* Calculate the EID as the x coordinate of a point on the elliptic curve. */
 	if (IS_ENABLED(CONFIG_BT_FAST_PAIR_FMDN_ECC_SECP160R1)) {
-		err = fp_crypto_ecc_secp160r1_calculate(fmdn_eid,
+		err = fp_crypto_ecc_secp160r1_calculate(eid,
 							secp_mod_res,
 							encrypted_eid_seed,
 							sizeof(encrypted_eid_seed));
@@ -242,7 +251,7 @@ static int eid_encode(void)
 			return err;
 		}
 	} else if (IS_ENABLED(CONFIG_BT_FAST_PAIR_FMDN_ECC_SECP256R1)) {
-		err = fp_crypto_ecc_secp256r1_calculate(fmdn_eid,
+		err = fp_crypto_ecc_secp256r1_calculate(eid,
 							secp_mod_res,
 							encrypted_eid_seed,
 							sizeof(encrypted_eid_seed));
@@ -256,7 +265,7 @@ static int eid_encode(void)
 		__ASSERT(0, "ECC selection not supported");
 	}
 
-	LOG_HEXDUMP_DBG(fmdn_eid, FP_FMDN_STATE_EID_LEN, "EID:");
+	LOG_HEXDUMP_DBG(eid, FP_FMDN_STATE_EID_LEN, "EID:");
 
 	/* Calculate the XOR operand for the Hashed Flags bitmask. */
 	err = fp_crypto_sha256(mod_res_hash, secp_mod_res, sizeof(secp_mod_res));
@@ -266,7 +275,162 @@ static int eid_encode(void)
 		return err;
 	}
 
-	fmdn_frame_hashed_flags_xor_operand = mod_res_hash[sizeof(mod_res_hash) - 1];
+	*hashed_flags_xor_operand = mod_res_hash[sizeof(mod_res_hash) - 1];
+
+	return 0;
+}
+
+#if CONFIG_BT_FAST_PAIR_FMDN_EID_PRECOMPUTE
+static bool eid_cache_get(uint32_t fmdn_clock, uint8_t *eid, uint8_t *hashed_flags_xor_operand)
+{
+	bool found;
+	struct eid_cache_entry *entry;
+	k_spinlock_key_t key = k_spin_lock(&eid_cache_lock);
+
+	entry = &eid_cache[EID_CACHE_IDX(fmdn_clock)];
+	found = (entry->valid && (entry->fmdn_clock == fmdn_clock));
+	if (found) {
+		memcpy(eid, entry->eid, FP_FMDN_STATE_EID_LEN);
+		*hashed_flags_xor_operand = entry->hashed_flags_xor_operand;
+	}
+
+	k_spin_unlock(&eid_cache_lock, key);
+
+	return found;
+}
+
+static void eid_cache_invalidate(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&eid_cache_lock);
+
+	/* Results of the ongoing precomputation are discarded on the generation change. */
+	eid_cache_generation++;
+	for (size_t i = 0; i < ARRAY_SIZE(eid_cache); i++) {
+		eid_cache[i].valid = false;
+	}
+
+	k_spin_unlock(&eid_cache_lock, key);
+}
+
+static void eid_precompute_request(uint32_t fmdn_clock)
+{
+	k_spinlock_key_t key = k_spin_lock(&eid_cache_lock);
+
+	eid_precompute_clock = fmdn_clock;
+
+	k_spin_unlock(&eid_cache_lock, key);
+
+	(void) k_work_submit_to_queue(&eid_precompute_work_q, &eid_precompute_work);
+}
+
+static void eid_precompute_work_handle(struct k_work *work)
+{
+	uint32_t base_clock;
+	uint32_t generation;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&eid_cache_lock);
+	base_clock = eid_precompute_clock;
+	generation = eid_cache_generation;
+	k_spin_unlock(&eid_cache_lock, key);
+
+	for (uint32_t i = 1; i <= CONFIG_BT_FAST_PAIR_FMDN_EID_PRECOMPUTE_COUNT; i++) {
+		int err;
+		bool stored;
+		struct eid_cache_entry *entry;
+		uint32_t fmdn_clock = base_clock + i * BIT(FMDN_EID_SEED_ROT_PERIOD_EXP);
+		uint8_t eid[FP_FMDN_STATE_EID_LEN];
+		uint8_t hashed_flags_xor_operand;
+
+		if (eid_cache_get(fmdn_clock, eid, &hashed_flags_xor_operand)) {
+			continue;
+		}
+
+		err = eid_calculate(fmdn_clock, eid, &hashed_flags_xor_operand);
+		if (err) {
+			LOG_WRN("FMDN State: EID precomputation failed: %d", err);
+			return;
+		}
+
+		key = k_spin_lock(&eid_cache_lock);
+		stored = (generation == eid_cache_generation);
+		if (stored) {
+			entry = &eid_cache[EID_CACHE_IDX(fmdn_clock)];
+			entry->valid = true;
+			entry->fmdn_clock = fmdn_clock;
+			memcpy(entry->eid, eid, sizeof(entry->eid));
+			entry->hashed_flags_xor_operand = hashed_flags_xor_operand;
+		}
+		k_spin_unlock(&eid_cache_lock, key);
+
+		if (!stored) {
+			LOG_DBG("FMDN State: EID precomputation discarded");
+			return;
+		}
+
+		LOG_DBG("FMDN State: EID precomputed for FMDN clock: %u [s]", fmdn_clock);
+	}
+}
+static void eid_precompute_init(void)
+{
+	static bool initialized;
+
+	if (initialized) {
+		return;
+	}
+
+	/* Use the lowest priority so that the precomputation does not delay other activities. */
+	k_work_queue_start(&eid_precompute_work_q, eid_precompute_stack,
+			   K_THREAD_STACK_SIZEOF(eid_precompute_stack),
+			   K_LOWEST_APPLICATION_THREAD_PRIO, NULL);
+	k_thread_name_set(k_work_queue_thread_get(&eid_precompute_work_q), "fmdn_eid_precompute");
+
+	initialized = true;
+}
+#endif /* CONFIG_BT_FAST_PAIR_FMDN_EID_PRECOMPUTE */
+
+static int eid_encode(void)
+{
+	int err;
+	uint32_t fmdn_clock;
+	const uint8_t uninitialized_eid[FP_FMDN_STATE_EID_LEN] = {};
+
+	/* Prepare the FMDN Clock value. */
+	fmdn_clock = fp_fmdn_clock_read();
+
+	/* Clear the K lowest bits in the clock value. */
+	fmdn_clock &= ~BIT_MASK(FMDN_EID_SEED_ROT_PERIOD_EXP);
+
+	/* Check if the EID seed or EIK has changed since the last call. */
+	if (memcmp(fmdn_eid, uninitialized_eid, sizeof(uninitialized_eid)) != 0) {
+		if (fmdn_clock == fmdn_eid_clock_checkpoint) {
+			LOG_DBG("FMDN State: EID does not require recalculation");
+
+			return 0;
+		}
+	}
+	fmdn_eid_clock_checkpoint = fmdn_clock;
+
+#if CONFIG_BT_FAST_PAIR_FMDN_EID_PRECOMPUTE
+	if (eid_cache_get(fmdn_clock, fmdn_eid, &fmdn_frame_hashed_flags_xor_operand)) {
+		LOG_DBG("FMDN State: using precomputed EID");
+		LOG_HEXDUMP_DBG(fmdn_eid, FP_FMDN_STATE_EID_LEN, "EID:");
+
+		eid_precompute_request(fmdn_clock);
+
+		return 0;
+	}
+#endif
+
+	err = eid_calculate(fmdn_clock, fmdn_eid, &fmdn_frame_hashed_flags_xor_operand);
+	if (err) {
+		return err;
+	}
+
+#if CONFIG_BT_FAST_PAIR_FMDN_EID_PRECOMPUTE
+	/* Prepare the EIDs for the following rotation periods in the background. */
+	eid_precompute_request(fmdn_clock);
+#endif
 
 	return 0;
 }
@@ -955,6 +1119,10 @@ static int fmdn_storage_unprovision(void)
 
 	memset(fmdn_eid, 0, FP_FMDN_STATE_EID_LEN);
 
+#if CONFIG_BT_FAST_PAIR_FMDN_EID_PRECOMPUTE
+	eid_cache_invalidate();
+#endif
+
 	return 0;
 }
 
@@ -1006,6 +1174,10 @@ static int fmdn_storage_provision(const uint8_t *eik)
 
 	memset(fmdn_eid, 0, FP_FMDN_STATE_EID_LEN);
 
+#if CONFIG_BT_FAST_PAIR_FMDN_EID_PRECOMPUTE
+	eid_cache_invalidate();
+#endif
+
 	return 0;
 }
 
@@ -1288,6 +1460,10 @@ int fp_fmdn_state_init(void)
 		return err;
 	}
 
+#if CONFIG_BT_FAST_PAIR_FMDN_EID_PRECOMPUTE
+	eid_precompute_init();
+#endif
+
 	/* Subscribe to the battery level changes. */
 	err = fp_fmdn_battery_cb_register(&fmdn_state_battery_cb);
 	if (err) {
@@ -1345,6 +1521,12 @@ int fp_fmdn_state_uninit(void)
 	/* Cancel the work for the provisioning_state_changed callback. */
 	(void) k_work_cancel(&fmdn_post_init_work);
 
+#if CONFIG_BT_FAST_PAIR_FMDN_EID_PRECOMPUTE
+	/* Drop the precomputed EIDs and the results of the ongoing precomputation. */
+	(void) k_work_cancel(&eid_precompute_work);
+	eid_cache_invalidate();
+#endif
+
 	LOG_DBG("FMDN State: disabled");
 
 	return 0;
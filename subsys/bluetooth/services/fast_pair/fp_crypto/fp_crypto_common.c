@@ -99,28 +99,31 @@ int fp_crypto_account_key_filter(uint8_t *out, const struct fp_account_key *acco
 	size_t s = fp_crypto_account_key_filter_size(n);
 	uint8_t v[FP_ACCOUNT_KEY_LEN + sizeof(salt) + FP_CRYPTO_BATTERY_INFO_LEN];
 	uint8_t h[FP_CRYPTO_SHA256_HASH_LEN];
+	size_t v_len = FP_ACCOUNT_KEY_LEN;
 	uint32_t x;
 	uint32_t m;
-	int err;
+	int err = 0;
+
+	/* The Salt and the battery info are the same for all of the Account Keys, so prepare
+	 * them once. Only the Account Key at the start of the hashed data changes in the loop.
+	 * The hashed data always fits in a single SHA-256 block, so there is no partial hash
+	 * state that could be reused between the Account Keys.
+	 */
+	sys_put_be16(salt, &v[v_len]);
+	v_len += sizeof(salt);
+
+	if (battery_info) {
+		memcpy(&v[v_len], battery_info, FP_CRYPTO_BATTERY_INFO_LEN);
+		v_len += FP_CRYPTO_BATTERY_INFO_LEN;
+	}
 
 	memset(out, 0, s);
 	for (size_t i = 0; i < n; i++) {
-		size_t pos = 0;
-
 		memcpy(v, account_key_list[i].key, FP_ACCOUNT_KEY_LEN);
-		pos += FP_ACCOUNT_KEY_LEN;
-
-		sys_put_be16(salt, &v[pos]);
-		pos += sizeof(salt);
 
-		if (battery_info) {
-			memcpy(&v[pos], battery_info, FP_CRYPTO_BATTERY_INFO_LEN);
-			pos += FP_CRYPTO_BATTERY_INFO_LEN;
-		}
-
-		err = fp_crypto_sha256(h, v, pos);
+		err = fp_crypto_sha256(h, v, v_len);
 		if (err) {
-			return err;
+			break;
 		}
 
 		for (size_t j = 0; j < FP_CRYPTO_SHA256_HASH_LEN / sizeof(x); j++) {
@@ -129,7 +132,10 @@ int fp_crypto_account_key_filter(uint8_t *out, const struct fp_account_key *acco
 			WRITE_BIT(out[m / __CHAR_BIT__], m % __CHAR_BIT__, 1);
 		}
 	}
-	return 0;
+
+	memset(v, 0, FP_ACCOUNT_KEY_LEN);
+
+	return err;
 }
 
 int fp_crypto_additional_data_encode(uint8_t *out_packet, const uint8_t *data, size_t data_len,
@@ -146,6 +146,109 @@ int fp_crypto_aes128_ecb_decrypt(uint8_t *out, const uint8_t *in, const uint8_t
 	return aes128_ecb_crypt(out, in, k, false);
 }
 
+int fp_crypto_aes128_ecb_decrypt_find(uint8_t *out, const uint8_t *in,
+				      const struct fp_account_key *account_key_list, size_t n,
+				      fp_crypto_key_check_cb check_cb, void *context)
+{
+	int ret;
+	int idx = -ESRCH;
+	mbedtls_aes_context aes_ctx;
+
+	/* A single AES context is used for the whole search. Only the key schedule is set up
+	 * for each Account Key.
+	 */
+	mbedtls_aes_init(&aes_ctx);
+
+	for (size_t i = 0; i < n; i++) {
+		ret = mbedtls_aes_setkey_dec(&aes_ctx, account_key_list[i].key,
+					     AES128_ECB_KEY_BIT_LEN);
+		if (ret) {
+			LOG_WRN("aes128_ecb_decrypt_find: mbedtls_aes_setkey_dec failed: %d", ret);
+			continue;
+		}
+
+		ret = mbedtls_aes_crypt_ecb(&aes_ctx, MBEDTLS_AES_DECRYPT, in, out);
+		if (ret) {
+			LOG_WRN("aes128_ecb_decrypt_find: mbedtls_aes_crypt_ecb failed: %d", ret);
+			continue;
+		}
+
+		if (check_cb(out, context)) {
+			idx = i;
+			break;
+		}
+	}
+
+	/* Free the AES context. */
+	mbedtls_aes_free(&aes_ctx);
+
+	if (idx < 0) {
+		memset(out, 0, FP_CRYPTO_AES128_BLOCK_LEN);
+	}
+
+	return idx;
+}
+
+int fp_crypto_hmac_sha256_find(uint8_t *out, const uint8_t *in, size_t data_len,
+			       const struct fp_account_key *account_key_list, size_t n,
+			       fp_crypto_key_check_cb check_cb, void *context)
+{
+	static const int hmac = 1;
+
+	int ret;
+	int idx = -ESRCH;
+	const mbedtls_md_info_t *md_info;
+	mbedtls_md_context_t md_ctx;
+
+	md_info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+	if (!md_info) {
+		LOG_ERR("hmac sha256 find: message-digest information not found");
+		return MBEDTLS_ERR_MD_FEATURE_UNAVAILABLE;
+	}
+
+	mbedtls_md_init(&md_ctx);
+
+	/* The message-digest context is allocated once for the whole search. Only the HMAC
+	 * state is set up for each Account Key.
+	 */
+	ret = mbedtls_md_setup(&md_ctx, md_info, hmac);
+	if (ret) {
+		LOG_ERR("hmac sha256 find: mbedtls_md_setup failed: %d", ret);
+		idx = ret;
+		goto cleanup;
+	}
+
+	for (size_t i = 0; i < n; i++) {
+		ret = mbedtls_md_hmac_starts(&md_ctx, account_key_list[i].key,
+					     sizeof(account_key_list[i].key));
+		if (!ret) {
+			ret = mbedtls_md_hmac_update(&md_ctx, in, data_len);
+		}
+		if (!ret) {
+			ret = mbedtls_md_hmac_finish(&md_ctx, out);
+		}
+		if (ret) {
+			LOG_WRN("hmac sha256 find: HMAC computation failed: %d", ret);
+			continue;
+		}
+
+		if (check_cb(out, context)) {
+			idx = i;
+			break;
+		}
+	}
+
+cleanup:
+	/* Free the message-digest context. */
+	mbedtls_md_free(&md_ctx);
+
+	if (idx < 0) {
+		memset(out, 0, FP_CRYPTO_SHA256_HASH_LEN);
+	}
+
+	return idx;
+}
+
 int fp_crypto_ecdh_shared_secret(uint8_t *secret_key,
 				 const uint8_t *public_key,
 				 const uint8_t *private_key)
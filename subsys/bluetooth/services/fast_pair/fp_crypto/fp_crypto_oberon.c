@@ -6,6 +6,7 @@
 
 #include "fp_crypto.h"
 
+#include <ocrypto_constant_time.h>
 #include <ocrypto_hmac_sha256.h>
 #include <ocrypto_sha256.h>
 #include <ocrypto_aes_ecb.h>
@@ -65,6 +66,59 @@ int fp_crypto_aes128_ecb_decrypt(uint8_t *out, const uint8_t *in, const uint8_t
 	return 0;
 }
 
+int fp_crypto_aes128_ecb_decrypt_find(uint8_t *out, const uint8_t *in,
+				      const struct fp_account_key *account_key_list, size_t n,
+				      fp_crypto_key_check_cb check_cb, void *context)
+{
+	/* The Oberon AES-ECB API expands the key schedule inside each call and does not expose
+	 * a context, so the key schedule is set up once for each Account Key by the call itself.
+	 */
+	for (size_t i = 0; i < n; i++) {
+		ocrypto_aes_ecb_decrypt(out, in, FP_CRYPTO_AES128_BLOCK_LEN,
+					account_key_list[i].key, FP_CRYPTO_AES128_KEY_LEN);
+
+		if (check_cb(out, context)) {
+			return i;
+		}
+	}
+
+	memset(out, 0, FP_CRYPTO_AES128_BLOCK_LEN);
+
+	return -ESRCH;
+}
+
+int fp_crypto_hmac_sha256_find(uint8_t *out, const uint8_t *in, size_t data_len,
+			       const struct fp_account_key *account_key_list, size_t n,
+			       fp_crypto_key_check_cb check_cb, void *context)
+{
+	int idx = -ESRCH;
+	ocrypto_hmac_sha256_ctx ctx;
+
+	/* A single HMAC context is used for the whole search. Only the HMAC key state is set up
+	 * for each Account Key.
+	 */
+	for (size_t i = 0; i < n; i++) {
+		ocrypto_hmac_sha256_init(&ctx, account_key_list[i].key,
+					 sizeof(account_key_list[i].key));
+		ocrypto_hmac_sha256_update(&ctx, in, data_len);
+		ocrypto_hmac_sha256_final(&ctx, out);
+
+		if (check_cb(out, context)) {
+			idx = i;
+			break;
+		}
+	}
+
+	/* Clear the key state. A memset() of the local context could be optimized out. */
+	ocrypto_constant_time_fill_zero(&ctx, sizeof(ctx));
+
+	if (idx < 0) {
+		memset(out, 0, FP_CRYPTO_SHA256_HASH_LEN);
+	}
+
+	return idx;
+}
+
 int fp_crypto_aes256_ecb_encrypt(uint8_t *out, const uint8_t *in, const uint8_t *k)
 {
 	ocrypto_aes_ecb_encrypt(out, in, FP_CRYPTO_AES256_BLOCK_LEN, k, FP_CRYPTO_AES256_KEY_LEN);
@@ -191,6 +191,47 @@ int fp_crypto_aes128_ecb_decrypt(uint8_t *out, const uint8_t *in, const uint8_t
 	return fp_crypto_aes128_ecb_crypt(out, in, k, false);
 }
 
+int fp_crypto_aes128_ecb_decrypt_find(uint8_t *out, const uint8_t *in,
+				      const struct fp_account_key *account_key_list, size_t n,
+				      fp_crypto_key_check_cb check_cb, void *context)
+{
+	/* PSA keys are opaque, so the key setup is the import of each Account Key. */
+	for (size_t i = 0; i < n; i++) {
+		if (fp_crypto_aes128_ecb_crypt(out, in, account_key_list[i].key, false)) {
+			continue;
+		}
+
+		if (check_cb(out, context)) {
+			return i;
+		}
+	}
+
+	memset(out, 0, FP_CRYPTO_AES128_BLOCK_LEN);
+
+	return -ESRCH;
+}
+
+int fp_crypto_hmac_sha256_find(uint8_t *out, const uint8_t *in, size_t data_len,
+			       const struct fp_account_key *account_key_list, size_t n,
+			       fp_crypto_key_check_cb check_cb, void *context)
+{
+	/* PSA keys are opaque, so the key setup is the import of each Account Key. */
+	for (size_t i = 0; i < n; i++) {
+		if (fp_crypto_hmac_sha256(out, in, data_len, account_key_list[i].key,
+					  sizeof(account_key_list[i].key))) {
+			continue;
+		}
+
+		if (check_cb(out, context)) {
+			return i;
+		}
+	}
+
+	memset(out, 0, FP_CRYPTO_SHA256_HASH_LEN);
+
+	return -ESRCH;
+}
+
 static psa_key_id_t import_ecdh_priv_key(const uint8_t *data)
 {
 	static const size_t len = 32;
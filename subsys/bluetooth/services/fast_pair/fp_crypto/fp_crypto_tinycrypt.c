@@ -5,11 +5,13 @@
  */
 
 #include <errno.h>
+#include <string.h>
 #include <tinycrypt/constants.h>
 #include <tinycrypt/sha256.h>
 #include <tinycrypt/hmac.h>
 #include <tinycrypt/aes.h>
 #include <tinycrypt/ecc_dh.h>
+#include <tinycrypt/utils.h>
 #include "fp_crypto.h"
 
 int fp_crypto_sha256(uint8_t *out, const uint8_t *in, size_t data_len)
@@ -77,6 +79,75 @@ int fp_crypto_aes128_ecb_decrypt(uint8_t *out, const uint8_t *in, const uint8_t
 	return 0;
 }
 
+int fp_crypto_aes128_ecb_decrypt_find(uint8_t *out, const uint8_t *in,
+				      const struct fp_account_key *account_key_list, size_t n,
+				      fp_crypto_key_check_cb check_cb, void *context)
+{
+	int idx = -ESRCH;
+	struct tc_aes_key_sched_struct s;
+
+	for (size_t i = 0; i < n; i++) {
+		if (tc_aes128_set_decrypt_key(&s, account_key_list[i].key) != TC_CRYPTO_SUCCESS) {
+			continue;
+		}
+		if (tc_aes_decrypt(out, in, &s) != TC_CRYPTO_SUCCESS) {
+			continue;
+		}
+		if (check_cb(out, context)) {
+			idx = i;
+			break;
+		}
+	}
+
+	/* Clear the key schedule. Unlike a memset() of the local state, _set() is not
+	 * optimized out.
+	 */
+	_set(&s, 0, sizeof(s));
+
+	if (idx < 0) {
+		memset(out, 0, FP_CRYPTO_AES128_BLOCK_LEN);
+	}
+
+	return idx;
+}
+
+int fp_crypto_hmac_sha256_find(uint8_t *out, const uint8_t *in, size_t data_len,
+			       const struct fp_account_key *account_key_list, size_t n,
+			       fp_crypto_key_check_cb check_cb, void *context)
+{
+	int idx = -ESRCH;
+	struct tc_hmac_state_struct s;
+
+	for (size_t i = 0; i < n; i++) {
+		if (tc_hmac_set_key(&s, account_key_list[i].key,
+				    sizeof(account_key_list[i].key)) != TC_CRYPTO_SUCCESS) {
+			continue;
+		}
+		if (tc_hmac_init(&s) != TC_CRYPTO_SUCCESS) {
+			continue;
+		}
+		if (tc_hmac_update(&s, in, data_len) != TC_CRYPTO_SUCCESS) {
+			continue;
+		}
+		if (tc_hmac_final(out, FP_CRYPTO_SHA256_HASH_LEN, &s) != TC_CRYPTO_SUCCESS) {
+			continue;
+		}
+		if (check_cb(out, context)) {
+			idx = i;
+			break;
+		}
+	}
+
+	/* Clear the HMAC key state. A failed step leaves it set. */
+	_set(&s, 0, sizeof(s));
+
+	if (idx < 0) {
+		memset(out, 0, FP_CRYPTO_SHA256_HASH_LEN);
+	}
+
+	return idx;
+}
+
 int fp_crypto_ecdh_shared_secret(uint8_t *secret_key, const uint8_t *public_key,
 				 const uint8_t *private_key)
 {
@@ -7,6 +7,7 @@
 #ifndef _FP_CRYPTO_H_
 #define _FP_CRYPTO_H_
 
+#include <stdbool.h>
 #include <zephyr/types.h>
 
 #include "fp_common.h"
@@ -207,6 +208,55 @@ int fp_crypto_ecc_secp256r1_calculate(uint8_t *out,
  */
 int fp_crypto_aes_key_compute(uint8_t *out, const uint8_t *in);
 
+/** Callback used to check the output of an operation done with a candidate key.
+ *
+ * @param[in] out Output of the operation done with the candidate key.
+ * @param[in] context Pointer used to pass operation context.
+ *
+ * @return True if the candidate key is the one searched for, false otherwise.
+ */
+typedef bool (*fp_crypto_key_check_cb)(const uint8_t *out, void *context);
+
+/** Find the Account Key that a message was encrypted with using AES-128-ECB.
+ *
+ * The message is decrypted with the Account Keys in array order until the check callback accepts
+ * the plaintext. An Account Key for which the decryption fails is treated as not matching.
+ *
+ * @param[out] out 128-bit (16-byte) buffer to receive plaintext decrypted with the found key.
+ * @param[in] in 128-bit (16-byte) ciphertext message.
+ * @param[in] account_key_list Pointer to array of Account Keys to be tried.
+ * @param[in] n Number of Account Keys.
+ * @param[in] check_cb Callback used to check the decrypted plaintext.
+ * @param[in] context Pointer passed to the check callback.
+ *
+ * @return Index of the found Account Key in the array if the operation was successful.
+ *	   -ESRCH if no Account Key was accepted. Otherwise, a (negative) error code is returned.
+ */
+int fp_crypto_aes128_ecb_decrypt_find(uint8_t *out, const uint8_t *in,
+				      const struct fp_account_key *account_key_list, size_t n,
+				      fp_crypto_key_check_cb check_cb, void *context);
+
+/** Find the Account Key that a HMAC-SHA256 was generated with.
+ *
+ * HMAC-SHA256 of the input data is generated with the Account Keys in array order until the check
+ * callback accepts the result. An Account Key for which the generation fails is treated as not
+ * matching.
+ *
+ * @param[out] out 256-bit (32-byte) buffer to receive HMAC generated with the found key.
+ * @param[in] in Input data.
+ * @param[in] data_len Length of input data.
+ * @param[in] account_key_list Pointer to array of Account Keys to be tried.
+ * @param[in] n Number of Account Keys.
+ * @param[in] check_cb Callback used to check the generated HMAC.
+ * @param[in] context Pointer passed to the check callback.
+ *
+ * @return Index of the found Account Key in the array if the operation was successful.
+ *	   -ESRCH if no Account Key was accepted. Otherwise, a (negative) error code is returned.
+ */
+int fp_crypto_hmac_sha256_find(uint8_t *out, const uint8_t *in, size_t data_len,
+			       const struct fp_account_key *account_key_list, size_t n,
+			       fp_crypto_key_check_cb check_cb, void *context);
+
 /** Get Account Key Filter size.
  *
  * @param[in] n Number of Account Keys.
@@ -241,42 +241,61 @@ static int key_gen_public_key(const struct bt_conn *conn,
 	return err;
 }
 
-static bool key_gen_account_key_check(const struct fp_account_key *account_key, void *context)
+static bool key_gen_account_key_check(const uint8_t *req, void *context)
 {
-	int err;
-	uint8_t req[FP_CRYPTO_AES128_BLOCK_LEN];
 	struct fp_key_gen_account_key_check_context *ak_check_context = context;
-	const struct bt_conn *conn = ak_check_context->conn;
 	struct fp_keys_keygen_params *keygen_params = ak_check_context->keygen_params;
-	struct fp_procedure *proc = &fp_procedures[bt_conn_index(conn)];
 
-	memcpy(proc->aes_key, account_key->key, FP_ACCOUNT_KEY_LEN);
-
-	err = fp_keys_decrypt(conn, req, keygen_params->req_enc);
-	if (err) {
-		return false;
-	}
+	return !keygen_params->req_validate_cb(ak_check_context->conn, req,
+					       keygen_params->context);
+}
 
-	err = keygen_params->req_validate_cb(conn, req, keygen_params->context);
-	if (err) {
-		return false;
-	}
+static bool account_key_match(const struct fp_account_key *account_key, void *context)
+{
+	const struct fp_account_key *found_key = context;
 
-	return true;
+	return !memcmp(account_key->key, found_key->key, sizeof(account_key->key));
 }
 
 static int key_gen_account_key(const struct bt_conn *conn,
 			       struct fp_keys_keygen_params *keygen_params)
 {
+	struct fp_procedure *proc = &fp_procedures[bt_conn_index(conn)];
+	struct fp_account_key ak[CONFIG_BT_FAST_PAIR_STORAGE_ACCOUNT_KEY_MAX];
+	size_t ak_cnt = ARRAY_SIZE(ak);
+	uint8_t req[FP_CRYPTO_AES128_BLOCK_LEN];
 	struct fp_key_gen_account_key_check_context context = {
 		.conn = conn,
 		.keygen_params = keygen_params,
 	};
+	int idx;
+	int err;
+
+	err = fp_storage_ak_get(ak, &ak_cnt);
+	if (err) {
+		return err;
+	}
 
-	/* This function call assigns the Account Key internally to the Fast Pair Keys
-	 * module. The assignment happens in the provided callback method.
+	/* Try all of the Account Keys in one batch, without going through the storage module
+	 * for each candidate.
 	 */
-	return fp_storage_ak_find(NULL, key_gen_account_key_check, &context);
+	idx = fp_crypto_aes128_ecb_decrypt_find(req, keygen_params->req_enc, ak, ak_cnt,
+						key_gen_account_key_check, &context);
+	if (idx < 0) {
+		err = idx;
+		goto cleanup;
+	}
+
+	memcpy(proc->aes_key, ak[idx].key, FP_ACCOUNT_KEY_LEN);
+
+	/* Mark the found Account Key as recently used. */
+	err = fp_storage_ak_find(NULL, account_key_match, &ak[idx]);
+
+cleanup:
+	memset(ak, 0, sizeof(ak));
+	memset(req, 0, sizeof(req));
+
+	return err;
 }
 
 int fp_keys_generate_key(const struct bt_conn *conn, struct fp_keys_keygen_params *keygen_params)
@@ -25,6 +25,8 @@
 
 #define BOOT_MOUSE_INPUT_REPORT_MIN_SIZE 3
 
+#define INP_REP_QUEUE_SLOT_BOOT_MOUSE CONFIG_BT_HIDS_INPUT_REP_MAX
+
 #define GATT_PERM_READ_MASK     (BT_GATT_PERM_READ | \
 				 BT_GATT_PERM_READ_ENCRYPT | \
 				 BT_GATT_PERM_READ_AUTHEN)
@@ -53,6 +55,10 @@
 
 LOG_MODULE_REGISTER(bt_hids, CONFIG_BT_HIDS_LOG_LEVEL);
 
+#if defined(CONFIG_BT_HIDS_INPUT_REP_QUEUE)
+static void inp_rep_queue_work_handler(struct k_work *work);
+#endif
+
 int bt_hids_connected(struct bt_hids *hids_obj, struct bt_conn *conn)
 {
 	__ASSERT_NO_MSG(conn != NULL);
@@ -94,6 +100,31 @@ int bt_hids_connected(struct bt_hids *hids_obj, struct bt_conn *conn)
 		    hids_obj->outp_rep_group.reports[i].size;
 	}
 
+#if defined(CONFIG_BT_HIDS_INPUT_REP_QUEUE)
+	struct bt_hids_inp_rep_queue *queue =
+		&hids_obj->inp_rep_queue[bt_conn_index(conn)];
+	k_spinlock_key_t key = k_spin_lock(&queue->lock);
+
+	/* Drop the notifications in flight of the previous connection. */
+	queue->tx_head = 0;
+	queue->tx_cnt = 0;
+
+	k_spin_unlock(&queue->lock, key);
+
+	queue->order_head = 0;
+	queue->order_cnt = 0;
+	queue->pending = 0;
+	memset(&queue->stats, 0, sizeof(queue->stats));
+
+	/* Assign queued input report context. */
+	queue->rep_ctx = conn_data->feat_rep_ctx;
+	cnt = MIN(hids_obj->feat_rep_group.cnt, ARRAY_SIZE(hids_obj->feat_rep_group.reports));
+
+	for (size_t i = 0; i < cnt; i++) {
+		queue->rep_ctx += hids_obj->feat_rep_group.reports[i].size;
+	}
+#endif
+
 	bt_conn_ctx_release(hids_obj->conn_ctx, (void *)conn_data);
 
 	return 0;
@@ -898,6 +929,10 @@ int bt_hids_init(struct bt_hids *hids_obj,
 	hids_obj->pm.evt_handler = init_param->pm_evt_handler;
 	hids_obj->cp.evt_handler = init_param->cp_evt_handler;
 
+#if defined(CONFIG_BT_HIDS_INPUT_REP_QUEUE)
+	k_work_init(&hids_obj->inp_rep_queue_work, inp_rep_queue_work_handler);
+#endif
+
 	/* Register primary service. */
 	BT_GATT_POOL_SVC(&hids_obj->gp, BT_UUID_HIDS);
 
@@ -1024,6 +1059,12 @@ int bt_hids_uninit(struct bt_hids *hids_obj)
 	struct bt_gatt_attr *attr_start = hids_obj->gp.svc.attrs;
 	struct bt_conn_ctx_lib *conn_ctx = hids_obj->conn_ctx;
 
+#if defined(CONFIG_BT_HIDS_INPUT_REP_QUEUE)
+	struct k_work_sync sync;
+
+	k_work_cancel_sync(&hids_obj->inp_rep_queue_work, &sync);
+#endif
+
 	/* Free the whole GATT pool */
 	bt_gatt_pool_free(&hids_obj->gp);
 
@@ -1038,6 +1079,277 @@ int bt_hids_uninit(struct bt_hids *hids_obj)
 	return 0;
 }
 
+#if defined(CONFIG_BT_HIDS_INPUT_REP_QUEUE)
+static struct bt_gatt_attr *inp_rep_queue_attr_get(struct bt_hids *hids_obj,
+						   uint8_t slot)
+{
+	if (slot == INP_REP_QUEUE_SLOT_BOOT_MOUSE) {
+		return &hids_obj->gp.svc.attrs[hids_obj->boot_mouse_inp_rep.att_ind];
+	}
+
+	return &hids_obj->gp.svc.attrs[hids_obj->inp_rep_group.reports[slot].att_ind];
+}
+
+static uint8_t *inp_rep_queue_buf_get(struct bt_hids *hids_obj,
+				      struct bt_hids_inp_rep_queue *queue,
+				      uint8_t slot, uint8_t *len)
+{
+	if (slot == INP_REP_QUEUE_SLOT_BOOT_MOUSE) {
+		*len = sizeof(queue->boot_mouse_rep);
+		return queue->boot_mouse_rep;
+	}
+
+	*len = hids_obj->inp_rep_group.reports[slot].size;
+	return queue->rep_ctx + hids_obj->inp_rep_group.reports[slot].offset;
+}
+
+static bool inp_rep_queue_tx_available(struct bt_hids_inp_rep_queue *queue)
+{
+	k_spinlock_key_t key = k_spin_lock(&queue->lock);
+	bool available = (queue->tx_cnt < ARRAY_SIZE(queue->tx_cb));
+
+	k_spin_unlock(&queue->lock, key);
+
+	return available;
+}
+
+static void inp_rep_queue_sent(struct bt_conn *conn, void *user_data)
+{
+	struct bt_hids *hids_obj = user_data;
+	struct bt_hids_inp_rep_queue *queue =
+		&hids_obj->inp_rep_queue[bt_conn_index(conn)];
+	bt_gatt_complete_func_t cb = NULL;
+	k_spinlock_key_t key = k_spin_lock(&queue->lock);
+
+	if (queue->tx_cnt > 0) {
+		cb = queue->tx_cb[queue->tx_head];
+		queue->tx_head = (queue->tx_head + 1) % ARRAY_SIZE(queue->tx_cb);
+		queue->tx_cnt--;
+	}
+
+	k_spin_unlock(&queue->lock, key);
+
+	/* The connection context cannot be locked in the notification
+	 * complete callback, so the next queued reports are sent from the
+	 * work queue.
+	 */
+	k_work_submit(&hids_obj->inp_rep_queue_work);
+
+	if (cb) {
+		cb(conn, NULL);
+	}
+}
+
+static int inp_rep_queue_notify(struct bt_hids *hids_obj, struct bt_conn *conn,
+				struct bt_hids_inp_rep_queue *queue,
+				uint8_t slot, uint8_t const *rep, uint8_t len,
+				bt_gatt_complete_func_t cb)
+{
+	struct bt_gatt_notify_params params = {0};
+	k_spinlock_key_t key;
+	int err;
+
+	params.attr = inp_rep_queue_attr_get(hids_obj, slot);
+	params.data = rep;
+	params.len = len;
+	params.func = inp_rep_queue_sent;
+	params.user_data = hids_obj;
+
+	/* Record the notification before sending it, because it can complete
+	 * before bt_gatt_notify_cb() returns.
+	 */
+	key = k_spin_lock(&queue->lock);
+	queue->tx_cb[(queue->tx_head + queue->tx_cnt) % ARRAY_SIZE(queue->tx_cb)] = cb;
+	queue->tx_cnt++;
+	k_spin_unlock(&queue->lock, key);
+
+	err = bt_gatt_notify_cb(conn, &params);
+	if (err) {
+		/* Only the sender with the connection context locked adds
+		 * notifications, so the last one is still this one.
+		 */
+		key = k_spin_lock(&queue->lock);
+		queue->tx_cnt--;
+		k_spin_unlock(&queue->lock, key);
+
+		return err;
+	}
+
+	queue->stats.sent++;
+
+	return 0;
+}
+
+static void inp_rep_queue_process(struct bt_hids *hids_obj,
+				  struct bt_conn *conn,
+				  struct bt_hids_inp_rep_queue *queue)
+{
+	while ((queue->order_cnt > 0) && inp_rep_queue_tx_available(queue)) {
+		uint8_t slot = queue->order[queue->order_head];
+		uint8_t len;
+		uint8_t *rep = inp_rep_queue_buf_get(hids_obj, queue, slot, &len);
+		int err;
+
+		err = inp_rep_queue_notify(hids_obj, conn, queue, slot, rep, len,
+					   queue->cb[slot]);
+		if (err == -ENOMEM) {
+			/* Retried when a notification completes or a report
+			 * is sent.
+			 */
+			break;
+		} else if (err) {
+			LOG_WRN("Queued report dropped (err %d)", err);
+			queue->stats.dropped++;
+		}
+
+		queue->pending &= ~BIT(slot);
+		queue->order_head = (queue->order_head + 1) % ARRAY_SIZE(queue->order);
+		queue->order_cnt--;
+	}
+}
+
+static void inp_rep_queue_work_handler(struct k_work *work)
+{
+	struct bt_hids *hids_obj =
+		CONTAINER_OF(work, struct bt_hids, inp_rep_queue_work);
+	const size_t contexts = bt_conn_ctx_count(hids_obj->conn_ctx);
+
+	for (size_t i = 0; i < contexts; i++) {
+		const struct bt_conn_ctx *ctx =
+			bt_conn_ctx_get_by_id(hids_obj->conn_ctx, i);
+
+		if (ctx) {
+			inp_rep_queue_process(
+				hids_obj, ctx->conn,
+				&hids_obj->inp_rep_queue[bt_conn_index(ctx->conn)]);
+
+			bt_conn_ctx_release(hids_obj->conn_ctx,
+					    (void *)ctx->data);
+		}
+	}
+}
+
+static int boot_mouse_delta_merge(uint8_t *queued, uint8_t delta)
+{
+	int16_t sum = (int8_t)*queued + (int8_t)delta;
+
+	if ((sum < INT8_MIN) || (sum > INT8_MAX)) {
+		return -EBUSY;
+	}
+
+	*queued = (uint8_t)sum;
+
+	return 0;
+}
+
+static int inp_rep_queue_merge(struct bt_hids *hids_obj, uint8_t slot,
+			       uint8_t *queued, uint8_t const *rep, uint8_t len)
+{
+	if (slot == INP_REP_QUEUE_SLOT_BOOT_MOUSE) {
+		uint8_t x = queued[1];
+		uint8_t y = queued[2];
+
+		/* A change of the buttons state is never merged. */
+		if ((queued[0] != rep[0]) ||
+		    boot_mouse_delta_merge(&x, rep[1]) ||
+		    boot_mouse_delta_merge(&y, rep[2])) {
+			return -EBUSY;
+		}
+
+		queued[1] = x;
+		queued[2] = y;
+
+		return 0;
+	}
+
+	const struct bt_hids_inp_rep *hids_inp_rep =
+		&hids_obj->inp_rep_group.reports[slot];
+
+	switch (hids_inp_rep->merge) {
+	case BT_HIDS_INP_REP_MERGE_REPLACE:
+		memcpy(queued, rep, len);
+		return 0;
+	case BT_HIDS_INP_REP_MERGE_CB:
+		__ASSERT_NO_MSG(hids_inp_rep->merge_cb);
+		return hids_inp_rep->merge_cb(queued, rep, len);
+	case BT_HIDS_INP_REP_MERGE_NONE:
+	default:
+		return -EBUSY;
+	}
+}
+
+static int inp_rep_queue_submit(struct bt_hids *hids_obj, struct bt_conn *conn,
+				uint8_t slot, uint8_t const *rep, uint8_t len,
+				bt_gatt_complete_func_t cb)
+{
+	struct bt_hids_inp_rep_queue *queue =
+		&hids_obj->inp_rep_queue[bt_conn_index(conn)];
+	uint8_t *queued;
+	uint8_t queued_len;
+	int err;
+
+	if (!queue->pending && inp_rep_queue_tx_available(queue)) {
+		err = inp_rep_queue_notify(hids_obj, conn, queue, slot, rep, len, cb);
+		if (err != -ENOMEM) {
+			return err;
+		}
+	}
+
+	queued = inp_rep_queue_buf_get(hids_obj, queue, slot, &queued_len);
+	__ASSERT_NO_MSG(queued_len == len);
+
+	if (queue->pending & BIT(slot)) {
+		err = inp_rep_queue_merge(hids_obj, slot, queued, rep, len);
+		if (err) {
+			queue->stats.dropped++;
+			return err;
+		}
+
+		/* Only the callback of the latest merged report is called. */
+		queue->cb[slot] = cb;
+		queue->stats.merged++;
+	} else {
+		memcpy(queued, rep, len);
+		queue->cb[slot] = cb;
+		queue->pending |= BIT(slot);
+		queue->order[(queue->order_head + queue->order_cnt) %
+			     ARRAY_SIZE(queue->order)] = slot;
+		queue->order_cnt++;
+	}
+
+	inp_rep_queue_process(hids_obj, conn, queue);
+
+	return 0;
+}
+#endif /* CONFIG_BT_HIDS_INPUT_REP_QUEUE */
+
+int bt_hids_inp_rep_queue_stats_get(struct bt_hids *hids_obj,
+				    struct bt_conn *conn,
+				    struct bt_hids_inp_rep_queue_stats *stats)
+{
+#if defined(CONFIG_BT_HIDS_INPUT_REP_QUEUE)
+	__ASSERT_NO_MSG(hids_obj != NULL);
+	__ASSERT_NO_MSG(conn != NULL);
+	__ASSERT_NO_MSG(stats != NULL);
+
+	struct bt_hids_conn_data *conn_data =
+		bt_conn_ctx_get(hids_obj->conn_ctx, conn);
+
+	if (!conn_data) {
+		LOG_WRN("The context was not found");
+		return -EINVAL;
+	}
+
+	*stats = hids_obj->inp_rep_queue[bt_conn_index(conn)].stats;
+
+	bt_conn_ctx_release(hids_obj->conn_ctx, (void *)conn_data);
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
 static void store_input_report(struct bt_hids_inp_rep *hids_inp_rep,
 			       uint8_t *rep_data, uint8_t const *rep,
 			       uint8_t len)
@@ -1065,6 +1377,7 @@ static int inp_rep_notify_all(struct bt_hids *hids_obj,
 	uint8_t *rep_data = NULL;
 	struct bt_gatt_attr *rep_attr =
 		&hids_obj->gp.svc.attrs[hids_inp_rep->att_ind];
+	int ret = 0;
 
 	const size_t contexts =
 	    bt_conn_ctx_count(hids_obj->conn_ctx);
@@ -1084,6 +1397,17 @@ static int inp_rep_notify_all(struct bt_hids *hids_obj,
 
 				store_input_report(hids_inp_rep, rep_data, rep,
 						   len);
+
+#if defined(CONFIG_BT_HIDS_INPUT_REP_QUEUE)
+				int err = inp_rep_queue_submit(hids_obj,
+							       ctx->conn,
+							       hids_inp_rep->idx,
+							       rep, len, cb);
+
+				if (err && !ret) {
+					ret = err;
+				}
+#endif
 			}
 
 			bt_conn_ctx_release(hids_obj->conn_ctx,
@@ -1091,6 +1415,10 @@ static int inp_rep_notify_all(struct bt_hids *hids_obj,
 		}
 	}
 
+	if (IS_ENABLED(CONFIG_BT_HIDS_INPUT_REP_QUEUE)) {
+		return (rep_data != NULL) ? ret : -ENODATA;
+	}
+
 	if (rep_data != NULL) {
 		struct bt_gatt_notify_params params = {0};
 
@@ -1140,6 +1468,10 @@ int bt_hids_inp_rep_send(struct bt_hids *hids_obj,
 
 	store_input_report(hids_inp_rep, rep_data, rep, len);
 
+#if defined(CONFIG_BT_HIDS_INPUT_REP_QUEUE)
+	int err = inp_rep_queue_submit(hids_obj, conn, rep_index, rep, len,
+				       cb);
+#else
 	struct bt_gatt_notify_params params = {0};
 
 	params.attr = &hids_obj->gp.svc.attrs[hids_inp_rep->att_ind];
@@ -1148,6 +1480,7 @@ int bt_hids_inp_rep_send(struct bt_hids *hids_obj,
 	params.func = cb;
 
 	int err = bt_gatt_notify_cb(conn, &params);
+#endif
 
 	bt_conn_ctx_release(hids_obj->conn_ctx, (void *)conn_data);
 
@@ -1164,6 +1497,7 @@ static int boot_mouse_inp_report_notify_all(
 	struct bt_gatt_attr *rep_attr = &hids_obj->gp.svc.attrs[rep_ind];
 	uint8_t *rep_data = NULL;
 	uint8_t rep_buff[BT_HIDS_BOOT_MOUSE_REP_LEN] = {0};
+	int ret = 0;
 
 	rep_buff[1] = (uint8_t)x_delta;
 	rep_buff[2] = (uint8_t)y_delta;
@@ -1191,6 +1525,17 @@ static int boot_mouse_inp_report_notify_all(
 				}
 
 				rep_buff[0] = rep_data[0];
+
+#if defined(CONFIG_BT_HIDS_INPUT_REP_QUEUE)
+				int err = inp_rep_queue_submit(
+					hids_obj, ctx->conn,
+					INP_REP_QUEUE_SLOT_BOOT_MOUSE,
+					rep_buff, sizeof(rep_buff), cb);
+
+				if (err && !ret) {
+					ret = err;
+				}
+#endif
 			}
 
 			bt_conn_ctx_release(hids_obj->conn_ctx,
@@ -1198,6 +1543,10 @@ static int boot_mouse_inp_report_notify_all(
 		}
 	}
 
+	if (IS_ENABLED(CONFIG_BT_HIDS_INPUT_REP_QUEUE)) {
+		return (rep_data != NULL) ? ret : -ENODATA;
+	}
+
 	if (rep_data != NULL) {
 		struct bt_gatt_notify_params params = {0};
 
@@ -1254,6 +1603,12 @@ int bt_hids_boot_mouse_inp_rep_send(struct bt_hids *hids_obj,
 	rep_data[1] = (uint8_t)x_delta;
 	rep_data[2] = (uint8_t)y_delta;
 
+#if defined(CONFIG_BT_HIDS_INPUT_REP_QUEUE)
+	int err = inp_rep_queue_submit(hids_obj, conn,
+				       INP_REP_QUEUE_SLOT_BOOT_MOUSE, rep_data,
+				       sizeof(conn_data->hids_boot_mouse_inp_rep_ctx),
+				       cb);
+#else
 	struct bt_gatt_notify_params params = {0};
 
 	params.attr = &hids_obj->gp.svc.attrs[rep_ind];
@@ -1262,6 +1617,7 @@ int bt_hids_boot_mouse_inp_rep_send(struct bt_hids *hids_obj,
 	params.func = cb;
 
 	int err = bt_gatt_notify_cb(conn, &params);
+#endif
 
 	rep_data[1] = 0;
 	rep_data[2] = 0;
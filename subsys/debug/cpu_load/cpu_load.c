@@ -16,6 +16,7 @@
 #include <hal/nrf_power.h>
 #include <debug/ppi_trace.h>
 #include <zephyr/logging/log.h>
+#include "cpu_load_profile.h"
 
 LOG_MODULE_REGISTER(cpu_load, CONFIG_CPU_LOAD_LOG_LEVEL);
 
@@ -103,12 +104,61 @@ static void ppi_cleanup(uint8_t ch_tick, uint8_t ch_sleep, uint8_t ch_wakeup)
 	}
 }
 
+struct profile_ctx {
+	const struct shell *shell;
+	uint32_t load;
+	uint64_t total;
+};
+
+/* Share of the measurement period used by the profile entry, in the same
+ * units as the CPU load.
+ */
+static uint32_t profile_load_get(const struct cpu_load_profile_entry *entry,
+				 const struct profile_ctx *ctx)
+{
+	return (ctx->total > 0) ? (uint32_t)((entry->cycles * ctx->load) / ctx->total) : 0;
+}
+
+static const char *profile_thread_name_get(const struct cpu_load_profile_entry *entry)
+{
+	const char *name;
+
+	if (!entry->thread) {
+		return "other";
+	}
+
+	name = k_thread_name_get((k_tid_t)entry->thread);
+
+	return (name && name[0]) ? name : "unnamed";
+}
+
+static void profile_log(const struct cpu_load_profile_entry *entry, void *user_data)
+{
+	uint32_t load = profile_load_get(entry, user_data);
+
+	if (entry->type == CPU_LOAD_PROFILE_THREAD) {
+		LOG_INF("Thread %s (%p): %d,%03d%%", profile_thread_name_get(entry),
+			(void *)entry->thread, load / 1000, load % 1000);
+	} else {
+		LOG_INF("IRQ %d: %d,%03d%%", entry->irq, load / 1000, load % 1000);
+	}
+}
+
 static void cpu_load_log_fn(struct k_work *item)
 {
 	uint32_t load = cpu_load_get();
 	uint32_t percent = load / 1000;
 	uint32_t fraction = load % 1000;
 
+	if (IS_ENABLED(CONFIG_CPU_LOAD_PROFILE)) {
+		struct profile_ctx ctx = {
+			.load = load,
+			.total = cpu_load_profile_total_get(),
+		};
+
+		cpu_load_profile_foreach(profile_log, &ctx);
+	}
+
 	cpu_load_reset();
 	LOG_INF("Load:%d,%03d%%", percent, fraction);
 	k_work_schedule(&cpu_load_log, K_MSEC(CPU_LOAD_LOG_INTERVAL));
@@ -197,6 +247,10 @@ int cpu_load_init(void)
 				(IS_CH_SHARED(ch_wakeup) ? 0 : BIT(ch_wakeup)) |
 				(IS_CH_SHARED(ch_tick) ? 0 : BIT(ch_tick)));
 
+	if (IS_ENABLED(CONFIG_CPU_LOAD_PROFILE)) {
+		cpu_load_profile_init();
+	}
+
 	cpu_load_reset();
 
 	if (IS_ENABLED(CONFIG_CPU_LOAD_LOG_PERIODIC)) {
@@ -215,6 +269,11 @@ void cpu_load_reset(void)
 {
 	nrfx_timer_clear(&timer);
 	cycle_ref = k_cycle_get_32();
+
+	if (IS_ENABLED(CONFIG_CPU_LOAD_PROFILE)) {
+		cpu_load_profile_reset();
+		cpu_load_work_hist_reset();
+	}
 }
 
 static uint32_t sleep_ticks_to_us(uint32_t ticks)
@@ -270,6 +329,74 @@ static int cmd_cpu_load_get(const struct shell *shell, size_t argc, char **argv)
 	return 0;
 }
 
+static uint32_t profile_us_get(const struct cpu_load_profile_entry *entry)
+{
+	return (uint32_t)(entry->cycles / (SystemCoreClock / NRFX_MHZ_TO_HZ(1)));
+}
+
+static void profile_print(const struct cpu_load_profile_entry *entry, void *user_data)
+{
+	const struct profile_ctx *ctx = user_data;
+	uint32_t load = profile_load_get(entry, ctx);
+
+	if (entry->type == CPU_LOAD_PROFILE_THREAD) {
+		shell_print(ctx->shell, "%-20s %-10p %8u %12u %3d,%03d%%",
+			    profile_thread_name_get(entry), (void *)entry->thread,
+			    entry->count, profile_us_get(entry), load / 1000, load % 1000);
+	} else {
+		shell_print(ctx->shell, "IRQ %-16d %-10s %8u %12u %3d,%03d%%",
+			    entry->irq, "", entry->count, profile_us_get(entry),
+			    load / 1000, load % 1000);
+	}
+}
+
+static int cmd_cpu_load_profile(const struct shell *shell, size_t argc, char **argv)
+{
+	struct profile_ctx ctx = {
+		.shell = shell,
+	};
+
+	if (!IS_ENABLED(CONFIG_CPU_LOAD_PROFILE)) {
+		shell_error(shell, "Profiling disabled.");
+		return 0;
+	}
+
+	if (!ready) {
+		shell_error(shell, "Not initialized.");
+		return 0;
+	}
+
+	ctx.load = cpu_load_get();
+	ctx.total = cpu_load_profile_total_get();
+
+	shell_print(shell, "%-20s %-10s %8s %12s %8s", "Context", "Thread", "Runs", "Time [us]",
+		    "Load");
+	cpu_load_profile_foreach(profile_print, &ctx);
+
+	return 0;
+}
+
+static int cmd_cpu_load_hist(const struct shell *shell, size_t argc, char **argv)
+{
+	if (!IS_ENABLED(CONFIG_CPU_LOAD_PROFILE)) {
+		shell_error(shell, "Profiling disabled.");
+		return 0;
+	}
+
+#ifdef CONFIG_CPU_LOAD_PROFILE
+	STRUCT_SECTION_FOREACH(cpu_load_work_hist, hist) {
+		shell_print(shell, "%s (max %u cycles):", hist->name, *hist->max);
+
+		for (size_t i = 0; i < CONFIG_CPU_LOAD_PROFILE_HIST_BINS; i++) {
+			shell_print(shell, "  < %10u: %u", cpu_load_work_hist_bin_limit(i),
+				    (uint32_t)atomic_get(&hist->bins[i]));
+		}
+	}
+#endif
+
+	return 0;
+}
+
 static int cmd_cpu_load_reset(const struct shell *shell,
 				size_t argc, char **argv)
 {
@@ -292,6 +419,12 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_cmd_cpu_load,
 			cmd_cpu_load_reset, 1, 0),
 	SHELL_CMD_ARG(init, NULL, "Init",
 			cmd_cpu_load_reset, 1, 0),
+	SHELL_COND_CMD_ARG(CONFIG_CPU_LOAD_PROFILE, profile, NULL,
+			"Get load of threads and interrupts",
+			cmd_cpu_load_profile, 1, 0),
+	SHELL_COND_CMD_ARG(CONFIG_CPU_LOAD_PROFILE, hist, NULL,
+			"Get work item execution time histograms",
+			cmd_cpu_load_hist, 1, 0),
 	SHELL_SUBCMD_SET_END
 );
 
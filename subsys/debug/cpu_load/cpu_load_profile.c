@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <string.h>
+#include <debug/cpu_load.h>
+#include <zephyr/tracing/tracing.h>
+#include <nrfx.h>
+#include "cpu_load_profile.h"
+
+/* Number of the interrupt lines, with one extra slot for the system exceptions. */
+#define IRQ_SLOTS (CONFIG_NUM_IRQS + 1)
+#define IRQ_SLOT_EXCEPTION CONFIG_NUM_IRQS
+
+/* Every interrupt priority level can preempt the lower one only once. */
+#define IRQ_NESTING_MAX (BIT(__NVIC_PRIO_BITS) + 1)
+
+/* The first histogram bin counts executions shorter than 2^HIST_BIN_SHIFT cycles. */
+#define HIST_BIN_SHIFT 6
+#define HIST_BINS CONFIG_CPU_LOAD_PROFILE_HIST_BINS
+
+#define THREAD_SLOTS CONFIG_CPU_LOAD_PROFILE_THREADS
+
+struct usage {
+	uint64_t cycles;
+	uint32_t count;
+};
+
+struct thread_usage {
+	const struct k_thread *thread;
+	struct usage usage;
+};
+
+static bool enabled;
+static uint32_t cycle_last;
+
+/* Threads are looked up by the address, using linear probing. */
+static struct thread_usage threads[THREAD_SLOTS];
+static struct usage thread_other;
+static struct thread_usage *thread_curr;
+
+static struct usage irqs[IRQ_SLOTS];
+static uint16_t irq_stack[IRQ_NESTING_MAX];
+static size_t irq_depth;
+
+/* The hooks are called also from zero latency interrupts, so the interrupts
+ * must be masked with PRIMASK and not with irq_lock().
+ */
+static inline uint32_t lock(void)
+{
+	uint32_t key = __get_PRIMASK();
+
+	__disable_irq();
+
+	return key;
+}
+
+static inline void unlock(uint32_t key)
+{
+	__set_PRIMASK(key);
+}
+
+static struct thread_usage *thread_usage_get(const struct k_thread *thread)
+{
+	size_t idx = ((uintptr_t)thread >> 3) % THREAD_SLOTS;
+
+	for (size_t i = 0; i < THREAD_SLOTS; i++) {
+		if (threads[idx].thread == thread) {
+			return &threads[idx];
+		}
+
+		if (!threads[idx].thread) {
+			threads[idx].thread = thread;
+			return &threads[idx];
+		}
+
+		idx = (idx + 1) % THREAD_SLOTS;
+	}
+
+	return NULL;
+}
+
+static size_t irq_slot_get(void)
+{
+	int irq = (int)__get_IPSR() - 16;
+
+	return (irq >= 0) && (irq < CONFIG_NUM_IRQS) ? irq : IRQ_SLOT_EXCEPTION;
+}
+
+/* Charge the cycles since the last event to the context that was running. */
+static void charge(void)
+{
+	uint32_t now = DWT->CYCCNT;
+	uint32_t cycles = now - cycle_last;
+
+	cycle_last = now;
+
+	if (irq_depth > 0) {
+		irqs[irq_stack[irq_depth - 1]].cycles += cycles;
+	} else if (thread_curr) {
+		thread_curr->usage.cycles += cycles;
+	} else {
+		thread_other.cycles += cycles;
+	}
+}
+
+void sys_trace_thread_switched_out_user(void)
+{
+	uint32_t key;
+
+	if (!enabled) {
+		return;
+	}
+
+	key = lock();
+	charge();
+	unlock(key);
+}
+
+void sys_trace_thread_switched_in_user(void)
+{
+	uint32_t key;
+
+	if (!enabled) {
+		return;
+	}
+
+	key = lock();
+
+	/* The context switch itself is charged to the incoming thread. */
+	thread_curr = thread_usage_get(k_current_get());
+	charge();
+
+	if (thread_curr) {
+		thread_curr->usage.count++;
+	} else {
+		thread_other.count++;
+	}
+
+	unlock(key);
+}
+
+void sys_trace_isr_enter_user(int nested_interrupts)
+{
+	uint32_t key;
+	size_t slot;
+
+	ARG_UNUSED(nested_interrupts);
+
+	if (!enabled) {
+		return;
+	}
+
+	key = lock();
+	charge();
+
+	if (irq_depth < ARRAY_SIZE(irq_stack)) {
+		slot = irq_slot_get();
+		irq_stack[irq_depth++] = slot;
+		irqs[slot].count++;
+	}
+
+	unlock(key);
+}
+
+void sys_trace_isr_exit_user(int nested_interrupts)
+{
+	uint32_t key;
+
+	ARG_UNUSED(nested_interrupts);
+
+	if (!enabled) {
+		return;
+	}
+
+	key = lock();
+	charge();
+
+	if (irq_depth > 0) {
+		irq_depth--;
+	}
+
+	unlock(key);
+}
+
+void cpu_load_profile_init(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	cpu_load_profile_reset();
+}
+
+void cpu_load_profile_reset(void)
+{
+	uint32_t key = lock();
+
+	memset(threads, 0, sizeof(threads));
+	memset(&thread_other, 0, sizeof(thread_other));
+	memset(irqs, 0, sizeof(irqs));
+
+	/* The interrupt stack is kept, as the reset can happen in an interrupt. */
+	thread_curr = k_is_pre_kernel() ? NULL : thread_usage_get(k_current_get());
+	cycle_last = DWT->CYCCNT;
+	enabled = true;
+
+	unlock(key);
+}
+
+uint32_t cpu_load_cycles_get(void)
+{
+	return DWT->CYCCNT;
+}
+
+void cpu_load_profile_foreach(cpu_load_profile_cb_t cb, void *user_data)
+{
+	struct cpu_load_profile_entry entry;
+	uint32_t key;
+
+	__ASSERT_NO_MSG(cb);
+
+	for (size_t i = 0; i < ARRAY_SIZE(threads); i++) {
+		key = lock();
+		entry.type = CPU_LOAD_PROFILE_THREAD;
+		entry.thread = threads[i].thread;
+		entry.irq = 0;
+		entry.cycles = threads[i].usage.cycles;
+		entry.count = threads[i].usage.count;
+		unlock(key);
+
+		if (entry.thread) {
+			cb(&entry, user_data);
+		}
+	}
+
+	key = lock();
+	entry.type = CPU_LOAD_PROFILE_THREAD;
+	entry.thread = NULL;
+	entry.irq = 0;
+	entry.cycles = thread_other.cycles;
+	entry.count = thread_other.count;
+	unlock(key);
+
+	if (entry.cycles > 0) {
+		cb(&entry, user_data);
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(irqs); i++) {
+		key = lock();
+		entry.type = CPU_LOAD_PROFILE_IRQ;
+		entry.thread = NULL;
+		entry.irq = (i == IRQ_SLOT_EXCEPTION) ? -1 : i;
+		entry.cycles = irqs[i].cycles;
+		entry.count = irqs[i].count;
+		unlock(key);
+
+		if (entry.count > 0) {
+			cb(&entry, user_data);
+		}
+	}
+}
+
+uint64_t cpu_load_profile_total_get(void)
+{
+	uint64_t total = 0;
+	uint32_t key = lock();
+
+	/* Include the cycles of the running context up to now. */
+	charge();
+
+	for (size_t i = 0; i < ARRAY_SIZE(threads); i++) {
+		total += threads[i].usage.cycles;
+	}
+
+	total += thread_other.cycles;
+
+	for (size_t i = 0; i < ARRAY_SIZE(irqs); i++) {
+		total += irqs[i].cycles;
+	}
+
+	unlock(key);
+
+	return total;
+}
+
+void cpu_load_work_hist_add(const struct cpu_load_work_hist *hist, uint32_t cycles)
+{
+	uint32_t scaled = cycles >> HIST_BIN_SHIFT;
+	size_t bin = 0;
+
+	__ASSERT_NO_MSG(hist);
+
+	if (scaled > 0) {
+		bin = MIN(32 - __builtin_clz(scaled), HIST_BINS - 1);
+	}
+
+	atomic_inc(&hist->bins[bin]);
+
+	/* A lost update of the maximum is acceptable for profiling. */
+	if (cycles > *hist->max) {
+		*hist->max = cycles;
+	}
+}
+
+uint32_t cpu_load_work_hist_bin_limit(size_t bin)
+{
+	if (bin >= HIST_BINS - 1) {
+		return UINT32_MAX;
+	}
+
+	return BIT(bin + HIST_BIN_SHIFT);
+}
+
+void cpu_load_work_hist_reset(void)
+{
+	STRUCT_SECTION_FOREACH(cpu_load_work_hist, hist) {
+		for (size_t i = 0; i < HIST_BINS; i++) {
+			atomic_clear(&hist->bins[i]);
+		}
+
+		*hist->max = 0;
+	}
+}
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef CPU_LOAD_PROFILE_H_
+#define CPU_LOAD_PROFILE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Enable the cycle counter and start profiling. */
+void cpu_load_profile_init(void);
+
+/** @brief Reset the per-thread and per-interrupt measurement. */
+void cpu_load_profile_reset(void);
+
+/** @brief Reset all work item histograms. */
+void cpu_load_work_hist_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CPU_LOAD_PROFILE_H_ */
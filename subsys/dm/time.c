@@ -21,3 +21,14 @@ uint32_t time_distance_get(uint32_t t1, uint32_t t2)
 
 	return t2 - t1;
 }
+
+int32_t time_diff_get(uint32_t t1, uint32_t t2)
+{
+	uint32_t distance = time_distance_get(t1, t2);
+
+	if (distance > RTC_COUNTER_MAX / 2) {
+		return (int32_t)distance - (int32_t)RTC_COUNTER_MAX - 1;
+	}
+
+	return distance;
+}
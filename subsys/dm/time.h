@@ -36,6 +36,18 @@ uint32_t time_now(void);
  */
 uint32_t time_distance_get(uint32_t t1, uint32_t t2);
 
+/** @brief Calculate the signed difference between t2 and t1.
+ *
+ *  The result is valid if the two times are less than half of the counter
+ *  range apart.
+ *
+ *  @param t1 Start time.
+ *  @param t2 End time.
+ *
+ *  @retval Positive value if t2 is after t1, negative value if t2 is before t1.
+ */
+int32_t time_diff_get(uint32_t t1, uint32_t t2);
+
 #ifdef __cplusplus
 }
 #endif
@@ -14,134 +14,238 @@
 #define MIN_TIME_BETWEEN_TIMESLOTS_US    CONFIG_DM_MIN_TIME_BETWEEN_TIMESLOTS_US
 #define RANGING_OFFSET_US                CONFIG_DM_RANGING_OFFSET_US
 
-static K_MUTEX_DEFINE(list_mtx);
-static sys_slist_t timeslot_list = SYS_SLIST_STATIC_INIT(&timeslot_list);
+/* Keep the peer table at most half full, so that the probe sequences stay short. */
+#define PEER_TABLE_SIZE                  (2 * TIMESLOT_QUEUE_LENGTH)
 
-struct timeslot_entry {
-	struct timeslot_request timeslot_req;
-	sys_snode_t node;
+struct peer_entry {
+	bt_addr_le_t addr;
+	/* Number of queued timeslots of the peer, 0 if the entry is free. */
+	uint8_t count;
 };
 
-static K_HEAP_DEFINE(heap, TIMESLOT_QUEUE_LENGTH * sizeof(struct timeslot_entry));
+BUILD_ASSERT(TIMESLOT_QUEUE_COUNT_SAME_PEER <= UINT8_MAX);
 
-static void list_lock(void)
+static struct k_spinlock lock;
+
+K_MEM_SLAB_DEFINE_STATIC(timeslot_slab, sizeof(struct timeslot_request),
+			 TIMESLOT_QUEUE_LENGTH, 4);
+
+/* Queued timeslots sorted by the start time, the earliest one is the last. */
+static struct timeslot_request *timeslot_queue[TIMESLOT_QUEUE_LENGTH];
+static size_t timeslot_queue_len;
+
+static struct peer_entry peer_table[PEER_TABLE_SIZE];
+
+static size_t peer_hash(const bt_addr_le_t *addr)
 {
-	k_mutex_lock(&list_mtx, K_FOREVER);
+	/* FNV-1a */
+	uint32_t hash = 2166136261U;
+
+	for (size_t i = 0; i < sizeof(addr->a.val); i++) {
+		hash = (hash ^ addr->a.val[i]) * 16777619U;
+	}
+
+	hash = (hash ^ addr->type) * 16777619U;
+
+	return hash % PEER_TABLE_SIZE;
 }
 
-static void list_unlock(void)
+static struct peer_entry *peer_find(const bt_addr_le_t *addr)
 {
-	k_mutex_unlock(&list_mtx);
+	size_t idx = peer_hash(addr);
+
+	/* The table cannot be full, so there is always a free entry to stop at. */
+	while (peer_table[idx].count &&
+	       bt_addr_le_cmp(&peer_table[idx].addr, addr) != 0) {
+		idx = (idx + 1) % PEER_TABLE_SIZE;
+	}
+
+	return &peer_table[idx];
 }
 
-static size_t get_list_size(void)
+static void peer_remove(struct peer_entry *peer)
 {
-	size_t ret = 0;
-	sys_snode_t *node, *tmp;
+	size_t hole = peer - peer_table;
+	size_t idx = hole;
+	size_t home;
+	bool in_range;
+
+	peer->count = 0;
+
+	/* Shift back the following entries of the probe sequence, so that
+	 * the lookups do not stop at the freed entry.
+	 */
+	while (true) {
+		idx = (idx + 1) % PEER_TABLE_SIZE;
+		if (!peer_table[idx].count) {
+			break;
+		}
+
+		home = peer_hash(&peer_table[idx].addr);
+
+		if (hole < idx) {
+			in_range = (home > hole) && (home <= idx);
+		} else {
+			in_range = (home > hole) || (home <= idx);
+		}
 
-	SYS_SLIST_FOR_EACH_NODE_SAFE(&timeslot_list, node, tmp) {
-		ret++;
+		if (!in_range) {
+			peer_table[hole] = peer_table[idx];
+			peer_table[idx].count = 0;
+			hole = idx;
+		}
 	}
+}
 
-	return ret;
+/* Find the position of the timeslot in the queue with a binary search. */
+static size_t queue_position_get(uint32_t start_time)
+{
+	size_t low = 0;
+	size_t high = timeslot_queue_len;
+	size_t mid;
+
+	while (low < high) {
+		mid = low + (high - low) / 2;
+
+		if (time_diff_get(start_time, timeslot_queue[mid]->start_time) > 0) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	return low;
 }
 
-static bool is_request_exist(struct dm_request *req)
+static bool is_time_available(size_t pos, uint32_t start_time, uint32_t timeslot_len_us)
 {
-	uint8_t cnt = 0;
-	sys_snode_t *node, *tmp;
-	struct timeslot_entry *item;
-
-	SYS_SLIST_FOR_EACH_NODE_SAFE(&timeslot_list, node, tmp) {
-		item = CONTAINER_OF(node, struct timeslot_entry, node);
-		if (bt_addr_le_cmp(&item->timeslot_req.dm_req.bt_addr, &req->bt_addr) == 0) {
-			cnt++;
+	const struct timeslot_request *prev;
+	const struct timeslot_request *next;
+
+	/* The earlier timeslot must end before this one starts. */
+	if (pos < timeslot_queue_len) {
+		prev = timeslot_queue[pos];
+
+		if (time_diff_get(prev->start_time, start_time) <
+		    (int32_t)US_TO_RTC_TICKS(prev->timeslot_length_us +
+					     MIN_TIME_BETWEEN_TIMESLOTS_US)) {
+			return false;
 		}
 	}
 
-	return cnt >= TIMESLOT_QUEUE_COUNT_SAME_PEER;
+	/* This timeslot must end before the later one starts. */
+	if (pos > 0) {
+		next = timeslot_queue[pos - 1];
+
+		if (time_diff_get(start_time, next->start_time) <
+		    (int32_t)US_TO_RTC_TICKS(timeslot_len_us + MIN_TIME_BETWEEN_TIMESLOTS_US)) {
+			return false;
+		}
+	}
+
+	return true;
 }
 
 int timeslot_queue_append(struct dm_request *req, uint32_t start_ref_tick,
 			  uint32_t window_len_us, uint32_t timeslot_len_us)
 {
-	uint32_t distance;
 	uint32_t start_time;
 	uint32_t delay;
-	size_t list_size;
-	struct timeslot_entry *last, *item;
+	size_t pos;
+	struct peer_entry *peer;
+	struct timeslot_request *item;
+	k_spinlock_key_t key;
+	int err = 0;
 
 	delay = req->start_delay_us + RANGING_OFFSET_US;
 	start_time = (start_ref_tick + US_TO_RTC_TICKS(delay)) % RTC_COUNTER_MAX;
 
-	list_size = get_list_size();
-	if (list_size >= TIMESLOT_QUEUE_LENGTH) {
-		return -ENOMEM;
-	}
+	key = k_spin_lock(&lock);
 
-	if (list_size != 0) {
-		if (is_request_exist(req)) {
-			return -EAGAIN;
-		}
+	if (timeslot_queue_len >= TIMESLOT_QUEUE_LENGTH) {
+		err = -ENOMEM;
+		goto out;
+	}
 
-		list_lock();
-		last = SYS_SLIST_PEEK_TAIL_CONTAINER(&timeslot_list, last, node);
-		list_unlock();
+	peer = peer_find(&req->bt_addr);
+	if (peer->count >= TIMESLOT_QUEUE_COUNT_SAME_PEER) {
+		err = -EAGAIN;
+		goto out;
+	}
 
-		distance = time_distance_get(last->timeslot_req.start_time, start_time);
-		if (distance < US_TO_RTC_TICKS(last->timeslot_req.timeslot_length_us +
-					       MIN_TIME_BETWEEN_TIMESLOTS_US)) {
-			return -EBUSY;
-		}
+	pos = queue_position_get(start_time);
+	if (!is_time_available(pos, start_time, timeslot_len_us)) {
+		err = -EBUSY;
+		goto out;
 	}
 
-	item = k_heap_alloc(&heap, sizeof(struct timeslot_entry), K_NO_WAIT);
-	if (!item) {
-		return -ENOMEM;
+	if (k_mem_slab_alloc(&timeslot_slab, (void **)&item, K_NO_WAIT)) {
+		err = -ENOMEM;
+		goto out;
 	}
 
-	item->timeslot_req.start_time = start_time;
-	item->timeslot_req.timeslot_length_us = timeslot_len_us;
-	item->timeslot_req.window_length_us = window_len_us;
+	item->start_time = start_time;
+	item->timeslot_length_us = timeslot_len_us;
+	item->window_length_us = window_len_us;
 	req->rng_seed++;
 
-	memcpy(&item->timeslot_req.dm_req, req, sizeof(item->timeslot_req.dm_req));
+	memcpy(&item->dm_req, req, sizeof(item->dm_req));
+
+	memmove(&timeslot_queue[pos + 1], &timeslot_queue[pos],
+		(timeslot_queue_len - pos) * sizeof(timeslot_queue[0]));
+	timeslot_queue[pos] = item;
+	timeslot_queue_len++;
 
-	list_lock();
-	sys_slist_append(&timeslot_list, &item->node);
-	list_unlock();
+	if (!peer->count) {
+		bt_addr_le_copy(&peer->addr, &req->bt_addr);
+	}
+	peer->count++;
 
-	return 0;
+out:
+	k_spin_unlock(&lock, key);
+
+	return err;
 }
 
 struct timeslot_request *timeslot_queue_peek(void)
 {
-	struct timeslot_entry *item;
-
-	list_lock();
-	item = SYS_SLIST_PEEK_HEAD_CONTAINER(&timeslot_list, item, node);
-	list_unlock();
+	struct timeslot_request *item = NULL;
+	k_spinlock_key_t key;
 
-	if (!item) {
-		return NULL;
+	key = k_spin_lock(&lock);
+	if (timeslot_queue_len) {
+		item = timeslot_queue[timeslot_queue_len - 1];
 	}
+	k_spin_unlock(&lock, key);
 
-	return &item->timeslot_req;
+	return item;
 }
 
 void timeslot_queue_remove_first(void)
 {
-	sys_snode_t *node;
-	struct timeslot_entry *item;
+	struct timeslot_request *item;
+	struct peer_entry *peer;
+	k_spinlock_key_t key;
 
-	list_lock();
-	node = sys_slist_get(&timeslot_list);
-	list_unlock();
+	key = k_spin_lock(&lock);
 
-	if (!node) {
+	if (!timeslot_queue_len) {
+		k_spin_unlock(&lock, key);
 		return;
 	}
 
-	item = CONTAINER_OF(node, struct timeslot_entry, node);
-	k_heap_free(&heap, item);
+	timeslot_queue_len--;
+	item = timeslot_queue[timeslot_queue_len];
+
+	peer = peer_find(&item->dm_req.bt_addr);
+	__ASSERT_NO_MSG(peer->count > 0);
+
+	peer->count--;
+	if (!peer->count) {
+		peer_remove(peer);
+	}
+
+	k_mem_slab_free(&timeslot_slab, item);
+
+	k_spin_unlock(&lock, key);
 }
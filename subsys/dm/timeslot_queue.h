@@ -29,13 +29,17 @@ struct timeslot_request {
 	uint32_t window_length_us;
 };
 
-/** @brief Append an element to the end of a queue.
+/** @brief Add an element to the queue.
+ *
+ *  The queue is kept sorted by the start time of the timeslots.
+ *  This function can be called from an interrupt context.
  *
  *  @param req Address of the structure with request parameters.
  *  @param start_ref_tick Reference start time tick.
  *  @param window_len Ranging window length.
  *  @param timeslot_len Timeslot length.
  *
+ *  @retval 0 when the timeslot was added to the queue.
  *  @retval -ENOMEM when the tiemslot queue is full or a memory allocation error.
  *  @retval -EAGAIN when a single peer has a maximum number of timeslots scheduled.
  *  @retval -EBUSY when the timeslot cannot be scheduled due to time restrictions.
@@ -44,6 +48,9 @@ int timeslot_queue_append(struct dm_request *req, uint32_t start_ref_tick,
 			  uint32_t window_len, uint32_t timeslot_len);
 
 /** @brief Peek element at the head of queue.
+ *
+ *  The element is valid until it is removed with
+ *  @ref timeslot_queue_remove_first.
  *
  *  @param None
  *
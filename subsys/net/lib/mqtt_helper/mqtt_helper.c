@@ -45,6 +45,28 @@ MQTT_HELPER_STATIC K_SEM_DEFINE(connection_poll_sem, 0, 1);
 static struct mqtt_helper_cfg current_cfg;
 MQTT_HELPER_STATIC enum mqtt_state mqtt_state = MQTT_STATE_UNINIT;
 
+#if defined(CONFIG_MQTT_HELPER_PUBLISH_QUEUE)
+struct publish_entry {
+	/* Reserved for the FIFO. */
+	void *fifo_reserved;
+	struct mqtt_publish_param param;
+	/* Topic followed by the payload. */
+	uint8_t data[CONFIG_MQTT_HELPER_PUBLISH_QUEUE_MSG_SIZE];
+};
+
+K_MEM_SLAB_DEFINE_STATIC(publish_slab, sizeof(struct publish_entry),
+			 CONFIG_MQTT_HELPER_PUBLISH_QUEUE_LEN, __alignof__(struct publish_entry));
+static K_FIFO_DEFINE(publish_fifo);
+/* Serializes the consumers of publish_fifo: the publish work and the flush on disconnect. */
+static K_MUTEX_DEFINE(publish_queue_lock);
+static K_MUTEX_DEFINE(qos1_lock);
+static uint16_t qos1_in_flight[CONFIG_MQTT_HELPER_QOS1_WINDOW];
+static size_t qos1_in_flight_count;
+static K_THREAD_STACK_DEFINE(publish_stack, CONFIG_MQTT_HELPER_PUBLISH_QUEUE_STACK_SIZE);
+MQTT_HELPER_STATIC struct k_work_q publish_work_q;
+static struct k_work publish_work;
+#endif /* CONFIG_MQTT_HELPER_PUBLISH_QUEUE */
+
 static const char *state_name_get(enum mqtt_state state)
 {
 	switch (state) {
@@ -275,6 +297,156 @@ static void send_ack(struct mqtt_client *const mqtt_client, uint16_t message_id)
 	LOG_DBG("PUBACK sent for message ID %d", message_id);
 }
 
+#if defined(CONFIG_MQTT_HELPER_PUBLISH_QUEUE)
+static bool qos1_in_flight_remove(uint16_t message_id)
+{
+	bool found = false;
+
+	k_mutex_lock(&qos1_lock, K_FOREVER);
+
+	for (size_t i = 0; i < qos1_in_flight_count; i++) {
+		if (qos1_in_flight[i] == message_id) {
+			qos1_in_flight_count--;
+			qos1_in_flight[i] = qos1_in_flight[qos1_in_flight_count];
+			found = true;
+			break;
+		}
+	}
+
+	k_mutex_unlock(&qos1_lock);
+
+	return found;
+}
+
+static bool qos1_in_flight_add(uint16_t message_id)
+{
+	bool added = false;
+
+	k_mutex_lock(&qos1_lock, K_FOREVER);
+
+	if (qos1_in_flight_count < ARRAY_SIZE(qos1_in_flight)) {
+		qos1_in_flight[qos1_in_flight_count++] = message_id;
+		added = true;
+	}
+
+	k_mutex_unlock(&qos1_lock);
+
+	return added;
+}
+
+MQTT_HELPER_STATIC void publish_queue_flush(void)
+{
+	struct publish_entry *entry;
+
+	k_mutex_lock(&publish_queue_lock, K_FOREVER);
+
+	while ((entry = k_fifo_get(&publish_fifo, K_NO_WAIT)) != NULL) {
+		k_mem_slab_free(&publish_slab, entry);
+	}
+
+	k_mutex_unlock(&publish_queue_lock);
+
+	k_mutex_lock(&qos1_lock, K_FOREVER);
+	qos1_in_flight_count = 0;
+	k_mutex_unlock(&qos1_lock);
+}
+
+/* Publish the queued messages until the queue is empty or the QoS 1 window is full. */
+MQTT_HELPER_STATIC void publish_queue_process(void)
+{
+	int err;
+	bool qos1;
+	struct publish_entry *entry;
+
+	k_mutex_lock(&publish_queue_lock, K_FOREVER);
+
+	while ((entry = k_fifo_peek_head(&publish_fifo)) != NULL) {
+		if (!mqtt_state_verify(MQTT_STATE_CONNECTED)) {
+			break;
+		}
+
+		qos1 = (entry->param.message.topic.qos == MQTT_QOS_1_AT_LEAST_ONCE);
+
+		if (qos1 && !qos1_in_flight_add(entry->param.message_id)) {
+			LOG_DBG("QoS 1 window full, waiting for PUBACK");
+			break;
+		}
+
+		/* The queue lock is held, so the flush cannot remove the entry in the meantime
+		 * and the entry is still the head.
+		 */
+		(void)k_fifo_get(&publish_fifo, K_NO_WAIT);
+
+		err = mqtt_publish(&mqtt_client, &entry->param);
+		if (err) {
+			LOG_ERR("Failed to publish queued message, error: %d", err);
+
+			if (qos1) {
+				(void)qos1_in_flight_remove(entry->param.message_id);
+
+				if (current_cfg.cb.on_puback) {
+					current_cfg.cb.on_puback(entry->param.message_id, err);
+				}
+			}
+		}
+
+		k_mem_slab_free(&publish_slab, entry);
+	}
+
+	k_mutex_unlock(&publish_queue_lock);
+}
+
+static void publish_work_fn(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	publish_queue_process();
+}
+
+static void publish_queue_init(void)
+{
+	static bool initialized;
+
+	if (initialized) {
+		return;
+	}
+
+	k_work_init(&publish_work, publish_work_fn);
+	k_work_queue_start(&publish_work_q, publish_stack,
+			   K_THREAD_STACK_SIZEOF(publish_stack),
+			   K_LOWEST_APPLICATION_THREAD_PRIO, NULL);
+	k_thread_name_set(k_work_queue_thread_get(&publish_work_q), "mqtt_helper_publish");
+
+	initialized = true;
+}
+#endif /* CONFIG_MQTT_HELPER_PUBLISH_QUEUE */
+
+static int publish_get_payload_fragmented(const struct mqtt_publish_param *p,
+					  struct mqtt_helper_buf topic)
+{
+	int err;
+	size_t offset = 0;
+	size_t total_len = p->message.payload.len;
+	struct mqtt_helper_buf fragment = {
+		.ptr = payload_buf,
+	};
+
+	do {
+		fragment.size = MIN(total_len - offset, sizeof(payload_buf));
+
+		err = mqtt_readall_publish_payload(&mqtt_client, payload_buf, fragment.size);
+		if (err) {
+			return err;
+		}
+
+		current_cfg.cb.on_publish_fragment(topic, fragment, offset, total_len);
+
+		offset += fragment.size;
+	} while (offset < total_len);
+
+	return 0;
+}
+
 MQTT_HELPER_STATIC void on_publish(const struct mqtt_evt *mqtt_evt)
 {
 	int err;
@@ -287,6 +459,20 @@ MQTT_HELPER_STATIC void on_publish(const struct mqtt_evt *mqtt_evt)
 		.ptr = payload_buf,
 	};
 
+	if (current_cfg.cb.on_publish_fragment) {
+		err = publish_get_payload_fragmented(p, topic);
+		if (err) {
+			LOG_ERR("publish_get_payload_fragmented, error: %d", err);
+			return;
+		}
+
+		if (p->message.topic.qos == MQTT_QOS_1_AT_LEAST_ONCE) {
+			send_ack(&mqtt_client, p->message_id);
+		}
+
+		return;
+	}
+
 	err = publish_get_payload(&mqtt_client, p->message.payload.len);
 	if (err) {
 		LOG_ERR("publish_get_payload, error: %d", err);
@@ -340,6 +526,10 @@ MQTT_HELPER_STATIC void mqtt_evt_handler(struct mqtt_client *const mqtt_client,
 
 		mqtt_state_set(MQTT_STATE_DISCONNECTED);
 
+#if defined(CONFIG_MQTT_HELPER_PUBLISH_QUEUE)
+		publish_queue_flush();
+#endif
+
 		if (current_cfg.cb.on_disconnect) {
 			current_cfg.cb.on_disconnect(mqtt_evt->result);
 		}
@@ -355,6 +545,13 @@ MQTT_HELPER_STATIC void mqtt_evt_handler(struct mqtt_client *const mqtt_client,
 			mqtt_evt->param.puback.message_id,
 			mqtt_evt->result);
 
+#if defined(CONFIG_MQTT_HELPER_PUBLISH_QUEUE)
+		if (qos1_in_flight_remove(mqtt_evt->param.puback.message_id)) {
+			/* Space in the QoS 1 window, continue publishing. */
+			(void)k_work_submit_to_queue(&publish_work_q, &publish_work);
+		}
+#endif
+
 		if (current_cfg.cb.on_puback) {
 			current_cfg.cb.on_puback(mqtt_evt->param.puback.message_id,
 						 mqtt_evt->result);
@@ -583,6 +780,10 @@ int mqtt_helper_init(struct mqtt_helper_cfg *cfg)
 
 	current_cfg = *cfg;
 
+#if defined(CONFIG_MQTT_HELPER_PUBLISH_QUEUE)
+	publish_queue_init();
+#endif
+
 	mqtt_state_set(MQTT_STATE_DISCONNECTED);
 
 	return 0;
@@ -686,6 +887,46 @@ int mqtt_helper_publish(const struct mqtt_publish_param *param)
 	return mqtt_publish(&mqtt_client, param);
 }
 
+#if defined(CONFIG_MQTT_HELPER_PUBLISH_QUEUE)
+int mqtt_helper_publish_queued(const struct mqtt_publish_param *param)
+{
+	struct publish_entry *entry;
+	size_t topic_len = param->message.topic.topic.size;
+	size_t payload_len = param->message.payload.len;
+
+	if (!mqtt_state_verify(MQTT_STATE_CONNECTED)) {
+		LOG_ERR("Library is in the wrong state (%s), %s required",
+			state_name_get(mqtt_state_get()),
+			state_name_get(MQTT_STATE_CONNECTED));
+
+		return -EOPNOTSUPP;
+	}
+
+	if (topic_len + payload_len > sizeof(entry->data)) {
+		LOG_ERR("Message too large for the publish queue");
+		return -EMSGSIZE;
+	}
+
+	if (k_mem_slab_alloc(&publish_slab, (void **)&entry, K_NO_WAIT)) {
+		LOG_WRN("Publish queue full");
+		return -ENOMEM;
+	}
+
+	entry->param = *param;
+	memcpy(entry->data, param->message.topic.topic.utf8, topic_len);
+	memcpy(&entry->data[topic_len], param->message.payload.data, payload_len);
+	entry->param.message.topic.topic.utf8 = entry->data;
+	entry->param.message.payload.data = &entry->data[topic_len];
+
+	LOG_DBG("Queued message to topic: %.*s", (int)topic_len, (char *)entry->data);
+
+	k_fifo_put(&publish_fifo, entry);
+	(void)k_work_submit_to_queue(&publish_work_q, &publish_work);
+
+	return 0;
+}
+#endif /* CONFIG_MQTT_HELPER_PUBLISH_QUEUE */
+
 int mqtt_helper_deinit(void)
 {
 	if (!mqtt_state_verify(MQTT_STATE_DISCONNECTED)) {
@@ -696,6 +937,10 @@ int mqtt_helper_deinit(void)
 		return -EOPNOTSUPP;
 	}
 
+#if defined(CONFIG_MQTT_HELPER_PUBLISH_QUEUE)
+	publish_queue_flush();
+#endif
+
 	memset(&current_cfg, 0, sizeof(current_cfg));
 	memset(&mqtt_client, 0, sizeof(mqtt_client));
 
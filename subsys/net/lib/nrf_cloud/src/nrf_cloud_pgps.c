@@ -104,8 +104,20 @@ static pgps_event_handler_t evt_handler;
 static uint8_t *write_buf;
 
 #if defined(CONFIG_PM_PARTITION_REGION_PGPS_EXTERNAL)
-static off_t prediction_cache_flash_offset = UINT32_MAX;
-static uint8_t prediction_cache[PGPS_PREDICTION_STORAGE_SIZE];
+#define PREDICTION_CACHE_SIZE		CONFIG_NRF_CLOUD_PGPS_PREDICTION_CACHE_SIZE
+#define PREDICTION_CACHE_NONE		((off_t)UINT32_MAX)
+
+/* Bytes preceding the ephemerides; enough to locate and check a prediction */
+#define PREDICTION_HEADER_SIZE		offsetof(struct nrf_cloud_pgps_prediction, ephemerii)
+
+struct prediction_cache_entry {
+	off_t flash_offset;
+	uint32_t last_used;
+	uint8_t buf[PGPS_PREDICTION_STORAGE_SIZE] __aligned(4);
+};
+
+static struct prediction_cache_entry prediction_cache[PREDICTION_CACHE_SIZE];
+static uint32_t prediction_cache_use_count;
 #endif
 
 static uint8_t prediction_buf[PGPS_PREDICTION_STORAGE_SIZE];
@@ -134,10 +146,59 @@ K_TIMER_DEFINE(prediction_timer, prediction_timer_handler, NULL);
 static void discard_prediction_buffer(void)
 {
 #if defined(CONFIG_PM_PARTITION_REGION_PGPS_EXTERNAL)
-	prediction_cache_flash_offset = UINT32_MAX;
+	for (int i = 0; i < PREDICTION_CACHE_SIZE; i++) {
+		prediction_cache[i].flash_offset = PREDICTION_CACHE_NONE;
+	}
 #endif
 }
 
+#if defined(CONFIG_PM_PARTITION_REGION_PGPS_EXTERNAL)
+/* Return the cache entry holding the prediction at off, or NULL if it is not cached.
+ * If victim is given, it is set to the least recently used entry.
+ */
+static struct prediction_cache_entry *find_cache_entry(off_t off,
+						       struct prediction_cache_entry **victim)
+{
+	struct prediction_cache_entry *lru = &prediction_cache[0];
+
+	for (int i = 0; i < PREDICTION_CACHE_SIZE; i++) {
+		struct prediction_cache_entry *entry = &prediction_cache[i];
+
+		if (entry->flash_offset == off) {
+			entry->last_used = ++prediction_cache_use_count;
+			return entry;
+		}
+		if (entry->flash_offset == PREDICTION_CACHE_NONE) {
+			lru = entry;
+		} else if ((lru->flash_offset != PREDICTION_CACHE_NONE) &&
+			   ((int32_t)(entry->last_used - lru->last_used) < 0)) {
+			lru = entry;
+		}
+	}
+
+	if (victim) {
+		*victim = lru;
+	}
+	return NULL;
+}
+
+static int read_prediction_bytes(off_t off, uint8_t *buf, size_t start, size_t len)
+{
+	/* Subtract fa_off from off to convert from flash device address space
+	 * to partition address space.
+	 */
+	int err = flash_area_read(prediction_flash_area,
+				  off - prediction_flash_area->fa_off + start,
+				  &buf[start], len);
+
+	if (err) {
+		LOG_ERR("Error %d reading prediction from flash offset 0x%lx",
+			err, off + start);
+	}
+	return err;
+}
+#endif
+
 static int get_prediction_block(int pnum)
 {
 	return npgps_pointer_to_block((uint8_t *)index.predictions[pnum]);
@@ -157,32 +218,71 @@ static int get_prediction_block(int pnum)
 static struct nrf_cloud_pgps_prediction *get_cached_prediction(off_t off)
 {
 #if defined(CONFIG_PM_PARTITION_REGION_PGPS_EXTERNAL)
-	/* Check if the cached prediction is the one we want; if not, read it now */
-	if (prediction_cache_flash_offset != off) {
-		int err;
-
-		/* Subtract fa_off from off to convert from flash device address space
-		 * to partition address space.
-		 */
-		err = flash_area_read(prediction_flash_area, off - prediction_flash_area->fa_off,
-				      prediction_cache, sizeof(prediction_cache));
+	struct prediction_cache_entry *entry;
+	struct prediction_cache_entry *victim;
 
-		if (err) {
-			LOG_ERR("Error %d reading prediction from flash offset 0x%lx",
-				err, off);
+	/* Check if the prediction we want is cached; if not, read it over the
+	 * least recently used entry now
+	 */
+	entry = find_cache_entry(off, &victim);
+	if (entry == NULL) {
+		entry = victim;
+		entry->flash_offset = PREDICTION_CACHE_NONE;
+		if (read_prediction_bytes(off, entry->buf, 0, sizeof(entry->buf))) {
 			return NULL;
 		}
-		prediction_cache_flash_offset = off;
+		entry->flash_offset = off;
+		entry->last_used = ++prediction_cache_use_count;
 		LOG_DBG("Caching offset 0x%X", (uint32_t)(off - prediction_flash_area->fa_off));
 	}
 
-	return (struct nrf_cloud_pgps_prediction *)prediction_cache;
+	return (struct nrf_cloud_pgps_prediction *)entry->buf;
 #else
 	/* The parameter off is really the address in built-in flash for the prediction */
 	return (struct nrf_cloud_pgps_prediction *)off;
 #endif
 }
 
+/**
+ * @brief Like get_cached_prediction(), but when using external flash and the prediction is not
+ * cached, read only the header fields and the sentinel; the ephemerides are left undefined.
+ * This is enough to catalog and validate a stored prediction without reading all of it.
+ *
+ * @param off Offset from the start of the flash device, when using external flash, or offset from
+ * the start of application processor memory space when using internal flash.
+ *
+ * @return struct nrf_cloud_pgps_prediction* Pointer to the partially read prediction, which
+ * remains valid until the next call to this function or to get_cached_prediction(), or NULL
+ * on read error.
+ */
+static const struct nrf_cloud_pgps_prediction *get_prediction_summary(off_t off)
+{
+#if defined(CONFIG_PM_PARTITION_REGION_PGPS_EXTERNAL)
+	struct prediction_cache_entry *entry;
+	struct prediction_cache_entry *victim;
+
+	entry = find_cache_entry(off, &victim);
+	if (entry) {
+		return (struct nrf_cloud_pgps_prediction *)entry->buf;
+	}
+
+	/* Borrow the least recently used entry; it is left invalid since the
+	 * ephemerides are not read
+	 */
+	victim->flash_offset = PREDICTION_CACHE_NONE;
+	if (read_prediction_bytes(off, victim->buf, 0, PREDICTION_HEADER_SIZE) ||
+	    read_prediction_bytes(off, victim->buf,
+				  offsetof(struct nrf_cloud_pgps_prediction, sentinel),
+				  sizeof(uint32_t))) {
+		return NULL;
+	}
+
+	return (struct nrf_cloud_pgps_prediction *)victim->buf;
+#else
+	return get_cached_prediction(off);
+#endif
+}
+
 static struct nrf_cloud_pgps_prediction *get_prediction(int pnum)
 {
 	off_t off = (off_t)index.predictions[pnum];
@@ -202,7 +302,7 @@ static struct nrf_cloud_pgps_prediction *get_prediction_slot(int slot, off_t *fl
 }
 
 static int determine_prediction_num(struct nrf_cloud_pgps_header *header,
-				    struct nrf_cloud_pgps_prediction *p)
+				    const struct nrf_cloud_pgps_prediction *p)
 {
 	int64_t start_sec = npgps_gps_day_time_to_sec(header->gps_day,
 						      header->gps_time_of_day);
@@ -329,7 +429,7 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 	uint16_t period_min = index.header.prediction_period_min;
 	uint16_t gps_day = index.header.gps_day;
 	uint32_t gps_time_of_day = index.header.gps_time_of_day;
-	struct nrf_cloud_pgps_prediction *pred;
+	const struct nrf_cloud_pgps_prediction *pred;
 	int64_t start_gps_sec = index.start_sec;
 	off_t off;
 	int64_t gps_sec;
@@ -342,9 +442,12 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 
 	npgps_reset_block_pool();
 
-	/* build catalog of predictions by block */
+	/* build catalog of predictions by block; only the header of each
+	 * prediction is needed for this and for validation below
+	 */
 	for (i = 0; i < count; i++) {
-		pred = (struct nrf_cloud_pgps_prediction *)get_prediction_slot(i, &off);
+		off = storage_addr + i * PGPS_PREDICTION_STORAGE_SIZE;
+		pred = get_prediction_summary(off);
 		if (pred == NULL) {
 			LOG_ERR("Prediction at idx:%d not accessible", i);
 			continue;
@@ -353,7 +456,7 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 		pnum = determine_prediction_num(&index.header, pred);
 		if (pnum < 0) {
 			LOG_ERR("prediction idx:%u, ofs:%p, out of expected time range;"
-				" day:%u, time:%u", i, (void *)pred, pred->time.date_day,
+				" day:%u, time:%u", i, (const void *)pred, pred->time.date_day,
 				pred->time.time_full_s);
 		} else if (index.predictions[pnum] == NULL) {
 			index.predictions[pnum] = (struct nrf_cloud_pgps_prediction *)off;
@@ -371,7 +474,8 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 		gps_sec = start_gps_sec + pnum * period_min * SEC_PER_MIN;
 		npgps_gps_sec_to_day_time(gps_sec, &gps_day, &gps_time_of_day);
 
-		pred = get_prediction(pnum);
+		off = (off_t)index.predictions[pnum];
+		pred = off ? get_prediction_summary(off) : NULL;
 		if (pred == NULL) {
 			LOG_WRN("Prediction num:%u missing", pnum);
 			/* request partial data; download interrupted? */
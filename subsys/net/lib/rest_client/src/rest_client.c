@@ -14,6 +14,7 @@
 #include <zephyr/posix/arpa/inet.h>
 #include <zephyr/posix/unistd.h>
 #include <zephyr/posix/netdb.h>
+#include <zephyr/posix/poll.h>
 #include <zephyr/posix/sys/socket.h>
 #else
 #include <zephyr/net/socket.h>
@@ -30,6 +31,28 @@ LOG_MODULE_REGISTER(rest_client, CONFIG_REST_CLIENT_LOG_LEVEL);
 
 #define HTTP_PROTOCOL "HTTP/1.1"
 
+#if defined(CONFIG_REST_CLIENT_CONN_POOL)
+#define CONN_POOL_HOST_SIZE 64
+#define CONN_POOL_IDLE_TIMEOUT_MS (CONFIG_REST_CLIENT_CONN_POOL_IDLE_TIMEOUT * MSEC_PER_SEC)
+
+/* An idle connection that can be reused for requests with the same parameters. */
+struct rest_client_conn {
+	bool valid;
+	int fd;
+	char host[CONN_POOL_HOST_SIZE];
+	uint16_t port;
+	int sec_tag;
+	int tls_peer_verify;
+	int64_t last_used;
+};
+
+static struct rest_client_conn conn_pool[CONFIG_REST_CLIENT_CONN_POOL_SIZE];
+static K_MUTEX_DEFINE(conn_pool_lock);
+
+static void conn_pool_idle_work_fn(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(conn_pool_idle_work, conn_pool_idle_work_fn);
+#endif /* CONFIG_REST_CLIENT_CONN_POOL */
+
 static void rest_client_http_response_cb(struct http_response *rsp,
 					  enum http_final_call final_data,
 					  void *user_data)
@@ -264,11 +287,206 @@ clean_up:
 	return ret;
 }
 
+#if defined(CONFIG_REST_CLIENT_CONN_POOL)
+static void conn_close(struct rest_client_conn *conn)
+{
+	if (close(conn->fd)) {
+		LOG_WRN("Failed to close pooled socket, error: %d", errno);
+	} else {
+		LOG_DBG("Pooled socket with id: %d was closed", conn->fd);
+	}
+
+	conn->valid = false;
+}
+
+static bool conn_matches(const struct rest_client_conn *conn,
+			 const struct rest_client_req_context *req_ctx)
+{
+	return conn->valid &&
+	       conn->port == req_ctx->port &&
+	       conn->sec_tag == req_ctx->sec_tag &&
+	       conn->tls_peer_verify == req_ctx->tls_peer_verify &&
+	       strcmp(conn->host, req_ctx->host) == 0;
+}
+
+/* An idle connection has nothing to read. If the socket is readable, the peer has
+ * closed the connection or the socket is in an error state.
+ */
+static bool conn_is_stale(int fd)
+{
+	struct pollfd fds = {
+		.fd = fd,
+		.events = POLLIN,
+	};
+
+	return poll(&fds, 1, 0) != 0;
+}
+
+static void conn_pool_idle_work_fn(struct k_work *work)
+{
+	int64_t now = k_uptime_get();
+	int64_t next_expiry = INT64_MAX;
+	int64_t expiry;
+
+	ARG_UNUSED(work);
+
+	k_mutex_lock(&conn_pool_lock, K_FOREVER);
+
+	for (size_t i = 0; i < ARRAY_SIZE(conn_pool); i++) {
+		if (!conn_pool[i].valid) {
+			continue;
+		}
+
+		expiry = conn_pool[i].last_used + CONN_POOL_IDLE_TIMEOUT_MS;
+		if (expiry <= now) {
+			conn_close(&conn_pool[i]);
+		} else {
+			next_expiry = MIN(next_expiry, expiry);
+		}
+	}
+
+	if (next_expiry != INT64_MAX) {
+		k_work_reschedule(&conn_pool_idle_work, K_MSEC(next_expiry - now));
+	}
+
+	k_mutex_unlock(&conn_pool_lock);
+}
+
+/* Takes a matching connection out of the pool. Returns -1 if there is none. */
+static int conn_pool_get(const struct rest_client_req_context *req_ctx)
+{
+	int fd = -1;
+
+	k_mutex_lock(&conn_pool_lock, K_FOREVER);
+
+	for (size_t i = 0; i < ARRAY_SIZE(conn_pool); i++) {
+		if (!conn_matches(&conn_pool[i], req_ctx)) {
+			continue;
+		}
+
+		if (conn_is_stale(conn_pool[i].fd) ||
+		    k_uptime_get() - conn_pool[i].last_used >= CONN_POOL_IDLE_TIMEOUT_MS) {
+			LOG_DBG("Pooled socket with id: %d is stale", conn_pool[i].fd);
+			conn_close(&conn_pool[i]);
+			continue;
+		}
+
+		fd = conn_pool[i].fd;
+		conn_pool[i].valid = false;
+		break;
+	}
+
+	k_mutex_unlock(&conn_pool_lock);
+
+	return fd;
+}
+
+/* Returns a connection into the pool, evicting the least recently used one if the
+ * pool is full. The connection is closed if it cannot be pooled.
+ */
+static void conn_pool_put(const struct rest_client_req_context *req_ctx, int fd)
+{
+	struct rest_client_conn *conn = NULL;
+
+	if (strlen(req_ctx->host) >= CONN_POOL_HOST_SIZE) {
+		LOG_DBG("Hostname too long for the connection pool");
+		(void)close(fd);
+		return;
+	}
+
+	k_mutex_lock(&conn_pool_lock, K_FOREVER);
+
+	for (size_t i = 0; i < ARRAY_SIZE(conn_pool); i++) {
+		if (!conn_pool[i].valid) {
+			conn = &conn_pool[i];
+			break;
+		}
+
+		if (!conn || conn_pool[i].last_used < conn->last_used) {
+			conn = &conn_pool[i];
+		}
+	}
+
+	if (conn->valid) {
+		conn_close(conn);
+	}
+
+	conn->valid = true;
+	conn->fd = fd;
+	strcpy(conn->host, req_ctx->host);
+	conn->port = req_ctx->port;
+	conn->sec_tag = req_ctx->sec_tag;
+	conn->tls_peer_verify = req_ctx->tls_peer_verify;
+	conn->last_used = k_uptime_get();
+
+	LOG_DBG("Socket with id: %d was returned to the connection pool", fd);
+
+	/* Keep an already scheduled, earlier expiry. */
+	k_work_schedule(&conn_pool_idle_work, K_MSEC(CONN_POOL_IDLE_TIMEOUT_MS));
+
+	k_mutex_unlock(&conn_pool_lock);
+}
+
+void rest_client_conn_pool_flush(void)
+{
+	k_mutex_lock(&conn_pool_lock, K_FOREVER);
+
+	for (size_t i = 0; i < ARRAY_SIZE(conn_pool); i++) {
+		if (conn_pool[i].valid) {
+			conn_close(&conn_pool[i]);
+		}
+	}
+
+	(void)k_work_cancel_delayable(&conn_pool_idle_work);
+
+	k_mutex_unlock(&conn_pool_lock);
+}
+#endif /* CONFIG_REST_CLIENT_CONN_POOL */
+
+/* Only requests that can be repeated without side effects are sent again on a new connection. */
+static bool http_method_is_idempotent(enum http_method method)
+{
+	switch (method) {
+	case HTTP_GET:
+	case HTTP_HEAD:
+	case HTTP_PUT:
+	case HTTP_DELETE:
+	case HTTP_OPTIONS:
+	case HTTP_TRACE:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* A pooled connection that the peer closed after the stale check fails in sending, or ends
+ * without any response data.
+ */
+static bool conn_reuse_failed(int err, const struct rest_client_resp_context *resp_ctx)
+{
+	if (resp_ctx->total_response_len != 0) {
+		return false;
+	}
+
+	return err >= 0 || err == -ECONNRESET || err == -EPIPE || err == -ENOTCONN;
+}
+
 static void rest_client_close_connection(struct rest_client_req_context *const req_ctx,
-					 struct rest_client_resp_context *const resp_ctx)
+					 struct rest_client_resp_context *const resp_ctx,
+					 bool pool)
 {
 	int ret;
 
+#if defined(CONFIG_REST_CLIENT_CONN_POOL)
+	if (pool) {
+		conn_pool_put(req_ctx, req_ctx->connect_socket);
+		req_ctx->connect_socket = REST_CLIENT_SCKT_CONNECT;
+		return;
+	}
+#else
+	ARG_UNUSED(pool);
+#endif
+
 	if (!req_ctx->keep_alive) {
 		ret = close(req_ctx->connect_socket);
 		if (ret) {
@@ -299,10 +517,40 @@ static void rest_client_init_request(struct rest_client_req_context *const req_c
 
 static int rest_client_do_api_call(struct http_request *http_req,
 				   struct rest_client_req_context *const req_ctx,
-				   struct rest_client_resp_context *const resp_ctx)
+				   struct rest_client_resp_context *const resp_ctx,
+				   bool pooled)
 {
 	int err = 0;
+	bool reused = false;
+
+#if defined(CONFIG_REST_CLIENT_CONN_POOL)
+	if (pooled) {
+		req_ctx->connect_socket = conn_pool_get(req_ctx);
+		if (req_ctx->connect_socket >= 0) {
+			LOG_DBG("Reusing pooled socket with id: %d", req_ctx->connect_socket);
+			reused = true;
+
+			err = rest_client_sckt_timeouts_set(req_ctx->connect_socket,
+							    req_ctx->timeout_ms);
+			if (err) {
+				(void)close(req_ctx->connect_socket);
+				req_ctx->connect_socket = REST_CLIENT_SCKT_CONNECT;
+				reused = false;
+			}
+		}
+	}
+#else
+	ARG_UNUSED(pooled);
+#endif
 
+	/* Assign the user provided receive buffer into the http request */
+	http_req->recv_buf = req_ctx->resp_buff;
+	http_req->recv_buf_len = req_ctx->resp_buff_len;
+
+	/* Ensure receive buffer stays NULL terminated */
+	--http_req->recv_buf_len;
+
+retry:
 	if (req_ctx->connect_socket < 0) {
 		err = rest_client_sckt_connect(&req_ctx->connect_socket,
 						http_req->host,
@@ -315,14 +563,7 @@ static int rest_client_do_api_call(struct http_request *http_req,
 		}
 	}
 
-	/* Assign the user provided receive buffer into the http request */
-	http_req->recv_buf = req_ctx->resp_buff;
-	http_req->recv_buf_len = req_ctx->resp_buff_len;
-
-	memset(http_req->recv_buf, 0, http_req->recv_buf_len);
-
-	/* Ensure receive buffer stays NULL terminated */
-	--http_req->recv_buf_len;
+	memset(req_ctx->resp_buff, 0, req_ctx->resp_buff_len);
 
 	resp_ctx->response = NULL;
 	resp_ctx->response_len = 0;
@@ -333,6 +574,28 @@ static int rest_client_do_api_call(struct http_request *http_req,
 	resp_ctx->http_status_code = 0;
 
 	err = http_client_req(req_ctx->connect_socket, http_req, req_ctx->timeout_ms, resp_ctx);
+
+	if (reused && conn_reuse_failed(err, resp_ctx)) {
+		if (!http_method_is_idempotent(http_req->method)) {
+			/* The server may have processed the request, so it is not sent again */
+			LOG_WRN("Pooled socket with id: %d was closed by the peer",
+				req_ctx->connect_socket);
+			if (err >= 0) {
+				err = -ECONNRESET;
+			}
+		} else {
+			/* The peer closed the pooled connection after it was checked. Nothing was
+			 * received, so the request is sent again in a new connection.
+			 */
+			LOG_DBG("Pooled socket with id: %d failed, reconnecting",
+				req_ctx->connect_socket);
+			(void)close(req_ctx->connect_socket);
+			req_ctx->connect_socket = REST_CLIENT_SCKT_CONNECT;
+			reused = false;
+			goto retry;
+		}
+	}
+
 	if (err < 0) {
 		LOG_ERR("http_client_req() error: %d", err);
 	} else if (resp_ctx->total_response_len >= req_ctx->resp_buff_len) {
@@ -373,6 +636,10 @@ int rest_client_request(struct rest_client_req_context *req_ctx,
 
 	struct http_request http_req;
 	int ret;
+	/* Connections opened by the library are pooled instead of being closed. */
+	bool pooled = IS_ENABLED(CONFIG_REST_CLIENT_CONN_POOL) &&
+		      req_ctx->connect_socket == REST_CLIENT_SCKT_CONNECT &&
+		      !req_ctx->keep_alive;
 
 	rest_client_init_request(req_ctx, &http_req);
 
@@ -395,7 +662,7 @@ int rest_client_request(struct rest_client_req_context *req_ctx,
 		}
 	}
 
-	ret = rest_client_do_api_call(&http_req, req_ctx, resp_ctx);
+	ret = rest_client_do_api_call(&http_req, req_ctx, resp_ctx, pooled);
 	if (ret) {
 		LOG_ERR("rest_client_do_api_call() failed, err %d", ret);
 		goto clean_up;
@@ -415,8 +682,10 @@ int rest_client_request(struct rest_client_req_context *req_ctx,
 
 clean_up:
 	if (req_ctx->connect_socket != REST_CLIENT_SCKT_CONNECT) {
-		/* Socket was not closed yet: */
-		rest_client_close_connection(req_ctx, resp_ctx);
+		/* Socket was not closed yet. A failed connection is not pooled, as its
+		 * state is unknown.
+		 */
+		rest_client_close_connection(req_ctx, resp_ctx, pooled && ret == 0);
 	}
 	return ret;
 }
@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <errno.h>
+#include <string.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/sys/byteorder.h>
+#include <nfc/ndef/msg_parser_stream.h>
+
+LOG_MODULE_DECLARE(nfc_ndef_parser, CONFIG_NFC_NDEF_PARSER_LOG_LEVEL);
+
+enum parser_state {
+	STATE_FLAGS,
+	STATE_TYPE_LEN,
+	STATE_PAYLOAD_LEN,
+	STATE_ID_LEN,
+	STATE_TYPE_ID,
+	STATE_PAYLOAD,
+	STATE_COMPLETE,
+	STATE_ERROR,
+};
+
+static int record_end(struct nfc_ndef_msg_parser_stream *parser)
+{
+	int err;
+
+	if (parser->cb && parser->cb->record_end) {
+		err = parser->cb->record_end(&parser->record, parser->user_data);
+		if (err) {
+			return err;
+		}
+	}
+
+	if ((parser->record.location == NDEF_LAST_RECORD) ||
+	    (parser->record.location == NDEF_LONE_RECORD)) {
+		parser->state = STATE_COMPLETE;
+	} else {
+		parser->record.index++;
+		parser->state = STATE_FLAGS;
+	}
+
+	return 0;
+}
+
+static int record_begin(struct nfc_ndef_msg_parser_stream *parser)
+{
+	struct nfc_ndef_msg_parser_stream_record *record = &parser->record;
+	int err;
+
+	record->type = (record->type_length > 0) ? parser->hdr_buf : NULL;
+	record->id = (record->id_length > 0) ?
+		     &parser->hdr_buf[record->type_length] : NULL;
+
+	if (parser->cb && parser->cb->record_begin) {
+		err = parser->cb->record_begin(record, parser->user_data);
+		if (err) {
+			return err;
+		}
+	}
+
+	parser->payload_offset = 0;
+	parser->field_left = record->payload_length;
+	parser->state = STATE_PAYLOAD;
+
+	if (parser->field_left == 0) {
+		return record_end(parser);
+	}
+
+	return 0;
+}
+
+static int type_id_begin(struct nfc_ndef_msg_parser_stream *parser)
+{
+	parser->hdr_len = 0;
+	parser->field_left = parser->record.type_length + parser->record.id_length;
+
+	if (parser->field_left > sizeof(parser->hdr_buf)) {
+		LOG_DBG("Record type and ID too long: %u bytes", parser->field_left);
+		return -ENOMEM;
+	}
+
+	parser->state = STATE_TYPE_ID;
+
+	if (parser->field_left == 0) {
+		return record_begin(parser);
+	}
+
+	return 0;
+}
+
+static int flags_parse(struct nfc_ndef_msg_parser_stream *parser, uint8_t flags)
+{
+	struct nfc_ndef_msg_parser_stream_record *record = &parser->record;
+
+	record->location = (enum nfc_ndef_record_location) (flags & NDEF_RECORD_LOCATION_MASK);
+
+	/* Verify the records location flags. */
+	if (record->index == 0) {
+		if ((record->location != NDEF_FIRST_RECORD) &&
+		    (record->location != NDEF_LONE_RECORD)) {
+			return -EFAULT;
+		}
+	} else {
+		if ((record->location != NDEF_MIDDLE_RECORD) &&
+		    (record->location != NDEF_LAST_RECORD)) {
+			return -EFAULT;
+		}
+	}
+
+	record->tnf = (enum nfc_ndef_record_tnf) (flags & NDEF_RECORD_TNF_MASK);
+
+	/* An NDEF parser that receives an NDEF record with an unknown
+	 * or unsupported TNF field value
+	 * SHOULD treat it as Unknown. See NFCForum-TS-NDEF_1.0
+	 */
+	if (record->tnf == TNF_RESERVED) {
+		record->tnf = TNF_UNKNOWN_TYPE;
+	}
+
+	record->id_length = 0;
+	parser->flags = flags;
+	parser->state = STATE_TYPE_LEN;
+
+	return 0;
+}
+
+static int payload_len_parse(struct nfc_ndef_msg_parser_stream *parser,
+			     const uint8_t *data, uint32_t *len)
+{
+	uint32_t chunk = MIN(parser->field_left, *len);
+
+	memcpy(&parser->field_buf[parser->field_len], data, chunk);
+	parser->field_len += chunk;
+	parser->field_left -= chunk;
+	*len = chunk;
+
+	if (parser->field_left > 0) {
+		return 0;
+	}
+
+	if (parser->field_len == NDEF_RECORD_PAYLOAD_LEN_SHORT_SIZE) {
+		parser->record.payload_length = parser->field_buf[0];
+	} else {
+		parser->record.payload_length = sys_get_be32(parser->field_buf);
+	}
+
+	if (parser->flags & NDEF_RECORD_IL_MASK) {
+		parser->state = STATE_ID_LEN;
+		return 0;
+	}
+
+	return type_id_begin(parser);
+}
+
+static int type_id_parse(struct nfc_ndef_msg_parser_stream *parser,
+			 const uint8_t *data, uint32_t *len)
+{
+	uint32_t chunk = MIN(parser->field_left, *len);
+
+	memcpy(&parser->hdr_buf[parser->hdr_len], data, chunk);
+	parser->hdr_len += chunk;
+	parser->field_left -= chunk;
+	*len = chunk;
+
+	if (parser->field_left > 0) {
+		return 0;
+	}
+
+	return record_begin(parser);
+}
+
+static int payload_parse(struct nfc_ndef_msg_parser_stream *parser,
+			 const uint8_t *data, uint32_t *len)
+{
+	uint32_t chunk = MIN(parser->field_left, *len);
+	int err;
+
+	if (parser->cb && parser->cb->payload) {
+		err = parser->cb->payload(&parser->record, parser->payload_offset,
+					  data, chunk, parser->user_data);
+		if (err) {
+			return err;
+		}
+	}
+
+	parser->payload_offset += chunk;
+	parser->field_left -= chunk;
+	*len = chunk;
+
+	if (parser->field_left > 0) {
+		return 0;
+	}
+
+	return record_end(parser);
+}
+
+void nfc_ndef_msg_parser_stream_init(struct nfc_ndef_msg_parser_stream *parser,
+				     const struct nfc_ndef_msg_parser_stream_cb *cb,
+				     void *user_data)
+{
+	__ASSERT_NO_MSG(parser);
+
+	memset(parser, 0, sizeof(*parser));
+
+	parser->cb = cb;
+	parser->user_data = user_data;
+	parser->state = STATE_FLAGS;
+}
+
+int nfc_ndef_msg_parser_stream_feed(struct nfc_ndef_msg_parser_stream *parser,
+				    const uint8_t *data,
+				    uint32_t *len)
+{
+	__ASSERT_NO_MSG(parser);
+	__ASSERT_NO_MSG(len);
+
+	int err = 0;
+	uint32_t offset = 0;
+	uint32_t used;
+
+	if (parser->state == STATE_COMPLETE) {
+		*len = 0;
+		return -EALREADY;
+	}
+
+	if (parser->state == STATE_ERROR) {
+		*len = 0;
+		return -EINVAL;
+	}
+
+	while ((offset < *len) && (parser->state != STATE_COMPLETE)) {
+		used = 1;
+
+		switch (parser->state) {
+		case STATE_FLAGS:
+			err = flags_parse(parser, data[offset]);
+			break;
+
+		case STATE_TYPE_LEN:
+			parser->record.type_length = data[offset];
+			parser->field_len = 0;
+			parser->field_left = (parser->flags & NDEF_RECORD_SR_MASK) ?
+					     NDEF_RECORD_PAYLOAD_LEN_SHORT_SIZE :
+					     NDEF_RECORD_PAYLOAD_LEN_LONG_SIZE;
+			parser->state = STATE_PAYLOAD_LEN;
+			break;
+
+		case STATE_PAYLOAD_LEN:
+			used = *len - offset;
+			err = payload_len_parse(parser, &data[offset], &used);
+			break;
+
+		case STATE_ID_LEN:
+			parser->record.id_length = data[offset];
+			err = type_id_begin(parser);
+			break;
+
+		case STATE_TYPE_ID:
+			used = *len - offset;
+			err = type_id_parse(parser, &data[offset], &used);
+			break;
+
+		case STATE_PAYLOAD:
+			used = *len - offset;
+			err = payload_parse(parser, &data[offset], &used);
+			break;
+
+		default:
+			err = -EINVAL;
+			break;
+		}
+
+		if (err) {
+			parser->state = STATE_ERROR;
+			break;
+		}
+
+		offset += used;
+	}
+
+	*len = offset;
+
+	return err;
+}
+
+bool nfc_ndef_msg_parser_stream_is_complete(const struct nfc_ndef_msg_parser_stream *parser)
+{
+	return parser->state == STATE_COMPLETE;
+}
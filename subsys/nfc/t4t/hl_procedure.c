@@ -101,11 +101,23 @@ static int on_cc_read(const struct nfc_t4t_apdu_resp *resp)
 	t4t_hl.file_offset += len;
 
 	if (t4t_hl.file_offset < t4t_hl.cc_file.len) {
+		uint16_t chunk_len = CC_MIN_RAPDU_SIZE;
+
+		/* Once the tag's MLe is known, read the rest of the file in chunks
+		 * as large as the tag allows.
+		 */
+		if (t4t_hl.file_offset >= (CC_RAPDU_MAX_SIZE_OFFSET + sizeof(uint16_t))) {
+			chunk_len = MAX(chunk_len,
+					MIN(APDU_LE_MAP_2_MAX_VALUE,
+					    sys_get_be16(t4t_hl.cc_file.data +
+							 CC_RAPDU_MAX_SIZE_OFFSET)));
+		}
+
 		nfc_t4t_apdu_comm_clear(&apdu_comm);
 
 		apdu_comm.instruction = NFC_T4T_APDU_COMM_INS_READ;
 		apdu_comm.parameter = t4t_hl.file_offset;
-		apdu_comm.resp_len = MIN(CC_MIN_RAPDU_SIZE,
+		apdu_comm.resp_len = MIN(chunk_len,
 				t4t_hl.cc_file.len - t4t_hl.file_offset);
 
 		return t4t_hl_data_exchange(&apdu_comm);
@@ -134,8 +146,9 @@ static int on_ndef_nlen_read(const struct nfc_t4t_apdu_resp *resp)
 	const uint8_t *data = resp->data.buff;
 	uint16_t len = resp->data.len;
 
-	if (len != NDEF_FILE_NLEN_SIZE) {
-		LOG_ERR("NDEF NLEN response is to long");
+	/* The NLEN field can be read together with the beginning of the NDEF message. */
+	if (len < NDEF_FILE_NLEN_SIZE) {
+		LOG_ERR("NDEF NLEN response is to short");
 		return -EINVAL;
 	}
 
@@ -187,6 +200,9 @@ static int ndef_file_chunk_read(const struct nfc_t4t_apdu_resp *resp)
 		return t4t_hl_data_exchange(&apdu_comm);
 	}
 
+	/* The first read could go past the end of the NDEF message. */
+	t4t_hl.file_offset = t4t_hl.ndef.nlen + NDEF_FILE_NLEN_SIZE;
+
 	file_id = sys_get_be16(t4t_hl.ndef.file_id);
 
 	err = t4t_file_assign(file_id);
@@ -404,6 +420,8 @@ int nfc_t4t_hl_procedure_ndef_read(struct nfc_t4t_cc_file *cc,
 				   uint16_t ndef_len)
 {
 	struct nfc_t4t_apdu_comm apdu_comm;
+	struct nfc_t4t_tlv_block *tlv_block;
+	uint32_t first_read_len;
 
 	t4t_hl.file_offset = 0;
 
@@ -411,11 +429,24 @@ int nfc_t4t_hl_procedure_ndef_read(struct nfc_t4t_cc_file *cc,
 		return -EINVAL;
 	}
 
+	/* Read the NLEN field together with as much of the NDEF message as fits in one
+	 * R-APDU, which saves a separate command for the NLEN field. Do not read past
+	 * the end of the file as the tag would reject it.
+	 */
+	first_read_len = MIN(ndef_len, MIN(APDU_LE_MAP_2_MAX_VALUE, cc->max_rapdu_size));
+
+	tlv_block = nfc_t4t_cc_file_content_get(cc, sys_get_be16(t4t_hl.ndef.file_id));
+	if (tlv_block) {
+		first_read_len = MIN(first_read_len, tlv_block->value.max_file_size);
+	} else {
+		first_read_len = NDEF_FILE_NLEN_SIZE;
+	}
+
 	nfc_t4t_apdu_comm_clear(&apdu_comm);
 
 	apdu_comm.instruction = NFC_T4T_APDU_COMM_INS_READ;
 	apdu_comm.parameter = 0;
-	apdu_comm.resp_len = NDEF_FILE_NLEN_SIZE;
+	apdu_comm.resp_len = MAX(first_read_len, NDEF_FILE_NLEN_SIZE);
 
 	t4t_hl.ndef.buff = ndef_buff;
 	t4t_hl.ndef.buff_size = ndef_len;
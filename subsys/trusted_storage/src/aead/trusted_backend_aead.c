@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <zephyr/kernel.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/logging/log.h>
 #include <mbedtls/platform_util.h>
@@ -47,11 +48,146 @@ typedef struct stored_object {
 	uint8_t data[AEAD_MAX_BUF_SIZE];
 } stored_object;
 
+#define CACHE_SIZE CONFIG_TRUSTED_STORAGE_BACKEND_AEAD_CACHE_SIZE
+
+#if CACHE_SIZE > 0
+/** Derived key and header of a recently used asset. */
+struct cache_entry {
+	psa_storage_uid_t uid;
+	const char *prefix;
+	uint32_t last_used;
+	bool header_valid;
+	stored_object_header header;
+	uint8_t key[AEAD_KEY_SIZE];
+};
+
+static struct cache_entry cache[CACHE_SIZE];
+static uint32_t cache_use_count;
+static K_MUTEX_DEFINE(cache_lock);
+
+/* Must be called with cache_lock held. */
+static struct cache_entry *cache_find(const psa_storage_uid_t uid, const char *prefix)
+{
+	for (size_t i = 0; i < CACHE_SIZE; i++) {
+		if (cache[i].uid == uid && cache[i].prefix != NULL &&
+		    strcmp(cache[i].prefix, prefix) == 0) {
+			cache[i].last_used = ++cache_use_count;
+			return &cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Must be called with cache_lock held. */
+static struct cache_entry *cache_evict(void)
+{
+	struct cache_entry *lru = &cache[0];
+
+	for (size_t i = 0; i < CACHE_SIZE; i++) {
+		if (cache[i].uid == INVALID_UID) {
+			lru = &cache[i];
+			break;
+		}
+		if ((int32_t)(cache[i].last_used - lru->last_used) < 0) {
+			lru = &cache[i];
+		}
+	}
+
+	mbedtls_platform_zeroize(lru, sizeof(*lru));
+	return lru;
+}
+#endif
+
+/* Gets the AEAD key for uid, from the cache if possible. */
+static psa_status_t get_key(const psa_storage_uid_t uid, const char *prefix, uint8_t *key_buf)
+{
+#if CACHE_SIZE > 0
+	psa_status_t status = PSA_SUCCESS;
+	struct cache_entry *entry;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	entry = cache_find(uid, prefix);
+	if (entry == NULL) {
+		entry = cache_evict();
+		status = trusted_storage_get_key(uid, entry->key, AEAD_KEY_SIZE);
+		if (status == PSA_SUCCESS) {
+			entry->uid = uid;
+			entry->prefix = prefix;
+			entry->last_used = ++cache_use_count;
+		} else {
+			mbedtls_platform_zeroize(entry, sizeof(*entry));
+		}
+	}
+
+	if (status == PSA_SUCCESS) {
+		memcpy(key_buf, entry->key, AEAD_KEY_SIZE);
+	}
+
+	k_mutex_unlock(&cache_lock);
+
+	return status;
+#else
+	ARG_UNUSED(prefix);
+
+	return trusted_storage_get_key(uid, key_buf, AEAD_KEY_SIZE);
+#endif
+}
+
+/*
+ * Gets the header of a stored object, from the cache if possible.
+ * The header read from storage is not authenticated, so it is not cached. The cache only holds
+ * headers that were written or decrypted by this backend.
+ */
+static psa_status_t get_header(const psa_storage_uid_t uid, const char *prefix,
+			       stored_object_header *header)
+{
+	size_t out_length;
+
+#if CACHE_SIZE > 0
+	struct cache_entry *entry;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	entry = cache_find(uid, prefix);
+	if (entry != NULL && entry->header_valid) {
+		*header = entry->header;
+		k_mutex_unlock(&cache_lock);
+		return PSA_SUCCESS;
+	}
+	k_mutex_unlock(&cache_lock);
+#endif
+
+	return storage_get_object(uid, prefix, (void *)header, sizeof(*header), &out_length);
+}
+
+/* Records the header of a stored object, or that the object is gone if header is NULL. */
+static void update_header(const psa_storage_uid_t uid, const char *prefix,
+			  const stored_object_header *header)
+{
+#if CACHE_SIZE > 0
+	struct cache_entry *entry;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	entry = cache_find(uid, prefix);
+	if (entry != NULL) {
+		entry->header_valid = (header != NULL);
+		if (header != NULL) {
+			entry->header = *header;
+		}
+	}
+	k_mutex_unlock(&cache_lock);
+#else
+	ARG_UNUSED(uid);
+	ARG_UNUSED(prefix);
+	ARG_UNUSED(header);
+#endif
+}
+
 psa_status_t trusted_get_info(const psa_storage_uid_t uid, const char *prefix,
 			      struct psa_storage_info_t *p_info)
 {
 	psa_status_t status;
-	size_t out_length;
 	stored_object_header header;
 
 	if (p_info == NULL || uid == INVALID_UID) {
@@ -59,7 +195,7 @@ psa_status_t trusted_get_info(const psa_storage_uid_t uid, const char *prefix,
 	}
 
 	/* Get size & flags */
-	status = storage_get_object(uid, prefix, (void *)&header, sizeof(header), &out_length);
+	status = get_header(uid, prefix, &header);
 	if (status != PSA_SUCCESS) {
 		return status;
 	}
@@ -93,7 +229,7 @@ psa_status_t trusted_get(const psa_storage_uid_t uid, const char *prefix, size_t
 	}
 
 	/* Get AEAD key */
-	status = trusted_storage_get_key(uid, key_buf, AEAD_KEY_SIZE);
+	status = get_key(uid, prefix, key_buf);
 	if (status != PSA_SUCCESS) {
 		return status;
 	}
@@ -115,6 +251,9 @@ psa_status_t trusted_get(const psa_storage_uid_t uid, const char *prefix, size_t
 		goto clean_up;
 	}
 
+	/* The header is authenticated now, keep it for later lookups */
+	update_header(uid, prefix, &object_data.header);
+
 	if (data_offset > out_length) {
 		*p_data_length = 0;
 		status = PSA_ERROR_INVALID_ARGUMENT;
@@ -159,8 +298,7 @@ psa_status_t trusted_set(const psa_storage_uid_t uid, const char *prefix, size_t
 	}
 
 	/* Get flags */
-	status = storage_get_object(uid, prefix, (void *)&object_data.header,
-				    sizeof(object_data.header), &out_length);
+	status = get_header(uid, prefix, &object_data.header);
 
 	if (status != PSA_SUCCESS && status != PSA_ERROR_DOES_NOT_EXIST) {
 		return status;
@@ -173,7 +311,7 @@ psa_status_t trusted_set(const psa_storage_uid_t uid, const char *prefix, size_t
 	}
 
 	/* Get AEAD key */
-	status = trusted_storage_get_key(uid, key_buf, AEAD_KEY_SIZE);
+	status = get_key(uid, prefix, key_buf);
 	if (status != PSA_SUCCESS) {
 		goto cleanup_objects;
 	}
@@ -205,12 +343,14 @@ psa_status_t trusted_set(const psa_storage_uid_t uid, const char *prefix, size_t
 		goto cleanup_objects;
 	}
 
+	update_header(uid, prefix, &object_data.header);
 	goto cleanup;
 
 cleanup_objects:
 	/* Remove object if an error occurs */
 	LOG_DBG("trusted_set cleanup. status %d", status);
 	storage_remove_object(uid, prefix);
+	update_header(uid, prefix, NULL);
 
 cleanup:
 	mbedtls_platform_zeroize(&object_data, sizeof(object_data));
@@ -221,7 +361,6 @@ cleanup:
 psa_status_t trusted_remove(const psa_storage_uid_t uid, const char *prefix)
 {
 	psa_status_t status = PSA_ERROR_CORRUPTION_DETECTED;
-	size_t out_length;
 	stored_object_header header;
 
 	if (uid == INVALID_UID) {
@@ -229,7 +368,7 @@ psa_status_t trusted_remove(const psa_storage_uid_t uid, const char *prefix)
 	}
 
 	/* Get flags */
-	status = storage_get_object(uid, prefix, (void *)&header, sizeof(header), &out_length);
+	status = get_header(uid, prefix, &header);
 	if (status != PSA_SUCCESS) {
 		return status;
 	}
@@ -238,7 +377,12 @@ psa_status_t trusted_remove(const psa_storage_uid_t uid, const char *prefix)
 		return PSA_ERROR_NOT_PERMITTED;
 	}
 
-	return storage_remove_object(uid, prefix);
+	status = storage_remove_object(uid, prefix);
+	if (status == PSA_SUCCESS) {
+		update_header(uid, prefix, NULL);
+	}
+
+	return status;
 }
 
 uint32_t trusted_get_support(void)
@@ -10,6 +10,7 @@
 #include <uart_async_adapter.h>
 #include <zephyr/drivers/uart.h>
 #include <zephyr/sys/__assert.h>
+#include <string.h>
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(uart_async_adapter, CONFIG_UART_ASYNC_ADAPTER_LOG_LEVEL);
@@ -23,6 +24,11 @@ LOG_MODULE_REGISTER(uart_async_adapter, CONFIG_UART_ASYNC_ADAPTER_LOG_LEVEL);
 #error "The adapter requires UART INTERRUPT API to be enabled"
 #endif
 
+#define RX_STAGING_SIZE CONFIG_UART_ASYNC_ADAPTER_RX_STAGING_SIZE
+
+/* Size of the buffer used to drain the FIFO when the data must be dropped */
+#define RX_DROP_CHUNK_SIZE 16
+
 
 /**
  * @brief Access the data inside device
@@ -139,6 +145,122 @@ static inline void switch_rx_buffer(const struct device *dev, bool request_new)
 	}
 }
 
+/**
+ * @brief Move the staged data into the current RX buffer
+ *
+ * Must be called with the lock held.
+ *
+ * @param data Adapter data.
+ * @return Number of bytes moved.
+ */
+static size_t rx_staging_unload(struct uart_async_adapter_data *data)
+{
+	size_t cnt = 0;
+
+#if RX_STAGING_SIZE > 0
+	while (data->rx.staging_len && data->rx.size_left) {
+		size_t chunk = MIN(data->rx.staging_len, RX_STAGING_SIZE - data->rx.staging_head);
+
+		chunk = MIN(chunk, data->rx.size_left);
+		memcpy(data->rx.curr_buf, &data->rx.staging[data->rx.staging_head], chunk);
+		data->rx.curr_buf += chunk;
+		data->rx.size_left -= chunk;
+		data->rx.staging_head = (data->rx.staging_head + chunk) % RX_STAGING_SIZE;
+		data->rx.staging_len -= chunk;
+		cnt += chunk;
+	}
+#else
+	ARG_UNUSED(data);
+#endif
+	return cnt;
+}
+
+/**
+ * @brief Read the FIFO into the staging buffer
+ *
+ * Must be called with the lock held.
+ *
+ * @param data Adapter data.
+ * @return Number of bytes read, 0 if the FIFO is empty or the staging buffer is full.
+ */
+static int rx_staging_load(struct uart_async_adapter_data *data)
+{
+#if RX_STAGING_SIZE > 0
+	size_t tail = (data->rx.staging_head + data->rx.staging_len) % RX_STAGING_SIZE;
+	size_t space = MIN(RX_STAGING_SIZE - data->rx.staging_len, RX_STAGING_SIZE - tail);
+	int ret;
+
+	if (!space) {
+		return 0;
+	}
+
+	ret = uart_fifo_read(data->target, &data->rx.staging[tail], space);
+	if (ret < 0) {
+		LOG_ERR("Unexpected error on FIFO read: %d", ret);
+		return 0;
+	}
+	data->rx.staging_len += ret;
+
+	return ret;
+#else
+	ARG_UNUSED(data);
+	return 0;
+#endif
+}
+
+static inline bool rx_staging_empty(const struct uart_async_adapter_data *data)
+{
+#if RX_STAGING_SIZE > 0
+	return !data->rx.staging_len;
+#else
+	ARG_UNUSED(data);
+	return true;
+#endif
+}
+
+static inline bool rx_staging_full(const struct uart_async_adapter_data *data)
+{
+#if RX_STAGING_SIZE > 0
+	return data->rx.staging_len == RX_STAGING_SIZE;
+#else
+	ARG_UNUSED(data);
+	return true;
+#endif
+}
+
+static inline void rx_staging_clear(struct uart_async_adapter_data *data)
+{
+#if RX_STAGING_SIZE > 0
+	data->rx.staging_head = 0;
+	data->rx.staging_len = 0;
+#else
+	ARG_UNUSED(data);
+#endif
+}
+
+/**
+ * @brief Record the RX activity for the timeout
+ *
+ * The timer is started only if it is not running already. Restarting it on every
+ * interrupt is avoided; instead, the timeout handler rearms it for the remaining
+ * time if data was received in the meantime.
+ * Must be called with the lock held.
+ *
+ * @param data Adapter data.
+ */
+static void rx_timeout_touch(struct uart_async_adapter_data *data)
+{
+	if (data->rx.timeout == SYS_FOREVER_US) {
+		return;
+	}
+
+	data->rx.last_rx_cycles = k_cycle_get_32();
+	if (!data->rx.timer_active) {
+		data->rx.timer_active = true;
+		k_timer_start(&data->rx.timeout_timer, K_USEC(data->rx.timeout), K_NO_WAIT);
+	}
+}
+
 static int tx(const struct device *dev, const uint8_t *buf, size_t len, int32_t timeout)
 {
 	int ret = 0;
@@ -223,6 +345,8 @@ static int rx_enable(const struct device *dev, uint8_t *buf, size_t len, int32_t
 	data->rx.next_buf = buf;
 	data->rx.next_buf_len = len;
 	data->rx.timeout = timeout;
+	data->rx.timer_active = false;
+	rx_staging_clear(data);
 	data->rx.enabled = true;
 
 	k_spin_unlock(&(data->lock), key);
@@ -261,6 +385,15 @@ static int rx_disable(const struct device *dev)
 	data->rx.enabled = false;
 	uart_irq_rx_disable(data->target);
 	uart_irq_err_disable(data->target);
+	k_timer_stop(&data->rx.timeout_timer);
+
+	k_spinlock_key_t key = k_spin_lock(&(data->lock));
+
+	data->rx.timer_active = false;
+	rx_staging_clear(data);
+
+	k_spin_unlock(&(data->lock), key);
+
 	while (data->rx.buf) {
 		switch_rx_buffer(dev, false);
 	}
@@ -384,18 +517,21 @@ static inline void on_tx_ready(const struct device *dev, struct uart_async_adapt
 	k_spinlock_key_t key = k_spin_lock(&(data->lock));
 
 	LOG_DBG("%s: Enter(%s) (left: %u)", __func__, dev->name, data->tx.size_left);
-	if (data->tx.size_left) {
+	/* Fill the FIFO until it is full to limit the number of TX interrupts */
+	while (data->tx.size_left) {
 		__ASSERT_NO_MSG(data->tx.curr_buf);
 		int ret;
 
 		ret = uart_fifo_fill(data->target, data->tx.curr_buf, data->tx.size_left);
 		LOG_DBG("Pushed %d characters", ret);
-		if (ret <= 0) {
+		if (ret < 0) {
 			LOG_ERR("Unexpected fifo fill err: %d", ret);
-		} else {
-			data->tx.curr_buf += ret;
-			data->tx.size_left -= ret;
+			break;
+		} else if (ret == 0) {
+			break;
 		}
+		data->tx.curr_buf += ret;
+		data->tx.size_left -= ret;
 	}
 
 	k_spin_unlock(&(data->lock), key);
@@ -442,16 +578,17 @@ static inline void on_tx_complete(const struct device *dev, struct uart_async_ad
 static inline void on_rx_ready(const struct device *dev, struct uart_async_adapter_data *data)
 {
 	int ret;
+	size_t dropped = 0;
 	bool notify_now = false;
 
 	LOG_DBG("%s: Enter (%s)", __func__, dev->name);
-	if (data->rx.timeout != SYS_FOREVER_US) {
-		k_timer_start(&data->rx.timeout_timer, K_USEC(data->rx.timeout), K_NO_WAIT);
-	}
-	do {
-		k_spinlock_key_t key = k_spin_lock(&(data->lock));
 
-		if (!data->rx.size_left) {
+	/* The lock is kept while draining and released only for the user callbacks */
+	k_spinlock_key_t key = k_spin_lock(&(data->lock));
+
+	rx_timeout_touch(data);
+	do {
+		if (!data->rx.size_left && (data->rx.buf || data->rx.next_buf)) {
 			notify_now = false;
 
 			k_spin_unlock(&(data->lock), key);
@@ -461,21 +598,10 @@ static inline void on_rx_ready(const struct device *dev, struct uart_async_adapt
 
 			key = k_spin_lock(&(data->lock));
 		}
-		if (!data->rx.size_left) {
-			/* Data received without buffer - dropping */
-			uint8_t dummy;
-			size_t cnt = 0;
-
-			do {
-				ret = uart_fifo_read(data->target, &dummy, 1);
-				if (ret < 0) {
-					LOG_ERR("Unexpected error on FIFO dropping: %d", ret);
-					ret = 0;
-				}
-				cnt += ret;
-			} while (ret);
-			LOG_ERR("Data received without buffer prepared, dropped %d bytes", cnt);
-		} else {
+		if (data->rx.size_left && !rx_staging_empty(data)) {
+			/* Staged data goes first to keep the order */
+			ret = rx_staging_unload(data);
+		} else if (data->rx.size_left) {
 			ret = uart_fifo_read(data->target, data->rx.curr_buf, data->rx.size_left);
 			LOG_DBG("Received %d characters", ret);
 			if (ret < 0) {
@@ -485,14 +611,32 @@ static inline void on_rx_ready(const struct device *dev, struct uart_async_adapt
 			__ASSERT_NO_MSG(data->rx.size_left >= ret);
 			data->rx.curr_buf += ret;
 			data->rx.size_left -= ret;
-			if (data->rx.timeout == 0) {
-				notify_now = true;
-			}
+		} else if (!rx_staging_full(data)) {
+			/* No buffer available, keep the data until one is provided */
+			ret = rx_staging_load(data);
+		} else {
+			/* Data received without buffer - dropping */
+			uint8_t dummy[RX_DROP_CHUNK_SIZE];
+
+			do {
+				ret = uart_fifo_read(data->target, dummy, sizeof(dummy));
+				if (ret < 0) {
+					LOG_ERR("Unexpected error on FIFO dropping: %d", ret);
+					ret = 0;
+				}
+				dropped += ret;
+			} while (ret);
+		}
+		if (ret && data->rx.buf && data->rx.timeout == 0) {
+			notify_now = true;
 		}
+	} while (ret);
 
-		k_spin_unlock(&(data->lock), key);
+	k_spin_unlock(&(data->lock), key);
 
-	} while (ret);
+	if (dropped) {
+		LOG_ERR("Data received without buffer prepared, dropped %d bytes", dropped);
+	}
 	if (notify_now) {
 		notify_rx_buffer(dev);
 	}
@@ -585,6 +729,38 @@ static void tx_timeout(struct k_timer *timer)
 static void rx_timeout(struct k_timer *timer)
 {
 	const struct device *dev = k_timer_user_data_get(timer);
+	struct uart_async_adapter_data *data = access_dev_data(dev);
+	uint32_t idle_us;
+	bool switch_buf;
+
+	k_spinlock_key_t key = k_spin_lock(&(data->lock));
+
+	idle_us = k_cyc_to_us_floor32(k_cycle_get_32() - data->rx.last_rx_cycles);
+	if (idle_us < (uint32_t)data->rx.timeout) {
+		/* Data received after the timer was started, wait for the line to be idle */
+		k_timer_start(timer, K_USEC(data->rx.timeout - idle_us), K_NO_WAIT);
+		k_spin_unlock(&(data->lock), key);
+		return;
+	}
+
+	/* Staged data waits for a new buffer if the current one is full */
+	switch_buf = !rx_staging_empty(data) && !data->rx.size_left && data->rx.next_buf;
+	k_spin_unlock(&(data->lock), key);
+
+	if (switch_buf) {
+		notify_rx_buffer(dev);
+		switch_rx_buffer(dev, true);
+	}
+
+	key = k_spin_lock(&(data->lock));
+	(void)rx_staging_unload(data);
+	if (data->rx.enabled && !rx_staging_empty(data)) {
+		/* Retry when the buffer is provided */
+		k_timer_start(timer, K_USEC(data->rx.timeout), K_NO_WAIT);
+	} else {
+		data->rx.timer_active = false;
+	}
+	k_spin_unlock(&(data->lock), key);
 
 	notify_rx_buffer(dev);
 }
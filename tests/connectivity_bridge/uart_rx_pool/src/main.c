@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <errno.h>
+
+#include "uart_rx_pool.h"
+
+#define QUEUE_SIZE 2
+
+static int free_cb_count;
+
+static void free_cb(void)
+{
+	free_cb_count++;
+}
+
+/* Count the free blocks by allocating all of them */
+static size_t pool_free_count(void)
+{
+	uint8_t *bufs[UART_RX_POOL_BLOCK_COUNT];
+	size_t count = 0;
+
+	while (count < ARRAY_SIZE(bufs)) {
+		bufs[count] = uart_rx_pool_alloc();
+		if (bufs[count] == NULL) {
+			break;
+		}
+		count++;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		uart_rx_pool_unref(bufs[i]);
+	}
+
+	return count;
+}
+
+static void pool_exhaust(uint8_t *bufs[UART_RX_POOL_BLOCK_COUNT])
+{
+	for (size_t i = 0; i < UART_RX_POOL_BLOCK_COUNT; i++) {
+		bufs[i] = uart_rx_pool_alloc();
+		zassert_not_null(bufs[i], "Block %d not allocated", i);
+	}
+
+	zassert_is_null(uart_rx_pool_alloc(), "Pool not exhausted");
+}
+
+static void test_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	uart_rx_pool_init(free_cb);
+	free_cb_count = 0;
+}
+
+static void test_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_equal(pool_free_count(), UART_RX_POOL_BLOCK_COUNT, "Blocks leaked");
+}
+
+ZTEST(suite_uart_rx_pool, test_alloc_exhaust)
+{
+	uint8_t *bufs[UART_RX_POOL_BLOCK_COUNT];
+
+	pool_exhaust(bufs);
+
+	uart_rx_pool_unref(bufs[0]);
+	zassert_equal(pool_free_count(), 1, "Block not freed");
+
+	for (size_t i = 1; i < ARRAY_SIZE(bufs); i++) {
+		uart_rx_pool_unref(bufs[i]);
+	}
+}
+
+ZTEST(suite_uart_rx_pool, test_ref_unref)
+{
+	uint8_t *buf = uart_rx_pool_alloc();
+
+	zassert_not_null(buf);
+
+	/* The UART driver reports data at an offset within the block */
+	uart_rx_pool_ref(&buf[10]);
+	uart_rx_pool_ref(&buf[UART_RX_POOL_BUF_SIZE - 1]);
+
+	uart_rx_pool_unref(buf);
+	zassert_equal(pool_free_count(), UART_RX_POOL_BLOCK_COUNT - 1, "Referenced block freed");
+
+	uart_rx_pool_unref(&buf[UART_RX_POOL_BUF_SIZE - 1]);
+	zassert_equal(pool_free_count(), UART_RX_POOL_BLOCK_COUNT - 1, "Referenced block freed");
+
+	uart_rx_pool_unref(&buf[10]);
+	zassert_equal(pool_free_count(), UART_RX_POOL_BLOCK_COUNT, "Block not freed");
+}
+
+ZTEST(suite_uart_rx_pool, test_wait_resumes_on_free)
+{
+	uint8_t *bufs[UART_RX_POOL_BLOCK_COUNT];
+
+	pool_exhaust(bufs);
+
+	/* RX stalls: no block for the UART driver */
+	uart_rx_pool_wait();
+	zassert_equal(free_cb_count, 0, "Resumed without a free block");
+
+	/* Releasing a reference that is not the last one does not free the block */
+	uart_rx_pool_ref(bufs[0]);
+	uart_rx_pool_unref(bufs[0]);
+	zassert_equal(free_cb_count, 0, "Resumed without a free block");
+
+	uart_rx_pool_unref(bufs[0]);
+	zassert_equal(free_cb_count, 1, "Not resumed when a block was freed");
+
+	/* The callback is called once for each wait */
+	uart_rx_pool_unref(bufs[1]);
+	zassert_equal(free_cb_count, 1, "Resumed more than once");
+
+	for (size_t i = 2; i < ARRAY_SIZE(bufs); i++) {
+		uart_rx_pool_unref(bufs[i]);
+	}
+}
+
+ZTEST(suite_uart_rx_pool, test_wait_with_free_block)
+{
+	uint8_t *buf = uart_rx_pool_alloc();
+
+	zassert_not_null(buf);
+
+	/* A block was freed before the wait: resume immediately */
+	uart_rx_pool_wait();
+	zassert_equal(free_cb_count, 1, "Not resumed with a free block");
+
+	uart_rx_pool_unref(buf);
+	zassert_equal(free_cb_count, 1, "Resumed more than once");
+}
+
+ZTEST(suite_uart_rx_pool, test_queue_append)
+{
+	struct uart_rx_queue_block blocks[QUEUE_SIZE];
+	struct uart_rx_queue queue;
+	const uint8_t *data;
+	uint8_t *buf = uart_rx_pool_alloc();
+
+	zassert_not_null(buf);
+	uart_rx_queue_init(&queue, blocks, ARRAY_SIZE(blocks));
+
+	zassert_ok(uart_rx_queue_put(&queue, &buf[0], 4));
+	zassert_ok(uart_rx_queue_put(&queue, &buf[4], 6));
+	zassert_equal(queue.count, 1, "Contiguous data not appended");
+	zassert_equal(uart_rx_queue_peek(&queue, &data), 10);
+	zassert_equal_ptr(data, buf);
+
+	/* Not contiguous with the queued data */
+	zassert_ok(uart_rx_queue_put(&queue, &buf[20], 2));
+	zassert_equal(queue.count, 2);
+
+	uart_rx_pool_unref(buf);
+	zassert_equal(pool_free_count(), UART_RX_POOL_BLOCK_COUNT - 1, "Queued block freed");
+
+	uart_rx_queue_flush(&queue);
+	zassert_equal(queue.count, 0);
+	zassert_equal(uart_rx_queue_peek(&queue, &data), 0);
+}
+
+ZTEST(suite_uart_rx_pool, test_queue_full_drops)
+{
+	struct uart_rx_queue_block blocks[QUEUE_SIZE];
+	struct uart_rx_queue queue;
+	uint8_t *bufs[QUEUE_SIZE + 1];
+
+	uart_rx_queue_init(&queue, blocks, ARRAY_SIZE(blocks));
+
+	for (size_t i = 0; i < ARRAY_SIZE(bufs); i++) {
+		bufs[i] = uart_rx_pool_alloc();
+		zassert_not_null(bufs[i]);
+	}
+
+	zassert_ok(uart_rx_queue_put(&queue, bufs[0], 8));
+	zassert_ok(uart_rx_queue_put(&queue, bufs[1], 8));
+	zassert_equal(uart_rx_queue_put(&queue, bufs[2], 5), -ENOMEM, "Full queue accepted data");
+	zassert_equal(queue.dropped, 5, "Dropped data not counted");
+
+	/* Appending to the last block does not need an entry */
+	zassert_ok(uart_rx_queue_put(&queue, &bufs[1][8], 8));
+	zassert_equal(queue.dropped, 5);
+
+	/* Only the queued blocks are held */
+	for (size_t i = 0; i < ARRAY_SIZE(bufs); i++) {
+		uart_rx_pool_unref(bufs[i]);
+	}
+	zassert_equal(pool_free_count(), UART_RX_POOL_BLOCK_COUNT - QUEUE_SIZE);
+
+	uart_rx_queue_flush(&queue);
+}
+
+ZTEST(suite_uart_rx_pool, test_queue_consume_resumes)
+{
+	struct uart_rx_queue_block blocks[QUEUE_SIZE];
+	struct uart_rx_queue queue;
+	uint8_t *bufs[UART_RX_POOL_BLOCK_COUNT];
+	const uint8_t *data;
+
+	uart_rx_queue_init(&queue, blocks, ARRAY_SIZE(blocks));
+	pool_exhaust(bufs);
+
+	/* A sink holds two blocks, all the other blocks are held by the UART driver */
+	zassert_ok(uart_rx_queue_put(&queue, &bufs[0][0], 16));
+	zassert_ok(uart_rx_queue_put(&queue, &bufs[1][0], 16));
+	uart_rx_pool_unref(bufs[0]);
+	uart_rx_pool_unref(bufs[1]);
+
+	/* RX stalls until the sink sends its data */
+	uart_rx_pool_wait();
+
+	zassert_equal(uart_rx_queue_peek(&queue, &data), 16);
+	zassert_equal_ptr(data, bufs[0]);
+	uart_rx_queue_consume(&queue, 10);
+	zassert_equal(free_cb_count, 0, "Block freed before all data was sent");
+
+	zassert_equal(uart_rx_queue_peek(&queue, &data), 6);
+	zassert_equal_ptr(data, &bufs[0][10]);
+	uart_rx_queue_consume(&queue, 6);
+	zassert_equal(free_cb_count, 1, "RX not resumed when the data was sent");
+	zassert_equal(queue.count, 1);
+
+	zassert_equal(uart_rx_queue_peek(&queue, &data), 16);
+	zassert_equal_ptr(data, bufs[1]);
+	uart_rx_queue_consume(&queue, 16);
+	zassert_equal(queue.count, 0);
+
+	for (size_t i = 2; i < ARRAY_SIZE(bufs); i++) {
+		uart_rx_pool_unref(bufs[i]);
+	}
+}
+
+ZTEST_SUITE(suite_uart_rx_pool, NULL, NULL, test_before, test_after, NULL);
@@ -5,6 +5,7 @@
  */
 
 #include <zephyr/ztest.h>
+#include <zephyr/irq_offload.h>
 #include <errno.h>
 #include <data_fifo.h>
 
@@ -189,4 +190,85 @@ ZTEST(suite_data_fifo, test_data_fifo_data_put_size_zero)
 	zassert_equal(ret, -EINVAL, "block_lock did not return -EINVAL");
 }
 
+#define STRESS_ITERATIONS 1000
+#define STRESS_BLOCKS_NUM 4
+
+static uint32_t stress_isr_seq;
+
+static void stress_isr_producer(const void *arg)
+{
+	struct data_fifo *data_fifo = (struct data_fifo *)arg;
+	uint32_t *data_ptr;
+	int ret;
+
+	ret = data_fifo_pointer_first_vacant_get(data_fifo, (void **)&data_ptr, K_NO_WAIT);
+	zassert_equal(ret, 0, "first_vacant_get in ISR did not return 0");
+
+	*data_ptr = stress_isr_seq++;
+
+	ret = data_fifo_block_lock(data_fifo, (void **)&data_ptr, sizeof(*data_ptr));
+	zassert_equal(ret, 0, "block_lock in ISR did not return 0");
+}
+
+ZTEST(suite_data_fifo, test_data_fifo_stress_two_instances)
+{
+	DATA_FIFO_DEFINE(stress_fifo_a, STRESS_BLOCKS_NUM, 16);
+	DATA_FIFO_DEFINE(stress_fifo_b, STRESS_BLOCKS_NUM, 16);
+
+	uint32_t thread_seq = 0;
+	uint32_t expected_isr_seq = 0;
+	uint32_t *data_ptr;
+	size_t size;
+	int ret;
+
+	ret = data_fifo_init(&stress_fifo_a);
+	zassert_equal(ret, 0, "init did not return 0");
+	ret = data_fifo_init(&stress_fifo_b);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	stress_isr_seq = 0;
+
+	for (uint32_t i = 0; i < STRESS_ITERATIONS; i++) {
+		/* Producer in interrupt context on one FIFO */
+		irq_offload(stress_isr_producer, &stress_fifo_a);
+
+		/* Producer in thread context on the other FIFO */
+		ret = data_fifo_pointer_first_vacant_get(&stress_fifo_b, (void **)&data_ptr,
+							 K_NO_WAIT);
+		zassert_equal(ret, 0, "first_vacant_get did not return 0");
+		*data_ptr = thread_seq++;
+		ret = data_fifo_block_lock(&stress_fifo_b, (void **)&data_ptr, sizeof(*data_ptr));
+		zassert_equal(ret, 0, "block_lock did not return 0");
+
+		/* Let the FIFOs fill up before draining them */
+		if ((i % STRESS_BLOCKS_NUM) != (STRESS_BLOCKS_NUM - 1)) {
+			continue;
+		}
+
+		internal_test_remaining_elements(&stress_fifo_a, STRESS_BLOCKS_NUM,
+						 STRESS_BLOCKS_NUM, __LINE__);
+		internal_test_remaining_elements(&stress_fifo_b, STRESS_BLOCKS_NUM,
+						 STRESS_BLOCKS_NUM, __LINE__);
+
+		for (uint32_t j = 0; j < STRESS_BLOCKS_NUM; j++) {
+			ret = data_fifo_pointer_last_filled_get(&stress_fifo_a, (void **)&data_ptr,
+								&size, K_NO_WAIT);
+			zassert_equal(ret, 0, "last_filled_get did not return 0");
+			zassert_equal(size, sizeof(*data_ptr), "Wrong size");
+			zassert_equal(*data_ptr, expected_isr_seq++, "Block out of order");
+			data_fifo_block_free(&stress_fifo_a, data_ptr);
+
+			ret = data_fifo_pointer_last_filled_get(&stress_fifo_b, (void **)&data_ptr,
+								&size, K_NO_WAIT);
+			zassert_equal(ret, 0, "last_filled_get did not return 0");
+			zassert_equal(*data_ptr, thread_seq - STRESS_BLOCKS_NUM + j,
+				      "Block out of order");
+			data_fifo_block_free(&stress_fifo_b, data_ptr);
+		}
+
+		internal_test_remaining_elements(&stress_fifo_a, 0, 0, __LINE__);
+		internal_test_remaining_elements(&stress_fifo_b, 0, 0, __LINE__);
+	}
+}
+
 ZTEST_SUITE(suite_data_fifo, NULL, NULL, NULL, NULL, NULL);
@@ -7,11 +7,24 @@
 #include <zephyr/ztest.h>
 #include <ei_run_classifier.h>
 
+#define SLICE_SIZE (EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE / EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW)
+
 static size_t prediction_idx;
 
+/* Input window rebuilt from the slices in continuous mode. */
+static float window_buf[EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE];
+static size_t window_slice_cnt;
+static size_t slice_cnt;
+
 void ei_run_classifier_mock_init(void)
 {
 	prediction_idx = 0;
+	slice_cnt = 0;
+}
+
+size_t ei_run_classifier_mock_slice_cnt(void)
+{
+	return slice_cnt;
 }
 
 /* Input data must be ascending sequence of floats. Difference between
@@ -46,6 +59,34 @@ static void verify_data_read(signal_t *signal, const size_t prediction_idx,
 	}
 }
 
+static void result_fill(ei_impulse_result_t *result, const size_t pred_idx)
+{
+	/* Timing results. */
+	result->timing.dsp = EI_MOCK_GEN_DSP_TIME(pred_idx);
+	result->timing.classification = EI_MOCK_GEN_CLASSIFICATION_TIME(pred_idx);
+	result->timing.anomaly = EI_MOCK_GEN_ANOMALY_TIME(pred_idx);
+
+	/* Classification results. */
+	result->anomaly = EI_MOCK_GEN_ANOMALY(pred_idx);
+
+	size_t res_idx = EI_MOCK_GEN_LABEL_IDX(pred_idx);
+	const float value_selected = EI_MOCK_GEN_VALUE(pred_idx);
+	const float value_others = EI_MOCK_GEN_VALUE_OTHERS(pred_idx);
+
+	zassert_true(value_selected < 1.0, "Wrong value of selected label.");
+	zassert_true(value_selected > value_others, "Wrong values");
+
+	for (size_t i = 0; i < EI_CLASSIFIER_LABEL_COUNT; i++) {
+		result->classification[i].label = ei_classifier_inferencing_categories[i];
+		result->classification[i].value =
+			(i == res_idx) ? (value_selected) : (value_others);
+	}
+
+	zassert_false(strcmp(EI_MOCK_GEN_LABEL(pred_idx),
+		      ei_classifier_inferencing_categories[res_idx]),
+		      "Wrong label");
+}
+
 EI_IMPULSE_ERROR run_classifier(signal_t *signal,
 				ei_impulse_result_t *result,
 				bool debug)
@@ -62,32 +103,57 @@ EI_IMPULSE_ERROR run_classifier(signal_t *signal,
 	/* Busy wait for predefined amount of time to simulate calculations. */
 	k_busy_wait(EI_MOCK_BUSY_WAIT_TIME);
 
-	/* Timing results. */
-	result->timing.dsp = EI_MOCK_GEN_DSP_TIME(prediction_idx);
-	result->timing.classification = EI_MOCK_GEN_CLASSIFICATION_TIME(prediction_idx);
-	result->timing.anomaly = EI_MOCK_GEN_ANOMALY_TIME(prediction_idx);
+	result_fill(result, prediction_idx);
+	prediction_idx++;
 
-	/* Classification results. */
-	result->anomaly = EI_MOCK_GEN_ANOMALY(prediction_idx);
+	return EI_IMPULSE_OK;
+}
 
-	size_t res_idx = EI_MOCK_GEN_LABEL_IDX(prediction_idx);
-	const float value_selected = EI_MOCK_GEN_VALUE(prediction_idx);
-	const float value_others = EI_MOCK_GEN_VALUE_OTHERS(prediction_idx);
+void run_classifier_init(void)
+{
+	memset(window_buf, 0, sizeof(window_buf));
+	window_slice_cnt = 0;
+}
 
-	zassert_true(value_selected < 1.0, "Wrong value of selected label.");
-	zassert_true(value_selected > value_others, "Wrong values");
+/* Every slice must be an ascending sequence of floats that continues the previous slice.
+ * Results are generated for the window made of the most recent slices, based on its first
+ * input value.
+ */
+EI_IMPULSE_ERROR run_classifier_continuous(signal_t *signal,
+					   ei_impulse_result_t *result,
+					   bool debug,
+					   bool enable_maf)
+{
+	ARG_UNUSED(debug);
+	ARG_UNUSED(enable_maf);
 
-	for (size_t i = 0; i < EI_CLASSIFIER_LABEL_COUNT; i++) {
-		result->classification[i].label = ei_classifier_inferencing_categories[i];
-		result->classification[i].value =
-			(i == res_idx) ? (value_selected) : (value_others);
+	zassert_equal(signal->total_length, SLICE_SIZE, "Wrong slice size");
+
+	float *slice = &window_buf[ARRAY_SIZE(window_buf) - SLICE_SIZE];
+	float prev_value = slice[SLICE_SIZE - 1];
+
+	memmove(window_buf, &window_buf[SLICE_SIZE],
+		(ARRAY_SIZE(window_buf) - SLICE_SIZE) * sizeof(window_buf[0]));
+
+	int err = signal->get_data(0, SLICE_SIZE, slice);
+
+	zassert_ok(err, "get_data returned an error");
+
+	for (size_t off = 0; off < SLICE_SIZE; off++) {
+		if ((off > 0) || (window_slice_cnt > 0)) {
+			zassert_within(slice[off], prev_value + 1, FLOAT_CMP_EPSILON,
+				       "Input data error");
+		}
+		prev_value = slice[off];
 	}
 
-	zassert_false(strcmp(EI_MOCK_GEN_LABEL(prediction_idx),
-		      ei_classifier_inferencing_categories[res_idx]),
-		      "Wrong label");
+	window_slice_cnt++;
+	slice_cnt++;
 
-	prediction_idx++;
+	/* Busy wait for predefined amount of time to simulate calculations. */
+	k_busy_wait(EI_MOCK_BUSY_WAIT_TIME / EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW);
+
+	result_fill(result, EI_MOCK_GEN_PRED_IDX(window_buf[0]));
 
 	return EI_IMPULSE_OK;
 }
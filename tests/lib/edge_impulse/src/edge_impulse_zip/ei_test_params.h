@@ -18,6 +18,9 @@
 #define EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE	300
 #define EI_CLASSIFIER_HAS_ANOMALY		1
 #define EI_CLASSIFIER_FREQUENCY			60
+#ifndef EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW
+#define EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW	4
+#endif
 
 /* Mocked results. */
 static const char * const ei_classifier_inferencing_categories[] = {
@@ -29,6 +32,9 @@ static const char * const ei_classifier_inferencing_categories[] = {
 #define EI_MOCK_GEN_FIRST_INPUT(PRED_IDX) \
 	((float)((PRED_IDX) * EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME))
 
+#define EI_MOCK_GEN_PRED_IDX(FIRST_INPUT) \
+	((size_t)(FIRST_INPUT) / EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME)
+
 #define EI_MOCK_GEN_LABEL_IDX(PRED_IDX) ((PRED_IDX) % EI_CLASSIFIER_LABEL_COUNT)
 #define EI_MOCK_GEN_LABEL(PRED_IDX)	\
 	(ei_classifier_inferencing_categories[EI_MOCK_GEN_LABEL_IDX(PRED_IDX)])
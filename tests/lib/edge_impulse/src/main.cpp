@@ -378,6 +378,44 @@ ZTEST(suite0, test_data_after_start)
 	}
 }
 
+ZTEST(suite0, test_continuous)
+{
+	if (!IS_ENABLED(CONFIG_EI_WRAPPER_CONTINUOUS)) {
+		ztest_test_skip();
+	}
+
+	const size_t slice_frames = ei_wrapper_get_window_size() /
+				    ei_wrapper_get_frame_size() /
+				    EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW;
+	const static size_t loop_cnt = 20;
+	int err;
+
+	err = add_input_data(prediction_idx, slice_frames * loop_cnt);
+	zassert_ok(err, "Cannot add input data");
+
+	/* The first prediction processes the whole window. */
+	err = ei_wrapper_start_prediction(0, 0);
+	zassert_ok(err, "Cannot start prediction");
+	err = k_sem_take(&test_sem, EI_TEST_SEM_TIMEOUT);
+	zassert_ok(err, "Cannot take semaphore");
+	zassert_equal(ei_run_classifier_mock_slice_cnt(), EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW,
+		      "Wrong number of processed slices");
+
+	/* Shifting the window by one slice processes only the new slice. */
+	for (size_t i = 0; i < loop_cnt; i++) {
+		/* Result is verified for the first input of the shifted window. */
+		prediction_idx += slice_frames - 1;
+
+		err = ei_wrapper_start_prediction(0, slice_frames);
+		zassert_ok(err, "Cannot start prediction");
+		err = k_sem_take(&test_sem, EI_TEST_SEM_TIMEOUT);
+		zassert_ok(err, "Cannot take semaphore");
+		zassert_equal(ei_run_classifier_mock_slice_cnt(),
+			      EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW + i + 1,
+			      "Wrong number of processed slices");
+	}
+}
+
 static void test_thread_fn(void)
 {
 	int err;
@@ -382,6 +382,138 @@ void test_parse_ncellmeas(void)
 	TEST_ASSERT_EQUAL(0, cells.ncells_count);
 }
 
+void test_parse_ncellmeas_too_many_neighbors(void)
+{
+	int err;
+	char *resp = "%NCELLMEAS: 0,\"021D140C\",\"24201\",\"0821\",65535,5300,449,50,15,10891,"
+		     "1,2,3,4,5,1,2,3,4,5,1,2,3,4,5,1,2,3,4,5,1,2,3,4,5,1,2,3,4,5,"
+		     "1,2,3,4,5,1,2,3,4,5,1,2,3,4,5,1,2,3,4,5,1,2,3,4,5,1,2,3,4,5,"
+		     "1000";
+	struct lte_lc_ncell ncells[CONFIG_LTE_NEIGHBOR_CELLS_MAX];
+	struct lte_lc_cells_info cells = {
+		.neighbor_cells = ncells,
+	};
+
+	/* 12 neighbors, but space only for CONFIG_LTE_NEIGHBOR_CELLS_MAX. */
+	err = parse_ncellmeas(resp, &cells);
+	TEST_ASSERT_EQUAL(-E2BIG, err);
+	TEST_ASSERT_EQUAL(35460108, cells.current_cell.id);
+	TEST_ASSERT_EQUAL(CONFIG_LTE_NEIGHBOR_CELLS_MAX, cells.ncells_count);
+	TEST_ASSERT_EQUAL(1000, cells.current_cell.timing_advance_meas_time);
+	TEST_ASSERT_EQUAL(1, cells.neighbor_cells[CONFIG_LTE_NEIGHBOR_CELLS_MAX - 1].earfcn);
+	TEST_ASSERT_EQUAL(5, cells.neighbor_cells[CONFIG_LTE_NEIGHBOR_CELLS_MAX - 1].time_diff);
+}
+
+void test_parse_ncellmeas_malformed(void)
+{
+	int err;
+	/* Truncated and otherwise malformed notifications must be rejected without
+	 * writing outside of the provided storage.
+	 */
+	char *corpus[] = {
+		"%NCELLMEAS: ",
+		"%NCELLMEAS: 0,",
+		"%NCELLMEAS: x",
+		"%NCELLMEAS: 0,\"021D140C",
+		"%NCELLMEAS: 0,\"021D140C\",\"24201\"",
+		"%NCELLMEAS: 0,021D140C,\"24201\",\"0821\",65535,5300,449,50,15,10891",
+		"%NCELLMEAS: 0,\"021D140C\",\"2420123\",\"0821\",65535,5300,449,50,15,10891",
+		"%NCELLMEAS: 0,\"021D140C\",\"24201\",\"0821\",65535,5300,449,50,15,\"10891\"",
+		"%NCELLMEAS: 0,\"021D140C\",\"24201\",\"0821\",65535,5300,449,50,15,10891,5300,194",
+		"%NCELLMEAS: 0,\"021D140C\",\"24201\",\"0821\",65535,5300,449,50,15,10891,,,,,",
+		"%NCELLMEAS: 0,\"021D140C\",\"24201\",\"0821\",65535,5300,99999,50,15,10891",
+		"%NCELLMEAS: 0,\"021D140C\"x,\"24201\",\"0821\",65535,5300,449,50,15,10891",
+	};
+	struct lte_lc_ncell ncells[CONFIG_LTE_NEIGHBOR_CELLS_MAX];
+	struct lte_lc_cell gci_cells[2];
+	struct lte_lc_ncellmeas_params params = {
+		.search_type = LTE_LC_NEIGHBOR_SEARCH_TYPE_GCI_DEFAULT,
+		.gci_count = ARRAY_SIZE(gci_cells),
+	};
+	struct lte_lc_cells_info cells;
+
+	for (size_t i = 0; i < ARRAY_SIZE(corpus); i++) {
+		memset(&cells, 0, sizeof(cells));
+		cells.neighbor_cells = ncells;
+
+		err = parse_ncellmeas(corpus[i], &cells);
+		TEST_ASSERT_LESS_THAN_MESSAGE(0, err, corpus[i]);
+		TEST_ASSERT_LESS_OR_EQUAL(CONFIG_LTE_NEIGHBOR_CELLS_MAX, cells.ncells_count);
+
+		memset(&cells, 0, sizeof(cells));
+		cells.neighbor_cells = ncells;
+		cells.gci_cells = gci_cells;
+
+		err = parse_ncellmeas_gci(&params, corpus[i], &cells);
+		TEST_ASSERT_LESS_THAN_MESSAGE(0, err, corpus[i]);
+		TEST_ASSERT_LESS_OR_EQUAL(CONFIG_LTE_NEIGHBOR_CELLS_MAX, cells.ncells_count);
+		TEST_ASSERT_LESS_OR_EQUAL(ARRAY_SIZE(gci_cells), cells.gci_cells_count);
+	}
+}
+
+void test_parse_ncellmeas_gci(void)
+{
+	int err;
+	char *resp1 =
+		"%NCELLMEAS: 0,"
+		"\"00112233\",\"11199\",\"1A2B\",64,20877,6200,110,53,22,189205,1,2,"
+		"6200,111,50,20,10,6300,112,40,15,20,"
+		"\"00567812\",\"11198\",\"3C4D\",65535,4,1300,75,53,16,189241,0,0,"
+		"\"0011AABB\",\"11297\",\"5E6F\",65534,5,2300,449,51,11,189245,0,0\r\n";
+	char *resp2 = "%NCELLMEAS: 1\r\n";
+	struct lte_lc_ncell ncells[CONFIG_LTE_NEIGHBOR_CELLS_MAX];
+	struct lte_lc_cell gci_cells[2];
+	struct lte_lc_ncellmeas_params params = {
+		.search_type = LTE_LC_NEIGHBOR_SEARCH_TYPE_GCI_EXTENDED_LIGHT,
+		.gci_count = ARRAY_SIZE(gci_cells),
+	};
+	struct lte_lc_cells_info cells = {
+		.neighbor_cells = ncells,
+		.gci_cells = gci_cells,
+	};
+
+	/* Serving cell with two neighbors and two surrounding cells. */
+	err = parse_ncellmeas_gci(&params, resp1, &cells);
+	TEST_ASSERT_EQUAL(0, err);
+	TEST_ASSERT_EQUAL(0x00112233, cells.current_cell.id);
+	TEST_ASSERT_EQUAL(111, cells.current_cell.mcc);
+	TEST_ASSERT_EQUAL(99, cells.current_cell.mnc);
+	TEST_ASSERT_EQUAL(0x1A2B, cells.current_cell.tac);
+	TEST_ASSERT_EQUAL(64, cells.current_cell.timing_advance);
+	TEST_ASSERT_EQUAL(20877, cells.current_cell.timing_advance_meas_time);
+	TEST_ASSERT_EQUAL(6200, cells.current_cell.earfcn);
+	TEST_ASSERT_EQUAL(189205, cells.current_cell.measurement_time);
+	TEST_ASSERT_EQUAL(2, cells.ncells_count);
+	TEST_ASSERT_EQUAL(6300, cells.neighbor_cells[1].earfcn);
+	TEST_ASSERT_EQUAL(112, cells.neighbor_cells[1].phys_cell_id);
+	TEST_ASSERT_EQUAL(40, cells.neighbor_cells[1].rsrp);
+	TEST_ASSERT_EQUAL(15, cells.neighbor_cells[1].rsrq);
+	TEST_ASSERT_EQUAL(20, cells.neighbor_cells[1].time_diff);
+	TEST_ASSERT_EQUAL(2, cells.gci_cells_count);
+	TEST_ASSERT_EQUAL(0x00567812, cells.gci_cells[0].id);
+	TEST_ASSERT_EQUAL(98, cells.gci_cells[0].mnc);
+	TEST_ASSERT_EQUAL(0x0011AABB, cells.gci_cells[1].id);
+	TEST_ASSERT_EQUAL(112, cells.gci_cells[1].mcc);
+	TEST_ASSERT_EQUAL(449, cells.gci_cells[1].phys_cell_id);
+
+	/* Only one surrounding cell fits. */
+	params.gci_count = 1;
+
+	err = parse_ncellmeas_gci(&params, resp1, &cells);
+	TEST_ASSERT_EQUAL(-E2BIG, err);
+	TEST_ASSERT_EQUAL(0x00112233, cells.current_cell.id);
+	TEST_ASSERT_EQUAL(2, cells.ncells_count);
+	TEST_ASSERT_EQUAL(1, cells.gci_cells_count);
+	TEST_ASSERT_EQUAL(0x00567812, cells.gci_cells[0].id);
+
+	/* Valid response of failed measurement. */
+	err = parse_ncellmeas_gci(&params, resp2, &cells);
+	TEST_ASSERT_EQUAL(1, err);
+	TEST_ASSERT_EQUAL(LTE_LC_CELL_EUTRAN_ID_INVALID, cells.current_cell.id);
+	TEST_ASSERT_EQUAL(0, cells.ncells_count);
+	TEST_ASSERT_EQUAL(0, cells.gci_cells_count);
+}
+
 void test_neighborcell_count_get(void)
 {
 	char *resp1 = "%NCELLMEAS: 1,2,3,4,5,6,7,8,9,10,1,2,3,4,5,1,2,3,4,5,1,2,3,4,5,1,2,3,4,5,"
@@ -0,0 +1,436 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <modem/modem_info.h>
+#include <mock_nrf_modem_at.h>
+
+#include "cmock_nrf_modem_at.h"
+
+#define NETWORK_TTL_MS CONFIG_MODEM_INFO_CACHE_NETWORK_TTL
+
+static const char xmonitor_resp[] =
+	"%XMONITOR: 1,\"Operator\",\"OP\",\"26201\",\"0040\",7,20,\"0013BEEF\","
+	"334,6400,60,24,\"\",\"11100000\",\"00010011\",\"01001001\"\r\nOK\r\n";
+static const char xmonitor_not_registered_resp[] = "%XMONITOR: 2\r\nOK\r\n";
+static const char cgdcont_resp[] =
+	"+CGDCONT: 0,\"IP\",\"internet\",\"10.0.0.1\",0,0\r\n"
+	"+CGDCONT: 1,\"IPV4V6\",\"ims\",\"10.0.0.2 1111:2222:3333:4444\",0,0\r\nOK\r\n";
+static const char xcband_sup_resp[] = "%XCBAND: (1,2,3,4,5)\r\nOK\r\n";
+static const char xsystemmode_ltem_resp[] = "%XSYSTEMMODE: 1,0,1,0\r\nOK\r\n";
+static const char xsim_not_ready_resp[] = "%XSIM: 0\r\nOK\r\n";
+static const char xsim_ready_resp[] = "%XSIM: 1\r\nOK\r\n";
+static const char cemode_ps2_resp[] = "+CEMODE: 0\r\nOK\r\n";
+static const char cemode_cs_ps2_resp[] = "+CEMODE: 2\r\nOK\r\n";
+static const char xsystemmode_nbiot_resp[] = "%XSYSTEMMODE: 0,1,1,0\r\nOK\r\n";
+
+/* at_monitor_dispatch() is implemented in at_monitor library and
+ * we'll call it directly to fake received AT notifications
+ */
+extern void at_monitor_dispatch(const char *at_notif);
+
+/* Modem library hooks, called directly when CONFIG_UNITY is set. */
+extern void modem_info_cache_on_modem_init(int ret, void *ctx);
+extern void modem_info_cache_on_modem_shutdown(void *ctx);
+
+static void notif_dispatch(const char *notif)
+{
+	at_monitor_dispatch(notif);
+
+	/* The AT monitor library dispatches the notifications in the system workqueue. */
+	k_sleep(K_MSEC(1));
+}
+
+static void at_cmd_expect(const char *cmd, const char *resp, size_t resp_len)
+{
+	__cmock_nrf_modem_at_cmd_ExpectAndReturn(NULL, 0, cmd, 0);
+	__cmock_nrf_modem_at_cmd_IgnoreArg_buf();
+	__cmock_nrf_modem_at_cmd_IgnoreArg_len();
+	__cmock_nrf_modem_at_cmd_ReturnArrayThruPtr_buf((char *)resp, resp_len);
+}
+
+static void xmonitor_expect(void)
+{
+	at_cmd_expect("AT%%XMONITOR", xmonitor_resp, sizeof(xmonitor_resp));
+}
+
+void setUp(void)
+{
+	mock_nrf_modem_at_Init();
+
+	(void)modem_info_init();
+	modem_info_cache_invalidate();
+}
+
+void tearDown(void)
+{
+	mock_nrf_modem_at_Verify();
+}
+
+void test_network_info_single_at_command(void)
+{
+	char buf[32];
+	uint8_t band;
+	int rsrp;
+	int ret;
+
+	xmonitor_expect();
+
+	ret = modem_info_get_rsrp(&rsrp);
+	TEST_ASSERT_EQUAL(0, ret);
+	TEST_ASSERT_EQUAL(-80, rsrp);
+
+	ret = modem_info_get_current_band(&band);
+	TEST_ASSERT_EQUAL(0, ret);
+	TEST_ASSERT_EQUAL(20, band);
+
+	ret = modem_info_get_operator(buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(0, ret);
+	TEST_ASSERT_EQUAL_STRING("OP", buf);
+
+	ret = modem_info_string_get(MODEM_INFO_OPERATOR, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(strlen("26201"), ret);
+	TEST_ASSERT_EQUAL_STRING("26201", buf);
+
+	ret = modem_info_string_get(MODEM_INFO_AREA_CODE, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(strlen("0040"), ret);
+	TEST_ASSERT_EQUAL_STRING("0040", buf);
+
+	ret = modem_info_string_get(MODEM_INFO_CELLID, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(strlen("0013BEEF"), ret);
+	TEST_ASSERT_EQUAL_STRING("0013BEEF", buf);
+}
+
+void test_network_info_not_registered(void)
+{
+	char buf[32];
+	uint8_t band;
+	int rsrp;
+	int ret;
+
+	at_cmd_expect("AT%%XMONITOR", xmonitor_not_registered_resp,
+		      sizeof(xmonitor_not_registered_resp));
+
+	ret = modem_info_get_rsrp(&rsrp);
+	TEST_ASSERT_EQUAL(-ENOENT, ret);
+
+	ret = modem_info_get_current_band(&band);
+	TEST_ASSERT_EQUAL(-ENOENT, ret);
+
+	ret = modem_info_get_operator(buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(-ENOTSUP, ret);
+
+	ret = modem_info_string_get(MODEM_INFO_CELLID, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(-ENOTSUP, ret);
+}
+
+void test_network_info_expires(void)
+{
+	int rsrp;
+	int ret;
+
+	xmonitor_expect();
+
+	ret = modem_info_get_rsrp(&rsrp);
+	TEST_ASSERT_EQUAL(0, ret);
+
+	k_sleep(K_MSEC(NETWORK_TTL_MS + 1));
+
+	xmonitor_expect();
+
+	ret = modem_info_get_rsrp(&rsrp);
+	TEST_ASSERT_EQUAL(0, ret);
+	TEST_ASSERT_EQUAL(-80, rsrp);
+}
+
+void test_cesq_notification_updates_rsrp(void)
+{
+	int rsrp;
+	int ret;
+
+	xmonitor_expect();
+
+	ret = modem_info_get_rsrp(&rsrp);
+	TEST_ASSERT_EQUAL(0, ret);
+	TEST_ASSERT_EQUAL(-80, rsrp);
+
+	notif_dispatch("%CESQ: 50,2,20,3\r\n");
+
+	ret = modem_info_get_rsrp(&rsrp);
+	TEST_ASSERT_EQUAL(0, ret);
+	TEST_ASSERT_EQUAL(-90, rsrp);
+}
+
+void test_cereg_notification_updates_cell(void)
+{
+	char buf[32];
+	uint8_t band;
+	int ret;
+
+	xmonitor_expect();
+
+	ret = modem_info_string_get(MODEM_INFO_CELLID, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL_STRING("0013BEEF", buf);
+
+	notif_dispatch("+CEREG: 5,\"0041\",\"0014BEEF\",7\r\n");
+
+	ret = modem_info_string_get(MODEM_INFO_CELLID, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(strlen("0014BEEF"), ret);
+	TEST_ASSERT_EQUAL_STRING("0014BEEF", buf);
+
+	ret = modem_info_string_get(MODEM_INFO_AREA_CODE, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(strlen("0041"), ret);
+	TEST_ASSERT_EQUAL_STRING("0041", buf);
+
+	/* The band is not reported in the notification, so it is read again. */
+	xmonitor_expect();
+
+	ret = modem_info_get_current_band(&band);
+	TEST_ASSERT_EQUAL(0, ret);
+}
+
+void test_cereg_notification_not_registered(void)
+{
+	char buf[32];
+	int ret;
+
+	xmonitor_expect();
+
+	ret = modem_info_string_get(MODEM_INFO_CELLID, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL_STRING("0013BEEF", buf);
+
+	notif_dispatch("+CEREG: 2\r\n");
+
+	at_cmd_expect("AT%%XMONITOR", xmonitor_not_registered_resp,
+		      sizeof(xmonitor_not_registered_resp));
+
+	ret = modem_info_string_get(MODEM_INFO_CELLID, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(-ENOTSUP, ret);
+}
+
+void test_modem_sleep_keeps_network_info(void)
+{
+	int rsrp;
+	int ret;
+
+	xmonitor_expect();
+
+	ret = modem_info_get_rsrp(&rsrp);
+	TEST_ASSERT_EQUAL(0, ret);
+
+	notif_dispatch("%XMODEMSLEEP: 1,36000000\r\n");
+
+	k_sleep(K_MSEC(NETWORK_TTL_MS + 1));
+
+	ret = modem_info_get_rsrp(&rsrp);
+	TEST_ASSERT_EQUAL(0, ret);
+	TEST_ASSERT_EQUAL(-80, rsrp);
+
+	/* The network information is read again after the modem wakes up. */
+	notif_dispatch("%XMODEMSLEEP: 1,0\r\n");
+
+	xmonitor_expect();
+
+	ret = modem_info_get_rsrp(&rsrp);
+	TEST_ASSERT_EQUAL(0, ret);
+}
+
+void test_pdn_info_single_at_command(void)
+{
+	char buf[64];
+	int ret;
+
+	at_cmd_expect("AT+CGDCONT?", cgdcont_resp, sizeof(cgdcont_resp));
+
+	ret = modem_info_string_get(MODEM_INFO_IP_ADDRESS, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(strlen("10.0.0.1, 10.0.0.2"), ret);
+	TEST_ASSERT_EQUAL_STRING("10.0.0.1, 10.0.0.2", buf);
+
+	ret = modem_info_string_get(MODEM_INFO_APN, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(strlen("internet"), ret);
+	TEST_ASSERT_EQUAL_STRING("internet", buf);
+}
+
+void test_cgev_notification_invalidates_pdn_info(void)
+{
+	char buf[64];
+	int ret;
+
+	at_cmd_expect("AT+CGDCONT?", cgdcont_resp, sizeof(cgdcont_resp));
+
+	ret = modem_info_string_get(MODEM_INFO_APN, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL_STRING("internet", buf);
+
+	notif_dispatch("+CGEV: ME PDN DEACT 0\r\n");
+
+	at_cmd_expect("AT+CGDCONT?", cgdcont_resp, sizeof(cgdcont_resp));
+
+	ret = modem_info_string_get(MODEM_INFO_APN, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(strlen("internet"), ret);
+}
+
+void test_static_info_read_once(void)
+{
+	char buf[64];
+	int ret;
+
+	at_cmd_expect("AT%%XCBAND=?", xcband_sup_resp, sizeof(xcband_sup_resp));
+
+	ret = modem_info_string_get(MODEM_INFO_SUP_BAND, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(strlen("(1,2,3,4,5)"), ret);
+	TEST_ASSERT_EQUAL_STRING("(1,2,3,4,5)", buf);
+
+	ret = modem_info_string_get(MODEM_INFO_SUP_BAND, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(strlen("(1,2,3,4,5)"), ret);
+	TEST_ASSERT_EQUAL_STRING("(1,2,3,4,5)", buf);
+}
+
+void test_invalidate(void)
+{
+	char buf[64];
+	int ret;
+
+	at_cmd_expect("AT%%XCBAND=?", xcband_sup_resp, sizeof(xcband_sup_resp));
+
+	ret = modem_info_string_get(MODEM_INFO_SUP_BAND, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(strlen("(1,2,3,4,5)"), ret);
+
+	modem_info_cache_invalidate();
+
+	at_cmd_expect("AT%%XCBAND=?", xcband_sup_resp, sizeof(xcband_sup_resp));
+
+	ret = modem_info_string_get(MODEM_INFO_SUP_BAND, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(strlen("(1,2,3,4,5)"), ret);
+}
+
+void test_system_mode_not_cached(void)
+{
+	uint16_t mode;
+	int ret;
+
+	at_cmd_expect("AT%%XSYSTEMMODE?", xsystemmode_ltem_resp, sizeof(xsystemmode_ltem_resp));
+
+	ret = modem_info_short_get(MODEM_INFO_LTE_MODE, &mode);
+	TEST_ASSERT_EQUAL(sizeof(uint16_t), ret);
+	TEST_ASSERT_EQUAL(1, mode);
+
+	/* The system mode is changed without the cache seeing it. */
+	at_cmd_expect("AT%%XSYSTEMMODE?", xsystemmode_nbiot_resp, sizeof(xsystemmode_nbiot_resp));
+
+	ret = modem_info_short_get(MODEM_INFO_LTE_MODE, &mode);
+	TEST_ASSERT_EQUAL(sizeof(uint16_t), ret);
+	TEST_ASSERT_EQUAL(0, mode);
+}
+
+static void uicc_read_expect(const char *resp, size_t resp_len, uint16_t expected)
+{
+	uint16_t uicc;
+	int ret;
+
+	if (resp) {
+		at_cmd_expect("AT%%XSIM?", resp, resp_len);
+	}
+
+	ret = modem_info_short_get(MODEM_INFO_UICC, &uicc);
+	TEST_ASSERT_EQUAL(sizeof(uint16_t), ret);
+	TEST_ASSERT_EQUAL(expected, uicc);
+}
+
+void test_sim_info_cached_with_xsim_subscription(void)
+{
+	__mock_nrf_modem_at_printf_ExpectAndReturn("AT%XSIM=1", 0);
+	modem_info_cache_on_modem_init(0, NULL);
+
+	uicc_read_expect(xsim_not_ready_resp, sizeof(xsim_not_ready_resp), 0);
+	uicc_read_expect(NULL, 0, 0);
+
+	/* The SIM state change is notified. */
+	notif_dispatch("%XSIM: 1\r\n");
+
+	uicc_read_expect(xsim_ready_resp, sizeof(xsim_ready_resp), 1);
+
+	modem_info_cache_on_modem_shutdown(NULL);
+}
+
+void test_sim_info_not_cached_without_xsim_subscription(void)
+{
+	__mock_nrf_modem_at_printf_ExpectAndReturn("AT%XSIM=1", -EFAULT);
+	modem_info_cache_on_modem_init(0, NULL);
+
+	uicc_read_expect(xsim_not_ready_resp, sizeof(xsim_not_ready_resp), 0);
+	uicc_read_expect(xsim_ready_resp, sizeof(xsim_ready_resp), 1);
+
+	modem_info_cache_on_modem_shutdown(NULL);
+
+	/* Nor after the modem library is shut down. */
+	uicc_read_expect(xsim_not_ready_resp, sizeof(xsim_not_ready_resp), 0);
+	uicc_read_expect(xsim_ready_resp, sizeof(xsim_ready_resp), 1);
+}
+
+void test_modem_init_invalidates(void)
+{
+	char buf[64];
+	int ret;
+
+	at_cmd_expect("AT%%XCBAND=?", xcband_sup_resp, sizeof(xcband_sup_resp));
+
+	ret = modem_info_string_get(MODEM_INFO_SUP_BAND, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(strlen("(1,2,3,4,5)"), ret);
+
+	__mock_nrf_modem_at_printf_ExpectAndReturn("AT%XSIM=1", 0);
+	modem_info_cache_on_modem_init(0, NULL);
+
+	at_cmd_expect("AT%%XCBAND=?", xcband_sup_resp, sizeof(xcband_sup_resp));
+
+	ret = modem_info_string_get(MODEM_INFO_SUP_BAND, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(strlen("(1,2,3,4,5)"), ret);
+
+	modem_info_cache_on_modem_shutdown(NULL);
+}
+
+void test_ue_mode_not_cached(void)
+{
+	uint16_t mode;
+	int ret;
+
+	at_cmd_expect("AT+CEMODE?", cemode_ps2_resp, sizeof(cemode_ps2_resp));
+
+	ret = modem_info_short_get(MODEM_INFO_UE_MODE, &mode);
+	TEST_ASSERT_EQUAL(sizeof(uint16_t), ret);
+	TEST_ASSERT_EQUAL(0, mode);
+
+	/* The UE mode is changed without the cache seeing it. */
+	at_cmd_expect("AT+CEMODE?", cemode_cs_ps2_resp, sizeof(cemode_cs_ps2_resp));
+
+	ret = modem_info_short_get(MODEM_INFO_UE_MODE, &mode);
+	TEST_ASSERT_EQUAL(sizeof(uint16_t), ret);
+	TEST_ASSERT_EQUAL(2, mode);
+}
+
+/* This is needed because AT Monitor library is initialized in SYS_INIT. */
+static int sys_init_helper(void)
+{
+	__cmock_nrf_modem_at_notif_handler_set_ExpectAnyArgsAndReturn(0);
+
+	return 0;
+}
+
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
+
+SYS_INIT(sys_init_helper, POST_KERNEL, 0);
@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <unity.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <modem/sms.h>
+#include <modem/at_monitor.h>
+#include <mock_nrf_modem_at.h>
+
+#include "cmock_nrf_modem_at.h"
+
+/* Test corpus of concatenated SMS-DELIVER PDUs. */
+
+/* 291 characters split into 2 messages with reference number 0x7E. */
+static const char *pdu_len291_part1 =
+	"0791534874894310440A912143658709000012201232054480A00500037E020162B219AD66BBE172B0986C46ABD96EB81C2C269BD16AB61B2E078BC966B49AED86CBC162B219AD66BBE172B0986C46ABD96EB81C2C269BD16AB61B2E078BC966B49AED86CBC162B219AD66BBE172B0986C46ABD96EB81C2C269BD16AB61B2E078BC966B49AED86CBC162B219AD66BBE172B0986C46ABD96EB81C2C269BD16AB61B2E078BC966";
+static const char *pdu_len291_part2 =
+	"0791534874894320440A912143658709000012201232054480910500037E02026835DB0D9783C564335ACD76C3E56031D98C56B3DD7039584C36A3D56C375C0E1693CD6835DB0D9783C564335ACD76C3E56031D98C56B3DD7039584C36A3D56C375C0E1693CD6835DB0D9783C564335ACD76C3E56031D98C56B3DD7039584C36A3D56C375C0E1693CD6835DB0D9783C564335ACD76C3E56031";
+static const char *text_len291_part1 =
+	"123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123";
+static const char *text_len291_part2 =
+	"456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901";
+
+/* 755 characters split into 5 messages with reference number 0x80. */
+static const char *pdu_len755_part[] = {
+	"0791534874894310440A912143658709000012202280655080A0050003800501C2E231B96C3EA3D3EA35BBED7EC3E3F239BD6EBFE3F37A50583C2697CD67745ABD66B7DD6F785C3EA7D7ED777C5E0F0A8BC7E4B2F98C4EABD7ECB6FB0D8FCBE7F4BAFD8ECFEB4161F1985C369FD169F59ADD76BFE171F99C5EB7DFF1793D282C1E93CBE6333AAD5EB3DBEE373C2E9FD3EBF63B3EAF0785C56372D97C46A7D56B76DBFD86C7E5",
+	"0791534874894370440A912143658709000012202280656080A0050003800502E6F4BAFD8ECFEB4161F1985C369FD169F59ADD76BFE171F99C5EB7DFF1793D282C1E93CBE6333AAD5EB3DBEE373C2E9FD3EBF63B3EAF0785C56372D97C46A7D56B76DBFD86C7E5737ADD7EC7E7F5A0B0784C2E9BCFE8B47ACD6EBBDFF0B87C4EAFDBEFF8BC1E14168FC965F3199D56AFD96DF71B1E97CFE975FB1D9FD783C2E231B96C3EA3D3",
+	"0791534874894310440A912143658709000012202280656080A0050003800503D46B76DBFD86C7E5737ADD7EC7E7F5A0B0784C2E9BCFE8B47ACD6EBBDFF0B87C4EAFDBEFF8BC1E14168FC965F3199D56AFD96DF71B1E97CFE975FB1D9FD783C2E231B96C3EA3D3EA35BBED7EC3E3F239BD6EBFE3F37A50583C2697CD67745ABD66B7DD6F785C3EA7D7ED777C5E0F0A8BC7E4B2F98C4EABD7ECB6FB0D8FCBE7F4BAFD8ECFEB41",
+	"0791534874894370440A912143658709000012202280656080A0050003800504C2E231B96C3EA3D3EA35BBED7EC3E3F239BD6EBFE3F37A50583C2697CD67745ABD66B7DD6F785C3EA7D7ED777C5E0F0A8BC7E4B2F98C4EABD7ECB6FB0D8FCBE7F4BAFD8ECFEB4161F1985C369FD169F59ADD76BFE171F99C5EB7DFF1793D282C1E93CBE6333AAD5EB3DBEE373C2E9FD3EBF63B3EAF0785C56372D97C46A7D56B76DBFD86C7E5",
+	"0791534874894310440A91214365870900001220228065608096050003800505E6F4BAFD8ECFEB4161F1985C369FD169F59ADD76BFE171F99C5EB7DFF1793D282C1E93CBE6333AAD5EB3DBEE373C2E9FD3EBF63B3EAF0785C56372D97C46A7D56B76DBFD86C7E5737ADD7EC7E7F5A0B0784C2E9BCFE8B47ACD6EBBDFF0B87C4EAFDBEFF8BC1E14168FC965F3199D56AFD96DF71B1E97CFE975FB1D9FD703",
+};
+static const char *text_alphabet = "abcdefghijklmnopqrstuvwxyz ";
+
+/* Single message with 3 characters. */
+static const char *pdu_len3 =
+	"0791534874894320040D91214365870921F300001220900285438003CD771A";
+
+static struct sms_data test_sms_data;
+static int test_handle;
+static int sms_callback_count_expected;
+static int sms_callback_count;
+
+/* at_monitor_dispatch() is implemented in at_monitor library and
+ * we'll call it directly to fake received SMS message
+ */
+extern void at_monitor_dispatch(const char *at_notif);
+
+/* sms_ack_resp_handler() is implemented in SMS library and
+ * we'll call it directly to fake response to AT+CNMA=1.
+ */
+extern void sms_ack_resp_handler(const char *resp);
+
+/** Callback that SMS library will call when a message is received. */
+static void sms_callback(struct sms_data *const data, void *context)
+{
+	struct sms_udh_concat *concat = &data->header.deliver.concatenated;
+	struct sms_udh_concat *test_concat = &test_sms_data.header.deliver.concatenated;
+
+	sms_callback_count++;
+	TEST_ASSERT_LESS_OR_EQUAL(sms_callback_count_expected, sms_callback_count);
+
+	TEST_ASSERT_EQUAL(SMS_TYPE_DELIVER, data->type);
+	TEST_ASSERT_EQUAL(test_sms_data.payload_len, data->payload_len);
+	TEST_ASSERT_EQUAL_STRING(test_sms_data.payload, data->payload);
+
+	TEST_ASSERT_EQUAL_STRING(test_sms_data.header.deliver.originating_address.address_str,
+		data->header.deliver.originating_address.address_str);
+	TEST_ASSERT_EQUAL(test_sms_data.header.deliver.time.second,
+		data->header.deliver.time.second);
+
+	TEST_ASSERT_EQUAL(test_concat->present, concat->present);
+	TEST_ASSERT_EQUAL(test_concat->ref_number, concat->ref_number);
+	TEST_ASSERT_EQUAL(test_concat->total_msgs, concat->total_msgs);
+	TEST_ASSERT_EQUAL(test_concat->seq_number, concat->seq_number);
+}
+
+static void helper_expect(const char *payload, uint8_t second,
+			  uint16_t ref_number, uint8_t total_msgs, uint8_t seq_number)
+{
+	memset(&test_sms_data, 0, sizeof(test_sms_data));
+
+	strcpy(test_sms_data.header.deliver.originating_address.address_str, "1234567890");
+	strcpy(test_sms_data.payload, payload);
+	test_sms_data.payload_len = strlen(payload);
+	test_sms_data.header.deliver.time.second = second;
+	test_sms_data.header.deliver.concatenated.present = (total_msgs > 0);
+	test_sms_data.header.deliver.concatenated.ref_number = ref_number;
+	test_sms_data.header.deliver.concatenated.total_msgs = total_msgs;
+	test_sms_data.header.deliver.concatenated.seq_number = seq_number;
+
+	sms_callback_count_expected++;
+}
+
+/**
+ * Fake a received PDU. Reference number and total number of messages in the concatenated
+ * short message information element are replaced if non-zero values are given.
+ */
+static void helper_recv(const char *pdu, uint8_t ref_number, uint8_t total_msgs)
+{
+	static char notif[512];
+	char *udh;
+	char hex[3];
+
+	snprintf(notif, sizeof(notif), "+CMT: \"1234567890\",159\r\n%s\r\n", pdu);
+
+	udh = strstr(notif, "050003");
+	TEST_ASSERT_TRUE(udh != NULL || (ref_number == 0 && total_msgs == 0));
+
+	if (ref_number != 0) {
+		snprintf(hex, sizeof(hex), "%02X", ref_number);
+		memcpy(udh + 6, hex, 2);
+	}
+	if (total_msgs != 0) {
+		snprintf(hex, sizeof(hex), "%02X", total_msgs);
+		memcpy(udh + 8, hex, 2);
+	}
+
+	__cmock_nrf_modem_at_cmd_async_ExpectAndReturn(sms_ack_resp_handler, "AT+CNMA=1", 0);
+	at_monitor_dispatch(notif);
+	k_sleep(K_MSEC(1));
+
+	TEST_ASSERT_EQUAL(sms_callback_count_expected, sms_callback_count);
+}
+
+static void sms_reg_helper(void)
+{
+	char resp[] = "+CNMI: 0,0,0,0,1\r\n";
+
+	__cmock_nrf_modem_at_cmd_ExpectAndReturn(NULL, 0, "AT+CNMI?", 0);
+	__cmock_nrf_modem_at_cmd_IgnoreArg_buf();
+	__cmock_nrf_modem_at_cmd_IgnoreArg_len();
+	__cmock_nrf_modem_at_cmd_ReturnArrayThruPtr_buf(resp, sizeof(resp));
+
+	__mock_nrf_modem_at_printf_ExpectAndReturn("AT+CNMI=3,2,0,1", 0);
+
+	test_handle = sms_register_listener(sms_callback, NULL);
+	TEST_ASSERT_EQUAL(0, test_handle);
+}
+
+static void sms_unreg_helper(void)
+{
+	__mock_nrf_modem_at_printf_ExpectAndReturn("AT+CNMI=0,0,0,0", 0);
+
+	/* Partially received messages are delivered as they are when the last listener is
+	 * unregistered.
+	 */
+	sms_unregister_listener(test_handle);
+	test_handle = -1;
+}
+
+void setUp(void)
+{
+	mock_nrf_modem_at_Init();
+
+	memset(&test_sms_data, 0, sizeof(test_sms_data));
+	sms_callback_count_expected = 0;
+	sms_callback_count = 0;
+
+	sms_reg_helper();
+}
+
+void tearDown(void)
+{
+	sms_unreg_helper();
+
+	TEST_ASSERT_EQUAL(sms_callback_count_expected, sms_callback_count);
+
+	mock_nrf_modem_at_Verify();
+}
+
+static void helper_text_len291(char *text)
+{
+	strcpy(text, text_len291_part1);
+	strcat(text, text_len291_part2);
+}
+
+static void helper_text_len755(char *text)
+{
+	text[0] = '\0';
+	for (int i = 0; i < 28; i++) {
+		strcat(text, text_alphabet);
+	}
+	/* Last part ends without the trailing space */
+	text[755] = '\0';
+}
+
+/********* SMS CONCATENATED MESSAGE REASSEMBLY TESTS ***********************/
+
+/** Non-concatenated message is delivered as is. */
+void test_concat_single_message(void)
+{
+	helper_expect("Moi", 34, 0, 0, 0);
+	strcpy(test_sms_data.header.deliver.originating_address.address_str, "1234567890123");
+	helper_recv(pdu_len3, 0, 0);
+}
+
+/** Two parts received in order are delivered once as a single message. */
+void test_concat_len291_msgs2(void)
+{
+	char text[300];
+
+	helper_recv(pdu_len291_part1, 0, 0);
+
+	helper_text_len291(text);
+	helper_expect(text, 44, 0x7E, 2, 0);
+	helper_recv(pdu_len291_part2, 0, 0);
+}
+
+/** Five parts received out of order are delivered once in sequence number order. */
+void test_concat_len755_msgs5_out_of_order(void)
+{
+	char text[28 * 27 + 1];
+
+	helper_recv(pdu_len755_part[0], 0, 0);
+	helper_recv(pdu_len755_part[3], 0, 0);
+	helper_recv(pdu_len755_part[1], 0, 0);
+	helper_recv(pdu_len755_part[2], 0, 0);
+
+	/* Timestamp is taken from the first part */
+	helper_text_len755(text);
+	helper_expect(text, 5, 0x80, 5, 0);
+	helper_recv(pdu_len755_part[4], 0, 0);
+}
+
+/** Last part received first. */
+void test_concat_len291_msgs2_reversed(void)
+{
+	char text[300];
+
+	helper_recv(pdu_len291_part2, 0, 0);
+
+	helper_text_len291(text);
+	helper_expect(text, 44, 0x7E, 2, 0);
+	helper_recv(pdu_len291_part1, 0, 0);
+}
+
+/** Retransmitted part is acknowledged but ignored. */
+void test_concat_duplicate_part(void)
+{
+	char text[300];
+
+	helper_recv(pdu_len291_part1, 0, 0);
+	helper_recv(pdu_len291_part1, 0, 0);
+
+	helper_text_len291(text);
+	helper_expect(text, 44, 0x7E, 2, 0);
+	helper_recv(pdu_len291_part2, 0, 0);
+}
+
+/** Interleaved messages are tracked separately by their reference numbers. */
+void test_concat_interleaved(void)
+{
+	char text[300];
+
+	helper_text_len291(text);
+
+	helper_recv(pdu_len291_part1, 0x11, 0);
+	helper_recv(pdu_len291_part1, 0x22, 0);
+
+	helper_expect(text, 44, 0x22, 2, 0);
+	helper_recv(pdu_len291_part2, 0x22, 0);
+
+	helper_expect(text, 44, 0x11, 2, 0);
+	helper_recv(pdu_len291_part2, 0x11, 0);
+}
+
+/** Parts of a message that does not fit into the pool are delivered as is. */
+void test_concat_pool_full(void)
+{
+	char text[300];
+
+	TEST_ASSERT_EQUAL(2, CONFIG_SMS_CONCAT_POOL_SIZE);
+
+	helper_recv(pdu_len291_part1, 0x11, 0);
+	helper_recv(pdu_len291_part1, 0x22, 0);
+
+	helper_expect(text_len291_part1, 44, 0x33, 2, 1);
+	helper_recv(pdu_len291_part1, 0x33, 0);
+	helper_expect(text_len291_part2, 44, 0x33, 2, 2);
+	helper_recv(pdu_len291_part2, 0x33, 0);
+
+	/* Messages already in the pool are not affected */
+	helper_text_len291(text);
+	helper_expect(text, 44, 0x11, 2, 0);
+	helper_recv(pdu_len291_part2, 0x11, 0);
+
+	/* Delivered as is when the listener is unregistered */
+	helper_expect(text_len291_part1, 44, 0x22, 2, 1);
+}
+
+/** Later parts of a message that did not fit into the pool are delivered as is even if
+ *  the pool has room for them.
+ */
+void test_concat_pool_full_later_part(void)
+{
+	char text[300];
+
+	helper_recv(pdu_len291_part1, 0x11, 0);
+	helper_recv(pdu_len291_part1, 0x22, 0);
+
+	helper_expect(text_len291_part1, 44, 0x33, 2, 1);
+	helper_recv(pdu_len291_part1, 0x33, 0);
+
+	helper_text_len291(text);
+	helper_expect(text, 44, 0x11, 2, 0);
+	helper_recv(pdu_len291_part2, 0x11, 0);
+	helper_expect(text, 44, 0x22, 2, 0);
+	helper_recv(pdu_len291_part2, 0x22, 0);
+
+	/* Part 1 has already been delivered, so part 2 must not wait for it */
+	helper_expect(text_len291_part2, 44, 0x33, 2, 2);
+	helper_recv(pdu_len291_part2, 0x33, 0);
+}
+
+/** Parts of a message with more parts than can be reassembled are delivered as is. */
+void test_concat_too_many_parts(void)
+{
+	TEST_ASSERT_EQUAL(5, CONFIG_SMS_CONCAT_MAX_PARTS);
+
+	helper_expect(text_len291_part1, 44, 0x7E, 6, 1);
+	helper_recv(pdu_len291_part1, 0, 6);
+}
+
+/** Parts of a partially received message are delivered as is after the timeout. */
+void test_concat_timeout(void)
+{
+	helper_recv(pdu_len291_part1, 0, 0);
+
+	k_sleep(K_MSEC(CONFIG_SMS_CONCAT_TIMEOUT * MSEC_PER_SEC / 2));
+	TEST_ASSERT_EQUAL(0, sms_callback_count);
+
+	/* Delivered without waiting for a new part */
+	helper_expect(text_len291_part1, 44, 0x7E, 2, 1);
+	k_sleep(K_MSEC(CONFIG_SMS_CONCAT_TIMEOUT * MSEC_PER_SEC / 2 + 100));
+	TEST_ASSERT_EQUAL(1, sms_callback_count);
+
+	/* Part 2 arriving after the timeout is delivered as is */
+	helper_expect(text_len291_part2, 44, 0x7E, 2, 2);
+	helper_recv(pdu_len291_part2, 0, 0);
+}
+
+/** Timeout is counted from the latest part of the message. */
+void test_concat_timeout_restarted(void)
+{
+	char text[28 * 27 + 1];
+
+	helper_recv(pdu_len755_part[0], 0, 0);
+	k_sleep(K_MSEC(CONFIG_SMS_CONCAT_TIMEOUT * MSEC_PER_SEC * 3 / 4));
+	helper_recv(pdu_len755_part[1], 0, 0);
+	k_sleep(K_MSEC(CONFIG_SMS_CONCAT_TIMEOUT * MSEC_PER_SEC * 3 / 4));
+	helper_recv(pdu_len755_part[2], 0, 0);
+	helper_recv(pdu_len755_part[3], 0, 0);
+
+	helper_text_len755(text);
+	helper_expect(text, 5, 0x80, 5, 0);
+	helper_recv(pdu_len755_part[4], 0, 0);
+}
+
+/** Parts of a partially received message are delivered as is on unregistration. */
+void test_concat_unregister(void)
+{
+	helper_recv(pdu_len291_part2, 0, 0);
+
+	helper_expect(text_len291_part2, 44, 0x7E, 2, 2);
+	sms_unreg_helper();
+	TEST_ASSERT_EQUAL(1, sms_callback_count);
+
+	/* Part 1 is stored again as the pool was emptied */
+	sms_reg_helper();
+	helper_recv(pdu_len291_part1, 0, 0);
+
+	/* Delivered as is when the listener is unregistered */
+	helper_expect(text_len291_part1, 44, 0x7E, 2, 1);
+}
+
+/* This is needed because AT Monitor library is initialized in SYS_INIT. */
+static int sms_test_sys_init(void)
+{
+	__cmock_nrf_modem_at_notif_handler_set_ExpectAnyArgsAndReturn(0);
+
+	return 0;
+}
+
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
+
+SYS_INIT(sms_test_sys_init, POST_KERNEL, 0);
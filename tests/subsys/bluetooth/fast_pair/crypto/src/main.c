@@ -77,6 +77,116 @@ ZTEST(suite_crypto, test_aes128_ecb)
 	zassert_mem_equal(result_buf, plaintext, sizeof(plaintext), "Invalid decryption result.");
 }
 
+#define FIND_TEST_ACCOUNT_KEY_CNT	5
+#define FIND_TEST_MATCH_IDX		3
+
+static bool aes128_ecb_find_check(const uint8_t *out, void *context)
+{
+	const uint8_t *expected = context;
+
+	return !memcmp(out, expected, FP_CRYPTO_AES128_BLOCK_LEN);
+}
+
+static bool hmac_sha256_find_check(const uint8_t *out, void *context)
+{
+	const uint8_t *expected = context;
+
+	return !memcmp(out, expected, FP_CRYPTO_SHA256_HASH_LEN);
+}
+
+static void find_test_keys_prepare(struct fp_account_key *account_key_list, size_t n,
+				   const uint8_t *key, size_t match_idx)
+{
+	for (size_t i = 0; i < n; i++) {
+		memset(account_key_list[i].key, (uint8_t)(i + 1), FP_ACCOUNT_KEY_LEN);
+	}
+
+	if (match_idx < n) {
+		memcpy(account_key_list[match_idx].key, key, FP_ACCOUNT_KEY_LEN);
+	}
+}
+
+ZTEST(suite_crypto, test_aes128_ecb_decrypt_find)
+{
+	static const uint8_t plaintext[] = {0xF3, 0x0F, 0x4E, 0x78, 0x6C, 0x59, 0xA7, 0xBB, 0xF3,
+					    0x87, 0x3B, 0x5A, 0x49, 0xBA, 0x97, 0xEA};
+
+	static const uint8_t key[] = {0xA0, 0xBA, 0xF0, 0xBB, 0x95, 0x1F, 0xF7, 0xB6, 0xCF, 0x5E,
+				      0x3F, 0x45, 0x61, 0xC3, 0x32, 0x1D};
+
+	static const uint8_t ciphertext[] = {0xAC, 0x9A, 0x16, 0xF0, 0x95, 0x3A, 0x3F, 0x22, 0x3D,
+					     0xD1, 0x0C, 0xF5, 0x36, 0xE0, 0x9E, 0x9C};
+
+	struct fp_account_key account_key_list[FIND_TEST_ACCOUNT_KEY_CNT];
+	uint8_t result_buf[FP_CRYPTO_AES128_BLOCK_LEN];
+	uint32_t start;
+	int ret;
+
+	find_test_keys_prepare(account_key_list, ARRAY_SIZE(account_key_list), key,
+			       FIND_TEST_MATCH_IDX);
+
+	start = k_cycle_get_32();
+	ret = fp_crypto_aes128_ecb_decrypt_find(result_buf, ciphertext, account_key_list,
+						ARRAY_SIZE(account_key_list), aes128_ecb_find_check,
+						(void *)plaintext);
+	TC_PRINT("AES-128-ECB find over %u keys: %u cycles\n", FIND_TEST_MATCH_IDX + 1U,
+		 k_cycle_get_32() - start);
+
+	zassert_equal(ret, FIND_TEST_MATCH_IDX, "Invalid key found.");
+	zassert_mem_equal(result_buf, plaintext, sizeof(plaintext), "Invalid decryption result.");
+
+	find_test_keys_prepare(account_key_list, ARRAY_SIZE(account_key_list), key,
+			       ARRAY_SIZE(account_key_list));
+
+	ret = fp_crypto_aes128_ecb_decrypt_find(result_buf, ciphertext, account_key_list,
+						ARRAY_SIZE(account_key_list), aes128_ecb_find_check,
+						(void *)plaintext);
+	zassert_equal(ret, -ESRCH, "Key found while none should match.");
+}
+
+ZTEST(suite_crypto, test_hmac_sha256_find)
+{
+	static const uint8_t input_data[] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0xEE,
+					     0x4A, 0x24, 0x83, 0x73, 0x80, 0x52, 0xE4, 0x4E, 0x9B,
+					     0x2A, 0x14, 0x5E, 0x5D, 0xDF, 0xAA, 0x44, 0xB9, 0xE5,
+					     0x53, 0x6A, 0xF4, 0x38, 0xE1, 0xE5, 0xC6};
+
+	static const uint8_t aes_key[] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF, 0x01,
+					  0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF};
+
+	static const uint8_t hashed_result[] = {0x55, 0xEC, 0x5E, 0x60, 0x55, 0xAF, 0x6E, 0x92,
+						0x61, 0x8B, 0x7D, 0x87, 0x10, 0xD4, 0x41, 0x37,
+						0x09, 0xAB, 0x5D, 0xA2, 0x7C, 0xA2, 0x6A, 0x66,
+						0xF5, 0x2E, 0x5A, 0xD4, 0xE8, 0x20, 0x90, 0x52};
+
+	struct fp_account_key account_key_list[FIND_TEST_ACCOUNT_KEY_CNT];
+	uint8_t result_buf[FP_CRYPTO_SHA256_HASH_LEN];
+	uint32_t start;
+	int ret;
+
+	find_test_keys_prepare(account_key_list, ARRAY_SIZE(account_key_list), aes_key,
+			       FIND_TEST_MATCH_IDX);
+
+	start = k_cycle_get_32();
+	ret = fp_crypto_hmac_sha256_find(result_buf, input_data, sizeof(input_data),
+					 account_key_list, ARRAY_SIZE(account_key_list),
+					 hmac_sha256_find_check, (void *)hashed_result);
+	TC_PRINT("HMAC-SHA256 find over %u keys: %u cycles\n", FIND_TEST_MATCH_IDX + 1U,
+		 k_cycle_get_32() - start);
+
+	zassert_equal(ret, FIND_TEST_MATCH_IDX, "Invalid key found.");
+	zassert_mem_equal(result_buf, hashed_result, sizeof(hashed_result),
+			  "Invalid hashing result.");
+
+	find_test_keys_prepare(account_key_list, ARRAY_SIZE(account_key_list), aes_key,
+			       ARRAY_SIZE(account_key_list));
+
+	ret = fp_crypto_hmac_sha256_find(result_buf, input_data, sizeof(input_data),
+					 account_key_list, ARRAY_SIZE(account_key_list),
+					 hmac_sha256_find_check, (void *)hashed_result);
+	zassert_equal(ret, -ESRCH, "Key found while none should match.");
+}
+
 ZTEST(suite_crypto, test_aes128_ctr)
 {
 	static const uint8_t plaintext[] = {0x53, 0x6F, 0x6D, 0x65, 0x6F, 0x6E, 0x65, 0x27, 0x73,
@@ -429,6 +539,7 @@ ZTEST(suite_crypto, test_bloom_filter)
 	static const uint8_t second_bloom_filter[] = {0x84, 0x4A, 0x62, 0x20, 0x8B};
 
 	uint8_t second_result_buf[sizeof(second_bloom_filter)];
+	uint32_t start;
 
 	s = fp_crypto_account_key_filter_size(ARRAY_SIZE(second_account_key_list));
 	zassert_equal(s, sizeof(second_bloom_filter),
@@ -444,10 +555,13 @@ ZTEST(suite_crypto, test_bloom_filter)
 
 	zassert_equal(sizeof(second_result_buf), sizeof(second_bloom_filter_with_battery_info),
 		      "Invalid size of expected result.");
+	start = k_cycle_get_32();
 	zassert_ok(fp_crypto_account_key_filter(second_result_buf, second_account_key_list,
 						ARRAY_SIZE(second_account_key_list), salt,
 						battery_info),
 		   "Error during filter computing");
+	TC_PRINT("Account Key Filter for %zu keys: %u cycles\n",
+		 ARRAY_SIZE(second_account_key_list), k_cycle_get_32() - start);
 	zassert_mem_equal(second_result_buf, second_bloom_filter_with_battery_info,
 			  sizeof(second_bloom_filter_with_battery_info),
 			  "Invalid resulting filter.");
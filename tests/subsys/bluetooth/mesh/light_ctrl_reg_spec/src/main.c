@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdint.h>
+#include <zephyr/ztest.h>
+#include <bluetooth/mesh/light_ctrl_reg_spec.h>
+
+#define REG_INT CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_INTERVAL
+
+/* Maximum difference between the fixed-point regulator and the floating-point reference, in
+ * lightness levels.
+ */
+#define TOLERANCE 1.0f
+
+/* Lux contributed by the luminaire per lightness level. */
+#define LUX_PER_LEVEL (1000.0f / UINT16_MAX)
+
+#define BENCHMARK_STEPS 1000
+
+static struct bt_mesh_light_ctrl_reg_spec spec_reg = BT_MESH_LIGHT_CTRL_REG_SPEC_INIT;
+static float output;
+
+/* Timer rescheduled by the reference step, as the regulator step reschedules its own. */
+static struct k_work_delayable ref_timer;
+
+/* Measured values changing at every benchmark step, so that the cost of converting the
+ * measured value is included.
+ */
+static const float bench_measured[] = { 300.0f, 310.0f, 295.0f, 305.0f };
+
+/* Floating-point reference implementation of the specification-defined regulator. */
+static struct {
+	float i;
+	bool neg;
+} ref;
+
+/* Coefficients are kept low enough for the simulated closed loop to be stable, so that rounding
+ * differences are not amplified.
+ */
+static const struct bt_mesh_light_ctrl_reg_cfg cfgs[] = {
+	{ .ki = { .up = 100.0f, .down = 25.0f }, .kp = { .up = 20.0f, .down = 20.0f },
+	  .accuracy = 2.0f },
+	{ .ki = { .up = 50.0f, .down = 50.0f }, .kp = { .up = 5.0f, .down = 10.0f },
+	  .accuracy = 0.0f },
+	{ .ki = { .up = 12.5f, .down = 0.5f }, .kp = { .up = 0.25f, .down = 3.0f },
+	  .accuracy = 10.0f },
+};
+
+static void ref_terms_calc(float *i, float *p)
+{
+	float target = bt_mesh_light_ctrl_reg_target_get(&spec_reg.reg);
+	float error = target - spec_reg.reg.measured;
+	float accuracy = (spec_reg.reg.cfg.accuracy * target) / (2 * 100.0f);
+	float input;
+	float kp, ki;
+
+	if (error > accuracy) {
+		input = error - accuracy;
+	} else if (error < -accuracy) {
+		input = error + accuracy;
+	} else {
+		input = 0.0f;
+	}
+
+	if (input >= 0) {
+		kp = spec_reg.reg.cfg.kp.up;
+		ki = spec_reg.reg.cfg.ki.up;
+	} else {
+		kp = spec_reg.reg.cfg.kp.down;
+		ki = spec_reg.reg.cfg.ki.down;
+	}
+
+	*i = input * ki * ((float)REG_INT / (float)MSEC_PER_SEC);
+	*p = input * kp;
+}
+
+static void ref_start(uint16_t lightness)
+{
+	float i, p;
+
+	ref_terms_calc(&i, &p);
+	ref.i = lightness - i;
+	ref.neg = true;
+}
+
+static float ref_step(void)
+{
+	float i, p;
+
+	ref_terms_calc(&i, &p);
+	ref.i += i;
+
+	if (ref.i >= 0) {
+		ref.neg = false;
+	}
+
+	if (!ref.neg) {
+		ref.i = CLAMP(ref.i, 0, UINT16_MAX);
+	}
+
+	return ref.i + p;
+}
+
+static void output_store(struct bt_mesh_light_ctrl_reg *reg, float value)
+{
+	output = value;
+}
+
+static void reg_step_run(void)
+{
+	/* Run the regulator step directly. The step reschedules the regulator timer, so it
+	 * never expires while the test keeps stepping.
+	 */
+	spec_reg.timer.work.handler(&spec_reg.timer.work);
+}
+
+static void ref_timer_handler(struct k_work *work)
+{
+}
+
+static void ref_step_run(void)
+{
+	/* Same work as the regulator step around the terms calculation. */
+	k_work_reschedule(&ref_timer, K_MSEC(REG_INT));
+	output_store(&spec_reg.reg, ref_step());
+}
+
+static float daylight_get(int step)
+{
+	if (step < 200) {
+		return 0.0f;
+	} else if (step < 300) {
+		return 800.0f;
+	} else if (step < 400) {
+		return 150.0f;
+	}
+
+	/* Slow sunset. */
+	return MAX(0.0f, 150.0f - (step - 400) * 0.75f);
+}
+
+static void trajectory_check(uint16_t lightness, float target, int32_t transition_time,
+			     float daylight_offset, int steps)
+{
+	float expected;
+
+	spec_reg.reg.measured = daylight_offset + lightness * LUX_PER_LEVEL;
+	bt_mesh_light_ctrl_reg_target_set(&spec_reg.reg, target, transition_time);
+	/* Start in the middle of the transition, so that the target is interpolated. */
+	spec_reg.reg.transition_start -= transition_time / 2;
+
+	ref_start(lightness);
+	spec_reg.reg.start(&spec_reg.reg, lightness);
+
+	for (int step = 0; step < steps; step++) {
+		expected = ref_step();
+		reg_step_run();
+
+		zassert_within(output, expected, TOLERANCE,
+			       "Step %d: output %d.%03d, expected %d.%03d", step,
+			       (int)output, (int)(output * 1000) % 1000,
+			       (int)expected, (int)(expected * 1000) % 1000);
+		zassert_within((float)spec_reg.i / (1 << 16), ref.i, TOLERANCE,
+			       "Step %d: internal sum diverged", step);
+		zassert_equal(spec_reg.neg, ref.neg, "Step %d: negative flag diverged", step);
+
+		/* Feed the regulator output back as measured illuminance. */
+		spec_reg.reg.measured = daylight_offset + daylight_get(step) +
+					CLAMP(output, 0, UINT16_MAX) * LUX_PER_LEVEL;
+	}
+
+	spec_reg.reg.stop(&spec_reg.reg);
+}
+
+ZTEST(light_ctrl_reg_spec_test, test_trajectory)
+{
+	for (int i = 0; i < ARRAY_SIZE(cfgs); i++) {
+		spec_reg.reg.cfg = cfgs[i];
+		trajectory_check(0, 500.0f, 0, 0.0f, 600);
+	}
+}
+
+ZTEST(light_ctrl_reg_spec_test, test_negative_internal_sum)
+{
+	/* Starting with the measured level far above the target makes the recovered internal
+	 * sum negative.
+	 */
+	for (int i = 0; i < ARRAY_SIZE(cfgs); i++) {
+		spec_reg.reg.cfg = cfgs[i];
+		trajectory_check(100, 200.0f, 0, 2000.0f, 300);
+	}
+}
+
+ZTEST(light_ctrl_reg_spec_test, test_target_transition)
+{
+	/* The transition is slow enough for the target to be the same for both regulators
+	 * within the tolerance, even if a millisecond passes between them.
+	 */
+	for (int i = 0; i < ARRAY_SIZE(cfgs); i++) {
+		spec_reg.reg.cfg = cfgs[i];
+		bt_mesh_light_ctrl_reg_target_set(&spec_reg.reg, 100.0f, 0);
+		trajectory_check(0, 600.0f, 1000000, 0.0f, 300);
+		trajectory_check(0, 100.0f, 1000000, 0.0f, 300);
+	}
+}
+
+ZTEST(light_ctrl_reg_spec_test, test_benchmark)
+{
+	uint32_t fixed_cycles;
+	uint32_t ref_cycles;
+	uint32_t start;
+
+	spec_reg.reg.cfg = cfgs[0];
+	bt_mesh_light_ctrl_reg_target_set(&spec_reg.reg, 500.0f, 0);
+
+	/* Both loops do the same work apart from the regulator arithmetic: the timer
+	 * reschedule, the measured value update and the output callback.
+	 */
+	spec_reg.reg.measured = bench_measured[0];
+	spec_reg.reg.start(&spec_reg.reg, 0);
+
+	start = k_cycle_get_32();
+	for (int step = 0; step < BENCHMARK_STEPS; step++) {
+		spec_reg.reg.measured = bench_measured[step % ARRAY_SIZE(bench_measured)];
+		reg_step_run();
+	}
+	fixed_cycles = k_cycle_get_32() - start;
+
+	spec_reg.reg.stop(&spec_reg.reg);
+
+	spec_reg.reg.measured = bench_measured[0];
+	ref_start(0);
+
+	start = k_cycle_get_32();
+	for (int step = 0; step < BENCHMARK_STEPS; step++) {
+		spec_reg.reg.measured = bench_measured[step % ARRAY_SIZE(bench_measured)];
+		ref_step_run();
+	}
+	ref_cycles = k_cycle_get_32() - start;
+
+	k_work_cancel_delayable(&ref_timer);
+
+	TC_PRINT("Regulator step: fixed-point %u cycles, floating-point %u cycles\n",
+		 fixed_cycles / BENCHMARK_STEPS, ref_cycles / BENCHMARK_STEPS);
+}
+
+static void *setup(void)
+{
+	spec_reg.reg.updated = output_store;
+	spec_reg.reg.init(&spec_reg.reg);
+	k_work_init_delayable(&ref_timer, ref_timer_handler);
+
+	return NULL;
+}
+
+ZTEST_SUITE(light_ctrl_reg_spec_test, NULL, setup, NULL, NULL, NULL);
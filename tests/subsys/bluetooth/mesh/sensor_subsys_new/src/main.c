@@ -975,4 +975,107 @@ TEST_SENSOR_TYPE(rel_dev_runtime_in_a_generic_level_range, 0x0061,
 
 TEST_SENSOR_TYPE(total_dev_runtime, 0x006e, CHANNEL(time_hour_24, 3))
 
+/* Sensor type defined outside of the sensor types module, not sorted by ID. */
+static const STRUCT_SECTION_ITERABLE(bt_mesh_sensor_type, test_custom_type) = {
+	.id = 0xfff0,
+};
+
+ZTEST(sensor_types_test_new, test_type_get)
+{
+	uint16_t prev_id = 0;
+	bool sorted = true;
+
+	STRUCT_SECTION_FOREACH(bt_mesh_sensor_type, type) {
+		zassert_equal_ptr(bt_mesh_sensor_type_get(type->id), type,
+				  "Wrong type for ID 0x%04x", type->id);
+
+		if (type == &test_custom_type) {
+			sorted = false;
+		}
+
+		if (sorted) {
+			zassert_true(type->id > prev_id, "Type 0x%04x not sorted", type->id);
+			prev_id = type->id;
+		}
+	}
+
+	zassert_equal_ptr(bt_mesh_sensor_type_get(0xfff0), &test_custom_type);
+	zassert_is_null(bt_mesh_sensor_type_get(0x0000));
+	zassert_is_null(bt_mesh_sensor_type_get(0xffff));
+}
+
+static const struct bt_mesh_sensor_type *linear_type_get(uint16_t id)
+{
+	STRUCT_SECTION_FOREACH(bt_mesh_sensor_type, type) {
+		if (type->id == id) {
+			return type;
+		}
+	}
+
+	return NULL;
+}
+
+/* Decodes a status message with a value of every sensor type, looking up the
+ * types either with bt_mesh_sensor_type_get() or with a linear scan, as done
+ * before the types were sorted by ID.
+ */
+static void status_decode(struct net_buf_simple *buf,
+			  const struct bt_mesh_sensor_type *(*type_get)(uint16_t id),
+			  uint32_t *cycles)
+{
+	struct bt_mesh_sensor_value values[CONFIG_BT_MESH_SENSOR_CHANNELS_MAX];
+	struct net_buf_simple_state state;
+	uint32_t start;
+
+	net_buf_simple_save(buf, &state);
+
+	start = k_cycle_get_32();
+
+	while (buf->len) {
+		const struct bt_mesh_sensor_type *type;
+		uint8_t len;
+		uint16_t id;
+
+		sensor_status_id_decode(buf, &len, &id);
+		type = type_get(id);
+		zassert_not_null(type, "No type for ID 0x%04x", id);
+		zassert_ok(sensor_value_decode(buf, type, values));
+	}
+
+	*cycles = k_cycle_get_32() - start;
+
+	net_buf_simple_restore(buf, &state);
+}
+
+ZTEST(sensor_types_test_new, test_status_decode_benchmark)
+{
+	NET_BUF_SIMPLE_DEFINE_STATIC(buf, 2048);
+	uint8_t data[BT_MESH_SENSOR_ENCODED_VALUE_MAXLEN] = { 0 };
+	uint32_t count = 0;
+	uint32_t cycles;
+
+	net_buf_simple_reset(&buf);
+
+	STRUCT_SECTION_FOREACH(bt_mesh_sensor_type, type) {
+		uint8_t len = sensor_value_len(type);
+
+		if (len == 0) {
+			continue;
+		}
+
+		zassert_ok(sensor_status_id_encode(&buf, len, type->id));
+		zassert_true(net_buf_simple_tailroom(&buf) >= len);
+		(void)net_buf_simple_add_mem(&buf, data, len);
+		count++;
+	}
+
+	status_decode(&buf, bt_mesh_sensor_type_get, &cycles);
+	TC_PRINT("Status decode of %u sensors (%u bytes): %u cycles\n", count, buf.len,
+		 cycles);
+
+	status_decode(&buf, linear_type_get, &cycles);
+	TC_PRINT("Status decode of %u sensors (%u bytes), linear lookup: %u cycles\n", count,
+		 buf.len, cycles);
+}
+
 ZTEST_SUITE(sensor_types_test_new, NULL, NULL, NULL, NULL, NULL);
@@ -11,6 +11,7 @@
 #include <helpers/nrfx_gppi.h>
 #include <nrfx_timer.h>
 #include <hal/nrf_power.h>
+#include <zephyr/tracing/tracing.h>
 
 #ifdef DPPI_PRESENT
 #include <nrfx_dppi.h>
@@ -85,4 +86,69 @@ ZTEST(cpu_load, test_cpu_load)
 	zassert_true(load < SMALL_LOAD, "Unexpected load:%d", load);
 }
 
+#ifdef CONFIG_CPU_LOAD_PROFILE
+#define HOOK_ROUNDS 100
+
+CPU_LOAD_WORK_HIST_DEFINE(test_work);
+
+static void profile_cb(const struct cpu_load_profile_entry *entry, void *user_data)
+{
+	uint64_t *cycles = user_data;
+
+	if ((entry->type == CPU_LOAD_PROFILE_THREAD) &&
+	    (entry->thread == k_current_get())) {
+		*cycles = entry->cycles;
+	}
+}
+
+ZTEST(cpu_load, test_cpu_load_profile)
+{
+	uint64_t thread_cycles = 0;
+	uint64_t total;
+	uint32_t start;
+	uint32_t overhead;
+	uint32_t count;
+	int err;
+
+	err = cpu_load_init();
+	zassert_equal(err, 0, "Unexpected err:%d", err);
+
+	cpu_load_reset();
+
+	/* Busy wait for 10 ms */
+	k_busy_wait(10000);
+
+	total = cpu_load_profile_total_get();
+	cpu_load_profile_foreach(profile_cb, &thread_cycles);
+
+	zassert_true(thread_cycles > total / 2, "Unexpected cycles:%llu", thread_cycles);
+	zassert_true(thread_cycles <= total, "Unexpected cycles:%llu", thread_cycles);
+
+	/* Measure the cost of the interrupt entry and exit hooks. */
+	start = cpu_load_cycles_get();
+	for (size_t i = 0; i < HOOK_ROUNDS; i++) {
+		sys_trace_isr_enter_user(0);
+		sys_trace_isr_exit_user(0);
+	}
+	overhead = (cpu_load_cycles_get() - start) / HOOK_ROUNDS;
+
+	TC_PRINT("Interrupt hooks overhead: %u cycles\n", overhead);
+
+	start = cpu_load_cycles_get();
+	k_busy_wait(100);
+	CPU_LOAD_WORK_HIST_ADD(test_work, start);
+
+	STRUCT_SECTION_FOREACH(cpu_load_work_hist, hist) {
+		count = 0;
+
+		for (size_t i = 0; i < CONFIG_CPU_LOAD_PROFILE_HIST_BINS; i++) {
+			count += atomic_get(&hist->bins[i]);
+		}
+
+		zassert_equal(count, 1, "Unexpected count:%u", count);
+		zassert_true(*hist->max > 0, "Unexpected max");
+	}
+}
+#endif /* CONFIG_CPU_LOAD_PROFILE */
+
 ZTEST_SUITE(cpu_load, NULL, NULL, NULL, NULL, NULL);
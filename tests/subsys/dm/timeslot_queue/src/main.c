@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "timeslot_queue.h"
+#include "time.h"
+
+#define QUEUE_LENGTH		CONFIG_DM_TIMESLOT_QUEUE_LENGTH
+#define COUNT_SAME_PEER		CONFIG_DM_TIMESLOT_QUEUE_COUNT_SAME_PEER
+#define MIN_TIME_BETWEEN_US	CONFIG_DM_MIN_TIME_BETWEEN_TIMESLOTS_US
+
+#define WINDOW_LEN_US		1000
+#define TIMESLOT_LEN_US		5000
+#define TIMESLOT_SPACING_US	(2 * (TIMESLOT_LEN_US + MIN_TIME_BETWEEN_US))
+
+#define BENCHMARK_ROUNDS	20
+
+/* Close to the counter wrap, so that the queued timeslots wrap around. */
+#define START_REF_TICK		(RTC_COUNTER_MAX - US_TO_RTC_TICKS(100000))
+
+static void request_init(struct dm_request *req, uint8_t peer, uint32_t slot)
+{
+	memset(req, 0, sizeof(*req));
+
+	req->role = DM_ROLE_INITIATOR;
+	req->bt_addr.type = BT_ADDR_LE_RANDOM;
+	req->bt_addr.a.val[0] = peer;
+	req->bt_addr.a.val[5] = 0xC0;
+	req->start_delay_us = slot * TIMESLOT_SPACING_US;
+}
+
+static int request_append(uint8_t peer, uint32_t slot)
+{
+	struct dm_request req;
+
+	request_init(&req, peer, slot);
+
+	return timeslot_queue_append(&req, START_REF_TICK, WINDOW_LEN_US, TIMESLOT_LEN_US);
+}
+
+static void queue_clear(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	while (timeslot_queue_peek()) {
+		timeslot_queue_remove_first();
+	}
+}
+
+/* Deterministic shuffle, so that the results can be compared between runs. */
+static void shuffle(uint32_t *array, size_t len)
+{
+	static uint32_t state = 0x12345678;
+	uint32_t tmp;
+	size_t j;
+
+	for (size_t i = len - 1; i > 0; i--) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		j = state % (i + 1);
+		tmp = array[i];
+		array[i] = array[j];
+		array[j] = tmp;
+	}
+}
+
+ZTEST(suite_dm_timeslot_queue, test_empty)
+{
+	zassert_is_null(timeslot_queue_peek(), "Queue is not empty");
+
+	/* Removing from an empty queue must be harmless. */
+	timeslot_queue_remove_first();
+	zassert_is_null(timeslot_queue_peek(), "Queue is not empty");
+}
+
+ZTEST(suite_dm_timeslot_queue, test_time_order)
+{
+	uint32_t slots[QUEUE_LENGTH];
+	struct timeslot_request *req;
+	uint32_t prev_start = 0;
+	int err;
+
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		slots[i] = i;
+	}
+	shuffle(slots, ARRAY_SIZE(slots));
+
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		err = request_append(slots[i] % UINT8_MAX, slots[i]);
+		zassert_ok(err, "Unexpected error: %d", err);
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		req = timeslot_queue_peek();
+		zassert_not_null(req, "Queue is empty");
+		zassert_equal(req->dm_req.start_delay_us, i * TIMESLOT_SPACING_US,
+			      "Timeslots are not in time order");
+		if (i > 0) {
+			zassert_true(time_diff_get(prev_start, req->start_time) > 0,
+				     "Start times are not increasing");
+		}
+
+		prev_start = req->start_time;
+		timeslot_queue_remove_first();
+	}
+
+	zassert_is_null(timeslot_queue_peek(), "Queue is not empty");
+}
+
+ZTEST(suite_dm_timeslot_queue, test_queue_full)
+{
+	int err;
+
+	for (uint32_t i = 0; i < QUEUE_LENGTH; i++) {
+		err = request_append(i, i);
+		zassert_ok(err, "Unexpected error: %d", err);
+	}
+
+	err = request_append(QUEUE_LENGTH, QUEUE_LENGTH);
+	zassert_equal(err, -ENOMEM, "Unexpected error: %d", err);
+
+	timeslot_queue_remove_first();
+
+	err = request_append(QUEUE_LENGTH, QUEUE_LENGTH);
+	zassert_ok(err, "Unexpected error: %d", err);
+}
+
+ZTEST(suite_dm_timeslot_queue, test_same_peer_limit)
+{
+	int err;
+
+	for (uint32_t i = 0; i < COUNT_SAME_PEER; i++) {
+		err = request_append(0, i);
+		zassert_ok(err, "Unexpected error: %d", err);
+	}
+
+	err = request_append(0, COUNT_SAME_PEER);
+	zassert_equal(err, -EAGAIN, "Unexpected error: %d", err);
+
+	/* Other peers are not affected. */
+	err = request_append(1, COUNT_SAME_PEER);
+	zassert_ok(err, "Unexpected error: %d", err);
+
+	timeslot_queue_remove_first();
+
+	err = request_append(0, COUNT_SAME_PEER + 1);
+	zassert_ok(err, "Unexpected error: %d", err);
+}
+
+ZTEST(suite_dm_timeslot_queue, test_time_conflict)
+{
+	struct dm_request req;
+	int err;
+
+	err = request_append(0, 2);
+	zassert_ok(err, "Unexpected error: %d", err);
+
+	/* Overlaps with the end of the queued timeslot. */
+	request_init(&req, 1, 2);
+	req.start_delay_us += TIMESLOT_LEN_US;
+	err = timeslot_queue_append(&req, START_REF_TICK, WINDOW_LEN_US, TIMESLOT_LEN_US);
+	zassert_equal(err, -EBUSY, "Unexpected error: %d", err);
+
+	/* Ends too close to the start of the queued timeslot. */
+	request_init(&req, 1, 2);
+	req.start_delay_us -= TIMESLOT_LEN_US;
+	err = timeslot_queue_append(&req, START_REF_TICK, WINDOW_LEN_US, TIMESLOT_LEN_US);
+	zassert_equal(err, -EBUSY, "Unexpected error: %d", err);
+
+	/* Fits before and after the queued timeslot. */
+	err = request_append(1, 1);
+	zassert_ok(err, "Unexpected error: %d", err);
+	err = request_append(1, 3);
+	zassert_ok(err, "Unexpected error: %d", err);
+}
+
+ZTEST(suite_dm_timeslot_queue, test_benchmark)
+{
+	uint32_t slots[QUEUE_LENGTH];
+	uint32_t append_min = UINT32_MAX;
+	uint32_t append_max = 0;
+	uint32_t remove_max = 0;
+	uint32_t start;
+	uint32_t cycles;
+	int err;
+
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		slots[i] = i;
+	}
+
+	for (size_t round = 0; round < BENCHMARK_ROUNDS; round++) {
+		shuffle(slots, ARRAY_SIZE(slots));
+
+		for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+			struct dm_request req;
+
+			request_init(&req, i, slots[i]);
+
+			start = k_cycle_get_32();
+			err = timeslot_queue_append(&req, START_REF_TICK, WINDOW_LEN_US,
+						    TIMESLOT_LEN_US);
+			cycles = k_cycle_get_32() - start;
+
+			zassert_ok(err, "Unexpected error: %d", err);
+			append_min = MIN(append_min, cycles);
+			append_max = MAX(append_max, cycles);
+		}
+
+		for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+			start = k_cycle_get_32();
+			timeslot_queue_remove_first();
+			cycles = k_cycle_get_32() - start;
+
+			remove_max = MAX(remove_max, cycles);
+		}
+	}
+
+	TC_PRINT("Timeslot queue with %d peers: append %u-%u cycles (jitter %u), remove max %u cycles\n",
+		 QUEUE_LENGTH, append_min, append_max, append_max - append_min, remove_max);
+}
+
+ZTEST_SUITE(suite_dm_timeslot_queue, NULL, NULL, queue_clear, queue_clear, NULL);
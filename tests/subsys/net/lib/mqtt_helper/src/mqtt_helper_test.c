@@ -33,6 +33,9 @@
 #define TEST_PAYLOAD		"This is a test payload"
 #define TEST_PAYLOAD_LEN	(sizeof(TEST_PAYLOAD) - 1)
 
+/* Spans several payload buffers and ends with a partial one. */
+#define TEST_LARGE_PAYLOAD_LEN	(2 * CONFIG_MQTT_HELPER_PAYLOAD_BUFFER_LEN + 100)
+
 /* Pull in variables and functions from the MQTT helper library. */
 extern struct mqtt_client mqtt_client;
 extern enum mqtt_state mqtt_state;
@@ -50,6 +53,9 @@ extern void mqtt_evt_handler(struct mqtt_client *const mqtt_client,
 extern void mqtt_helper_poll_loop(void);
 extern void on_publish(const struct mqtt_evt *mqtt_evt);
 extern char payload_buf[];
+extern struct k_work_q publish_work_q;
+extern void publish_queue_process(void);
+extern void publish_queue_flush(void);
 
 /* Semaphores used by tests to wait for a certain callbacks */
 static K_SEM_DEFINE(connack_success_sem, 0, 1);
@@ -60,6 +66,11 @@ static K_SEM_DEFINE(suback_sem, 0, 1);
 static K_SEM_DEFINE(publish_sem, 0, 1);
 static K_SEM_DEFINE(error_msg_size_sem, 0, 1);
 
+static size_t fragment_offset;
+static size_t fragment_count;
+static uint16_t published_ids[CONFIG_MQTT_HELPER_PUBLISH_QUEUE_LEN];
+static size_t published_count;
+
 void setUp(void)
 {
 	__cmock_mqtt_keepalive_time_left_IgnoreAndReturn(0);
@@ -80,6 +91,40 @@ static int mqtt_readall_publish_payload_stub(struct mqtt_client *client, uint8_t
 	return 0;
 }
 
+static uint8_t large_payload_byte(size_t offset)
+{
+	return (uint8_t)(offset * 7);
+}
+
+static int mqtt_readall_publish_payload_large_stub(struct mqtt_client *client, uint8_t *buffer,
+						   size_t length, int num_calls)
+{
+	size_t offset = num_calls * CONFIG_MQTT_HELPER_PAYLOAD_BUFFER_LEN;
+
+	TEST_ASSERT_TRUE(length <= CONFIG_MQTT_HELPER_PAYLOAD_BUFFER_LEN);
+	TEST_ASSERT_TRUE(offset + length <= TEST_LARGE_PAYLOAD_LEN);
+
+	for (size_t i = 0; i < length; i++) {
+		buffer[i] = large_payload_byte(offset + i);
+	}
+
+	return 0;
+}
+
+static int mqtt_publish_stub(struct mqtt_client *client, const struct mqtt_publish_param *param,
+			     int num_calls)
+{
+	TEST_ASSERT_EQUAL(TEST_TOPIC_1_LEN, param->message.topic.topic.size);
+	TEST_ASSERT_EQUAL_MEMORY(TEST_TOPIC_1, param->message.topic.topic.utf8, TEST_TOPIC_1_LEN);
+	TEST_ASSERT_EQUAL(TEST_PAYLOAD_LEN, param->message.payload.len);
+	TEST_ASSERT_EQUAL_MEMORY(TEST_PAYLOAD, param->message.payload.data, TEST_PAYLOAD_LEN);
+	TEST_ASSERT_TRUE(published_count < ARRAY_SIZE(published_ids));
+
+	published_ids[published_count++] = param->message_id;
+
+	return 0;
+}
+
 static int poll_stub_pollin(struct pollfd *fds, int nfds, int timeout, int num_calls)
 {
 	fds[0].revents = fds[0].events & POLLIN;
@@ -180,6 +225,22 @@ static void cb_on_publish(struct mqtt_helper_buf topic, struct mqtt_helper_buf p
 	k_sem_give(&publish_sem);
 }
 
+static void cb_on_publish_fragment(struct mqtt_helper_buf topic, struct mqtt_helper_buf fragment,
+				   size_t offset, size_t total_len)
+{
+	TEST_ASSERT_EQUAL(TEST_TOPIC_1_LEN, topic.size);
+	TEST_ASSERT_EQUAL_MEMORY(TEST_TOPIC_1, topic.ptr, TEST_TOPIC_1_LEN);
+	TEST_ASSERT_EQUAL(TEST_LARGE_PAYLOAD_LEN, total_len);
+	TEST_ASSERT_EQUAL(fragment_offset, offset);
+
+	for (size_t i = 0; i < fragment.size; i++) {
+		TEST_ASSERT_EQUAL(large_payload_byte(offset + i), (uint8_t)fragment.ptr[i]);
+	}
+
+	fragment_offset += fragment.size;
+	fragment_count++;
+}
+
 static void cb_on_connack(enum mqtt_conn_return_code return_code, bool session_present)
 {
 	switch (return_code) {
@@ -599,6 +660,190 @@ void test_mqtt_helper_poll_loop_pollerr(void)
 	mqtt_helper_poll_loop();
 }
 
+static void publish_param_init(struct mqtt_publish_param *param, enum mqtt_qos qos,
+			       uint16_t message_id)
+{
+	*param = (struct mqtt_publish_param) {
+		.message = {
+			.payload = {
+				.data = TEST_PAYLOAD,
+				.len = TEST_PAYLOAD_LEN,
+			},
+			.topic = {
+				.topic = {
+					.utf8 = TEST_TOPIC_1,
+					.size = TEST_TOPIC_1_LEN,
+				},
+				.qos = qos,
+			},
+		},
+		.message_id = message_id,
+	};
+}
+
+static void publish_queue_test_init(void)
+{
+	struct mqtt_helper_cfg cfg = {
+		.cb = {
+			.on_puback = cb_on_puback,
+		},
+	};
+
+	TEST_ASSERT_EQUAL(0, mqtt_helper_init(&cfg));
+
+	/* Suspend the publish work queue to have full control over publishing. */
+	k_thread_suspend(k_work_queue_thread_get(&publish_work_q));
+
+	publish_queue_flush();
+	published_count = 0;
+
+	mqtt_state = MQTT_STATE_CONNECTED;
+}
+
+void test_on_publish_fragmented(void)
+{
+	struct mqtt_helper_cfg cfg = {
+		.cb = {
+			.on_publish_fragment = cb_on_publish_fragment,
+		},
+	};
+	struct mqtt_evt evt = {
+		.type = MQTT_EVT_PUBLISH,
+		.param.publish = {
+			.message = {
+				.topic = {
+					.topic = {
+						.utf8 = TEST_TOPIC_1,
+						.size = TEST_TOPIC_1_LEN,
+					},
+					.qos = MQTT_QOS_1_AT_LEAST_ONCE,
+				},
+				.payload.len = TEST_LARGE_PAYLOAD_LEN,
+			},
+			.message_id = TEST_MESSAGE_ID,
+		},
+	};
+
+	TEST_ASSERT_EQUAL(0, mqtt_helper_init(&cfg));
+
+	__cmock_mqtt_readall_publish_payload_Stub(mqtt_readall_publish_payload_large_stub);
+	__cmock_mqtt_publish_qos1_ack_ExpectAnyArgsAndReturn(0);
+
+	fragment_offset = 0;
+	fragment_count = 0;
+
+	mqtt_evt_handler(&mqtt_client, &evt);
+
+	TEST_ASSERT_EQUAL(TEST_LARGE_PAYLOAD_LEN, fragment_offset);
+	TEST_ASSERT_EQUAL(3, fragment_count);
+}
+
+void test_mqtt_helper_publish_queued_when_disconnected(void)
+{
+	struct mqtt_publish_param pub_param;
+
+	publish_param_init(&pub_param, MQTT_QOS_0_AT_MOST_ONCE, TEST_MESSAGE_ID);
+	mqtt_state = MQTT_STATE_DISCONNECTED;
+
+	TEST_ASSERT_EQUAL(-EOPNOTSUPP, mqtt_helper_publish_queued(&pub_param));
+}
+
+void test_mqtt_helper_publish_queued_too_large(void)
+{
+	struct mqtt_publish_param pub_param;
+
+	publish_queue_test_init();
+
+	publish_param_init(&pub_param, MQTT_QOS_0_AT_MOST_ONCE, TEST_MESSAGE_ID);
+	pub_param.message.payload.len = CONFIG_MQTT_HELPER_PUBLISH_QUEUE_MSG_SIZE;
+
+	TEST_ASSERT_EQUAL(-EMSGSIZE, mqtt_helper_publish_queued(&pub_param));
+}
+
+void test_mqtt_helper_publish_queued_full(void)
+{
+	struct mqtt_publish_param pub_param;
+
+	publish_queue_test_init();
+
+	for (uint16_t i = 0; i < CONFIG_MQTT_HELPER_PUBLISH_QUEUE_LEN; i++) {
+		publish_param_init(&pub_param, MQTT_QOS_0_AT_MOST_ONCE, i + 1);
+		TEST_ASSERT_EQUAL(0, mqtt_helper_publish_queued(&pub_param));
+	}
+
+	TEST_ASSERT_EQUAL(-ENOMEM, mqtt_helper_publish_queued(&pub_param));
+}
+
+/* Test that all queued QoS 0 messages are published in order in one batch. */
+void test_mqtt_helper_publish_queued_qos0(void)
+{
+	struct mqtt_publish_param pub_param;
+
+	publish_queue_test_init();
+
+	__cmock_mqtt_publish_Stub(mqtt_publish_stub);
+
+	for (uint16_t i = 0; i < CONFIG_MQTT_HELPER_PUBLISH_QUEUE_LEN; i++) {
+		publish_param_init(&pub_param, MQTT_QOS_0_AT_MOST_ONCE, i + 1);
+		TEST_ASSERT_EQUAL(0, mqtt_helper_publish_queued(&pub_param));
+	}
+
+	publish_queue_process();
+
+	TEST_ASSERT_EQUAL(CONFIG_MQTT_HELPER_PUBLISH_QUEUE_LEN, published_count);
+
+	for (uint16_t i = 0; i < CONFIG_MQTT_HELPER_PUBLISH_QUEUE_LEN; i++) {
+		TEST_ASSERT_EQUAL(i + 1, published_ids[i]);
+	}
+}
+
+/* Test that publishing of QoS 1 messages stops when the window is full,
+ * and continues after a PUBACK is received.
+ */
+void test_mqtt_helper_publish_queued_qos1_window(void)
+{
+	struct mqtt_publish_param pub_param;
+
+	publish_queue_test_init();
+
+	__cmock_mqtt_publish_Stub(mqtt_publish_stub);
+
+	for (uint16_t i = 0; i < CONFIG_MQTT_HELPER_QOS1_WINDOW + 1; i++) {
+		publish_param_init(&pub_param, MQTT_QOS_1_AT_LEAST_ONCE, i + 1);
+		TEST_ASSERT_EQUAL(0, mqtt_helper_publish_queued(&pub_param));
+	}
+
+	publish_queue_process();
+	TEST_ASSERT_EQUAL(CONFIG_MQTT_HELPER_QOS1_WINDOW, published_count);
+
+	publish_queue_process();
+	TEST_ASSERT_EQUAL(CONFIG_MQTT_HELPER_QOS1_WINDOW, published_count);
+
+	send_mqtt_event(MQTT_EVT_PUBACK, 1);
+
+	publish_queue_process();
+	TEST_ASSERT_EQUAL(CONFIG_MQTT_HELPER_QOS1_WINDOW + 1, published_count);
+	TEST_ASSERT_EQUAL(CONFIG_MQTT_HELPER_QOS1_WINDOW + 1, published_ids[published_count - 1]);
+}
+
+/* Test that queued messages are dropped when the client disconnects. */
+void test_mqtt_helper_publish_queued_dropped_on_disconnect(void)
+{
+	struct mqtt_publish_param pub_param;
+
+	publish_queue_test_init();
+
+	publish_param_init(&pub_param, MQTT_QOS_1_AT_LEAST_ONCE, TEST_MESSAGE_ID);
+	TEST_ASSERT_EQUAL(0, mqtt_helper_publish_queued(&pub_param));
+
+	send_mqtt_event(MQTT_EVT_DISCONNECT, 0);
+	TEST_ASSERT_EQUAL(MQTT_STATE_DISCONNECTED, mqtt_state_get());
+
+	/* No calls to mqtt_publish() are expected. */
+	mqtt_state = MQTT_STATE_CONNECTED;
+	publish_queue_process();
+}
+
 int main(void)
 {
 	(void)unity_main();
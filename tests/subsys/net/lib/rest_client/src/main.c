@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/posix/arpa/inet.h>
+#include <zephyr/posix/unistd.h>
+#include <zephyr/posix/sys/socket.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <net/rest_client.h>
+
+#define SERVER_ADDR "127.0.0.1"
+#define SERVER_PORT 8080
+#define SERVER_STACK_SIZE 2048
+#define SERVER_PRIORITY K_PRIO_PREEMPT(7)
+#define SERVER_SETTLE_MS 100
+
+#define CONTENT_LENGTH_FIELD "Content-Length: "
+
+enum server_mode {
+	/* Respond to every request and keep the connection open */
+	SERVER_KEEP_OPEN,
+	/* Respond to the first request and close the connection */
+	SERVER_CLOSE_AFTER_RESPONSE,
+	/* Close the connection without responding to the second request */
+	SERVER_DROP_SECOND,
+};
+
+static const char server_response[] = "HTTP/1.1 200 OK\r\n"
+				      "Content-Length: 2\r\n"
+				      "\r\n"
+				      "OK";
+
+static K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+static struct k_thread server_thread_data;
+static int listen_fd = -1;
+
+static atomic_t server_mode;
+static atomic_t accept_count;
+static atomic_t request_count;
+
+static char resp_buf[256];
+
+/* Receives one request. Returns 0 on success, or -1 if the connection was closed. */
+static int server_request_recv(int fd)
+{
+	char buf[512];
+	size_t len = 0;
+	size_t header_len;
+	size_t content_len = 0;
+	char *header_end;
+	char *field;
+	ssize_t received;
+
+	for (;;) {
+		received = recv(fd, &buf[len], sizeof(buf) - 1 - len, 0);
+		if (received <= 0) {
+			return -1;
+		}
+
+		len += received;
+		buf[len] = '\0';
+
+		header_end = strstr(buf, "\r\n\r\n");
+		if (header_end == NULL) {
+			if (len == sizeof(buf) - 1) {
+				return -1;
+			}
+			continue;
+		}
+
+		header_len = header_end + 4 - buf;
+
+		field = strstr(buf, CONTENT_LENGTH_FIELD);
+		if (field != NULL && field < header_end) {
+			content_len = strtoul(field + strlen(CONTENT_LENGTH_FIELD), NULL, 10);
+		}
+
+		if (len >= header_len + content_len) {
+			return 0;
+		}
+	}
+}
+
+static void server_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (;;) {
+		int fd = accept(listen_fd, NULL, NULL);
+
+		if (fd < 0) {
+			continue;
+		}
+
+		atomic_inc(&accept_count);
+
+		for (int n = 1; server_request_recv(fd) == 0; n++) {
+			atomic_inc(&request_count);
+
+			if (atomic_get(&server_mode) == SERVER_DROP_SECOND && n == 2) {
+				break;
+			}
+
+			(void)send(fd, server_response, strlen(server_response), 0);
+
+			if (atomic_get(&server_mode) == SERVER_CLOSE_AFTER_RESPONSE) {
+				break;
+			}
+		}
+
+		(void)close(fd);
+	}
+}
+
+static int request_send(enum http_method method, struct rest_client_resp_context *resp_ctx)
+{
+	struct rest_client_req_context req_ctx;
+
+	rest_client_request_defaults_set(&req_ctx);
+	req_ctx.http_method = method;
+	req_ctx.host = SERVER_ADDR;
+	req_ctx.port = SERVER_PORT;
+	req_ctx.url = "/";
+	req_ctx.resp_buff = resp_buf;
+	req_ctx.resp_buff_len = sizeof(resp_buf);
+
+	if (method == HTTP_POST) {
+		req_ctx.body = "{}";
+	}
+
+	return rest_client_request(&req_ctx, resp_ctx);
+}
+
+static void request_ok(enum http_method method)
+{
+	struct rest_client_resp_context resp_ctx;
+	int err;
+
+	err = request_send(method, &resp_ctx);
+	zassert_ok(err, "Request failed: %d", err);
+	zassert_equal(resp_ctx.http_status_code, 200);
+	zassert_equal(resp_ctx.response_len, 2);
+	zassert_mem_equal(resp_ctx.response, "OK", 2);
+}
+
+static void *suite_setup(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+	int err;
+
+	zassert_equal(inet_pton(AF_INET, SERVER_ADDR, &addr.sin_addr), 1);
+
+	listen_fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(listen_fd >= 0, "socket() failed: %d", errno);
+
+	err = bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_ok(err, "bind() failed: %d", errno);
+
+	err = listen(listen_fd, 2);
+	zassert_ok(err, "listen() failed: %d", errno);
+
+	k_thread_create(&server_thread_data, server_stack, K_THREAD_STACK_SIZEOF(server_stack),
+			server_thread, NULL, NULL, NULL, SERVER_PRIORITY, 0, K_NO_WAIT);
+
+	return NULL;
+}
+
+static void test_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	/* Let the server see the pooled connections of the previous test close */
+	rest_client_conn_pool_flush();
+	k_msleep(SERVER_SETTLE_MS);
+
+	atomic_set(&server_mode, SERVER_KEEP_OPEN);
+	atomic_set(&accept_count, 0);
+	atomic_set(&request_count, 0);
+}
+
+ZTEST(rest_client_conn_pool, test_connection_reused)
+{
+	request_ok(HTTP_GET);
+	request_ok(HTTP_GET);
+	request_ok(HTTP_POST);
+
+	zassert_equal(atomic_get(&accept_count), 1, "Connection not reused");
+	zassert_equal(atomic_get(&request_count), 3);
+}
+
+ZTEST(rest_client_conn_pool, test_closed_connection_replaced)
+{
+	atomic_set(&server_mode, SERVER_CLOSE_AFTER_RESPONSE);
+
+	request_ok(HTTP_GET);
+
+	/* The pooled connection is closed by the peer before it is reused */
+	k_msleep(SERVER_SETTLE_MS);
+	request_ok(HTTP_POST);
+
+	zassert_equal(atomic_get(&accept_count), 2, "Closed connection not replaced");
+	zassert_equal(atomic_get(&request_count), 2, "Request sent on a closed connection");
+}
+
+ZTEST(rest_client_conn_pool, test_idempotent_request_retried)
+{
+	atomic_set(&server_mode, SERVER_DROP_SECOND);
+
+	request_ok(HTTP_GET);
+
+	/* The peer closes the pooled connection after receiving the request */
+	request_ok(HTTP_GET);
+
+	zassert_equal(atomic_get(&accept_count), 2, "Request not retried in a new connection");
+	zassert_equal(atomic_get(&request_count), 3);
+}
+
+ZTEST(rest_client_conn_pool, test_post_not_retried)
+{
+	struct rest_client_resp_context resp_ctx;
+	int err;
+
+	atomic_set(&server_mode, SERVER_DROP_SECOND);
+
+	request_ok(HTTP_POST);
+
+	/* The server may have processed the request, so it must not be sent again */
+	err = request_send(HTTP_POST, &resp_ctx);
+	zassert_equal(err, -ECONNRESET, "Unexpected result: %d", err);
+
+	zassert_equal(atomic_get(&accept_count), 1, "POST request retried");
+	zassert_equal(atomic_get(&request_count), 2);
+
+	/* The failed connection is not pooled */
+	request_ok(HTTP_GET);
+	zassert_equal(atomic_get(&accept_count), 2);
+}
+
+ZTEST_SUITE(rest_client_conn_pool, NULL, suite_setup, test_before, NULL, NULL);
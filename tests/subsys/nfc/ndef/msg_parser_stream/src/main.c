@@ -0,0 +1,494 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
+
+#include <nfc/ndef/msg_parser.h>
+#include <nfc/ndef/msg_parser_stream.h>
+
+#define RANDOM_SEED 0x6E646566
+
+#define ITERATION_CNT 500
+/* Number of random fragmentations of each message. */
+#define FRAGMENTATION_CNT 4
+
+#define MSG_RECORD_MAX 5
+#define RECORD_TYPE_LEN_MAX 16
+#define RECORD_ID_LEN_MAX 8
+#define RECORD_PAYLOAD_LEN_MAX 300
+#define RANDOM_DATA_LEN_MAX 64
+#define TRAILING_DATA_LEN_MAX 16
+
+#define MSG_BUF_SIZE 2048
+/* The shortest record takes 3 bytes, so nfc_ndef_msg_parse() never runs out of descriptors. */
+#define MSG_RECORD_COUNT_MAX ((MSG_BUF_SIZE / 3) + 1)
+
+struct stream_ctx {
+	/* Parsed message. */
+	const uint8_t *data;
+	uint32_t len;
+
+	/* Result of nfc_ndef_msg_parse() for the message. */
+	const struct nfc_ndef_msg_desc *expected;
+	bool expected_valid;
+
+	/* Result of the streaming parser. */
+	int err;
+	bool complete;
+	uint32_t consumed;
+	uint32_t record_count;
+	uint32_t payload_received;
+};
+
+static uint8_t msg_buf[MSG_BUF_SIZE];
+static uint8_t desc_buf[NFC_NDEF_PARSER_REQUIRED_MEM(MSG_RECORD_COUNT_MAX)] __aligned(4);
+static uint32_t rand_state;
+
+/* Deterministic pseudo-random generator, so that failures are reproducible. */
+static uint32_t rand_get(void)
+{
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+
+	return rand_state;
+}
+
+static void rand_fill(uint8_t *buf, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		buf[i] = rand_get();
+	}
+}
+
+static uint32_t msg_generate(uint8_t *buf)
+{
+	uint32_t record_cnt = 1 + (rand_get() % MSG_RECORD_MAX);
+	uint32_t len = 0;
+
+	for (uint32_t i = 0; i < record_cnt; i++) {
+		uint8_t type_len = rand_get() % (RECORD_TYPE_LEN_MAX + 1);
+		uint8_t id_len = (rand_get() % 2) ? (rand_get() % (RECORD_ID_LEN_MAX + 1)) : 0;
+		uint32_t payload_len = rand_get() % (RECORD_PAYLOAD_LEN_MAX + 1);
+		/* Use the long format and the ID length field also when they are not needed. */
+		bool sr = (payload_len <= UINT8_MAX) && (rand_get() % 2);
+		bool il = (id_len > 0) || ((rand_get() % 4) == 0);
+		uint8_t flags = rand_get() & NDEF_RECORD_TNF_MASK;
+
+		if (i == 0) {
+			flags |= NDEF_FIRST_RECORD;
+		}
+		if (i == (record_cnt - 1)) {
+			flags |= NDEF_LAST_RECORD;
+		}
+		if (sr) {
+			flags |= NDEF_RECORD_SR_MASK;
+		}
+		if (il) {
+			flags |= NDEF_RECORD_IL_MASK;
+		}
+
+		buf[len++] = flags;
+		buf[len++] = type_len;
+
+		if (sr) {
+			buf[len++] = payload_len;
+		} else {
+			sys_put_be32(payload_len, &buf[len]);
+			len += NDEF_RECORD_PAYLOAD_LEN_LONG_SIZE;
+		}
+
+		if (il) {
+			buf[len++] = id_len;
+		}
+
+		rand_fill(&buf[len], type_len + id_len + payload_len);
+		len += type_len + id_len + payload_len;
+	}
+
+	__ASSERT_NO_MSG(len <= MSG_BUF_SIZE);
+
+	return len;
+}
+
+static uint32_t fragment_len_get(uint32_t left)
+{
+	/* Mostly short fragments, so that the header fields are split between them. */
+	uint32_t max = (rand_get() % 4) ? 8 : 128;
+
+	return 1 + (rand_get() % MIN(left, max));
+}
+
+static enum nfc_ndef_record_location location_get(uint32_t index, uint32_t record_count)
+{
+	if (record_count == 1) {
+		return NDEF_LONE_RECORD;
+	} else if (index == 0) {
+		return NDEF_FIRST_RECORD;
+	} else if (index == (record_count - 1)) {
+		return NDEF_LAST_RECORD;
+	}
+
+	return NDEF_MIDDLE_RECORD;
+}
+
+static const struct nfc_ndef_bin_payload_desc *
+expected_payload_get(const struct nfc_ndef_record_desc *rec_desc)
+{
+	return rec_desc->payload_descriptor;
+}
+
+static int record_begin(const struct nfc_ndef_msg_parser_stream_record *record, void *user_data)
+{
+	struct stream_ctx *ctx = user_data;
+	const struct nfc_ndef_record_desc *rec_desc;
+
+	zassert_equal(record->index, ctx->record_count, "Record %u began twice", record->index);
+	zassert_equal(record->type == NULL, record->type_length == 0);
+	zassert_equal(record->id == NULL, record->id_length == 0);
+
+	ctx->payload_received = 0;
+
+	/* The record may be truncated if nfc_ndef_msg_parse() did not accept it. */
+	if (record->index >= ctx->expected->record_count) {
+		return 0;
+	}
+
+	rec_desc = ctx->expected->record[record->index];
+
+	zassert_equal(record->tnf, rec_desc->tnf, "Record %u: invalid TNF", record->index);
+	zassert_equal(record->type_length, rec_desc->type_length,
+		      "Record %u: invalid type length", record->index);
+	if (record->type_length > 0) {
+		zassert_mem_equal(record->type, rec_desc->type, record->type_length,
+				  "Record %u: invalid type", record->index);
+	}
+	zassert_equal(record->id_length, rec_desc->id_length,
+		      "Record %u: invalid ID length", record->index);
+	if (record->id_length > 0) {
+		zassert_mem_equal(record->id, rec_desc->id, record->id_length,
+				  "Record %u: invalid ID", record->index);
+	}
+	zassert_equal(record->payload_length, expected_payload_get(rec_desc)->payload_length,
+		      "Record %u: invalid payload length", record->index);
+
+	if (ctx->expected_valid) {
+		zassert_equal(record->location,
+			      location_get(record->index, ctx->expected->record_count),
+			      "Record %u: invalid location", record->index);
+	}
+
+	return 0;
+}
+
+static int payload(const struct nfc_ndef_msg_parser_stream_record *record, uint32_t offset,
+		   const uint8_t *data, uint32_t len, void *user_data)
+{
+	struct stream_ctx *ctx = user_data;
+
+	zassert_true(len > 0, "Record %u: empty payload slice", record->index);
+	zassert_equal(offset, ctx->payload_received, "Record %u: payload slices out of order",
+		      record->index);
+	zassert_true(offset + len <= record->payload_length,
+		     "Record %u: payload longer than its length", record->index);
+
+	/* Payload slices point into the fed data, without copying. */
+	zassert_true((data >= ctx->data) && (data + len <= ctx->data + ctx->len),
+		     "Record %u: payload slice outside of the message", record->index);
+
+	if (record->index < ctx->expected->record_count) {
+		const struct nfc_ndef_bin_payload_desc *bin_pay_desc =
+			expected_payload_get(ctx->expected->record[record->index]);
+
+		zassert_equal_ptr(data, &bin_pay_desc->payload[offset],
+				  "Record %u: invalid payload slice", record->index);
+	}
+
+	ctx->payload_received += len;
+
+	return 0;
+}
+
+static int record_end(const struct nfc_ndef_msg_parser_stream_record *record, void *user_data)
+{
+	struct stream_ctx *ctx = user_data;
+
+	zassert_true(record->index < ctx->expected->record_count,
+		     "Record %u was not accepted by nfc_ndef_msg_parse()", record->index);
+	zassert_equal(ctx->payload_received, record->payload_length,
+		      "Record %u: payload incomplete", record->index);
+
+	ctx->record_count++;
+
+	return 0;
+}
+
+static const struct nfc_ndef_msg_parser_stream_cb stream_cb = {
+	.record_begin = record_begin,
+	.payload = payload,
+	.record_end = record_end,
+};
+
+static void stream_parse(struct stream_ctx *ctx, bool fragmented)
+{
+	struct nfc_ndef_msg_parser_stream parser;
+	uint32_t offset = 0;
+	uint32_t fragment_len;
+	uint32_t used;
+
+	ctx->err = 0;
+	ctx->record_count = 0;
+	ctx->payload_received = 0;
+
+	nfc_ndef_msg_parser_stream_init(&parser, &stream_cb, ctx);
+
+	while ((offset < ctx->len) && !nfc_ndef_msg_parser_stream_is_complete(&parser)) {
+		fragment_len = fragmented ? fragment_len_get(ctx->len - offset) :
+					    (ctx->len - offset);
+		used = fragment_len;
+
+		ctx->err = nfc_ndef_msg_parser_stream_feed(&parser, &ctx->data[offset], &used);
+
+		zassert_true(used <= fragment_len, "More data consumed than fed");
+		offset += used;
+
+		if (ctx->err) {
+			break;
+		}
+
+		/* Data is left in the fragment only if the message ended in it. */
+		if (used < fragment_len) {
+			zassert_true(nfc_ndef_msg_parser_stream_is_complete(&parser),
+				     "Data left in the fragment of an incomplete message");
+		}
+	}
+
+	ctx->consumed = offset;
+	ctx->complete = nfc_ndef_msg_parser_stream_is_complete(&parser);
+}
+
+static void parse_check(const uint8_t *data, uint32_t len)
+{
+	const struct nfc_ndef_msg_desc *expected = (const struct nfc_ndef_msg_desc *)desc_buf;
+	uint32_t desc_buf_len = sizeof(desc_buf);
+	uint32_t expected_len = len;
+	struct stream_ctx whole;
+	struct stream_ctx fragmented;
+	int expected_err;
+
+	expected_err = nfc_ndef_msg_parse(desc_buf, &desc_buf_len, data, &expected_len);
+	zassert_not_equal(expected_err, -ENOMEM, "Descriptor buffer too small");
+
+	whole = (struct stream_ctx){
+		.data = data,
+		.len = len,
+		.expected = expected,
+		.expected_valid = (expected_err == 0),
+	};
+
+	stream_parse(&whole, false);
+
+	/* Records reported by the streaming parser are the records accepted by
+	 * nfc_ndef_msg_parse(), including the ones before a malformed record.
+	 */
+	zassert_equal(whole.record_count, expected->record_count, "Invalid record count");
+
+	if (expected_err == 0) {
+		zassert_ok(whole.err, "Valid message rejected: %d", whole.err);
+		zassert_true(whole.complete, "Valid message not complete");
+		zassert_equal(whole.consumed, expected_len, "Invalid message length");
+	} else {
+		zassert_false(whole.complete, "Malformed message (%d) complete", expected_err);
+
+		/* nfc_ndef_msg_parse() reports a message that ends early as malformed, while the
+		 * streaming parser waits for more data. Only a location flag error is detected
+		 * before the end of the data.
+		 */
+		zassert_true((expected_err == -EINVAL) || (expected_err == -EFAULT),
+			     "Unexpected error: %d", expected_err);
+
+		if (whole.err) {
+			zassert_equal(whole.err, -EFAULT, "Unexpected error: %d", whole.err);
+		} else {
+			zassert_equal(whole.consumed, len, "Incomplete message not consumed");
+		}
+	}
+
+	/* The result does not depend on how the message is split into fragments. */
+	for (int i = 0; i < FRAGMENTATION_CNT; i++) {
+		fragmented = (struct stream_ctx){
+			.data = data,
+			.len = len,
+			.expected = expected,
+			.expected_valid = whole.expected_valid,
+		};
+
+		stream_parse(&fragmented, true);
+
+		zassert_equal(fragmented.err, whole.err, "Error depends on fragmentation");
+		zassert_equal(fragmented.complete, whole.complete,
+			      "Completion depends on fragmentation");
+		zassert_equal(fragmented.consumed, whole.consumed,
+			      "Consumed length depends on fragmentation");
+		zassert_equal(fragmented.record_count, whole.record_count,
+			      "Record count depends on fragmentation");
+	}
+}
+
+ZTEST(nfc_ndef_msg_parser_stream, test_valid_messages)
+{
+	uint32_t len;
+
+	for (int i = 0; i < ITERATION_CNT; i++) {
+		len = msg_generate(msg_buf);
+		parse_check(msg_buf, len);
+	}
+}
+
+ZTEST(nfc_ndef_msg_parser_stream, test_trailing_data)
+{
+	uint32_t len;
+	uint32_t trailing_len;
+
+	for (int i = 0; i < ITERATION_CNT; i++) {
+		len = msg_generate(msg_buf);
+		trailing_len = 1 + (rand_get() % TRAILING_DATA_LEN_MAX);
+
+		rand_fill(&msg_buf[len], trailing_len);
+		parse_check(msg_buf, len + trailing_len);
+	}
+}
+
+ZTEST(nfc_ndef_msg_parser_stream, test_truncated_messages)
+{
+	uint32_t len;
+
+	for (int i = 0; i < ITERATION_CNT; i++) {
+		len = msg_generate(msg_buf);
+		parse_check(msg_buf, rand_get() % len);
+	}
+}
+
+ZTEST(nfc_ndef_msg_parser_stream, test_mutated_messages)
+{
+	uint32_t len;
+	uint32_t pos;
+	uint32_t mutation_cnt;
+
+	for (int i = 0; i < ITERATION_CNT; i++) {
+		len = msg_generate(msg_buf);
+		mutation_cnt = 1 + (rand_get() % 3);
+
+		for (uint32_t j = 0; j < mutation_cnt; j++) {
+			pos = rand_get() % len;
+
+			if (rand_get() % 2) {
+				msg_buf[pos] ^= BIT(rand_get() % 8);
+			} else {
+				msg_buf[pos] = rand_get();
+			}
+		}
+
+		parse_check(msg_buf, len);
+	}
+}
+
+ZTEST(nfc_ndef_msg_parser_stream, test_random_data)
+{
+	uint32_t len;
+
+	for (int i = 0; i < ITERATION_CNT; i++) {
+		len = rand_get() % (RANDOM_DATA_LEN_MAX + 1);
+		rand_fill(msg_buf, len);
+
+		/* Make the first location flags valid in half of the cases. */
+		if ((len > 0) && (rand_get() % 2)) {
+			msg_buf[0] |= NDEF_FIRST_RECORD;
+		}
+
+		parse_check(msg_buf, len);
+	}
+}
+
+ZTEST(nfc_ndef_msg_parser_stream, test_feed_after_complete)
+{
+	static const uint8_t msg[] = {
+		/* Lone short record with TNF Well Known, type "T" and 1-byte payload. */
+		NDEF_LONE_RECORD | NDEF_RECORD_SR_MASK | TNF_WELL_KNOWN, 0x01, 0x01, 'T', 0x00,
+		/* Data after the message. */
+		0xAA, 0xBB,
+	};
+	struct stream_ctx ctx = {
+		.data = msg,
+		.len = sizeof(msg),
+		.expected = (const struct nfc_ndef_msg_desc *)desc_buf,
+	};
+	struct nfc_ndef_msg_parser_stream parser;
+	uint32_t desc_buf_len = sizeof(desc_buf);
+	uint32_t len = sizeof(msg);
+	int err;
+
+	err = nfc_ndef_msg_parse(desc_buf, &desc_buf_len, msg, &len);
+	zassert_ok(err);
+
+	nfc_ndef_msg_parser_stream_init(&parser, &stream_cb, &ctx);
+
+	len = sizeof(msg);
+	err = nfc_ndef_msg_parser_stream_feed(&parser, msg, &len);
+	zassert_ok(err);
+	zassert_equal(len, sizeof(msg) - 2, "Data after the message consumed");
+	zassert_true(nfc_ndef_msg_parser_stream_is_complete(&parser));
+	zassert_equal(ctx.record_count, 1);
+
+	len = 2;
+	err = nfc_ndef_msg_parser_stream_feed(&parser, &msg[sizeof(msg) - 2], &len);
+	zassert_equal(err, -EALREADY);
+	zassert_equal(len, 0);
+}
+
+static int payload_reject(const struct nfc_ndef_msg_parser_stream_record *record,
+			  uint32_t offset, const uint8_t *data, uint32_t len, void *user_data)
+{
+	return -ECANCELED;
+}
+
+ZTEST(nfc_ndef_msg_parser_stream, test_callback_error)
+{
+	static const uint8_t msg[] = {
+		/* Lone short record with TNF Media-type, no type and 2-byte payload. */
+		NDEF_LONE_RECORD | NDEF_RECORD_SR_MASK | TNF_MEDIA_TYPE, 0x00, 0x02, 0x01, 0x02,
+	};
+	static const struct nfc_ndef_msg_parser_stream_cb cb = {
+		.payload = payload_reject,
+	};
+	struct nfc_ndef_msg_parser_stream parser;
+	uint32_t len = sizeof(msg);
+	int err;
+
+	nfc_ndef_msg_parser_stream_init(&parser, &cb, NULL);
+
+	err = nfc_ndef_msg_parser_stream_feed(&parser, msg, &len);
+	zassert_equal(err, -ECANCELED, "Callback error not returned: %d", err);
+	zassert_equal(len, 3, "Payload consumed after the callback error");
+
+	/* The parser must be initialized again after an error. */
+	len = sizeof(msg) - 3;
+	err = nfc_ndef_msg_parser_stream_feed(&parser, &msg[3], &len);
+	zassert_equal(err, -EINVAL);
+	zassert_equal(len, 0);
+}
+
+static void test_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	rand_state = RANDOM_SEED;
+}
+
+ZTEST_SUITE(nfc_ndef_msg_parser_stream, NULL, NULL, test_before, NULL, NULL);